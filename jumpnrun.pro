@@ -20,6 +20,11 @@ LIBS -= -lQtCore
 
 DEFINES_RELEASE += RELEASE_BUILD
 
+# count allocations in release builds as well, e.g. for benchmarks
+allocation_tracker {
+   DEFINES += ALLOCATION_TRACKER
+}
+
 #debug {
    CONFIG += console
 #}
@@ -110,6 +115,7 @@ SOURCES += \
    src/game/arrow.cpp \
    src/game/atmosphere.cpp \
    src/game/audio.cpp \
+   src/game/benchmarkrunner.cpp \
    src/game/bitmapfont.cpp \
    src/game/boomeffect.cpp \
    src/game/bow.cpp \
@@ -120,6 +126,7 @@ SOURCES += \
    src/game/console.cpp \
    src/game/detonationanimation.cpp \
    src/game/effects/lightsystem.cpp \
+   src/game/effects/shadowquads.cpp \
    src/game/eventserializer.cpp \
    src/game/fadetransitioneffect.cpp \
    src/game/gameclock.cpp \
@@ -129,8 +136,11 @@ SOURCES += \
    src/game/debugdraw.cpp \
    src/game/dialogue.cpp \
    src/game/displaymode.cpp \
+   src/game/dynamicresolution.cpp \
    src/game/effects/blur.cpp \
    src/game/effects/effect.cpp \
+   src/game/effects/particleemitter.cpp \
+   src/game/effects/particlesystem.cpp \
    src/game/effects/pixelate.cpp \
    src/game/effects/smokeeffect.cpp \
    src/game/effects/staticlight.cpp \
@@ -180,6 +190,9 @@ SOURCES += \
    src/game/messagebox.cpp \
    src/game/physics/physics.cpp \
    src/game/physics/physicsconfiguration.cpp \
+   src/game/physics/islandsolver.cpp \
+   src/game/physics/simulationregion.cpp \
+   src/game/physics/staticchains.cpp \
    src/game/player/player.cpp \
    src/game/player/playeranimation.cpp \
    src/game/player/playerclimb.cpp \
@@ -192,7 +205,10 @@ SOURCES += \
    src/game/overlays/rainoverlay.cpp \
    src/game/projectile.cpp \
    src/game/projectilehitanimation.cpp \
+   src/game/propertykey.cpp \
+   src/game/renderpassscheduler.cpp \
    src/game/room.cpp \
+   src/game/roomindex.cpp \
    src/game/savestate.cpp \
    src/game/screentransition.cpp \
    src/game/screentransitioneffect.cpp \
@@ -202,6 +218,7 @@ SOURCES += \
    src/game/shaders/blurshader.cpp \
    src/game/shaders/deathshader.cpp \
    src/game/shaders/gammashader.cpp \
+   src/game/spatialquery.cpp \
    src/game/squaremarcher.cpp \
    src/game/test.cpp \
    src/game/texturepool.cpp \
@@ -232,14 +249,17 @@ SOURCES += \
 
 SOURCES += \
    src/framework/image/image.cpp \
+   src/framework/image/imagekernels.cpp \
    src/framework/image/layer.cpp \
    src/framework/image/psd.cpp \
+   src/framework/image/psdatlas.cpp \
    src/framework/image/tga.cpp \
    src/framework/joystick/gamecontroller.cpp \
    src/framework/joystick/gamecontrollerinfo.cpp \
    src/framework/math/fbm.cpp \
    src/framework/math/hermitecurve.cpp \
    src/framework/math/maptools.cpp \
+   src/framework/math/pathbatch.cpp \
    src/framework/math/pathinterpolation.cpp \
    src/framework/math/sfmlmath.cpp \
    src/framework/tmxparser/tmxanimation.cpp \
@@ -259,24 +279,31 @@ SOURCES += \
    src/framework/tmxparser/tmxtile.cpp \
    src/framework/tmxparser/tmxtileset.cpp \
    src/framework/tmxparser/tmxtools.cpp \
+   src/framework/tools/allocationtracker.cpp \
    src/framework/tools/callbackmap.cpp \
    src/framework/tools/checksum.cpp \
    src/framework/tools/globalclock.cpp \
+   src/framework/tools/profiler.cpp \
    src/framework/tools/timer.cpp \
+   src/framework/tools/workerpool.cpp \
 
 
 HEADERS += \
    src/framework/image/image.h \
+   src/framework/image/imagekernels.h \
    src/framework/image/layer.h \
    src/framework/image/psd.h \
+   src/framework/image/psdatlas.h \
    src/framework/image/tga.h \
    src/framework/joystick/gamecontroller.h \
    src/framework/joystick/gamecontrollerballvector.h \
    src/framework/joystick/gamecontrollerinfo.h \
+   src/framework/math/fastrandom.h \
    src/framework/math/fbm.h \
    src/framework/math/hermitecurve.h \
    src/framework/math/hermitecurvekey.h \
    src/framework/math/maptools.h \
+   src/framework/math/pathbatch.h \
    src/framework/math/pathinterpolation.h \
    src/framework/math/sfmlmath.h \
    src/framework/tmxparser/tmxanimation.h \
@@ -319,8 +346,11 @@ HEADERS += \
    src/easings/easings.h \
    src/effects/blur.h \
    src/effects/effect.h \
+   src/effects/particleemitter.h \
+   src/effects/particlesystem.h \
    src/effects/pixelate.h \
    src/effects/lightsystem.h \
+   src/effects/shadowquads.h \
    src/effects/smokeeffect.h \
    src/effects/staticlight.h \
    src/game/actioncontrollermap.h \
@@ -330,6 +360,7 @@ HEADERS += \
    src/game/animationsettings.h \
    src/game/atmosphere.h \
    src/game/audio.h \
+   src/game/benchmarkrunner.h \
    src/game/bitmapfont.h \
    src/game/boomeffect.h \
    src/game/bow.h \
@@ -344,6 +375,7 @@ HEADERS += \
    src/game/debugdraw.h \
    src/game/dialogue.h \
    src/game/displaymode.h \
+   src/game/dynamicresolution.h \
    src/game/enemy.h \
    src/game/enemydescription.h \
    src/game/extra.h \
@@ -356,10 +388,15 @@ HEADERS += \
    src/game/forestscene.h \
    src/game/projectile.h \
    src/game/projectilehitanimation.h \
+   src/game/propertykey.h \
+   src/game/propertytable.h \
+   src/framework/tools/allocationtracker.h \
    src/game/tools/callbackmap.h \
    src/game/tools/checksum.h \
    src/game/tools/globalclock.h \
+   src/framework/tools/profiler.h \
    src/game/tools/timer.h \
+   src/framework/tools/workerpool.h \
    src/game/game.h \
    src/game/gameconfiguration.h \
    src/game/gamecontactlistener.h \
@@ -398,6 +435,9 @@ HEADERS += \
    src/game/messagebox.h \
    src/game/physics/physics.h \
    src/game/physics/physicsconfiguration.h \
+   src/game/physics/islandsolver.h \
+   src/game/physics/simulationregion.h \
+   src/game/physics/staticchains.h \
    src/game/player/player.h \
    src/game/player/playerclimb.h \
    src/game/player/playerconfiguration.h \
@@ -406,13 +446,16 @@ HEADERS += \
    src/game/player/playerjump.h \
    src/game/progresssettings.h \
    src/game/overlays/rainoverlay.h \
+   src/game/renderpassscheduler.h \
    src/game/room.h \
+   src/game/roomindex.h \
    src/game/savestate.h \
    src/game/scriptproperty.h \
    src/game/shaders/atmosphereshader.h \
    src/game/shaders/blurshader.h \
    src/game/shaders/deathshader.h \
    src/game/shaders/gammashader.h \
+   src/game/spatialquery.h \
    src/game/squaremarcher.h \
    src/game/test.h \
    src/game/texturepool.h \
@@ -522,6 +565,7 @@ HEADERS += \
     src/thirdparty/Box2D/Common/b2Settings.h \
     src/thirdparty/Box2D/Common/b2StackAllocator.h \
     src/thirdparty/Box2D/Common/b2Timer.h \
+    src/thirdparty/Box2D/Common/b2WideMath.h \
     src/thirdparty/Box2D/Collision/b2BroadPhase.h \
     src/thirdparty/Box2D/Collision/b2Collision.h \
     src/thirdparty/Box2D/Collision/b2Distance.h \
@@ -0,0 +1,144 @@
+#include "benchmark.h"
+
+#include "json/json.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+
+double median(std::vector<double> values)
+{
+   std::sort(values.begin(), values.end());
+
+   const auto size = values.size();
+   if (size == 0)
+   {
+      return 0.0;
+   }
+
+   return (size % 2 == 1) ? values[size / 2] : 0.5 * (values[size / 2 - 1] + values[size / 2]);
+}
+
+
+double timeBatch(const std::function<void()>& function, int64_t batch_size)
+{
+   const auto start = Clock::now();
+
+   for (auto i = 0; i < batch_size; i++)
+   {
+      function();
+   }
+
+   return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+}
+
+
+Benchmark::Benchmark(const Settings& settings)
+ : mSettings(settings)
+{
+}
+
+
+void Benchmark::run(const std::string& name, const std::string& fixture, const std::function<void()>& function)
+{
+   if (!mSettings.mFilter.empty() && (name + "/" + fixture).find(mSettings.mFilter) == std::string::npos)
+   {
+      return;
+   }
+
+   // grow the batch until it fills a sample, this doubles as warmup for caches and lazy initialization
+   const auto sample_us = static_cast<double>(mSettings.mSampleTime.count());
+
+   int64_t batch_size = 1;
+   while (timeBatch(function, batch_size) < sample_us && batch_size < (1 << 24))
+   {
+      batch_size *= 2;
+   }
+
+   timeBatch(function, batch_size);
+
+   std::vector<double> samples;
+   samples.reserve(static_cast<size_t>(mSettings.mRepetitions));
+
+   for (auto i = 0; i < mSettings.mRepetitions; i++)
+   {
+      samples.push_back(timeBatch(function, batch_size) / static_cast<double>(batch_size));
+   }
+
+   Result result;
+   result.mName = name;
+   result.mFixture = fixture;
+   result.mBatchSize = batch_size;
+   result.mRepetitions = mSettings.mRepetitions;
+   result.mMedianUs = median(samples);
+   result.mMinUs = *std::min_element(samples.begin(), samples.end());
+
+   std::vector<double> deviations;
+   deviations.reserve(samples.size());
+   for (auto sample : samples)
+   {
+      deviations.push_back(std::abs(sample - result.mMedianUs));
+   }
+
+   result.mMadUs = median(deviations);
+
+   std::cout
+      << std::setw(32) << std::left << name
+      << std::setw(12) << std::left << fixture
+      << std::setw(14) << std::right << std::fixed << std::setprecision(3) << result.mMedianUs << "us"
+      << " +- " << std::setw(10) << std::left << result.mMadUs
+      << " (" << std::setprecision(1) << (result.mMedianUs > 0.0 ? 100.0 * result.mMadUs / result.mMedianUs : 0.0) << "%)"
+      << " batch " << batch_size
+      << std::endl;
+
+   mResults.push_back(result);
+}
+
+
+const std::vector<Benchmark::Result>& Benchmark::getResults() const
+{
+   return mResults;
+}
+
+
+bool Benchmark::writeJson(const std::string& filename) const
+{
+   nlohmann::json json;
+   json["repetitions"] = mSettings.mRepetitions;
+   json["sample_time_us"] = mSettings.mSampleTime.count();
+   json["results"] = nlohmann::json::array();
+
+   for (const auto& result : mResults)
+   {
+      json["results"].push_back(
+         {
+            {"name", result.mName},
+            {"fixture", result.mFixture},
+            {"median_us", result.mMedianUs},
+            {"mad_us", result.mMadUs},
+            {"min_us", result.mMinUs},
+            {"batch_size", result.mBatchSize},
+            {"repetitions", result.mRepetitions}
+         }
+      );
+   }
+
+   std::ofstream out(filename);
+   if (!out)
+   {
+      std::cerr << "unable to write " << filename << std::endl;
+      return false;
+   }
+
+   out << json.dump(3) << std::endl;
+   return true;
+}
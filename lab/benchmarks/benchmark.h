@@ -0,0 +1,63 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+
+// minimal benchmark harness
+//
+// every benchmark is calibrated so a single sample takes a few milliseconds, warmed up
+// and then sampled a fixed number of times. the reported value is the median time per
+// call, the spread is the median absolute deviation (mad) which unlike the standard
+// deviation is not thrown off by the odd descheduled sample.
+class Benchmark
+{
+
+public:
+
+   struct Settings
+   {
+      std::string mFilter;
+      int32_t mRepetitions = 15;
+      std::chrono::microseconds mSampleTime{2000};
+   };
+
+   struct Result
+   {
+      std::string mName;
+      std::string mFixture;
+      int64_t mBatchSize = 0;
+      int32_t mRepetitions = 0;
+      double mMedianUs = 0.0;
+      double mMadUs = 0.0;
+      double mMinUs = 0.0;
+   };
+
+   explicit Benchmark(const Settings& settings);
+
+   //! measure function, skipped if name and fixture don't match the filter
+   void run(const std::string& name, const std::string& fixture, const std::function<void()>& function);
+
+   const std::vector<Result>& getResults() const;
+   bool writeJson(const std::string& filename) const;
+
+
+private:
+
+   Settings mSettings;
+   std::vector<Result> mResults;
+};
+
+
+inline volatile const void* benchmarkSink = nullptr;
+
+//! keep the optimizer from discarding a computed value
+template <typename T>
+void doNotOptimize(const T& value)
+{
+   benchmarkSink = &value;
+}
+
@@ -0,0 +1,52 @@
+TARGET = benchmarks
+TEMPLATE = app
+
+CONFIG += c++17
+CONFIG += console
+CONFIG -= qt
+
+DEFINES += _USE_MATH_DEFINES
+
+INCLUDEPATH += ../../src
+INCLUDEPATH += ../../src/game
+INCLUDEPATH += ../../src/thirdparty
+INCLUDEPATH += ../../sfml/include
+
+LIBS += -L../../sfml/lib
+
+CONFIG(debug, debug|release) {
+   win32:LIBS += -lsfml-graphics-d -lsfml-window-d -lsfml-system-d
+   unix:LIBS += -lsfml-graphics -lsfml-window -lsfml-system
+} else {
+   LIBS += -lsfml-graphics -lsfml-window -lsfml-system
+}
+
+win32:LIBS += -lopengl32
+unix:LIBS += -lGL -lpthread
+
+SOURCES += \
+        main.cpp \
+        benchmark.cpp \
+        $$files(../../src/framework/tmxparser/*.cpp) \
+        $$files(../../src/thirdparty/Box2D/*.cpp, true) \
+        ../../src/thirdparty/tinyxml2/tinyxml2.cpp \
+        ../../src/framework/image/image.cpp \
+        ../../src/framework/image/imagekernels.cpp \
+        ../../src/framework/image/psd.cpp \
+        ../../src/framework/image/tga.cpp \
+        ../../src/framework/math/hermitecurve.cpp \
+        ../../src/framework/math/maptools.cpp \
+        ../../src/framework/math/pathbatch.cpp \
+        ../../src/framework/math/pathinterpolation.cpp \
+        ../../src/framework/tools/globalclock.cpp \
+        ../../src/framework/tools/profiler.cpp \
+        ../../src/framework/tools/timer.cpp \
+        ../../src/game/effects/shadowquads.cpp \
+        ../../src/game/meshtools.cpp \
+        ../../src/game/physics/physics.cpp \
+        ../../src/game/squaremarcher.cpp \
+        ../../src/game/texturepool.cpp \
+        ../../src/game/tilemap.cpp
+
+HEADERS += \
+        benchmark.h
@@ -0,0 +1,760 @@
+#include <algorithm>
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <SFML/Graphics.hpp>
+
+#include "Box2D/Box2D.h"
+
+#include "benchmark.h"
+#include "constants.h"
+#include "effects/shadowquads.h"
+#include "framework/image/image.h"
+#include "framework/image/psd.h"
+#include "framework/math/hermitecurve.h"
+#include "framework/math/pathbatch.h"
+#include "framework/math/pathinterpolation.h"
+#include "framework/math/maptools.h"
+#include "framework/tmxparser/tmxelement.h"
+#include "framework/tmxparser/tmxlayer.h"
+#include "framework/tmxparser/tmxparser.h"
+#include "framework/tmxparser/tmxtileset.h"
+#include "framework/tools/timer.h"
+#include "physics/physics.h"
+#include "squaremarcher.h"
+#include "tilemap.h"
+
+
+// microbenchmarks for the engine hot paths
+//
+// every benchmark runs against a synthetic fixture with fixed dimensions and, where it
+// makes sense, against a real level. run from the repository root so the data paths
+// resolve.
+//
+// usage: benchmarks [--filter <text>] [--repetitions <n>] [--json <file>] [--level <tmx>] [--psd <psd>]
+
+
+namespace {
+
+constexpr auto syntheticWidth = 512;
+constexpr auto syntheticHeight = 256;
+constexpr auto syntheticLayers = 4;
+constexpr auto tileSize = 24;
+constexpr auto tileColumns = 8;
+
+
+struct Options
+{
+   Benchmark::Settings mSettings;
+   std::string mJsonFilename;
+   std::filesystem::path mLevel = "data/level-demo/demolevel.tmx";
+   std::filesystem::path mPsd = "data/menus/controls.psd";
+};
+
+
+void deleteElements(const TmxParser& parser)
+{
+   for (auto element : parser.getElements())
+   {
+      delete element;
+   }
+}
+
+
+// a parsed level with everything derived from it that the benchmarks need as input
+struct LevelFixture
+{
+   ~LevelFixture()
+   {
+      if (mParser)
+      {
+         deleteElements(*mParser);
+      }
+   }
+
+   bool load(const std::filesystem::path& tmx)
+   {
+      if (!std::filesystem::exists(tmx))
+      {
+         std::cerr << "fixture not found: " << tmx.string() << std::endl;
+         return false;
+      }
+
+      mTmx = tmx;
+      mBasePath = tmx.parent_path();
+      mParser = std::make_unique<TmxParser>();
+      mParser->parse(tmx.string());
+
+      for (auto element : mParser->getElements())
+      {
+         if (element->_type != TmxElement::TypeLayer)
+         {
+            continue;
+         }
+
+         auto layer = dynamic_cast<TmxLayer*>(element);
+         auto tileset = mParser->getTileSet(layer);
+
+         if (!tileset || !layer->_data)
+         {
+            continue;
+         }
+
+         mLayers.push_back({layer, tileset});
+
+         if (layer->_name == "level" && !mPhysicsLayer)
+         {
+            mPhysicsLayer = layer;
+            mPhysicsTileSet = tileset;
+         }
+      }
+
+      if (mPhysicsLayer)
+      {
+         mPhysics.parse(mPhysicsLayer, mPhysicsTileSet, mBasePath);
+
+         SquareMarcher marcher(
+            mPhysics.mGridWidth,
+            mPhysics.mGridHeight,
+            mPhysics.mPhysicsMap,
+            {1},
+            mBasePath / "missing" / "physics_path.csv",
+            1.0f / 3.0f
+         );
+
+         mPaths = marcher.mPaths;
+      }
+
+      createWorld();
+      return true;
+   }
+
+   void createWorld()
+   {
+      mWorld = std::make_unique<b2World>(b2Vec2{0.0f, 9.81f});
+
+      // static chains as built by Level::addPathsToWorld
+      for (const auto& path : mPaths)
+      {
+         std::vector<b2Vec2> chain;
+         for (const auto& pos : path.mScaled)
+         {
+            chain.push_back({pos.x * PIXELS_PER_TILE / PPM, pos.y * PIXELS_PER_TILE / PPM});
+         }
+
+         if (chain.size() < 3)
+         {
+            continue;
+         }
+
+         b2ChainShape shape;
+         shape.CreateLoop(chain.data(), static_cast<int32_t>(chain.size()));
+
+         b2BodyDef body_def;
+         auto body = mWorld->CreateBody(&body_def);
+         body->CreateFixture(&shape, 0);
+      }
+
+      // some boxes and balls spread across the level
+      std::mt19937 rng(7);
+      const auto width_m = mPhysics.mGridWidth > 0 ? mPhysics.mGridWidth / 3.0f * PIXELS_PER_TILE / PPM : 50.0f;
+      const auto height_m = mPhysics.mGridHeight > 0 ? mPhysics.mGridHeight / 3.0f * PIXELS_PER_TILE / PPM : 50.0f;
+      std::uniform_real_distribution<float> x_distribution(0.0f, width_m);
+      std::uniform_real_distribution<float> y_distribution(0.0f, height_m);
+
+      for (auto i = 0; i < 96; i++)
+      {
+         b2BodyDef body_def;
+         body_def.type = b2_dynamicBody;
+         body_def.position = {x_distribution(rng), y_distribution(rng)};
+         auto body = mWorld->CreateBody(&body_def);
+
+         if (i % 3 == 0)
+         {
+            b2CircleShape shape;
+            shape.m_radius = 0.25f;
+            body->CreateFixture(&shape, 1.0f);
+         }
+         else
+         {
+            b2PolygonShape shape;
+            shape.SetAsBox(0.5f, 0.5f);
+            body->CreateFixture(&shape, 1.0f);
+         }
+      }
+
+      for (auto i = 0; i < 64; i++)
+      {
+         mLightPositions.push_back({x_distribution(rng), y_distribution(rng)});
+      }
+   }
+
+   std::filesystem::path mTmx;
+   std::filesystem::path mBasePath;
+   std::unique_ptr<TmxParser> mParser;
+   std::vector<std::pair<TmxLayer*, TmxTileSet*>> mLayers;
+
+   TmxLayer* mPhysicsLayer = nullptr;
+   TmxTileSet* mPhysicsTileSet = nullptr;
+   Physics mPhysics;
+   std::vector<SquareMarcher::Path> mPaths;
+
+   std::unique_ptr<b2World> mWorld;
+   std::vector<b2Vec2> mLightPositions;
+};
+
+
+// writes a tmx file with a few noisy layers, an inline tileset and the physics mapping
+std::filesystem::path writeSyntheticLevel(const std::filesystem::path& directory)
+{
+   std::filesystem::create_directories(directory);
+
+   std::mt19937 rng(1);
+
+   sf::Image tiles;
+   tiles.create(tileColumns * tileSize, tileColumns * tileSize);
+   for (auto y = 0u; y < tiles.getSize().y; y++)
+   {
+      for (auto x = 0u; x < tiles.getSize().x; x++)
+      {
+         tiles.setPixel(x, y, sf::Color(rng() & 0xff, rng() & 0xff, rng() & 0xff));
+      }
+   }
+   tiles.saveToFile((directory / "synthetic.png").string());
+
+   // every tile of the tileset is fully solid
+   std::ofstream physics(directory / "physics_tiles.csv");
+   physics << "0," << (tileColumns * tileColumns - 1) << ",1,1,1,1,1,1,1,1,1" << std::endl;
+
+   const auto path = directory / "synthetic.tmx";
+   std::ofstream tmx(path);
+
+   tmx << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>" << std::endl;
+   tmx << "<map version=\"1.2\" orientation=\"orthogonal\" width=\"" << syntheticWidth << "\" height=\"" << syntheticHeight
+       << "\" tilewidth=\"" << tileSize << "\" tileheight=\"" << tileSize << "\">" << std::endl;
+   tmx << " <tileset firstgid=\"1\" name=\"synthetic\" tilewidth=\"" << tileSize << "\" tileheight=\"" << tileSize
+       << "\" tilecount=\"" << tileColumns * tileColumns << "\" columns=\"" << tileColumns << "\">" << std::endl;
+   tmx << "  <image source=\"synthetic.png\" width=\"" << tileColumns * tileSize << "\" height=\"" << tileColumns * tileSize << "\"/>" << std::endl;
+   tmx << " </tileset>" << std::endl;
+
+   for (auto layer = 0; layer < syntheticLayers; layer++)
+   {
+      // the first layer is the collision layer, a cave like structure with roughly 40% solid tiles
+      const auto name = (layer == 0) ? std::string("level") : ("decoration_" + std::to_string(layer));
+      const auto fill = (layer == 0) ? 0.4f : 0.25f;
+
+      std::vector<int32_t> solid(syntheticWidth * syntheticHeight);
+      std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+      for (auto& value : solid)
+      {
+         value = distribution(rng) < fill ? 1 : 0;
+      }
+
+      // smooth the noise a few times so it forms connected areas
+      for (auto pass = 0; pass < 4; pass++)
+      {
+         auto next = solid;
+         for (auto y = 1; y < syntheticHeight - 1; y++)
+         {
+            for (auto x = 1; x < syntheticWidth - 1; x++)
+            {
+               auto neighbours = 0;
+               for (auto dy = -1; dy <= 1; dy++)
+               {
+                  for (auto dx = -1; dx <= 1; dx++)
+                  {
+                     neighbours += solid[(y + dy) * syntheticWidth + x + dx];
+                  }
+               }
+
+               next[y * syntheticWidth + x] = neighbours >= 5 ? 1 : 0;
+            }
+         }
+         solid.swap(next);
+      }
+
+      tmx << " <layer id=\"" << layer + 1 << "\" name=\"" << name << "\" width=\"" << syntheticWidth << "\" height=\"" << syntheticHeight << "\">" << std::endl;
+      tmx << "  <data encoding=\"csv\">" << std::endl;
+
+      for (auto y = 0; y < syntheticHeight; y++)
+      {
+         for (auto x = 0; x < syntheticWidth; x++)
+         {
+            const auto tile = solid[y * syntheticWidth + x] ? static_cast<int32_t>(1 + rng() % (tileColumns * tileColumns)) : 0;
+            tmx << tile;
+
+            if (x < syntheticWidth - 1 || y < syntheticHeight - 1)
+            {
+               tmx << ",";
+            }
+         }
+         tmx << std::endl;
+      }
+
+      tmx << "  </data>" << std::endl;
+      tmx << " </layer>" << std::endl;
+   }
+
+   tmx << "</map>" << std::endl;
+   return path;
+}
+
+
+void runLevelBenchmarks(Benchmark& benchmark, const std::string& fixture_name, LevelFixture& fixture)
+{
+   benchmark.run(
+      "TmxParser::parse",
+      fixture_name,
+      [&]()
+      {
+         TmxParser parser;
+         parser.parse(fixture.mTmx.string());
+         deleteElements(parser);
+      }
+   );
+
+   benchmark.run(
+      "TileMap::load",
+      fixture_name,
+      [&]()
+      {
+         for (const auto& [layer, tileset] : fixture.mLayers)
+         {
+            TileMap tile_map;
+            tile_map.load(layer, tileset, fixture.mBasePath);
+         }
+      }
+   );
+
+   std::vector<std::unique_ptr<TileMap>> tile_maps;
+   for (const auto& [layer, tileset] : fixture.mLayers)
+   {
+      auto tile_map = std::make_unique<TileMap>();
+      tile_map->load(layer, tileset, fixture.mBasePath);
+      tile_maps.push_back(std::move(tile_map));
+   }
+
+   benchmark.run(
+      "TileMap::update",
+      fixture_name,
+      [&]()
+      {
+         for (auto& tile_map : tile_maps)
+         {
+            tile_map->update(sf::milliseconds(16));
+         }
+      }
+   );
+
+   // drawVertices is private, it is measured through the public draw call
+   sf::RenderTexture color;
+   sf::RenderTexture normal;
+   if (color.create(640, 360) && normal.create(640, 360))
+   {
+      auto frame = 0u;
+      benchmark.run(
+         "TileMap::draw",
+         fixture_name,
+         [&]()
+         {
+            // pan across the level so different blocks are visited
+            sf::View view(sf::FloatRect(0.0f, 0.0f, 640.0f, 360.0f));
+            view.setCenter(static_cast<float>((frame++ * 37) % 4096), 400.0f);
+            color.setView(view);
+            normal.setView(view);
+
+            for (auto& tile_map : tile_maps)
+            {
+               tile_map->draw(color, normal, {});
+            }
+
+            color.display();
+            normal.display();
+         }
+      );
+   }
+
+   if (!fixture.mPhysicsLayer)
+   {
+      return;
+   }
+
+   benchmark.run(
+      "Physics::parse",
+      fixture_name,
+      [&]()
+      {
+         Physics physics;
+         physics.parse(fixture.mPhysicsLayer, fixture.mPhysicsTileSet, fixture.mBasePath);
+         doNotOptimize(physics.mPhysicsMap);
+      }
+   );
+
+   const auto obj_path = std::filesystem::temp_directory_path() / ("deceptus_benchmark_" + fixture_name + ".obj");
+   benchmark.run(
+      "Physics::dumpObj",
+      fixture_name,
+      [&]()
+      {
+         Physics physics;
+         physics.dumpObj(fixture.mPhysicsLayer, fixture.mPhysicsTileSet, obj_path);
+      }
+   );
+   std::filesystem::remove(obj_path);
+
+   // the cache file never exists so every run scans the whole grid
+   benchmark.run(
+      "SquareMarcher",
+      fixture_name,
+      [&]()
+      {
+         SquareMarcher marcher(
+            fixture.mPhysics.mGridWidth,
+            fixture.mPhysics.mGridHeight,
+            fixture.mPhysics.mPhysicsMap,
+            {1},
+            fixture.mBasePath / "missing" / "physics_path.csv",
+            1.0f / 3.0f
+         );
+         doNotOptimize(marcher.mPaths);
+      }
+   );
+
+   const auto& physics = fixture.mPhysics;
+   if (physics.mGridWidth > 0 && physics.mGridHeight > 0)
+   {
+      std::mt19937 rng(3);
+      std::vector<std::array<int32_t, 4>> lines;
+      for (auto i = 0; i < 256; i++)
+      {
+         const auto x = static_cast<int32_t>(rng() % physics.mGridWidth);
+         const auto y = static_cast<int32_t>(rng() % physics.mGridHeight);
+         lines.push_back({
+            x,
+            y,
+            std::clamp(x + static_cast<int32_t>(rng() % 97) - 48, 0, static_cast<int32_t>(physics.mGridWidth) - 1),
+            std::clamp(y + static_cast<int32_t>(rng() % 97) - 48, 0, static_cast<int32_t>(physics.mGridHeight) - 1)
+         });
+      }
+
+      benchmark.run(
+         "MapTools::lineCollide",
+         fixture_name,
+         [&]()
+         {
+            auto hits = 0;
+            for (const auto& line : lines)
+            {
+               hits += MapTools::lineCollide(
+                  line[0],
+                  line[1],
+                  line[2],
+                  line[3],
+                  [&physics](int32_t x, int32_t y){return physics.mPhysicsMap[y * physics.mGridWidth + x] == 1;}
+               );
+            }
+            doNotOptimize(hits);
+         }
+      );
+   }
+
+   sf::VertexArray quads(sf::Quads);
+   auto light_index = 0u;
+   benchmark.run(
+      "ShadowQuads::append",
+      fixture_name,
+      [&]()
+      {
+         quads.clear();
+         const auto& light = fixture.mLightPositions[light_index++ % fixture.mLightPositions.size()];
+         ShadowQuads::append(quads, fixture.mWorld.get(), nullptr, light, 100.0f);
+         doNotOptimize(quads);
+      }
+   );
+}
+
+
+void runSyntheticBenchmarks(Benchmark& benchmark)
+{
+   {
+      std::mt19937 rng(5);
+
+      Image image;
+      image.init(1024, 1024);
+      for (auto y = 0; y < 1024; y++)
+      {
+         auto row = image.getScanline(y);
+         for (auto x = 0; x < 1024; x++)
+         {
+            row[x] = rng();
+         }
+      }
+
+      benchmark.run(
+         "Image::buildNormalMap",
+         "synthetic",
+         [&]()
+         {
+            std::unique_ptr<uint32_t[]> normals(image.buildNormalMap(32));
+            doNotOptimize(normals);
+         }
+      );
+   }
+
+   {
+      std::mt19937 rng(6);
+      std::uniform_real_distribution<float> distribution(-200.0f, 200.0f);
+
+      std::vector<HermiteCurveKey> keys;
+      for (auto i = 0; i < 32; i++)
+      {
+         HermiteCurveKey key;
+         key.mTime = i / 31.0f;
+         key.mPosition = {distribution(rng), distribution(rng)};
+         keys.push_back(key);
+      }
+
+      HermiteCurve curve;
+      curve.setPositionKeys(keys);
+      curve.compute();
+
+      benchmark.run(
+         "HermiteCurve::computePoint",
+         "synthetic",
+         [&]()
+         {
+            sf::Vector2f sum;
+            for (auto i = 0; i < 1000; i++)
+            {
+               sum += curve.computePoint(i / 999.0f);
+            }
+            doNotOptimize(sum);
+         }
+      );
+
+      curve.bake(256);
+
+      benchmark.run(
+         "HermiteCurve::computePointAtDistance",
+         "synthetic",
+         [&]()
+         {
+            sf::Vector2f sum;
+            const auto length = curve.getLength();
+            for (auto i = 0; i < 1000; i++)
+            {
+               sum += curve.computePointAtDistance(length * i / 999.0f);
+            }
+            doNotOptimize(sum);
+         }
+      );
+   }
+
+   {
+      // 64 moving platforms with 8 keys each, one frame at a time
+      std::mt19937 rng(7);
+      std::uniform_real_distribution<float> distribution(-20.0f, 20.0f);
+
+      std::vector<PathInterpolation> paths(64);
+      PathBatch batch;
+      std::vector<PathBatch::Follower> followers;
+
+      for (auto& path : paths)
+      {
+         for (auto i = 0; i < 8; i++)
+         {
+            path.addKey({distribution(rng), distribution(rng)}, i / 7.0f);
+         }
+
+         path.bake();
+         followers.push_back(batch.addFollower(batch.addPath(path)));
+      }
+
+      auto distance = 0.0f;
+
+      benchmark.run(
+         "PathInterpolation::computePosition",
+         "synthetic",
+         [&]()
+         {
+            b2Vec2 sum = b2Vec2_zero;
+            distance += 0.05f;
+            for (const auto& path : paths)
+            {
+               sum += path.computePosition(distance);
+            }
+            doNotOptimize(sum);
+         }
+      );
+
+      benchmark.run(
+         "PathBatch::update",
+         "synthetic",
+         [&]()
+         {
+            for (auto follower : followers)
+            {
+               batch.setSpeed(follower, 3.0f);
+            }
+
+            batch.update(1.0f / 60.0f);
+            doNotOptimize(batch.getPosition(followers.back()));
+         }
+      );
+   }
+
+   for (auto wide : {false, true})
+   {
+      // box pyramids that never fall asleep so every step solves the full contact set
+      b2World world(b2Vec2{0.0f, 9.81f});
+      world.SetAllowSleeping(false);
+      world.SetWideContactSolver(wide);
+
+      b2BodyDef ground_def;
+      auto ground = world.CreateBody(&ground_def);
+      b2EdgeShape ground_shape;
+      ground_shape.Set({-200.0f, 0.0f}, {200.0f, 0.0f});
+      ground->CreateFixture(&ground_shape, 0.0f);
+
+      b2PolygonShape box;
+      box.SetAsBox(0.5f, 0.5f);
+
+      constexpr auto rows = 12;
+      for (auto pyramid = 0; pyramid < 4; pyramid++)
+      {
+         for (auto row = 0; row < rows; row++)
+         {
+            for (auto column = 0; column < rows - row; column++)
+            {
+               b2BodyDef body_def;
+               body_def.type = b2_dynamicBody;
+               body_def.position = {pyramid * 20.0f + column * 1.05f + row * 0.525f, -0.5f - row};
+               world.CreateBody(&body_def)->CreateFixture(&box, 1.0f);
+            }
+         }
+      }
+
+      benchmark.run(
+         wide ? "b2World::Step/wide" : "b2World::Step/scalar",
+         "synthetic",
+         [&world]()
+         {
+            world.Step(1.0f / 35.0f, 8, 3);
+         }
+      );
+   }
+
+   {
+      // timers are global, those added here stay for the rest of the run
+      for (auto i = 0; i < 1000; i++)
+      {
+         Timer::add(std::chrono::hours(1), [](){});
+      }
+
+      benchmark.run("Timer::update", "synthetic", [](){Timer::update();});
+   }
+}
+
+
+bool parseOptions(int argc, char** argv, Options& options)
+{
+   for (auto i = 1; i < argc; i++)
+   {
+      const std::string arg = argv[i];
+
+      if (i + 1 >= argc)
+      {
+         std::cerr << "missing value for " << arg << std::endl;
+         return false;
+      }
+
+      if (arg == "--filter")
+      {
+         options.mSettings.mFilter = argv[++i];
+      }
+      else if (arg == "--repetitions")
+      {
+         options.mSettings.mRepetitions = std::max(1, std::stoi(argv[++i]));
+      }
+      else if (arg == "--json")
+      {
+         options.mJsonFilename = argv[++i];
+      }
+      else if (arg == "--level")
+      {
+         options.mLevel = argv[++i];
+      }
+      else if (arg == "--psd")
+      {
+         options.mPsd = argv[++i];
+      }
+      else
+      {
+         std::cerr << "unknown option " << arg << std::endl;
+         return false;
+      }
+   }
+
+   return true;
+}
+
+}
+
+
+int main(int argc, char** argv)
+{
+   Options options;
+   if (!parseOptions(argc, argv, options))
+   {
+      return 1;
+   }
+
+   // texture loading and the tile map drawing need a gl context
+   sf::Context context;
+
+   Benchmark benchmark(options.mSettings);
+
+   {
+      LevelFixture synthetic;
+      if (synthetic.load(writeSyntheticLevel(std::filesystem::temp_directory_path() / "deceptus_benchmark")))
+      {
+         runLevelBenchmarks(benchmark, "synthetic", synthetic);
+      }
+   }
+
+   {
+      LevelFixture level;
+      if (level.load(options.mLevel))
+      {
+         runLevelBenchmarks(benchmark, "level", level);
+      }
+   }
+
+   if (std::filesystem::exists(options.mPsd))
+   {
+      benchmark.run(
+         "PSD::load",
+         "level",
+         [&]()
+         {
+            PSD psd;
+            psd.load(options.mPsd.string());
+         }
+      );
+   }
+
+   runSyntheticBenchmarks(benchmark);
+
+   if (!options.mJsonFilename.empty() && !benchmark.writeJson(options.mJsonFilename))
+   {
+      return 1;
+   }
+
+   return 0;
+}
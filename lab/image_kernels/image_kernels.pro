@@ -0,0 +1,14 @@
+TARGET = image_kernels
+TEMPLATE = app
+
+CONFIG += c++17
+CONFIG += console
+CONFIG -= qt
+
+INCLUDEPATH += ../../src
+
+SOURCES += \
+        main.cpp \
+        ../../src/framework/image/image.cpp \
+        ../../src/framework/image/imagekernels.cpp \
+        ../../src/framework/image/tga.cpp
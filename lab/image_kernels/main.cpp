@@ -0,0 +1,153 @@
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "framework/image/image.h"
+#include "framework/image/imagekernels.h"
+
+
+// runs every image operation with each instruction set the cpu supports,
+// verifies the results are bit-identical to the scalar code and prints the timings
+
+
+namespace {
+
+constexpr auto width = 1920;
+constexpr auto height = 1080;
+constexpr auto iterations = 20;
+
+
+Image createNoise(uint32_t seed)
+{
+   std::mt19937 rng(seed);
+
+   Image image;
+   image.init(width, height);
+
+   for (auto y = 0; y < height; y++)
+   {
+      auto row = image.getScanline(y);
+      for (auto x = 0; x < width; x++)
+      {
+         row[x] = rng();
+      }
+   }
+
+   return image;
+}
+
+
+Image copyOf(const Image& source)
+{
+   Image image;
+   image.init(source.getWidth(), source.getHeight());
+   image.copy(0, 0, source);
+   return image;
+}
+
+
+std::vector<uint32_t> toVector(const Image& image)
+{
+   return image.getData();
+}
+
+
+std::vector<uint32_t> toVector(std::unique_ptr<uint32_t[]> data, const Image& image)
+{
+   return std::vector<uint32_t>(data.get(), data.get() + image.getWidth() * image.getHeight());
+}
+
+
+struct Operation
+{
+   std::string mName;
+   std::function<std::vector<uint32_t>()> mFunction;
+};
+
+
+const char* name(ImageKernels::InstructionSet set)
+{
+   switch (set)
+   {
+      case ImageKernels::InstructionSet::Scalar:
+         return "scalar";
+      case ImageKernels::InstructionSet::SSE2:
+         return "sse2";
+      case ImageKernels::InstructionSet::AVX2:
+         return "avx2";
+   }
+
+   return "";
+}
+
+}
+
+
+int main(int argc, char** argv)
+{
+   if (argc > 1)
+   {
+      ImageKernels::setThreadCount(std::stoi(argv[1]));
+   }
+
+   const auto a = createNoise(1);
+   const auto b = createNoise(2);
+
+   const std::vector<Operation> operations = {
+      {"downsample", [&](){return toVector(a.downsample());}},
+      {"scaled", [&](){Image dst; dst.init(1280, 720); dst.scaled(a); return toVector(dst);}},
+      {"premultiplyAlpha", [&](){auto dst = copyOf(a); dst.premultiplyAlpha(); return toVector(dst);}},
+      {"minimum", [&](){auto dst = copyOf(a); dst.minimum(b); return toVector(dst);}},
+      {"buildNormalMap", [&](){auto src = copyOf(a); return toVector(std::unique_ptr<uint32_t[]>(src.buildNormalMap(32)), src);}},
+      {"buildDeltaMap", [&](){auto src = copyOf(a); return toVector(std::unique_ptr<uint32_t[]>(src.buildDeltaMap()), src);}},
+   };
+
+   std::vector<ImageKernels::InstructionSet> sets;
+   for (auto set : {ImageKernels::InstructionSet::Scalar, ImageKernels::InstructionSet::SSE2, ImageKernels::InstructionSet::AVX2})
+   {
+      if (set <= ImageKernels::detectInstructionSet())
+      {
+         sets.push_back(set);
+      }
+   }
+
+   std::cout << "threads: " << ImageKernels::getThreadCount() << std::endl;
+
+   auto ok = true;
+
+   for (const auto& operation : operations)
+   {
+      ImageKernels::setInstructionSet(ImageKernels::InstructionSet::Scalar);
+      const auto reference = operation.mFunction();
+
+      for (auto set : sets)
+      {
+         ImageKernels::setInstructionSet(set);
+
+         const auto result = operation.mFunction();
+         const auto identical = (result == reference);
+         ok &= identical;
+
+         const auto start = std::chrono::high_resolution_clock::now();
+         for (auto i = 0; i < iterations; i++)
+         {
+            operation.mFunction();
+         }
+         const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start);
+
+         std::cout
+            << std::setw(18) << std::left << operation.mName
+            << std::setw(8) << name(set)
+            << std::setw(10) << std::right << std::fixed << std::setprecision(3) << elapsed.count() / iterations << "ms"
+            << (identical ? "" : "  MISMATCH")
+            << std::endl;
+      }
+   }
+
+   return ok ? 0 : 1;
+}
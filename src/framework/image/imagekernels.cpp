@@ -0,0 +1,934 @@
+#include "imagekernels.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define IMAGEKERNELS_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define TARGET_AVX2
+#else
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+
+namespace
+{
+
+// scalar ---------------------------------------------------------------------
+
+// linear blend between c1 & c2
+uint32_t blend(uint32_t c1, uint32_t c2, unsigned char f)
+{
+   unsigned char a= (c1>>24&0xff) + (( (c2>>24&0xff) - (c1>>24&0xff) ) * f >> 8);
+   unsigned char r= (c1>>16&0xff) + (( (c2>>16&0xff) - (c1>>16&0xff) ) * f >> 8);
+   unsigned char g= (c1>>8 &0xff) + (( (c2>>8 &0xff) - (c1>>8 &0xff) ) * f >> 8);
+   unsigned char b= (c1    &0xff) + (( (c2    &0xff) - (c1    &0xff) ) * f >> 8);
+
+   return (a<<24)|(r<<16)|(g<<8)|b;
+}
+
+
+uint32_t calcNormal(int32_t z, uint32_t x0, uint32_t x1, uint32_t y0, uint32_t y1)
+{
+   // height= red + green + blue;
+   x0= (x0 >> 16 & 255) + (x0 >> 8 & 255) + (x0 & 255);
+   x1= (x1 >> 16 & 255) + (x1 >> 8 & 255) + (x1 & 255);
+   y0= (y0 >> 16 & 255) + (y0 >> 8 & 255) + (y0 & 255);
+   y1= (y1 >> 16 & 255) + (y1 >> 8 & 255) + (y1 & 255);
+
+   int32_t x= (x0-x1);
+   int32_t y= (y0-y1);
+
+   int32_t mag= x*x + y*y + z*z;
+   float t = static_cast<float>(128.0 / sqrt( (double)mag));
+   x = static_cast<int32_t>(128 + x * t); if (x < 0) x = 0; if (x > 255) x = 255;
+   y = static_cast<int32_t>(128 - y * t); if (y < 0) y = 0; if (y > 255) y = 255;
+   z = static_cast<int32_t>(128 + z * t); if (z < 0) z = 0; if (z > 255) z = 255;
+
+   return (255<<24) | (x<<16) | (y<<8) | z;
+}
+
+
+uint32_t calcDelta(uint32_t x0, uint32_t x1, uint32_t y0, uint32_t y1)
+{
+   constexpr uint32_t s = 2;
+
+   return
+        ((128 + (x0 & 0xff) * s - (x1 & 0xff) * s) << 16)
+      | ((128 + (y0 & 0xff) * s - (y1 & 0xff) * s) << 8);
+}
+
+
+void downsampleScalar(uint32_t* dst, const uint32_t* src1, const uint32_t* src2, int32_t from, int32_t to)
+{
+   src1 += from * 2;
+   src2 += from * 2;
+
+   for (int32_t x=from;x<to;x++)
+   {
+      uint32_t c1= *src1++;
+      uint32_t c2= *src1++;
+      uint32_t c3= *src2++;
+      uint32_t c4= *src2++;
+
+      int32_t a= ((c1>>24&0xff) + (c2>>24&0xff) + (c3>>24&0xff) + (c4>>24&0xff)) >> 2;
+      int32_t r= ((c1>>16&0xff) + (c2>>16&0xff) + (c3>>16&0xff) + (c4>>16&0xff)) >> 2;
+      int32_t g= ((c1>> 8&0xff) + (c2>> 8&0xff) + (c3>> 8&0xff) + (c4>> 8&0xff)) >> 2;
+      int32_t b= ((c1    &0xff) + (c2    &0xff) + (c3    &0xff) + (c4    &0xff)) >> 2;
+
+      dst[x]= (a<<24)+(r<<16)+(g<<8)+b;
+   }
+}
+
+
+void scaledScalar(
+   uint32_t* dst,
+   const uint32_t* src1,
+   const uint32_t* src2,
+   int32_t from,
+   int32_t to,
+   int32_t dx,
+   int32_t sy
+)
+{
+   int32_t ix= from * dx;
+   for (int32_t dstX=from; dstX<to; dstX++)
+   {
+      int32_t x= ix >> 16;
+      int32_t sx= ix >> 8 & 0xff;
+
+      uint32_t c1= src1[x];
+      uint32_t c2= src1[x+1];
+      uint32_t c3= src2[x];
+      uint32_t c4= src2[x+1];
+
+      c1= blend(c1, c2, sx);
+      c2= blend(c3, c4, sx);
+
+      dst[dstX]= blend(c1, c2, sy);
+
+      ix+=dx;
+   }
+}
+
+
+void premultiplyAlphaScalar(uint32_t* dst, int32_t from, int32_t to)
+{
+   for (int32_t x=from;x<to;x++)
+   {
+      uint32_t c1= dst[x];
+
+      unsigned char a= (c1>>24&0xff);
+      if (a != 255)
+      {
+         unsigned char r= (c1>>16&0xff);
+         unsigned char g= (c1>> 8&0xff);
+         unsigned char b= (c1    &0xff);
+
+         r= (r*a)>>8;
+         g= (g*a)>>8;
+         b= (b*a)>>8;
+
+         dst[x]= (a<<24)+(r<<16)+(g<<8)+b;
+      }
+   }
+}
+
+
+void minimumScalar(uint32_t* dst, const uint32_t* src, int32_t from, int32_t to)
+{
+   for (int32_t x=from; x<to; x++)
+   {
+      uint32_t c1= src[x];
+      uint32_t c2= dst[x];
+
+      unsigned char a1= (c1>>24&0xff);
+      unsigned char r1= (c1>>16&0xff);
+      unsigned char g1= (c1>> 8&0xff);
+      unsigned char b1= (c1    &0xff);
+
+      unsigned char a2= (c2>>24&0xff);
+      unsigned char r2= (c2>>16&0xff);
+      unsigned char g2= (c2>> 8&0xff);
+      unsigned char b2= (c2    &0xff);
+
+      if (a2<a1) a1= a2;
+      if (r2<r1) r1= r2;
+      if (g2<g1) g1= g2;
+      if (b2<b1) b1= b2;
+
+      dst[x]= (a1<<24)+(r1<<16)+(g1<<8)+b1;
+   }
+}
+
+
+void normalMapScalar(
+   uint32_t* dst,
+   const uint32_t* prev,
+   const uint32_t* cur,
+   const uint32_t* next,
+   int32_t from,
+   int32_t to,
+   int32_t z
+)
+{
+   for (int32_t x = from; x < to; x++)
+   {
+      dst[x] = calcNormal(z, cur[x - 1], cur[x + 1], prev[x], next[x]);
+   }
+}
+
+
+void deltaMapScalar(
+   uint32_t* dst,
+   const uint32_t* prev,
+   const uint32_t* cur,
+   const uint32_t* next,
+   int32_t from,
+   int32_t to
+)
+{
+   for (int32_t x = from; x < to; x++)
+   {
+      dst[x] = calcDelta(cur[x - 1], cur[x + 1], prev[x], next[x]);
+   }
+}
+
+
+// the simd kernels process as many pixels as they can and return the index of the first
+// pixel they didn't touch, the remainder is handled by the scalar kernels
+
+#ifdef IMAGEKERNELS_X86
+
+// sse2 -----------------------------------------------------------------------
+
+int32_t downsampleSSE2(uint32_t* dst, const uint32_t* src1, const uint32_t* src2, int32_t width)
+{
+   const auto zero = _mm_setzero_si128();
+
+   int32_t x = 0;
+   for (; x + 4 <= width; x += 4)
+   {
+      const auto a0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src1 + x * 2));
+      const auto a1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src1 + x * 2 + 4));
+      const auto b0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src2 + x * 2));
+      const auto b1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src2 + x * 2 + 4));
+
+      // vertical sums, two pixels per register
+      const auto v01 = _mm_add_epi16(_mm_unpacklo_epi8(a0, zero), _mm_unpacklo_epi8(b0, zero));
+      const auto v23 = _mm_add_epi16(_mm_unpackhi_epi8(a0, zero), _mm_unpackhi_epi8(b0, zero));
+      const auto v45 = _mm_add_epi16(_mm_unpacklo_epi8(a1, zero), _mm_unpacklo_epi8(b1, zero));
+      const auto v67 = _mm_add_epi16(_mm_unpackhi_epi8(a1, zero), _mm_unpackhi_epi8(b1, zero));
+
+      // horizontal sums
+      const auto s01 = _mm_add_epi16(_mm_unpacklo_epi64(v01, v23), _mm_unpackhi_epi64(v01, v23));
+      const auto s23 = _mm_add_epi16(_mm_unpacklo_epi64(v45, v67), _mm_unpackhi_epi64(v45, v67));
+
+      const auto result = _mm_packus_epi16(_mm_srli_epi16(s01, 2), _mm_srli_epi16(s23, 2));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), result);
+   }
+
+   return x;
+}
+
+
+__m128i blendSSE2(__m128i c1, __m128i c2, __m128i f01, __m128i f23)
+{
+   // the differences are allowed to wrap around, only the low byte of each channel is kept
+   const auto zero = _mm_setzero_si128();
+   const auto mask = _mm_set1_epi16(0x00ff);
+
+   const auto c1lo = _mm_unpacklo_epi8(c1, zero);
+   const auto c1hi = _mm_unpackhi_epi8(c1, zero);
+   const auto c2lo = _mm_unpacklo_epi8(c2, zero);
+   const auto c2hi = _mm_unpackhi_epi8(c2, zero);
+
+   const auto lo = _mm_and_si128(
+      _mm_add_epi16(c1lo, _mm_srli_epi16(_mm_mullo_epi16(_mm_sub_epi16(c2lo, c1lo), f01), 8)),
+      mask
+   );
+
+   const auto hi = _mm_and_si128(
+      _mm_add_epi16(c1hi, _mm_srli_epi16(_mm_mullo_epi16(_mm_sub_epi16(c2hi, c1hi), f23), 8)),
+      mask
+   );
+
+   return _mm_packus_epi16(lo, hi);
+}
+
+
+int32_t scaledSSE2(
+   uint32_t* dst,
+   const uint32_t* src1,
+   const uint32_t* src2,
+   int32_t to,
+   int32_t dx,
+   int32_t sy
+)
+{
+   const auto fy = _mm_set1_epi16(static_cast<int16_t>(sy));
+
+   int32_t ix = 0;
+   int32_t dstX = 0;
+   for (; dstX + 4 <= to; dstX += 4)
+   {
+      int32_t xs[4];
+      int16_t fs[4];
+      for (auto i = 0; i < 4; i++)
+      {
+         xs[i] = ix >> 16;
+         fs[i] = static_cast<int16_t>(ix >> 8 & 0xff);
+         ix += dx;
+      }
+
+      const auto c1 = _mm_set_epi32(
+         static_cast<int32_t>(src1[xs[3]]), static_cast<int32_t>(src1[xs[2]]),
+         static_cast<int32_t>(src1[xs[1]]), static_cast<int32_t>(src1[xs[0]])
+      );
+      const auto c2 = _mm_set_epi32(
+         static_cast<int32_t>(src1[xs[3] + 1]), static_cast<int32_t>(src1[xs[2] + 1]),
+         static_cast<int32_t>(src1[xs[1] + 1]), static_cast<int32_t>(src1[xs[0] + 1])
+      );
+      const auto c3 = _mm_set_epi32(
+         static_cast<int32_t>(src2[xs[3]]), static_cast<int32_t>(src2[xs[2]]),
+         static_cast<int32_t>(src2[xs[1]]), static_cast<int32_t>(src2[xs[0]])
+      );
+      const auto c4 = _mm_set_epi32(
+         static_cast<int32_t>(src2[xs[3] + 1]), static_cast<int32_t>(src2[xs[2] + 1]),
+         static_cast<int32_t>(src2[xs[1] + 1]), static_cast<int32_t>(src2[xs[0] + 1])
+      );
+
+      const auto f01 = _mm_set_epi16(fs[1], fs[1], fs[1], fs[1], fs[0], fs[0], fs[0], fs[0]);
+      const auto f23 = _mm_set_epi16(fs[3], fs[3], fs[3], fs[3], fs[2], fs[2], fs[2], fs[2]);
+
+      const auto top = blendSSE2(c1, c2, f01, f23);
+      const auto bottom = blendSSE2(c3, c4, f01, f23);
+
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + dstX), blendSSE2(top, bottom, fy, fy));
+   }
+
+   return dstX;
+}
+
+
+int32_t premultiplyAlphaSSE2(uint32_t* row, int32_t width)
+{
+   const auto zero = _mm_setzero_si128();
+   const auto alphaMask = _mm_set1_epi32(static_cast<int32_t>(0xff000000));
+
+   int32_t x = 0;
+   for (; x + 4 <= width; x += 4)
+   {
+      const auto c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + x));
+
+      auto lo = _mm_unpacklo_epi8(c, zero);
+      auto hi = _mm_unpackhi_epi8(c, zero);
+
+      // broadcast alpha across the channels of each pixel
+      const auto alo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(lo, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+      const auto ahi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(hi, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+
+      lo = _mm_srli_epi16(_mm_mullo_epi16(lo, alo), 8);
+      hi = _mm_srli_epi16(_mm_mullo_epi16(hi, ahi), 8);
+
+      // keep the original alpha, and leave opaque pixels untouched
+      auto premultiplied = _mm_packus_epi16(lo, hi);
+      premultiplied = _mm_or_si128(_mm_andnot_si128(alphaMask, premultiplied), _mm_and_si128(c, alphaMask));
+
+      const auto opaque = _mm_cmpeq_epi32(_mm_and_si128(c, alphaMask), alphaMask);
+      const auto result = _mm_or_si128(_mm_and_si128(opaque, c), _mm_andnot_si128(opaque, premultiplied));
+
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(row + x), result);
+   }
+
+   return x;
+}
+
+
+int32_t minimumSSE2(uint32_t* dst, const uint32_t* src, int32_t width)
+{
+   int32_t x = 0;
+   for (; x + 4 <= width; x += 4)
+   {
+      const auto a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x));
+      const auto b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + x));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), _mm_min_epu8(a, b));
+   }
+
+   return x;
+}
+
+
+__m128i heightSSE2(__m128i c)
+{
+   const auto mask = _mm_set1_epi32(0xff);
+
+   return _mm_add_epi32(
+      _mm_add_epi32(
+         _mm_and_si128(_mm_srli_epi32(c, 16), mask),
+         _mm_and_si128(_mm_srli_epi32(c, 8), mask)
+      ),
+      _mm_and_si128(c, mask)
+   );
+}
+
+
+__m128i clampSSE2(__m128i v)
+{
+   // saturating packs clamp to [0..255]
+   const auto zero = _mm_setzero_si128();
+   const auto bytes = _mm_packus_epi16(_mm_packs_epi32(v, v), zero);
+   return _mm_unpacklo_epi16(_mm_unpacklo_epi8(bytes, zero), zero);
+}
+
+
+__m128 normalScaleSSE2(__m128i x, __m128i y, double zz)
+{
+   // the scale is computed in double precision and then rounded to float, just like the scalar code
+   const auto x01 = _mm_cvtepi32_pd(x);
+   const auto x23 = _mm_cvtepi32_pd(_mm_shuffle_epi32(x, _MM_SHUFFLE(1, 0, 3, 2)));
+   const auto y01 = _mm_cvtepi32_pd(y);
+   const auto y23 = _mm_cvtepi32_pd(_mm_shuffle_epi32(y, _MM_SHUFFLE(1, 0, 3, 2)));
+   const auto z = _mm_set1_pd(zz);
+   const auto n = _mm_set1_pd(128.0);
+
+   const auto mag01 = _mm_add_pd(_mm_add_pd(_mm_mul_pd(x01, x01), _mm_mul_pd(y01, y01)), z);
+   const auto mag23 = _mm_add_pd(_mm_add_pd(_mm_mul_pd(x23, x23), _mm_mul_pd(y23, y23)), z);
+
+   const auto t01 = _mm_cvtpd_ps(_mm_div_pd(n, _mm_sqrt_pd(mag01)));
+   const auto t23 = _mm_cvtpd_ps(_mm_div_pd(n, _mm_sqrt_pd(mag23)));
+
+   return _mm_movelh_ps(t01, t23);
+}
+
+
+int32_t normalMapSSE2(
+   uint32_t* dst,
+   const uint32_t* prev,
+   const uint32_t* cur,
+   const uint32_t* next,
+   int32_t from,
+   int32_t to,
+   int32_t z
+)
+{
+   const auto zz = static_cast<double>(z * z);
+   const auto zf = _mm_set1_ps(static_cast<float>(z));
+   const auto n = _mm_set1_ps(128.0f);
+   const auto alpha = _mm_set1_epi32(static_cast<int32_t>(0xff000000));
+
+   int32_t x = from;
+   for (; x + 4 <= to; x += 4)
+   {
+      const auto x0 = heightSSE2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(cur + x - 1)));
+      const auto x1 = heightSSE2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(cur + x + 1)));
+      const auto y0 = heightSSE2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(prev + x)));
+      const auto y1 = heightSSE2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(next + x)));
+
+      const auto dx = _mm_sub_epi32(x0, x1);
+      const auto dy = _mm_sub_epi32(y0, y1);
+
+      const auto t = normalScaleSSE2(dx, dy, zz);
+
+      const auto nx = clampSSE2(_mm_cvttps_epi32(_mm_add_ps(n, _mm_mul_ps(_mm_cvtepi32_ps(dx), t))));
+      const auto ny = clampSSE2(_mm_cvttps_epi32(_mm_sub_ps(n, _mm_mul_ps(_mm_cvtepi32_ps(dy), t))));
+      const auto nz = clampSSE2(_mm_cvttps_epi32(_mm_add_ps(n, _mm_mul_ps(zf, t))));
+
+      const auto result = _mm_or_si128(
+         _mm_or_si128(alpha, _mm_slli_epi32(nx, 16)),
+         _mm_or_si128(_mm_slli_epi32(ny, 8), nz)
+      );
+
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), result);
+   }
+
+   return x;
+}
+
+
+int32_t deltaMapSSE2(
+   uint32_t* dst,
+   const uint32_t* prev,
+   const uint32_t* cur,
+   const uint32_t* next,
+   int32_t from,
+   int32_t to
+)
+{
+   const auto mask = _mm_set1_epi32(0xff);
+   const auto offset = _mm_set1_epi32(128);
+
+   int32_t x = from;
+   for (; x + 4 <= to; x += 4)
+   {
+      const auto x0 = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(cur + x - 1)), mask);
+      const auto x1 = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(cur + x + 1)), mask);
+      const auto y0 = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(prev + x)), mask);
+      const auto y1 = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(next + x)), mask);
+
+      const auto u = _mm_sub_epi32(_mm_add_epi32(offset, _mm_slli_epi32(x0, 1)), _mm_slli_epi32(x1, 1));
+      const auto v = _mm_sub_epi32(_mm_add_epi32(offset, _mm_slli_epi32(y0, 1)), _mm_slli_epi32(y1, 1));
+
+      _mm_storeu_si128(
+         reinterpret_cast<__m128i*>(dst + x),
+         _mm_or_si128(_mm_slli_epi32(u, 16), _mm_slli_epi32(v, 8))
+      );
+   }
+
+   return x;
+}
+
+
+// avx2 -----------------------------------------------------------------------
+
+TARGET_AVX2 int32_t downsampleAVX2(uint32_t* dst, const uint32_t* src1, const uint32_t* src2, int32_t width)
+{
+   const auto zero = _mm256_setzero_si256();
+
+   int32_t x = 0;
+   for (; x + 8 <= width; x += 8)
+   {
+      const auto a0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src1 + x * 2));
+      const auto a1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src1 + x * 2 + 8));
+      const auto b0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src2 + x * 2));
+      const auto b1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src2 + x * 2 + 8));
+
+      // same as the sse2 version, just within each 128 bit lane
+      const auto vlo0 = _mm256_add_epi16(_mm256_unpacklo_epi8(a0, zero), _mm256_unpacklo_epi8(b0, zero));
+      const auto vhi0 = _mm256_add_epi16(_mm256_unpackhi_epi8(a0, zero), _mm256_unpackhi_epi8(b0, zero));
+      const auto vlo1 = _mm256_add_epi16(_mm256_unpacklo_epi8(a1, zero), _mm256_unpacklo_epi8(b1, zero));
+      const auto vhi1 = _mm256_add_epi16(_mm256_unpackhi_epi8(a1, zero), _mm256_unpackhi_epi8(b1, zero));
+
+      const auto s0 = _mm256_add_epi16(_mm256_unpacklo_epi64(vlo0, vhi0), _mm256_unpackhi_epi64(vlo0, vhi0));
+      const auto s1 = _mm256_add_epi16(_mm256_unpacklo_epi64(vlo1, vhi1), _mm256_unpackhi_epi64(vlo1, vhi1));
+
+      // packing interleaves the lanes, restore the pixel order afterwards
+      const auto packed = _mm256_packus_epi16(_mm256_srli_epi16(s0, 2), _mm256_srli_epi16(s1, 2));
+      const auto result = _mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0));
+
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + x), result);
+   }
+
+   return x;
+}
+
+
+TARGET_AVX2 int32_t premultiplyAlphaAVX2(uint32_t* row, int32_t width)
+{
+   const auto zero = _mm256_setzero_si256();
+   const auto alphaMask = _mm256_set1_epi32(static_cast<int32_t>(0xff000000));
+
+   int32_t x = 0;
+   for (; x + 8 <= width; x += 8)
+   {
+      const auto c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + x));
+
+      auto lo = _mm256_unpacklo_epi8(c, zero);
+      auto hi = _mm256_unpackhi_epi8(c, zero);
+
+      const auto alo = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(lo, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+      const auto ahi = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(hi, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+
+      lo = _mm256_srli_epi16(_mm256_mullo_epi16(lo, alo), 8);
+      hi = _mm256_srli_epi16(_mm256_mullo_epi16(hi, ahi), 8);
+
+      auto premultiplied = _mm256_packus_epi16(lo, hi);
+      premultiplied = _mm256_or_si256(_mm256_andnot_si256(alphaMask, premultiplied), _mm256_and_si256(c, alphaMask));
+
+      const auto opaque = _mm256_cmpeq_epi32(_mm256_and_si256(c, alphaMask), alphaMask);
+      const auto result = _mm256_blendv_epi8(premultiplied, c, opaque);
+
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(row + x), result);
+   }
+
+   return x;
+}
+
+
+TARGET_AVX2 int32_t minimumAVX2(uint32_t* dst, const uint32_t* src, int32_t width)
+{
+   int32_t x = 0;
+   for (; x + 8 <= width; x += 8)
+   {
+      const auto a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + x));
+      const auto b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + x));
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + x), _mm256_min_epu8(a, b));
+   }
+
+   return x;
+}
+
+
+TARGET_AVX2 __m256i heightAVX2(__m256i c)
+{
+   const auto mask = _mm256_set1_epi32(0xff);
+
+   return _mm256_add_epi32(
+      _mm256_add_epi32(
+         _mm256_and_si256(_mm256_srli_epi32(c, 16), mask),
+         _mm256_and_si256(_mm256_srli_epi32(c, 8), mask)
+      ),
+      _mm256_and_si256(c, mask)
+   );
+}
+
+
+TARGET_AVX2 __m256i clampAVX2(__m256i v)
+{
+   return _mm256_min_epi32(_mm256_max_epi32(v, _mm256_setzero_si256()), _mm256_set1_epi32(255));
+}
+
+
+TARGET_AVX2 __m128 normalScaleAVX2(__m128i x, __m128i y, double zz)
+{
+   const auto xd = _mm256_cvtepi32_pd(x);
+   const auto yd = _mm256_cvtepi32_pd(y);
+
+   const auto mag = _mm256_add_pd(
+      _mm256_add_pd(_mm256_mul_pd(xd, xd), _mm256_mul_pd(yd, yd)),
+      _mm256_set1_pd(zz)
+   );
+
+   return _mm256_cvtpd_ps(_mm256_div_pd(_mm256_set1_pd(128.0), _mm256_sqrt_pd(mag)));
+}
+
+
+TARGET_AVX2 int32_t normalMapAVX2(
+   uint32_t* dst,
+   const uint32_t* prev,
+   const uint32_t* cur,
+   const uint32_t* next,
+   int32_t from,
+   int32_t to,
+   int32_t z
+)
+{
+   const auto zz = static_cast<double>(z * z);
+   const auto zf = _mm256_set1_ps(static_cast<float>(z));
+   const auto n = _mm256_set1_ps(128.0f);
+   const auto alpha = _mm256_set1_epi32(static_cast<int32_t>(0xff000000));
+
+   int32_t x = from;
+   for (; x + 8 <= to; x += 8)
+   {
+      const auto x0 = heightAVX2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(cur + x - 1)));
+      const auto x1 = heightAVX2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(cur + x + 1)));
+      const auto y0 = heightAVX2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(prev + x)));
+      const auto y1 = heightAVX2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(next + x)));
+
+      const auto dx = _mm256_sub_epi32(x0, x1);
+      const auto dy = _mm256_sub_epi32(y0, y1);
+
+      const auto tlo = normalScaleAVX2(_mm256_castsi256_si128(dx), _mm256_castsi256_si128(dy), zz);
+      const auto thi = normalScaleAVX2(_mm256_extracti128_si256(dx, 1), _mm256_extracti128_si256(dy, 1), zz);
+      const auto t = _mm256_insertf128_ps(_mm256_castps128_ps256(tlo), thi, 1);
+
+      const auto nx = clampAVX2(_mm256_cvttps_epi32(_mm256_add_ps(n, _mm256_mul_ps(_mm256_cvtepi32_ps(dx), t))));
+      const auto ny = clampAVX2(_mm256_cvttps_epi32(_mm256_sub_ps(n, _mm256_mul_ps(_mm256_cvtepi32_ps(dy), t))));
+      const auto nz = clampAVX2(_mm256_cvttps_epi32(_mm256_add_ps(n, _mm256_mul_ps(zf, t))));
+
+      const auto result = _mm256_or_si256(
+         _mm256_or_si256(alpha, _mm256_slli_epi32(nx, 16)),
+         _mm256_or_si256(_mm256_slli_epi32(ny, 8), nz)
+      );
+
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + x), result);
+   }
+
+   return x;
+}
+
+
+TARGET_AVX2 int32_t deltaMapAVX2(
+   uint32_t* dst,
+   const uint32_t* prev,
+   const uint32_t* cur,
+   const uint32_t* next,
+   int32_t from,
+   int32_t to
+)
+{
+   const auto mask = _mm256_set1_epi32(0xff);
+   const auto offset = _mm256_set1_epi32(128);
+
+   int32_t x = from;
+   for (; x + 8 <= to; x += 8)
+   {
+      const auto x0 = _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(cur + x - 1)), mask);
+      const auto x1 = _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(cur + x + 1)), mask);
+      const auto y0 = _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(prev + x)), mask);
+      const auto y1 = _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(next + x)), mask);
+
+      const auto u = _mm256_sub_epi32(_mm256_add_epi32(offset, _mm256_slli_epi32(x0, 1)), _mm256_slli_epi32(x1, 1));
+      const auto v = _mm256_sub_epi32(_mm256_add_epi32(offset, _mm256_slli_epi32(y0, 1)), _mm256_slli_epi32(y1, 1));
+
+      _mm256_storeu_si256(
+         reinterpret_cast<__m256i*>(dst + x),
+         _mm256_or_si256(_mm256_slli_epi32(u, 16), _mm256_slli_epi32(v, 8))
+      );
+   }
+
+   return x;
+}
+
+
+bool cpuSupportsAVX2()
+{
+#ifdef _MSC_VER
+   int32_t info[4] = {};
+   __cpuid(info, 1);
+
+   const auto osxsave = (info[2] & (1 << 27)) != 0;
+   const auto avx = (info[2] & (1 << 28)) != 0;
+
+   if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6)
+   {
+      return false;
+   }
+
+   __cpuidex(info, 7, 0);
+   return (info[1] & (1 << 5)) != 0;
+#else
+   return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif // IMAGEKERNELS_X86
+
+
+std::atomic<ImageKernels::InstructionSet> sInstructionSet{ImageKernels::detectInstructionSet()};
+std::atomic<int32_t> sThreadCount{1};
+
+}
+
+
+ImageKernels::InstructionSet ImageKernels::detectInstructionSet()
+{
+#ifdef IMAGEKERNELS_X86
+   if (cpuSupportsAVX2())
+   {
+      return InstructionSet::AVX2;
+   }
+
+   return InstructionSet::SSE2;
+#else
+   return InstructionSet::Scalar;
+#endif
+}
+
+
+ImageKernels::InstructionSet ImageKernels::getInstructionSet()
+{
+   return sInstructionSet;
+}
+
+
+void ImageKernels::setInstructionSet(InstructionSet set)
+{
+   sInstructionSet = std::min(set, detectInstructionSet());
+}
+
+
+void ImageKernels::setThreadCount(int32_t count)
+{
+   sThreadCount = std::max(count, 1);
+}
+
+
+int32_t ImageKernels::getThreadCount()
+{
+   return sThreadCount;
+}
+
+
+void ImageKernels::forEachRow(int32_t rows, const std::function<void(int32_t, int32_t)>& func)
+{
+   // don't bother spawning threads for small images
+   static constexpr int32_t minRowsPerThread = 32;
+
+   const auto threadCount = std::min(sThreadCount.load(), rows / minRowsPerThread);
+
+   if (threadCount <= 1)
+   {
+      func(0, rows);
+      return;
+   }
+
+   std::vector<std::thread> threads;
+   const auto rowsPerThread = (rows + threadCount - 1) / threadCount;
+
+   for (auto from = 0; from < rows; from += rowsPerThread)
+   {
+      threads.emplace_back(func, from, std::min(from + rowsPerThread, rows));
+   }
+
+   for (auto& thread : threads)
+   {
+      thread.join();
+   }
+}
+
+
+void ImageKernels::downsampleRow(uint32_t* dst, const uint32_t* src1, const uint32_t* src2, int32_t width)
+{
+   auto x = 0;
+
+#ifdef IMAGEKERNELS_X86
+   switch (getInstructionSet())
+   {
+      case InstructionSet::AVX2:
+         x = downsampleAVX2(dst, src1, src2, width);
+         break;
+      case InstructionSet::SSE2:
+         x = downsampleSSE2(dst, src1, src2, width);
+         break;
+      case InstructionSet::Scalar:
+         break;
+   }
+#endif
+
+   downsampleScalar(dst, src1, src2, x, width);
+}
+
+
+void ImageKernels::scaledRow(
+   uint32_t* dst,
+   const uint32_t* src1,
+   const uint32_t* src2,
+   int32_t width,
+   int32_t srcWidth,
+   int32_t dx,
+   int32_t sy
+)
+{
+   auto x = 0;
+
+#ifdef IMAGEKERNELS_X86
+   // the source pixels need to be gathered one by one, so avx2 doesn't buy anything here
+   if (getInstructionSet() != InstructionSet::Scalar)
+   {
+      x = scaledSSE2(dst, src1, src2, width - 1, dx, sy);
+   }
+#endif
+
+   scaledScalar(dst, src1, src2, x, width - 1, dx, sy);
+   dst[width - 1] = blend(src1[srcWidth - 1], src2[srcWidth - 1], static_cast<unsigned char>(sy));
+}
+
+
+void ImageKernels::premultiplyAlphaRow(uint32_t* row, int32_t width)
+{
+   auto x = 0;
+
+#ifdef IMAGEKERNELS_X86
+   switch (getInstructionSet())
+   {
+      case InstructionSet::AVX2:
+         x = premultiplyAlphaAVX2(row, width);
+         break;
+      case InstructionSet::SSE2:
+         x = premultiplyAlphaSSE2(row, width);
+         break;
+      case InstructionSet::Scalar:
+         break;
+   }
+#endif
+
+   premultiplyAlphaScalar(row, x, width);
+}
+
+
+void ImageKernels::minimumRow(uint32_t* dst, const uint32_t* src, int32_t width)
+{
+   auto x = 0;
+
+#ifdef IMAGEKERNELS_X86
+   switch (getInstructionSet())
+   {
+      case InstructionSet::AVX2:
+         x = minimumAVX2(dst, src, width);
+         break;
+      case InstructionSet::SSE2:
+         x = minimumSSE2(dst, src, width);
+         break;
+      case InstructionSet::Scalar:
+         break;
+   }
+#endif
+
+   minimumScalar(dst, src, x, width);
+}
+
+
+void ImageKernels::normalMapRow(
+   uint32_t* dst,
+   const uint32_t* prev,
+   const uint32_t* cur,
+   const uint32_t* next,
+   int32_t width,
+   int32_t z
+)
+{
+   // the horizontal neighbors wrap around at the image borders
+   dst[0] = calcNormal(z, cur[width - 1], cur[1], prev[0], next[0]);
+
+   auto x = 1;
+
+#ifdef IMAGEKERNELS_X86
+   switch (getInstructionSet())
+   {
+      case InstructionSet::AVX2:
+         x = normalMapAVX2(dst, prev, cur, next, 1, width - 1, z);
+         break;
+      case InstructionSet::SSE2:
+         x = normalMapSSE2(dst, prev, cur, next, 1, width - 1, z);
+         break;
+      case InstructionSet::Scalar:
+         break;
+   }
+#endif
+
+   normalMapScalar(dst, prev, cur, next, x, width - 1, z);
+
+   dst[width - 1] = calcNormal(z, cur[width - 2], cur[0], prev[width - 1], next[width - 1]);
+}
+
+
+void ImageKernels::deltaMapRow(
+   uint32_t* dst,
+   const uint32_t* prev,
+   const uint32_t* cur,
+   const uint32_t* next,
+   int32_t width
+)
+{
+   // the horizontal neighbors wrap around at the image borders
+   dst[0] = calcDelta(cur[width - 1], cur[1], prev[0], next[0]);
+
+   auto x = 1;
+
+#ifdef IMAGEKERNELS_X86
+   switch (getInstructionSet())
+   {
+      case InstructionSet::AVX2:
+         x = deltaMapAVX2(dst, prev, cur, next, 1, width - 1);
+         break;
+      case InstructionSet::SSE2:
+         x = deltaMapSSE2(dst, prev, cur, next, 1, width - 1);
+         break;
+      case InstructionSet::Scalar:
+         break;
+   }
+#endif
+
+   deltaMapScalar(dst, prev, cur, next, x, width - 1);
+
+   dst[width - 1] = calcDelta(cur[width - 2], cur[0], prev[width - 1], next[width - 1]);
+}
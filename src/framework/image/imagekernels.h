@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+// per-scanline kernels behind the Image operations
+//
+// every kernel comes in a scalar, an sse2 and an avx2 flavor. the fastest one supported by
+// the cpu is picked at runtime; all of them produce bit-identical results.
+namespace ImageKernels
+{
+   enum class InstructionSet
+   {
+      Scalar,
+      SSE2,
+      AVX2
+   };
+
+   InstructionSet detectInstructionSet();
+   InstructionSet getInstructionSet();
+
+   //! force a particular instruction set, the request is clamped to what the cpu supports
+   void setInstructionSet(InstructionSet set);
+
+   //! number of threads the rows of an image are distributed to, 1 disables threading
+   void setThreadCount(int32_t count);
+   int32_t getThreadCount();
+
+   //! call func(from, to) for row ranges [from, to) covering [0, rows)
+   void forEachRow(int32_t rows, const std::function<void(int32_t, int32_t)>& func);
+
+   void downsampleRow(uint32_t* dst, const uint32_t* src1, const uint32_t* src2, int32_t width);
+
+   void scaledRow(
+      uint32_t* dst,
+      const uint32_t* src1,
+      const uint32_t* src2,
+      int32_t width,
+      int32_t srcWidth,
+      int32_t dx,
+      int32_t sy
+   );
+
+   void premultiplyAlphaRow(uint32_t* row, int32_t width);
+
+   void minimumRow(uint32_t* dst, const uint32_t* src, int32_t width);
+
+   void normalMapRow(
+      uint32_t* dst,
+      const uint32_t* prev,
+      const uint32_t* cur,
+      const uint32_t* next,
+      int32_t width,
+      int32_t z
+   );
+
+   void deltaMapRow(
+      uint32_t* dst,
+      const uint32_t* prev,
+      const uint32_t* cur,
+      const uint32_t* next,
+      int32_t width
+   );
+}
+
@@ -0,0 +1,383 @@
+#include "psdatlas.h"
+
+#include "psd.h"
+#include "framework/tools/checksum.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+
+
+namespace
+{
+   constexpr uint32_t sMagic = 0x41445350; // 'PSDA'
+   constexpr uint32_t sVersion = 1;
+   constexpr int32_t sPadding = 1;
+
+   // smallest possible entry and page header in the cache, used to sanity check the counts
+   constexpr uint64_t sEntrySize = sizeof(uint32_t) + 7 * sizeof(int32_t) + sizeof(uint8_t);
+   constexpr uint64_t sPageHeaderSize = 2 * sizeof(int32_t);
+
+   // oversized layers get a page of their own, anything beyond this can't be a texture anyway
+   constexpr int32_t sMaxPageDimension = 16384;
+
+   template <typename T>
+   void write(std::ostream& stream, T value)
+   {
+      stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+   }
+
+   template <typename T>
+   T read(std::istream& stream)
+   {
+      T value{};
+      stream.read(reinterpret_cast<char*>(&value), sizeof(T));
+      return value;
+   }
+}
+
+
+bool PSDAtlas::load(const std::string& psdFilename)
+{
+   const auto cacheFilename = psdFilename + ".atlas";
+   const auto checksum = Checksum::calcChecksum(psdFilename);
+
+   if (readCache(cacheFilename, checksum))
+   {
+      return true;
+   }
+
+   PSD psd;
+   psd.setColorFormat(PSD::ColorFormat::ABGR);
+
+   if (!psd.load(psdFilename))
+   {
+      std::cerr << "[!] could not load psd: " << psdFilename << std::endl;
+      return false;
+   }
+
+   build(psd);
+   writeCache(cacheFilename, checksum);
+
+   return true;
+}
+
+
+const std::vector<PSDAtlas::Entry>& PSDAtlas::getEntries() const
+{
+   return mEntries;
+}
+
+
+const std::vector<PSDAtlas::Page>& PSDAtlas::getPages() const
+{
+   return mPages;
+}
+
+
+void PSDAtlas::build(const PSD& psd)
+{
+   mEntries.clear();
+   mPages.clear();
+
+   std::vector<const PSD::Layer*> layers;
+
+   for (const auto& layer : psd.getLayers())
+   {
+      // skip groups
+      if (layer.getSectionDivider() != PSD::Layer::SectionDivider::None)
+      {
+         continue;
+      }
+
+      Entry entry;
+      entry.mName = layer.getName();
+      entry.mLeft = layer.getLeft();
+      entry.mTop = layer.getTop();
+      entry.mWidth = layer.getWidth();
+      entry.mHeight = layer.getHeight();
+      entry.mOpacity = static_cast<uint8_t>(layer.getOpacity());
+
+      mEntries.push_back(entry);
+      layers.push_back(&layer);
+   }
+
+   // shelf packing works best when the tallest layers go first;
+   // the entries themselves stay in psd order since that's the draw order
+   std::vector<size_t> order(mEntries.size());
+   std::iota(order.begin(), order.end(), 0);
+   std::stable_sort(order.begin(), order.end(), [this](auto a, auto b){
+      return mEntries[a].mHeight > mEntries[b].mHeight;
+   });
+
+   struct Shelf
+   {
+      int32_t mX = 0;
+      int32_t mY = 0;
+      int32_t mHeight = 0;
+   };
+
+   Shelf shelf;
+   auto currentPage = -1;
+
+   auto addPage = [this](int32_t width, int32_t height) {
+      Page page;
+      page.mWidth = width;
+      page.mHeight = height;
+      mPages.push_back(page);
+      return static_cast<int32_t>(mPages.size() - 1);
+   };
+
+   for (auto index : order)
+   {
+      auto& entry = mEntries[index];
+
+      if (entry.mWidth <= 0 || entry.mHeight <= 0)
+      {
+         continue;
+      }
+
+      const auto width = entry.mWidth + sPadding;
+      const auto height = entry.mHeight + sPadding;
+
+      // layers that don't fit into a regular page get a page of their own
+      if (width > sPageSize || height > sPageSize)
+      {
+         entry.mPage = addPage(entry.mWidth, entry.mHeight);
+         continue;
+      }
+
+      if (currentPage == -1)
+      {
+         currentPage = addPage(0, 0);
+      }
+
+      // open a new shelf
+      if (shelf.mX + width > sPageSize)
+      {
+         shelf.mY += shelf.mHeight;
+         shelf.mX = 0;
+         shelf.mHeight = 0;
+      }
+
+      // open a new page
+      if (shelf.mY + height > sPageSize)
+      {
+         currentPage = addPage(0, 0);
+         shelf = {};
+      }
+
+      entry.mPage = currentPage;
+      entry.mAtlasX = shelf.mX;
+      entry.mAtlasY = shelf.mY;
+
+      shelf.mX += width;
+      shelf.mHeight = std::max(shelf.mHeight, height);
+
+      auto& page = mPages[static_cast<size_t>(currentPage)];
+      page.mWidth = std::max(page.mWidth, entry.mAtlasX + entry.mWidth);
+      page.mHeight = std::max(page.mHeight, entry.mAtlasY + entry.mHeight);
+   }
+
+   for (auto& page : mPages)
+   {
+      page.mData.resize(static_cast<size_t>(page.mWidth * page.mHeight), 0u);
+   }
+
+   for (auto i = 0u; i < mEntries.size(); i++)
+   {
+      const auto& entry = mEntries[i];
+
+      if (entry.mWidth <= 0 || entry.mHeight <= 0)
+      {
+         continue;
+      }
+
+      auto& page = mPages[static_cast<size_t>(entry.mPage)];
+      const auto& image = layers[i]->getImage();
+
+      for (auto y = 0; y < entry.mHeight; y++)
+      {
+         const auto src = image.getScanline(y);
+         auto dst = &page.mData[static_cast<size_t>((entry.mAtlasY + y) * page.mWidth + entry.mAtlasX)];
+         std::copy(src, src + entry.mWidth, dst);
+      }
+   }
+}
+
+
+bool PSDAtlas::readCache(const std::string& filename, uint32_t checksum)
+{
+   std::ifstream stream(filename, std::ios::binary | std::ios::ate);
+
+   if (!stream.is_open())
+   {
+      return false;
+   }
+
+   const auto fileSize = static_cast<uint64_t>(stream.tellg());
+   stream.seekg(0);
+
+   // counts and sizes come from the file, so none of them may size a container
+   // before it's clear the file actually holds that much data
+   const auto remaining = [&stream, fileSize]() -> uint64_t {
+      const auto position = stream.tellg();
+      return (position < 0) ? 0 : fileSize - static_cast<uint64_t>(position);
+   };
+
+   const auto corrupt = [&filename]() {
+      std::cerr << "[!] atlas cache is corrupt: " << filename << std::endl;
+      return false;
+   };
+
+   if (
+         read<uint32_t>(stream) != sMagic
+      || read<uint32_t>(stream) != sVersion
+      || read<uint32_t>(stream) != checksum
+   )
+   {
+      return false;
+   }
+
+   const auto entryCount = read<uint32_t>(stream);
+   if (!stream || entryCount > remaining() / sEntrySize)
+   {
+      return corrupt();
+   }
+
+   std::vector<Entry> entries(entryCount);
+   for (auto& entry : entries)
+   {
+      const auto nameLength = read<uint32_t>(stream);
+      if (!stream || nameLength > remaining())
+      {
+         return corrupt();
+      }
+
+      entry.mName.resize(nameLength);
+      stream.read(entry.mName.data(), static_cast<std::streamsize>(entry.mName.size()));
+      entry.mLeft = read<int32_t>(stream);
+      entry.mTop = read<int32_t>(stream);
+      entry.mWidth = read<int32_t>(stream);
+      entry.mHeight = read<int32_t>(stream);
+      entry.mPage = read<int32_t>(stream);
+      entry.mAtlasX = read<int32_t>(stream);
+      entry.mAtlasY = read<int32_t>(stream);
+      entry.mOpacity = read<uint8_t>(stream);
+   }
+
+   const auto pageCount = read<uint32_t>(stream);
+   if (!stream || pageCount > remaining() / sPageHeaderSize)
+   {
+      return corrupt();
+   }
+
+   std::vector<Page> pages(pageCount);
+   for (auto& page : pages)
+   {
+      page.mWidth = read<int32_t>(stream);
+      page.mHeight = read<int32_t>(stream);
+
+      if (
+            !stream
+         || page.mWidth <= 0
+         || page.mHeight <= 0
+         || page.mWidth > sMaxPageDimension
+         || page.mHeight > sMaxPageDimension
+      )
+      {
+         return corrupt();
+      }
+
+      const auto pixels = static_cast<uint64_t>(page.mWidth) * static_cast<uint64_t>(page.mHeight);
+      if (pixels * sizeof(uint32_t) > remaining())
+      {
+         return corrupt();
+      }
+
+      page.mData.resize(static_cast<size_t>(pixels));
+      stream.read(
+         reinterpret_cast<char*>(page.mData.data()),
+         static_cast<std::streamsize>(page.mData.size() * sizeof(uint32_t))
+      );
+   }
+
+   if (!stream)
+   {
+      return corrupt();
+   }
+
+   // every layer with pixels has to lie within its page, empty layers don't own one
+   for (const auto& entry : entries)
+   {
+      if (entry.mWidth <= 0 || entry.mHeight <= 0)
+      {
+         continue;
+      }
+
+      if (entry.mPage < 0 || static_cast<size_t>(entry.mPage) >= pages.size())
+      {
+         return corrupt();
+      }
+
+      const auto& page = pages[static_cast<size_t>(entry.mPage)];
+
+      if (
+            entry.mAtlasX < 0
+         || entry.mAtlasY < 0
+         || entry.mWidth > page.mWidth - entry.mAtlasX
+         || entry.mHeight > page.mHeight - entry.mAtlasY
+      )
+      {
+         return corrupt();
+      }
+   }
+
+   mEntries = std::move(entries);
+   mPages = std::move(pages);
+
+   return true;
+}
+
+
+void PSDAtlas::writeCache(const std::string& filename, uint32_t checksum) const
+{
+   std::ofstream stream(filename, std::ios::binary);
+
+   if (!stream.is_open())
+   {
+      std::cerr << "[!] could not write atlas cache: " << filename << std::endl;
+      return;
+   }
+
+   write(stream, sMagic);
+   write(stream, sVersion);
+   write(stream, checksum);
+
+   write(stream, static_cast<uint32_t>(mEntries.size()));
+   for (const auto& entry : mEntries)
+   {
+      write(stream, static_cast<uint32_t>(entry.mName.size()));
+      stream.write(entry.mName.data(), static_cast<std::streamsize>(entry.mName.size()));
+      write(stream, entry.mLeft);
+      write(stream, entry.mTop);
+      write(stream, entry.mWidth);
+      write(stream, entry.mHeight);
+      write(stream, entry.mPage);
+      write(stream, entry.mAtlasX);
+      write(stream, entry.mAtlasY);
+      write(stream, entry.mOpacity);
+   }
+
+   write(stream, static_cast<uint32_t>(mPages.size()));
+   for (const auto& page : mPages)
+   {
+      write(stream, page.mWidth);
+      write(stream, page.mHeight);
+      stream.write(
+         reinterpret_cast<const char*>(page.mData.data()),
+         static_cast<std::streamsize>(page.mData.size() * sizeof(uint32_t))
+      );
+   }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+class PSD;
+
+// packs all non-group layers of a psd into one or more texture pages.
+//
+// the packed result is cached next to the psd (<filename>.atlas) in a raw rgba
+// format that can be passed to the gpu as is. the cache is keyed by the psd's
+// checksum, so whenever the psd changes the atlas is rebuilt.
+class PSDAtlas
+{
+   public:
+
+      struct Entry
+      {
+         std::string mName;
+         int32_t mLeft = 0;
+         int32_t mTop = 0;
+         int32_t mWidth = 0;
+         int32_t mHeight = 0;
+         int32_t mPage = 0;
+         int32_t mAtlasX = 0;
+         int32_t mAtlasY = 0;
+         uint8_t mOpacity = 255;
+      };
+
+      struct Page
+      {
+         int32_t mWidth = 0;
+         int32_t mHeight = 0;
+         std::vector<uint32_t> mData;
+      };
+
+      PSDAtlas() = default;
+
+      bool load(const std::string& psdFilename);
+
+      const std::vector<Entry>& getEntries() const;
+      const std::vector<Page>& getPages() const;
+
+      static constexpr int32_t sPageSize = 2048;
+
+
+   private:
+
+      void build(const PSD& psd);
+      bool readCache(const std::string& filename, uint32_t checksum);
+      void writeCache(const std::string& filename, uint32_t checksum) const;
+
+      std::vector<Entry> mEntries;
+      std::vector<Page> mPages;
+};
+
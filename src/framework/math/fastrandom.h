@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+
+
+// xorshift64* generator
+//
+// much cheaper than std::rand() and std::mt19937, and every instance has its own state
+// so it can be used from several places without interfering. not suited for anything
+// that needs statistically strong random numbers.
+class FastRandom
+{
+   public:
+
+      explicit FastRandom(uint64_t seed = 0x9e3779b97f4a7c15ull)
+      {
+         setSeed(seed);
+      }
+
+      void setSeed(uint64_t seed)
+      {
+         // splitmix64 to spread the seed over all bits, the state must never be 0
+         seed += 0x9e3779b97f4a7c15ull;
+         seed = (seed ^ (seed >> 30)) * 0xbf58476d1ce4e5b9ull;
+         seed = (seed ^ (seed >> 27)) * 0x94d049bb133111ebull;
+         mState = (seed ^ (seed >> 31)) | 1ull;
+      }
+
+      uint32_t next()
+      {
+         mState ^= mState >> 12;
+         mState ^= mState << 25;
+         mState ^= mState >> 27;
+         return static_cast<uint32_t>((mState * 0x2545f4914f6cdd1dull) >> 32);
+      }
+
+      //! uniform float in [0..1)
+      float nextFloat()
+      {
+         return static_cast<float>(next() >> 8) * (1.0f / 16777216.0f);
+      }
+
+      //! uniform float in [min..max)
+      float range(float min, float max)
+      {
+         return min + (max - min) * nextFloat();
+      }
+
+
+   private:
+
+      uint64_t mState = 0;
+};
+
@@ -2,6 +2,7 @@
 #include "hermitecurve.h"
 
 // stl
+#include <algorithm>
 #include <cstdint>
 #include <math.h>
 
@@ -58,6 +59,8 @@ void HermiteCurve::compute()
 
    auto comp = [](std::vector<HermiteCurveKey>& source, std::vector<sf::Vector2f>& destination)
    {
+      destination.clear();
+
       if (source.empty())
       {
           return;
@@ -100,7 +103,7 @@ void HermiteCurve::compute()
 
 
 //-----------------------------------------------------------------------------
-sf::Vector2f HermiteCurve::computePoint(float time, Mode mode)
+sf::Vector2f HermiteCurve::computePoint(float time, Mode mode) const
 {
    if (clamp)
    {
@@ -130,19 +133,8 @@ sf::Vector2f HermiteCurve::computePoint(float time, Mode mode)
    }
 
    // init data to work on
-   std::vector<HermiteCurveKey> keys;
-   std::vector<sf::Vector2f> tangents;
-
-   if (mode == Mode::Position)
-   {
-      keys = mPositionKeys;
-      tangents = mPositionTangents;
-   }
-   else
-   {
-      keys = mOrientationKeys;
-      tangents = mOrientationTangents;
-   }
+   const auto& keys = (mode == Mode::Position) ? mPositionKeys : mOrientationKeys;
+   const auto& tangents = (mode == Mode::Position) ? mPositionTangents : mOrientationTangents;
 
    // init sf::Vector2fs
    sf::Vector2f p;
@@ -151,16 +143,12 @@ sf::Vector2f HermiteCurve::computePoint(float time, Mode mode)
    auto h3 = 0.0f;
    auto h4 = 0.0f;
 
-   // find index
-   auto index = 0;
-   for (; index < static_cast<int32_t>(keys.size()); index++)
-   {
-      if (keys[index].mTime > time)
-      {
-         index--;
-         break;
-      }
-   }
+   // find index, the last key at or before the given time
+   const auto next = std::upper_bound(keys.begin(), keys.end(), time, [](float t, const HermiteCurveKey& key){
+      return t < key.mTime;
+   });
+
+   auto index = (next == keys.end()) ? static_cast<int32_t>(keys.size()) : static_cast<int32_t>(next - keys.begin()) - 1;
 
    if (index < 0)
       index = 0;
@@ -211,4 +199,71 @@ sf::Vector2f HermiteCurve::computePoint(float time, Mode mode)
 }
 
 
+//-----------------------------------------------------------------------------
+void HermiteCurve::bake(int32_t sample_count)
+{
+   mSamples.clear();
+   mSampleDistances.clear();
+
+   if (mPositionKeys.empty() || sample_count < 1)
+   {
+      return;
+   }
+
+   mSamples.reserve(static_cast<size_t>(sample_count) + 1);
+   mSampleDistances.reserve(static_cast<size_t>(sample_count) + 1);
+
+   auto distance = 0.0f;
+
+   for (auto i = 0; i <= sample_count; i++)
+   {
+      const auto point = computePoint(i / static_cast<float>(sample_count));
+
+      if (!mSamples.empty())
+      {
+         const auto delta = point - mSamples.back();
+         distance += sqrt(delta.x * delta.x + delta.y * delta.y);
+      }
+
+      mSamples.push_back(point);
+      mSampleDistances.push_back(distance);
+   }
+}
+
+
+//-----------------------------------------------------------------------------
+float HermiteCurve::getLength() const
+{
+   return mSampleDistances.empty() ? 0.0f : mSampleDistances.back();
+}
+
+
+//-----------------------------------------------------------------------------
+sf::Vector2f HermiteCurve::computePointAtDistance(float distance) const
+{
+   if (mSamples.empty())
+   {
+      return {};
+   }
+
+   if (distance <= 0.0f)
+   {
+      return mSamples.front();
+   }
+
+   if (distance >= mSampleDistances.back())
+   {
+      return mSamples.back();
+   }
+
+   // first sample beyond the distance, the point lies on the chord before it
+   const auto it = std::upper_bound(mSampleDistances.begin(), mSampleDistances.end(), distance);
+   const auto index = static_cast<size_t>(it - mSampleDistances.begin());
+
+   const auto d0 = mSampleDistances[index - 1];
+   const auto d1 = mSampleDistances[index];
+   const auto s = (d1 > d0) ? (distance - d0) / (d1 - d0) : 0.0f;
+
+   return mSamples[index - 1] + (mSamples[index] - mSamples[index - 1]) * s;
+}
 
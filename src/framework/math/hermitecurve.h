@@ -19,7 +19,17 @@ class HermiteCurve
       HermiteCurve() = default;
       virtual ~HermiteCurve() = default;
       void compute();
-      sf::Vector2f computePoint(float time, Mode mode = Mode::Position);
+      sf::Vector2f computePoint(float time, Mode mode = Mode::Position) const;
+
+      //! tabulate the arc length of the position curve, call after compute
+      void bake(int32_t sample_count = 64);
+
+      //! length of the baked position curve
+      float getLength() const;
+
+      //! point at the given distance along the baked position curve, a distance growing
+      //! linearly moves along the curve at constant speed
+      sf::Vector2f computePointAtDistance(float distance) const;
 
       void setPositionKeys(const std::vector<HermiteCurveKey>&);
       void setOrientationKeys(const std::vector<HermiteCurveKey>&);
@@ -37,5 +47,9 @@ class HermiteCurve
       std::vector<HermiteCurveKey> mOrientationKeys;
       std::vector<sf::Vector2f> mPositionTangents;
       std::vector<sf::Vector2f> mOrientationTangents;
+
+      // baked samples of the position curve and their distance from the start
+      std::vector<sf::Vector2f> mSamples;
+      std::vector<float> mSampleDistances;
 };
 
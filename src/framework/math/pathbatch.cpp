@@ -0,0 +1,137 @@
+#include "pathbatch.h"
+
+#include "pathinterpolation.h"
+
+#include <cmath>
+
+
+void PathBatch::clear()
+{
+   mKeyX.clear();
+   mKeyY.clear();
+   mKeyDistance.clear();
+
+   mPathFirstKey.clear();
+   mPathKeyCount.clear();
+   mPathLength.clear();
+
+   mFollowerPath.clear();
+   mFollowerSegment.clear();
+   mFollowerDistance.clear();
+   mFollowerSpeed.clear();
+   mFollowerX.clear();
+   mFollowerY.clear();
+}
+
+
+int32_t PathBatch::addPath(const PathInterpolation& interpolation)
+{
+   const auto& track = interpolation.getTrack();
+   const auto& distances = interpolation.getArcLengths();
+
+   mPathFirstKey.push_back(static_cast<uint32_t>(mKeyX.size()));
+   mPathKeyCount.push_back(static_cast<uint32_t>(distances.size()));
+   mPathLength.push_back(interpolation.getLength());
+
+   for (auto i = 0u; i < distances.size(); i++)
+   {
+      const auto& pos = track[i % track.size()].mPos;
+      mKeyX.push_back(pos.x);
+      mKeyY.push_back(pos.y);
+      mKeyDistance.push_back(distances[i]);
+   }
+
+   return static_cast<int32_t>(mPathFirstKey.size() - 1);
+}
+
+
+PathBatch::Follower PathBatch::addFollower(int32_t path)
+{
+   const auto first = mPathFirstKey[static_cast<size_t>(path)];
+   const auto empty = mPathKeyCount[static_cast<size_t>(path)] == 0;
+
+   mFollowerPath.push_back(static_cast<uint32_t>(path));
+   mFollowerSegment.push_back(0);
+   mFollowerDistance.push_back(0.0f);
+   mFollowerSpeed.push_back(0.0f);
+   mFollowerX.push_back(empty ? 0.0f : mKeyX[first]);
+   mFollowerY.push_back(empty ? 0.0f : mKeyY[first]);
+
+   return static_cast<Follower>(mFollowerPath.size() - 1);
+}
+
+
+void PathBatch::setSpeed(Follower follower, float speed)
+{
+   mFollowerSpeed[static_cast<size_t>(follower)] = speed;
+}
+
+
+void PathBatch::update(float dt)
+{
+   const auto count = mFollowerPath.size();
+
+   for (auto i = 0u; i < count; i++)
+   {
+      const auto speed = mFollowerSpeed[i];
+      mFollowerSpeed[i] = 0.0f;
+
+      const auto path = mFollowerPath[i];
+      const auto length = mPathLength[path];
+
+      if (speed == 0.0f || length <= 0.0f)
+      {
+         continue;
+      }
+
+      auto distance = mFollowerDistance[i] + speed * dt;
+      auto segment = mFollowerSegment[i];
+
+      // wrapping around or moving backwards starts the segment walk from the first key
+      if (distance >= length || distance < 0.0f)
+      {
+         distance = std::fmod(distance, length);
+         if (distance < 0.0f)
+         {
+            distance += length;
+         }
+
+         segment = 0;
+      }
+      else if (speed < 0.0f)
+      {
+         segment = 0;
+      }
+
+      const auto first = mPathFirstKey[path];
+      const auto last = first + mPathKeyCount[path] - 1;
+
+      auto key = first + segment;
+      while (key + 1 < last && mKeyDistance[key + 1] <= distance)
+      {
+         key++;
+      }
+
+      const auto d0 = mKeyDistance[key];
+      const auto d1 = mKeyDistance[key + 1];
+      const auto s = (d1 > d0) ? (distance - d0) / (d1 - d0) : 0.0f;
+
+      mFollowerX[i] = mKeyX[key] + s * (mKeyX[key + 1] - mKeyX[key]);
+      mFollowerY[i] = mKeyY[key] + s * (mKeyY[key + 1] - mKeyY[key]);
+      mFollowerDistance[i] = distance;
+      mFollowerSegment[i] = key - first;
+   }
+}
+
+
+b2Vec2 PathBatch::getPosition(Follower follower) const
+{
+   return {mFollowerX[static_cast<size_t>(follower)], mFollowerY[static_cast<size_t>(follower)]};
+}
+
+
+size_t PathBatch::getFollowerCount() const
+{
+   return mFollowerPath.size();
+}
+
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <Box2D/Box2D.h>
+
+#include <cstdint>
+#include <vector>
+
+class PathInterpolation;
+
+
+// moves many followers along baked, closed paths at constant speed
+//
+// the keys of all paths are stored back to back in flat arrays and every follower is a
+// slot in a few more arrays, so updating all of them is a single pass over contiguous
+// memory. a follower remembers its segment, moving forward it only ever checks the next
+// key instead of searching the whole path.
+class PathBatch
+{
+
+public:
+
+   using Follower = int32_t;
+
+   void clear();
+
+   //! copy the track of a baked interpolation, returns the path index
+   int32_t addPath(const PathInterpolation& interpolation);
+
+   //! new follower at the start of a path
+   Follower addFollower(int32_t path);
+
+   //! distance per second for the next update, reset by every update so followers that
+   //! are not driven any longer stop where they are
+   void setSpeed(Follower follower, float speed);
+
+   void update(float dt);
+
+   b2Vec2 getPosition(Follower follower) const;
+   size_t getFollowerCount() const;
+
+
+private:
+
+   // keys of all paths, every path repeats its first key at the end
+   std::vector<float> mKeyX;
+   std::vector<float> mKeyY;
+   std::vector<float> mKeyDistance;
+
+   std::vector<uint32_t> mPathFirstKey;
+   std::vector<uint32_t> mPathKeyCount;
+   std::vector<float> mPathLength;
+
+   std::vector<uint32_t> mFollowerPath;
+   std::vector<uint32_t> mFollowerSegment;
+   std::vector<float> mFollowerDistance;
+   std::vector<float> mFollowerSpeed;
+   std::vector<float> mFollowerX;
+   std::vector<float> mFollowerY;
+};
+
@@ -1,5 +1,8 @@
 #include "pathinterpolation.h"
 
+#include <algorithm>
+#include <cmath>
+
 
 // const float checkRadius = 0.5f;
 
@@ -166,3 +169,70 @@ size_t PathInterpolation::nextKeyIndex()
 }
 
 
+void PathInterpolation::bake()
+{
+   mArcLengths.clear();
+
+   if (mTrack.empty())
+   {
+      return;
+   }
+
+   mArcLengths.reserve(mTrack.size() + 1);
+
+   auto distance = 0.0f;
+   mArcLengths.push_back(distance);
+
+   for (auto i = 1u; i <= mTrack.size(); i++)
+   {
+      distance += (mTrack[i % mTrack.size()].mPos - mTrack[i - 1].mPos).Length();
+      mArcLengths.push_back(distance);
+   }
+}
+
+
+float PathInterpolation::getLength() const
+{
+   return mArcLengths.empty() ? 0.0f : mArcLengths.back();
+}
+
+
+const std::vector<float>& PathInterpolation::getArcLengths() const
+{
+   return mArcLengths;
+}
+
+
+b2Vec2 PathInterpolation::computePosition(float distance) const
+{
+   if (mTrack.empty())
+   {
+      return b2Vec2_zero;
+   }
+
+   const auto length = getLength();
+   if (length <= 0.0f)
+   {
+      return mTrack[0].mPos;
+   }
+
+   distance = fmodf(distance, length);
+   if (distance < 0.0f)
+   {
+      distance += length;
+   }
+
+   // the segment starts at the last key not farther away than the distance
+   const auto it = std::upper_bound(mArcLengths.begin(), mArcLengths.end(), distance);
+   const auto index = std::min(static_cast<size_t>(it - mArcLengths.begin()), mTrack.size()) - 1;
+
+   const auto d0 = mArcLengths[index];
+   const auto d1 = mArcLengths[index + 1];
+   const auto s = (d1 > d0) ? (distance - d0) / (d1 - d0) : 0.0f;
+
+   const auto& a = mTrack[index].mPos;
+   const auto& b = mTrack[(index + 1) % mTrack.size()].mPos;
+
+   return a + s * (b - a);
+}
+
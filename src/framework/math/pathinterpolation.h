@@ -31,6 +31,19 @@ public:
 
    const std::vector<Key>& getTrack() const;
 
+   //! tabulate the distance of each key from the first one, the track is closed back to the
+   //! first key just like update walks it. call once after all keys have been added.
+   void bake();
+
+   //! length of the closed track, 0 until baked
+   float getLength() const;
+
+   //! distance of each key from the first one plus the length of the closed track
+   const std::vector<float>& getArcLengths() const;
+
+   //! position at the given distance along the closed track, wraps around
+   b2Vec2 computePosition(float distance) const;
+
 
 private:
 
@@ -41,6 +54,7 @@ private:
 
    Mode mMode = Mode::Linear;
    std::vector<Key> mTrack;
+   std::vector<float> mArcLengths;
    float mTime = 0.0f;
    bool mUp = true;
 
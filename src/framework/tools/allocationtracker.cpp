@@ -0,0 +1,278 @@
+#include "allocationtracker.h"
+
+#include "profiler.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+
+// the operator new replacement is linked into development builds only, release builds use
+// the stock allocator unless the tracker is asked for with CONFIG += allocation_tracker
+#if !defined(RELEASE_BUILD) || defined(ALLOCATION_TRACKER)
+#define REPLACE_OPERATOR_NEW
+#endif
+
+
+namespace
+{
+std::atomic<uint64_t> allocations{0};
+std::atomic<uint64_t> deallocations{0};
+std::atomic<uint64_t> bytes{0};
+
+std::atomic<bool> enabled{false};
+
+constexpr size_t scopeSlotCount = 256;
+const char* const unscopedName = "(unscoped)";
+const char* const overflowName = "(other)";
+
+// open addressing keyed by the scope name pointer, slots are claimed once and never freed
+struct ScopeSlot
+{
+   std::atomic<const char*> mName{nullptr};
+   std::atomic<uint64_t> mAllocations{0};
+   std::atomic<uint64_t> mBytes{0};
+};
+
+std::array<ScopeSlot, scopeSlotCount> scopeSlots;
+ScopeSlot overflowSlot;
+
+// frame bookkeeping, main thread only
+struct ScopeFrame
+{
+   uint64_t mPreviousTotal = 0;
+   uint64_t mLastFrame = 0;
+   uint64_t mMaxFrame = 0;
+};
+
+std::array<ScopeFrame, scopeSlotCount> scopeFrames;
+ScopeFrame overflowFrame;
+
+AllocationTracker::FrameStatistics frameStatistics;
+AllocationTracker::Snapshot frameStart;
+
+
+ScopeSlot& findSlot(const char* name)
+{
+   auto index = (reinterpret_cast<uintptr_t>(name) >> 3) * 0x9e3779b97f4a7c15ull;
+
+   for (auto probe = 0u; probe < scopeSlotCount; probe++, index++)
+   {
+      auto& slot = scopeSlots[index % scopeSlotCount];
+
+      auto current = slot.mName.load(std::memory_order_acquire);
+      if (current == name)
+      {
+         return slot;
+      }
+
+      if (!current)
+      {
+         // another thread may claim the slot first, either for this name or for another one
+         if (slot.mName.compare_exchange_strong(current, name, std::memory_order_acq_rel) || current == name)
+         {
+            return slot;
+         }
+      }
+   }
+
+   return overflowSlot;
+}
+
+
+#ifdef REPLACE_OPERATOR_NEW
+void attribute(std::size_t size)
+{
+#ifdef RELEASE_BUILD
+   (void)size;
+#else
+   auto name = Profiler::getCurrentScope();
+   auto& slot = findSlot(name ? name : unscopedName);
+   slot.mAllocations.fetch_add(1, std::memory_order_relaxed);
+   slot.mBytes.fetch_add(size, std::memory_order_relaxed);
+#endif
+}
+#endif
+
+
+void updateFrame(const ScopeSlot& slot, ScopeFrame& frame)
+{
+   const auto total = slot.mAllocations.load(std::memory_order_relaxed);
+   frame.mLastFrame = total - frame.mPreviousTotal;
+   frame.mMaxFrame = std::max(frame.mMaxFrame, frame.mLastFrame);
+   frame.mPreviousTotal = total;
+}
+
+
+void appendStatistics(
+   std::vector<AllocationTracker::ScopeStatistics>& statistics,
+   const char* name,
+   const ScopeSlot& slot,
+   const ScopeFrame& frame
+)
+{
+   const auto total = slot.mAllocations.load(std::memory_order_relaxed);
+   if (total == 0 && frame.mMaxFrame == 0)
+   {
+      return;
+   }
+
+   AllocationTracker::ScopeStatistics s;
+   s.mName = name;
+   s.mAllocations = total;
+   s.mBytes = slot.mBytes.load(std::memory_order_relaxed);
+   s.mLastFrame = frame.mLastFrame;
+   s.mMaxFrame = frame.mMaxFrame;
+   statistics.push_back(s);
+}
+}
+
+
+bool AllocationTracker::isAvailable()
+{
+#ifdef REPLACE_OPERATOR_NEW
+   return true;
+#else
+   return false;
+#endif
+}
+
+
+AllocationTracker::Snapshot AllocationTracker::getSnapshot()
+{
+   Snapshot snapshot;
+   snapshot.mAllocations = allocations.load(std::memory_order_relaxed);
+   snapshot.mDeallocations = deallocations.load(std::memory_order_relaxed);
+   snapshot.mBytes = bytes.load(std::memory_order_relaxed);
+   return snapshot;
+}
+
+
+void AllocationTracker::setEnabled(bool enable)
+{
+   enabled.store(enable, std::memory_order_relaxed);
+}
+
+
+bool AllocationTracker::isEnabled()
+{
+   return enabled.load(std::memory_order_relaxed);
+}
+
+
+void AllocationTracker::endFrame()
+{
+   const auto snapshot = getSnapshot();
+
+   if (frameStatistics.mFrames > 0)
+   {
+      const auto frameAllocations = snapshot.mAllocations - frameStart.mAllocations;
+
+      frameStatistics.mLastFrame = frameAllocations;
+      frameStatistics.mLastFrameBytes = snapshot.mBytes - frameStart.mBytes;
+      frameStatistics.mMaxFrame = std::max(frameStatistics.mMaxFrame, frameAllocations);
+      frameStatistics.mAllocatingFrames += (frameAllocations > 0) ? 1 : 0;
+   }
+
+   frameStatistics.mFrames++;
+   frameStart = snapshot;
+
+   for (auto i = 0u; i < scopeSlotCount; i++)
+   {
+      updateFrame(scopeSlots[i], scopeFrames[i]);
+   }
+
+   updateFrame(overflowSlot, overflowFrame);
+}
+
+
+std::vector<AllocationTracker::ScopeStatistics> AllocationTracker::getScopeStatistics()
+{
+   std::vector<ScopeStatistics> statistics;
+
+   for (auto i = 0u; i < scopeSlotCount; i++)
+   {
+      auto name = scopeSlots[i].mName.load(std::memory_order_acquire);
+      if (name)
+      {
+         appendStatistics(statistics, name, scopeSlots[i], scopeFrames[i]);
+      }
+   }
+
+   appendStatistics(statistics, overflowName, overflowSlot, overflowFrame);
+
+   std::sort(statistics.begin(), statistics.end(), [](const auto& a, const auto& b){return a.mName < b.mName;});
+
+   return statistics;
+}
+
+
+AllocationTracker::FrameStatistics AllocationTracker::getFrameStatistics()
+{
+   // the first frame only opens the measurement
+   auto statistics = frameStatistics;
+   statistics.mFrames = (statistics.mFrames > 0) ? (statistics.mFrames - 1) : 0;
+   return statistics;
+}
+
+
+void AllocationTracker::reset()
+{
+   // names stay claimed so concurrent lookups remain valid
+   for (auto& slot : scopeSlots)
+   {
+      slot.mAllocations.store(0, std::memory_order_relaxed);
+      slot.mBytes.store(0, std::memory_order_relaxed);
+   }
+
+   overflowSlot.mAllocations.store(0, std::memory_order_relaxed);
+   overflowSlot.mBytes.store(0, std::memory_order_relaxed);
+
+   scopeFrames.fill({});
+   overflowFrame = {};
+   frameStatistics = {};
+}
+
+
+#ifdef REPLACE_OPERATOR_NEW
+// the array and nothrow versions of the standard library forward to these two
+void* operator new(std::size_t size)
+{
+   allocations.fetch_add(1, std::memory_order_relaxed);
+   bytes.fetch_add(size, std::memory_order_relaxed);
+
+   if (enabled.load(std::memory_order_relaxed))
+   {
+      attribute(size);
+   }
+
+   auto ptr = std::malloc(size > 0 ? size : 1);
+   if (!ptr)
+   {
+      throw std::bad_alloc();
+   }
+
+   return ptr;
+}
+
+
+void operator delete(void* ptr) noexcept
+{
+   if (!ptr)
+   {
+      return;
+   }
+
+   deallocations.fetch_add(1, std::memory_order_relaxed);
+   std::free(ptr);
+}
+
+
+void operator delete(void* ptr, std::size_t /*size*/) noexcept
+{
+   operator delete(ptr);
+}
+#endif
+
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+// counts heap allocations made through the global operator new
+//
+// the counters are process wide and only ever grow, take the difference of two
+// snapshots to get the allocations of a piece of code.
+//
+// attribution is opt-in: once enabled every allocation is also charged to the innermost
+// profiler scope of the allocating thread (see PROFILE_SCOPE), so the scopes double as
+// subsystems. the scope table has a fixed size and is updated with atomics only, the hook
+// itself never allocates. endFrame turns the running totals into per-frame counts.
+// attribution needs the profiler and therefore compiles out along with it in release
+// builds. release builds don't replace operator new at all and all counters stay at zero,
+// build with CONFIG += allocation_tracker to get the global counters there as well.
+class AllocationTracker
+{
+public:
+
+   struct Snapshot
+   {
+      uint64_t mAllocations = 0;
+      uint64_t mDeallocations = 0;
+      uint64_t mBytes = 0;
+   };
+
+   struct ScopeStatistics
+   {
+      std::string mName;
+      uint64_t mAllocations = 0; // total since attribution was enabled
+      uint64_t mBytes = 0;
+      uint64_t mLastFrame = 0;   // allocations during the last completed frame
+      uint64_t mMaxFrame = 0;    // worst frame so far
+   };
+
+   struct FrameStatistics
+   {
+      uint64_t mFrames = 0;
+      uint64_t mLastFrame = 0;
+      uint64_t mLastFrameBytes = 0;
+      uint64_t mMaxFrame = 0;
+      uint64_t mAllocatingFrames = 0; // frames with at least one allocation
+   };
+
+   //! whether operator new is replaced, all counters stay at zero otherwise
+   static bool isAvailable();
+
+   static Snapshot getSnapshot();
+
+   //! enable or disable per-scope attribution
+   static void setEnabled(bool enabled);
+   static bool isEnabled();
+
+   //! close the current frame, to be called once per frame from the main thread
+   static void endFrame();
+
+   //! per-scope counts sorted by name, empty unless attribution is or was enabled
+   static std::vector<ScopeStatistics> getScopeStatistics();
+
+   static FrameStatistics getFrameStatistics();
+
+   //! clear per-scope and per-frame counts, the global counters are not affected
+   static void reset();
+};
+
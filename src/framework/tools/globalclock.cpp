@@ -22,17 +22,50 @@ GlobalClock *GlobalClock::getInstance()
 
 int GlobalClock::getElapsedTimeInMs()
 {
-   return mClock.getElapsedTime().asMilliseconds();
+   return getElapsedTime().asMilliseconds();
 }
 
 
 float GlobalClock::getElapsedTimeInS()
 {
-   return mClock.getElapsedTime().asMilliseconds() * 0.001f;
+   return getElapsedTime().asMilliseconds() * 0.001f;
 }
 
 
 sf::Time GlobalClock::getElapsedTime()
 {
-   return mClock.getElapsedTime();
+   if (mSimulated)
+   {
+      return mSimulatedTime;
+   }
+
+   return mClock.getElapsedTime() + mOffset;
+}
+
+
+void GlobalClock::setSimulated(bool simulated, const sf::Time& time)
+{
+   if (simulated)
+   {
+      mSimulatedTime = time;
+   }
+   else if (mSimulated)
+   {
+      // continue from the simulated time so the clock never runs backwards
+      mOffset = mSimulatedTime - mClock.getElapsedTime();
+   }
+
+   mSimulated = simulated;
+}
+
+
+bool GlobalClock::isSimulated() const
+{
+   return mSimulated;
+}
+
+
+void GlobalClock::advance(const sf::Time& dt)
+{
+   mSimulatedTime += dt;
 }
@@ -14,10 +14,18 @@ public:
    float getElapsedTimeInS();
    sf::Time getElapsedTime();
 
+   //! while simulated, the clock stands still unless it is moved on by advance(), used for replays
+   void setSimulated(bool simulated, const sf::Time& time = sf::Time::Zero);
+   bool isSimulated() const;
+   void advance(const sf::Time& dt);
+
 
 private:
 
    sf::Clock mClock;
+   sf::Time mOffset;
+   sf::Time mSimulatedTime;
+   bool mSimulated = false;
 
    static GlobalClock* sInstance;
 };
@@ -0,0 +1,260 @@
+#include "profiler.h"
+
+#ifndef RELEASE_BUILD
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+
+namespace
+{
+   constexpr auto maxDepth = 64;
+
+   thread_local std::array<const char*, maxDepth> sScopeStack;
+   thread_local int32_t sDepth = 0;
+
+   class SpinLock
+   {
+      public:
+
+         SpinLock(std::atomic_flag& flag) : mFlag(flag)
+         {
+            while (mFlag.test_and_set(std::memory_order_acquire))
+            {
+            }
+         }
+
+         ~SpinLock()
+         {
+            mFlag.clear(std::memory_order_release);
+         }
+
+      private:
+
+         std::atomic_flag& mFlag;
+   };
+}
+
+
+thread_local Profiler::ThreadBuffer* Profiler::sThreadBuffer = nullptr;
+
+
+Profiler::Profiler()
+ : mEpoch(std::chrono::steady_clock::now())
+{
+}
+
+
+Profiler& Profiler::getInstance()
+{
+   static Profiler sInstance;
+   return sInstance;
+}
+
+
+int64_t Profiler::now() const
+{
+   return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - mEpoch).count();
+}
+
+
+Profiler::ThreadBuffer& Profiler::getThreadBuffer()
+{
+   // every thread registers its buffer once, from then on recording is lock free
+   if (!sThreadBuffer)
+   {
+      auto buffer = std::make_unique<ThreadBuffer>();
+      buffer->mThreadId = mThreadCounter++;
+      sThreadBuffer = buffer.get();
+
+      SpinLock lock(mBuffersLock);
+      mBuffers.push_back(std::move(buffer));
+   }
+
+   return *sThreadBuffer;
+}
+
+
+void Profiler::push(const Sample& sample)
+{
+   auto& buffer = getThreadBuffer();
+
+   // single producer: only the owning thread writes, readers check the index to detect overwrites
+   const auto index = buffer.mWriteIndex.load(std::memory_order_relaxed);
+   buffer.mSamples[index % sRingSize] = sample;
+   buffer.mWriteIndex.store(index + 1, std::memory_order_release);
+}
+
+
+const char* Profiler::getCurrentScope()
+{
+   return (sDepth > 0 && sDepth <= maxDepth) ? sScopeStack[static_cast<size_t>(sDepth - 1)] : nullptr;
+}
+
+
+std::vector<Profiler::Sample> Profiler::copySamples(const ThreadBuffer& buffer, uint64_t from) const
+{
+   const auto to = buffer.mWriteIndex.load(std::memory_order_acquire);
+   from = std::max(from, (to > sRingSize) ? (to - sRingSize) : 0);
+
+   std::vector<Sample> samples;
+   samples.reserve(static_cast<size_t>(to - from));
+
+   for (auto i = from; i < to; i++)
+   {
+      samples.push_back(buffer.mSamples[i % sRingSize]);
+   }
+
+   // drop whatever the writer might have overwritten while copying
+   const auto after = buffer.mWriteIndex.load(std::memory_order_acquire);
+   if (after > sRingSize && after - sRingSize > from)
+   {
+      const auto overwritten = std::min<uint64_t>(after - sRingSize - from, samples.size());
+      samples.erase(samples.begin(), samples.begin() + static_cast<ptrdiff_t>(overwritten));
+   }
+
+   return samples;
+}
+
+
+void Profiler::endFrame()
+{
+   SpinLock lock(mBuffersLock);
+
+   for (auto& buffer : mBuffers)
+   {
+      const auto to = buffer->mWriteIndex.load(std::memory_order_acquire);
+      const auto from = std::max(buffer->mReadIndex, (to > sRingSize) ? (to - sRingSize) : 0);
+
+      for (auto i = from; i < to; i++)
+      {
+         const auto& sample = buffer->mSamples[i % sRingSize];
+
+         auto it = mHistoryLookup.find(sample.mName);
+         if (it == mHistoryLookup.end())
+         {
+            it = mHistoryLookup.emplace(sample.mName, &mHistories[sample.mName]).first;
+         }
+
+         it->second->mCurrent += static_cast<float>(sample.mEnd - sample.mStart) * 1e-6f;
+      }
+
+      buffer->mReadIndex = to;
+   }
+
+   for (auto& [name, history] : mHistories)
+   {
+      history.mValues[history.mIndex] = history.mCurrent;
+      history.mIndex = (history.mIndex + 1) % sHistorySize;
+      history.mCount = std::min(history.mCount + 1, sHistorySize);
+      history.mCurrent = 0.0f;
+   }
+}
+
+
+std::vector<std::pair<std::string, Profiler::Statistics>> Profiler::getStatistics() const
+{
+   std::vector<std::pair<std::string, Statistics>> statistics;
+
+   for (const auto& [name, history] : mHistories)
+   {
+      if (history.mCount == 0)
+      {
+         continue;
+      }
+
+      std::vector<float> values(history.mValues.begin(), history.mValues.begin() + static_cast<ptrdiff_t>(history.mCount));
+      std::sort(values.begin(), values.end());
+
+      auto percentile = [&values](float p) {
+         return values[std::min(values.size() - 1, static_cast<size_t>(p * static_cast<float>(values.size())))];
+      };
+
+      Statistics s;
+      s.mLast = history.mValues[(history.mIndex + sHistorySize - 1) % sHistorySize];
+      s.mP50 = percentile(0.5f);
+      s.mP90 = percentile(0.9f);
+      s.mP99 = percentile(0.99f);
+      s.mMax = values.back();
+
+      statistics.emplace_back(name, s);
+   }
+
+   return statistics;
+}
+
+
+bool Profiler::writeChromeTrace(const std::string& filename) const
+{
+   std::ofstream out(filename);
+   if (!out.is_open())
+   {
+      std::cerr << "[!] could not write trace: " << filename << std::endl;
+      return false;
+   }
+
+   out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+   auto first = true;
+
+   SpinLock lock(mBuffersLock);
+
+   for (const auto& buffer : mBuffers)
+   {
+      for (const auto& sample : copySamples(*buffer, 0))
+      {
+         if (!first)
+         {
+            out << ",\n";
+         }
+
+         first = false;
+
+         // complete events, timestamps are given in microseconds
+         out
+            << "{\"name\":\"" << sample.mName << "\""
+            << ",\"ph\":\"X\""
+            << ",\"pid\":0"
+            << ",\"tid\":" << buffer->mThreadId
+            << ",\"ts\":" << static_cast<double>(sample.mStart) * 0.001
+            << ",\"dur\":" << static_cast<double>(sample.mEnd - sample.mStart) * 0.001
+            << "}";
+      }
+   }
+
+   out << "\n]}\n";
+
+   return true;
+}
+
+
+Profiler::Scope::Scope(const char* name)
+ : mName(name),
+   mStart(Profiler::getInstance().now())
+{
+   if (sDepth < maxDepth)
+   {
+      sScopeStack[static_cast<size_t>(sDepth)] = name;
+   }
+
+   sDepth++;
+}
+
+
+Profiler::Scope::~Scope()
+{
+   auto& profiler = Profiler::getInstance();
+
+   sDepth--;
+
+   Sample sample;
+   sample.mName = mName;
+   sample.mStart = mStart;
+   sample.mEnd = profiler.now();
+   sample.mDepth = sDepth;
+
+   profiler.push(sample);
+}
+
+#endif
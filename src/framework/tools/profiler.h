@@ -0,0 +1,133 @@
+#pragma once
+
+// lightweight instrumentation for the game loop
+//
+// PROFILE_SCOPE("name") measures the enclosing scope. the samples are written to a ring
+// buffer owned by the calling thread, so recording needs neither locks nor allocations.
+// once per frame the main thread collects the new samples into per-scope histories
+// which are used for the profiler overlay and the chrome trace export
+// (chrome://tracing or https://ui.perfetto.dev).
+//
+// everything compiles out to nothing when RELEASE_BUILD is defined. scope names must be
+// string literals (or have static storage duration), only the pointer is stored.
+
+#ifdef RELEASE_BUILD
+
+#define PROFILE_SCOPE(name)
+#define PROFILE_FRAME()
+
+#else
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#define PROFILE_CONCAT_IMPL(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_IMPL(a, b)
+#define PROFILE_SCOPE(name) Profiler::Scope PROFILE_CONCAT(profileScope, __LINE__)(name)
+#define PROFILE_FRAME() Profiler::getInstance().endFrame()
+
+
+class Profiler
+{
+
+public:
+
+   struct Sample
+   {
+      const char* mName = nullptr;
+      int64_t mStart = 0; // ns since the profiler was created
+      int64_t mEnd = 0;
+      int32_t mDepth = 0;
+   };
+
+   struct Statistics
+   {
+      float mLast = 0.0f; // all values in ms
+      float mP50 = 0.0f;
+      float mP90 = 0.0f;
+      float mP99 = 0.0f;
+      float mMax = 0.0f;
+   };
+
+   class Scope
+   {
+      public:
+
+         Scope(const char* name);
+         ~Scope();
+
+         Scope(const Scope&) = delete;
+         Scope& operator=(const Scope&) = delete;
+
+      private:
+
+         const char* mName = nullptr;
+         int64_t mStart = 0;
+   };
+
+   static Profiler& getInstance();
+
+   //! collect the samples recorded since the last call, to be called once per frame from the main thread
+   void endFrame();
+
+   //! rolling statistics of the per-frame time spent in each scope, sorted by name
+   std::vector<std::pair<std::string, Statistics>> getStatistics() const;
+
+   //! write all samples still held in the ring buffers as chrome trace json
+   bool writeChromeTrace(const std::string& filename) const;
+
+   //! name of the innermost scope active on the calling thread, nullptr if there is none
+   static const char* getCurrentScope();
+
+   int64_t now() const;
+
+
+private:
+
+   static constexpr size_t sRingSize = 1 << 14;
+   static constexpr size_t sHistorySize = 240;
+
+   struct ThreadBuffer
+   {
+      std::array<Sample, sRingSize> mSamples;
+      std::atomic<uint64_t> mWriteIndex{0};
+      uint64_t mReadIndex = 0; // main thread only
+      int32_t mThreadId = 0;
+   };
+
+   struct History
+   {
+      std::array<float, sHistorySize> mValues{};
+      size_t mCount = 0;
+      size_t mIndex = 0;
+      float mCurrent = 0.0f; // accumulated during the current frame
+   };
+
+   Profiler();
+
+   ThreadBuffer& getThreadBuffer();
+   void push(const Sample& sample);
+   std::vector<Sample> copySamples(const ThreadBuffer& buffer, uint64_t from) const;
+
+   std::chrono::steady_clock::time_point mEpoch;
+
+   static thread_local ThreadBuffer* sThreadBuffer;
+
+   mutable std::atomic<int32_t> mThreadCounter{0};
+   std::vector<std::unique_ptr<ThreadBuffer>> mBuffers;
+   mutable std::atomic_flag mBuffersLock = ATOMIC_FLAG_INIT;
+
+   // histories are keyed by name, the pointer lookup avoids building strings every frame
+   std::map<std::string, History> mHistories;
+   std::map<const char*, History*> mHistoryLookup;
+
+   friend class Scope;
+};
+
+#endif
@@ -1,15 +1,33 @@
 #include "timer.h"
 
+#include "globalclock.h"
+#include "profiler.h"
+
 #include <algorithm>
 
 
+namespace
+{
+// timers follow the global clock so they are in sync with replays
+std::chrono::high_resolution_clock::time_point clockNow()
+{
+   const auto elapsed = std::chrono::microseconds(GlobalClock::getInstance()->getElapsedTime().asMicroseconds());
+   return std::chrono::high_resolution_clock::time_point(
+      std::chrono::duration_cast<std::chrono::high_resolution_clock::duration>(elapsed)
+   );
+}
+}
+
+
 std::vector<std::unique_ptr<Timer>> Timer::mTimers;
 std::mutex Timer::mMutex;
 
 
 void Timer::update()
 {
-   auto now = std::chrono::high_resolution_clock::now();
+   PROFILE_SCOPE("Timer::update");
+
+   auto now = clockNow();
 
    std::lock_guard<std::mutex> guard(mMutex);
 
@@ -64,7 +82,7 @@ void Timer::add(
    std::unique_ptr<Timer> timer = std::make_unique<Timer>();
    timer->mInterval = interval;
    timer->mType = type;
-   timer->mStartTime = std::chrono::high_resolution_clock::now();
+   timer->mStartTime = clockNow();
    timer->mCallback = callback;
    timer->mData = data;
 
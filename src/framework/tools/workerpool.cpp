@@ -0,0 +1,144 @@
+#include "workerpool.h"
+
+#include <algorithm>
+
+
+namespace
+{
+thread_local size_t threadIndex = 0;
+}
+
+
+WorkerPool& WorkerPool::getInstance()
+{
+   static WorkerPool pool;
+   return pool;
+}
+
+
+WorkerPool::WorkerPool()
+{
+   // leave one core to the main thread which joins every job anyway
+   const auto cores = std::max(std::thread::hardware_concurrency(), 1u);
+
+   for (auto i = 1u; i < cores; i++)
+   {
+      mThreads.emplace_back([this, i](){work(i);});
+   }
+}
+
+
+WorkerPool::~WorkerPool()
+{
+   {
+      std::lock_guard<std::mutex> lock(mMutex);
+      mStop = true;
+   }
+
+   mWakeCondition.notify_all();
+
+   for (auto& thread : mThreads)
+   {
+      thread.join();
+   }
+}
+
+
+size_t WorkerPool::getThreadCount() const
+{
+   return mThreads.size() + 1;
+}
+
+
+void WorkerPool::process()
+{
+   for (;;)
+   {
+      const auto index = mNextIndex.fetch_add(1, std::memory_order_relaxed);
+      if (index >= mCount)
+      {
+         break;
+      }
+
+      (*mJob)(index);
+   }
+}
+
+
+size_t WorkerPool::getThreadIndex()
+{
+   return threadIndex;
+}
+
+
+void WorkerPool::work(size_t index)
+{
+   threadIndex = index;
+
+   uint64_t generation = 0;
+
+   for (;;)
+   {
+      {
+         std::unique_lock<std::mutex> lock(mMutex);
+         mWakeCondition.wait(lock, [&](){return mStop || mGeneration != generation;});
+
+         if (mStop)
+         {
+            return;
+         }
+
+         generation = mGeneration;
+         mBusyWorkers++;
+      }
+
+      process();
+
+      {
+         std::lock_guard<std::mutex> lock(mMutex);
+         mBusyWorkers--;
+      }
+
+      mDoneCondition.notify_one();
+   }
+}
+
+
+void WorkerPool::parallelFor(size_t count, const std::function<void(size_t)>& job)
+{
+   // small jobs, single core machines and calls from inside a job run on the calling thread
+   auto expected = false;
+   if (count < 2 || mThreads.empty() || !mRunning.compare_exchange_strong(expected, true))
+   {
+      for (auto i = 0u; i < count; i++)
+      {
+         job(i);
+      }
+
+      return;
+   }
+
+   {
+      // a worker that woke up too late for the previous job may still be leaving it
+      std::unique_lock<std::mutex> lock(mMutex);
+      mDoneCondition.wait(lock, [this](){return mBusyWorkers == 0;});
+      mJob = &job;
+      mCount = count;
+      mNextIndex.store(0, std::memory_order_relaxed);
+      mGeneration++;
+   }
+
+   mWakeCondition.notify_all();
+
+   process();
+
+   // workers that wake up late find no indices left and leave right away
+   {
+      std::unique_lock<std::mutex> lock(mMutex);
+      mDoneCondition.wait(lock, [this](){return mBusyWorkers == 0;});
+      mJob = nullptr;
+      mCount = 0;
+   }
+
+   mRunning.store(false);
+}
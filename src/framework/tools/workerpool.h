@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+// persistent worker threads for data parallel jobs
+//
+// parallelFor hands out the indices of a job through an atomic counter, the calling thread
+// takes part and returns once every index has been processed. the workers sleep between
+// jobs so spinning up a job costs a wakeup rather than a thread creation.
+// only one job runs at a time, nested calls from inside a job are executed serially.
+class WorkerPool
+{
+
+public:
+
+   static WorkerPool& getInstance();
+
+   ~WorkerPool();
+
+   WorkerPool(const WorkerPool&) = delete;
+   WorkerPool& operator=(const WorkerPool&) = delete;
+
+   //! call job for every index in [0, count), blocks until all calls have returned
+   void parallelFor(size_t count, const std::function<void(size_t)>& job);
+
+   //! number of threads working on a job, including the caller
+   size_t getThreadCount() const;
+
+   //! index of the calling thread, 0 outside the pool and 1..n for the workers
+   static size_t getThreadIndex();
+
+
+private:
+
+   WorkerPool();
+
+   void work(size_t index);
+   void process();
+
+   std::vector<std::thread> mThreads;
+
+   std::mutex mMutex;
+   std::condition_variable mWakeCondition;
+   std::condition_variable mDoneCondition;
+   uint64_t mGeneration = 0;
+   size_t mBusyWorkers = 0;
+   bool mStop = false;
+
+   const std::function<void(size_t)>* mJob = nullptr;
+   size_t mCount = 0;
+   std::atomic<size_t> mNextIndex{0};
+   std::atomic<bool> mRunning{false};
+};
+
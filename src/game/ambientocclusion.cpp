@@ -5,18 +5,38 @@
 #include <fstream>
 #include <sstream>
 
-#include "framework/math/sfmlmath.h"
-#include "player/player.h"
+#include "constants.h"
 #include "texturepool.h"
 
 
+namespace
+{
+   // blocks are tile-aligned, the size is given in tiles
+   constexpr auto blockSize = 16;
+   constexpr auto blockSizePx = blockSize * PIXELS_PER_TILE;
+
+   // the ao sprites are slightly offset against the tiles they belong to
+   constexpr auto offsetX = -5;
+   constexpr auto offsetY = -6;
+
+   constexpr uint32_t binaryMagic = 0x4f414f41; // 'AOAO'
+   constexpr uint32_t binaryVersion = 1;
+
+   int32_t blockIndex(int32_t px)
+   {
+      return (px >= 0) ? (px / blockSizePx) : ((px - blockSizePx + 1) / blockSizePx);
+   }
+}
+
+
 void AmbientOcclusion::load(
   const std::filesystem::path& path,
   const std::string &aoBaseFilename
 )
 {
-  auto texture = (path / (aoBaseFilename + "_ao_tiles.png")).string();
-  auto uv = (path / (aoBaseFilename + "_ao_tiles.uv")).string();
+   auto texture = (path / (aoBaseFilename + "_ao_tiles.png")).string();
+   auto uv = (path / (aoBaseFilename + "_ao_tiles.uv"));
+   auto uvBinary = (path / (aoBaseFilename + "_ao_tiles.uv.bin"));
 
    if (!std::filesystem::exists(texture))
    {
@@ -26,65 +46,168 @@ void AmbientOcclusion::load(
 
    mTexture = TexturePool::getInstance().get(texture);
 
-   auto xi = 0;
-   auto yi = 0;
+   if (!std::filesystem::exists(uv))
+   {
+      std::cout << "AmbientOcclusion::load: unable to open uv file: " << uv.string() << std::endl;
+      return;
+   }
+
+   // the binary sidecar is regenerated whenever the uv file is newer
+   std::vector<Quad> quads;
+
+   const auto binaryValid =
+         std::filesystem::exists(uvBinary)
+      && std::filesystem::last_write_time(uvBinary) >= std::filesystem::last_write_time(uv);
+
+   if (!binaryValid || !loadQuadsBinary(uvBinary, quads))
+   {
+      parseQuads(uv, quads);
+      writeQuadsBinary(uvBinary, quads);
+   }
+
+   buildBlocks(quads);
+
+   std::cout << "[x] loaded " << quads.size() << " ao sprites into " << mBlocks.size() << " block rows" << std::endl;
+}
+
+
+void AmbientOcclusion::parseQuads(const std::filesystem::path& path, std::vector<Quad>& quads) const
+{
+   const auto textureWidth = static_cast<int32_t>(mTexture->getSize().x);
+
+   auto u = 0;
+   auto v = 0;
    auto i = 0;
-   auto x = 0;
-   auto y = 0;
-   auto w = 0;
-   auto h = 0;
 
    std::string line;
-   std::ifstream uvFile(uv);
-   if (uvFile.is_open())
+   std::ifstream uvFile(path);
+
+   while (std::getline(uvFile, line))
    {
-      while (uvFile.good())
+      Quad quad;
+
+      if (std::sscanf(line.c_str(), "%d;%d;%d;%d;%d", &i, &quad.mX, &quad.mY, &quad.mWidth, &quad.mHeight) != 5)
       {
-         std::getline(uvFile, line);
-         std::sscanf(line.c_str(), "%d;%d;%d;%d;%d", &i, &x, &y, &w, &h);
-
-         // std::cout << "x: " << x << " y: " << y << " w: " << w << " h: " << h << std::endl;
-
-         sf::Sprite sprite;
-         sprite.setPosition(static_cast<float>(x - 5), static_cast<float>(y - 6));
-         sprite.setTexture(*mTexture);
-         sprite.setTextureRect({xi, yi, w, h});
-         mSprites.push_back(sprite);
-
-         xi += w;
-         if (xi == static_cast<int32_t>(mTexture->getSize().x))
-         {
-            xi = 0;
-            yi += h;
-         }
+         continue;
       }
 
-      uvFile.close();
+      quad.mU = u;
+      quad.mV = v;
+      quads.push_back(quad);
 
-      std::cout << "[x] loaded " << mSprites.size() << " ao sprites" << std::endl;
+      u += quad.mWidth;
+      if (u == textureWidth)
+      {
+         u = 0;
+         v += quad.mHeight;
+      }
    }
-   else
+}
+
+
+bool AmbientOcclusion::loadQuadsBinary(const std::filesystem::path& path, std::vector<Quad>& quads) const
+{
+   std::ifstream file(path, std::ios::binary);
+
+   uint32_t magic = 0;
+   uint32_t version = 0;
+   uint32_t count = 0;
+
+   file.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+   file.read(reinterpret_cast<char*>(&version), sizeof(version));
+   file.read(reinterpret_cast<char*>(&count), sizeof(count));
+
+   if (!file || magic != binaryMagic || version != binaryVersion)
    {
-      std::cout << "AmbientOcclusion::load: unable to open uv file: " << uv << std::endl;
+      return false;
    }
+
+   quads.resize(count);
+   file.read(reinterpret_cast<char*>(quads.data()), static_cast<std::streamsize>(count * sizeof(Quad)));
+
+   if (!file)
+   {
+      quads.clear();
+      return false;
+   }
+
+   return true;
 }
 
 
-// optimize this!
-// just check if the sprite is outside the current screen
-// also group sprites to blocks of equal positions
+void AmbientOcclusion::writeQuadsBinary(const std::filesystem::path& path, const std::vector<Quad>& quads) const
+{
+   std::ofstream file(path, std::ios::binary);
 
-void AmbientOcclusion::draw(sf::RenderTarget& window)
+   if (!file.is_open())
+   {
+      return;
+   }
+
+   const auto count = static_cast<uint32_t>(quads.size());
+
+   file.write(reinterpret_cast<const char*>(&binaryMagic), sizeof(binaryMagic));
+   file.write(reinterpret_cast<const char*>(&binaryVersion), sizeof(binaryVersion));
+   file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+   file.write(reinterpret_cast<const char*>(quads.data()), static_cast<std::streamsize>(count * sizeof(Quad)));
+}
+
+
+void AmbientOcclusion::buildBlocks(const std::vector<Quad>& quads)
 {
-   const auto pos = Player::getCurrent()->getPixelPositionf();
+   mBlocks.clear();
+   mMaxQuadSize = {};
 
-   for (auto& sprite : mSprites)
+   for (const auto& quad : quads)
    {
-      auto diff = SfmlMath::lengthSquared(pos - sprite.getPosition());
+      const auto x = static_cast<float>(quad.mX + offsetX);
+      const auto y = static_cast<float>(quad.mY + offsetY);
+      const auto w = static_cast<float>(quad.mWidth);
+      const auto h = static_cast<float>(quad.mHeight);
+      const auto u = static_cast<float>(quad.mU);
+      const auto v = static_cast<float>(quad.mV);
+
+      auto& block = mBlocks[blockIndex(quad.mY + offsetY)][blockIndex(quad.mX + offsetX)];
+      block.setPrimitiveType(sf::Quads);
+      block.append(sf::Vertex({x,     y    }, {u,     v    }));
+      block.append(sf::Vertex({x + w, y    }, {u + w, v    }));
+      block.append(sf::Vertex({x + w, y + h}, {u + w, v + h}));
+      block.append(sf::Vertex({x,     y + h}, {u,     v + h}));
+
+      mMaxQuadSize.x = std::max(mMaxQuadSize.x, quad.mWidth);
+      mMaxQuadSize.y = std::max(mMaxQuadSize.y, quad.mHeight);
+   }
+}
 
-      if (diff > 300000)
-         continue;
 
-      window.draw(sprite, {sf::BlendAlpha});
+void AmbientOcclusion::draw(sf::RenderTarget& window)
+{
+   if (!mTexture)
+   {
+      return;
+   }
+
+   const auto& view = window.getView();
+   const auto topLeft = view.getCenter() - view.getSize() * 0.5f;
+   const auto bottomRight = view.getCenter() + view.getSize() * 0.5f;
+
+   // quads are stored in the block of their top left corner, so they may reach
+   // into the view from the blocks left of and above the visible area
+   const auto x0 = blockIndex(static_cast<int32_t>(topLeft.x) - mMaxQuadSize.x);
+   const auto y0 = blockIndex(static_cast<int32_t>(topLeft.y) - mMaxQuadSize.y);
+   const auto x1 = blockIndex(static_cast<int32_t>(bottomRight.x));
+   const auto y1 = blockIndex(static_cast<int32_t>(bottomRight.y));
+
+   sf::RenderStates states(sf::BlendAlpha);
+   states.texture = mTexture.get();
+
+   for (auto it_y = mBlocks.lower_bound(y0); it_y != mBlocks.end() && it_y->first <= y1; ++it_y)
+   {
+      const auto& row = it_y->second;
+
+      for (auto it_x = row.lower_bound(x0); it_x != row.end() && it_x->first <= x1; ++it_x)
+      {
+         window.draw(it_x->second, states);
+      }
    }
 }
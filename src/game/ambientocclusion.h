@@ -2,6 +2,7 @@
 
 #include <SFML/Graphics.hpp>
 #include <filesystem>
+#include <map>
 #include <memory>
 
 class AmbientOcclusion
@@ -19,8 +20,25 @@ public:
 
 private:
 
+   struct Quad
+   {
+      int32_t mX = 0;
+      int32_t mY = 0;
+      int32_t mWidth = 0;
+      int32_t mHeight = 0;
+      int32_t mU = 0;
+      int32_t mV = 0;
+   };
+
+   bool loadQuadsBinary(const std::filesystem::path& path, std::vector<Quad>& quads) const;
+   void writeQuadsBinary(const std::filesystem::path& path, const std::vector<Quad>& quads) const;
+   void parseQuads(const std::filesystem::path& path, std::vector<Quad>& quads) const;
+   void buildBlocks(const std::vector<Quad>& quads);
+
    std::shared_ptr<sf::Texture> mTexture;
-   std::vector<sf::Sprite> mSprites;
 
+   // ao quads baked into one vertex array per block, indexed by [y][x]
+   std::map<int32_t, std::map<int32_t, sf::VertexArray>> mBlocks;
+   sf::Vector2i mMaxQuadSize;
 };
 
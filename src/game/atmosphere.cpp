@@ -1,5 +1,7 @@
 #include "atmosphere.h"
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 
 #include "framework/tmxparser/tmxlayer.h"
@@ -57,3 +59,37 @@ void Atmosphere::parse(TmxLayer* layer, TmxTileSet* tileSet)
       }
    }
 }
+
+
+//-----------------------------------------------------------------------------
+bool Atmosphere::hasTilesInRect(const sf::FloatRect& rect_px) const
+{
+   if (mMap.empty())
+   {
+      return false;
+   }
+
+   // one tile of margin for partially covered tiles at the borders
+   const auto left   = static_cast<int32_t>(std::floor(rect_px.left / PIXELS_PER_TILE)) - mMapOffsetX - 1;
+   const auto top    = static_cast<int32_t>(std::floor(rect_px.top / PIXELS_PER_TILE)) - mMapOffsetY - 1;
+   const auto right  = static_cast<int32_t>(std::floor((rect_px.left + rect_px.width) / PIXELS_PER_TILE)) - mMapOffsetX + 1;
+   const auto bottom = static_cast<int32_t>(std::floor((rect_px.top + rect_px.height) / PIXELS_PER_TILE)) - mMapOffsetY + 1;
+
+   const auto x0 = std::max(left, 0);
+   const auto y0 = std::max(top, 0);
+   const auto x1 = std::min(right, static_cast<int32_t>(mMapWidth) - 1);
+   const auto y1 = std::min(bottom, static_cast<int32_t>(mMapHeight) - 1);
+
+   for (auto y = y0; y <= y1; y++)
+   {
+      for (auto x = x0; x <= x1; x++)
+      {
+         if (mMap[static_cast<size_t>(y) * mMapWidth + static_cast<size_t>(x)] != AtmosphereTileInvalid)
+         {
+            return true;
+         }
+      }
+   }
+
+   return false;
+}
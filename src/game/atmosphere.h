@@ -30,5 +30,8 @@ struct Atmosphere
    std::shared_ptr<TileMap> mTileMap;
 
    AtmosphereTile getTileForPosition(const b2Vec2& playerPos) const;
+
+   //! true if any atmosphere tile lies in the given pixel rectangle
+   bool hasTilesInRect(const sf::FloatRect& rect_px) const;
 };
 
@@ -2,6 +2,9 @@
 
 #include "gameconfiguration.h"
 
+#include "framework/math/sfmlmath.h"
+
+#include <algorithm>
 #include <string>
 #include <iostream>
 #include <filesystem>
@@ -12,6 +15,13 @@ Audio* Audio::sInstance = nullptr;
 namespace
 {
 static const auto SFX_ROOT = "data/sounds/";
+
+// samples larger than this are only decoded when they're played for the first time
+static constexpr std::uintmax_t LAZY_LOAD_THRESHOLD_BYTES = 256 * 1024;
+
+// distance attenuation, given in pixels
+static constexpr float ATTENUATION_DISTANCE_NEAR = 160.0f;
+static constexpr float ATTENUATION_DISTANCE_FAR = 640.0f;
 }
 
 //-----------------------------------------------------------------------------
@@ -22,6 +32,10 @@ static const auto SFX_ROOT = "data/sounds/";
 Audio::Audio()
 {
    sInstance = this;
+
+   const auto voiceCount = std::max(GameConfiguration::getInstance().mAudioVoiceCount, 1);
+   mVoices.resize(static_cast<size_t>(voiceCount));
+
    initializeMusicVolume();
    initializeSamples();
    initializeTracks();
@@ -45,18 +59,63 @@ Audio* Audio::getInstance()
 
 
 //-----------------------------------------------------------------------------
-void Audio::addSample(const std::string& sample)
+Audio::SampleHandle Audio::addSample(const std::string& sample)
 {
-   auto loader = [](const std::string& fileName) -> sf::SoundBuffer {
-      sf::SoundBuffer buf;
-      buf.loadFromFile(SFX_ROOT + fileName);
-      return buf;
-   };
+   const auto it = mSampleHandles.find(sample);
+   if (it != mSampleHandles.end())
+   {
+      return it->second;
+   }
+
+   const auto handle = static_cast<SampleHandle>(mSamples.size());
 
-   if (mSounds.find(sample) == mSounds.end())
+   // the buffers are kept on the heap since sounds refer to them by address
+   Sample entry;
+   entry.mFilename = SFX_ROOT + sample;
+
+   std::error_code error;
+   const auto size = std::filesystem::file_size(entry.mFilename, error);
+   if (!error && size <= LAZY_LOAD_THRESHOLD_BYTES)
    {
-      mSounds[sample] = loader(sample);
+      entry.mBuffer = std::make_unique<sf::SoundBuffer>();
+      entry.mBuffer->loadFromFile(entry.mFilename);
    }
+
+   mSamples.push_back(std::move(entry));
+   mSampleHandles[sample] = handle;
+
+   return handle;
+}
+
+
+//-----------------------------------------------------------------------------
+Audio::SampleHandle Audio::getSample(const std::string& sample) const
+{
+   const auto it = mSampleHandles.find(sample);
+   return (it != mSampleHandles.end()) ? it->second : InvalidSample;
+}
+
+
+//-----------------------------------------------------------------------------
+const sf::SoundBuffer* Audio::getBuffer(SampleHandle sample)
+{
+   if (sample < 0 || sample >= static_cast<SampleHandle>(mSamples.size()))
+   {
+      return nullptr;
+   }
+
+   auto& entry = mSamples[static_cast<size_t>(sample)];
+
+   if (!entry.mBuffer)
+   {
+      entry.mBuffer = std::make_unique<sf::SoundBuffer>();
+      if (!entry.mBuffer->loadFromFile(entry.mFilename))
+      {
+         std::cerr << "[!] could not load sample: " << entry.mFilename << std::endl;
+      }
+   }
+
+   return entry.mBuffer.get();
 }
 
 
@@ -111,35 +170,114 @@ void Audio::initializeMusicVolume()
 
 
 //-----------------------------------------------------------------------------
-void Audio::playSample(const std::string& sample, float volume)
+Audio::Voice* Audio::findVoice(Priority priority)
 {
-   sf::Sound* sound = nullptr;
-   for (int i = 0; i < 10; i++)
+   Voice* candidate = nullptr;
+
+   for (auto& voice : mVoices)
    {
-      if (mThreads[i].getStatus() == sf::Sound::Stopped)
+      if (voice.mSound.getStatus() == sf::Sound::Stopped)
+      {
+         return &voice;
+      }
+
+      // all voices busy: pick the oldest one of the lowest priority
+      if (
+            !candidate
+         || voice.mPriority < candidate->mPriority
+         || (voice.mPriority == candidate->mPriority && voice.mStartIndex < candidate->mStartIndex)
+      )
       {
-         sound = &mThreads[i];
-         break;
+         candidate = &voice;
       }
    }
 
-   if (sound == nullptr)
+   // don't steal voices from more important samples
+   if (candidate && candidate->mPriority > priority)
+   {
+      return nullptr;
+   }
+
+   return candidate;
+}
+
+
+//-----------------------------------------------------------------------------
+float Audio::computeAttenuation(const PlayInfo& info) const
+{
+   if (!info.mPosition.has_value())
+   {
+      return 1.0f;
+   }
+
+   const auto distance = SfmlMath::length(info.mPosition.value() - mListenerPosition);
+
+   if (distance <= ATTENUATION_DISTANCE_NEAR)
+   {
+      return 1.0f;
+   }
+
+   if (distance >= ATTENUATION_DISTANCE_FAR)
+   {
+      return 0.0f;
+   }
+
+   return 1.0f - (distance - ATTENUATION_DISTANCE_NEAR) / (ATTENUATION_DISTANCE_FAR - ATTENUATION_DISTANCE_NEAR);
+}
+
+
+//-----------------------------------------------------------------------------
+void Audio::playSample(SampleHandle sample, const PlayInfo& info)
+{
+   const auto attenuation = computeAttenuation(info);
+
+   // inaudible samples don't need a voice
+   if (attenuation <= 0.0f)
    {
       return;
    }
 
-   auto it = mSounds.find(sample);
+   auto voice = findVoice(info.mPriority);
 
-   if (it != mSounds.end())
+   if (voice == nullptr)
    {
-      sound->setBuffer(it->second);
+      return;
+   }
 
-      const auto master = (GameConfiguration::getInstance().mAudioVolumeMaster * 0.01f);
-      const auto sfx = (GameConfiguration::getInstance().mAudioVolumeSfx);
+   const auto buffer = getBuffer(sample);
 
-      sound->setVolume(master * sfx * volume);
-      sound->play();
+   if (buffer == nullptr)
+   {
+      return;
    }
+
+   voice->mSound.stop();
+   voice->mSound.setBuffer(*buffer);
+   voice->mSample = sample;
+   voice->mPriority = info.mPriority;
+   voice->mStartIndex = mVoiceStartCounter++;
+
+   const auto master = (GameConfiguration::getInstance().mAudioVolumeMaster * 0.01f);
+   const auto sfx = (GameConfiguration::getInstance().mAudioVolumeSfx);
+
+   voice->mSound.setVolume(master * sfx * info.mVolume * attenuation);
+   voice->mSound.play();
+}
+
+
+//-----------------------------------------------------------------------------
+void Audio::playSample(const std::string& sample, float volume)
+{
+   PlayInfo info;
+   info.mVolume = volume;
+   playSample(getSample(sample), info);
+}
+
+
+//-----------------------------------------------------------------------------
+void Audio::setListenerPosition(const sf::Vector2f& position)
+{
+   mListenerPosition = position;
 }
 
 
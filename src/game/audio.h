@@ -2,6 +2,9 @@
 
 #include <SFML/Audio.hpp>
 #include <map>
+#include <memory>
+#include <optional>
+#include <vector>
 
 class Audio
 {
@@ -12,26 +15,76 @@ public:
        std::string mFilename;
    };
 
+   //! samples are interned once and then addressed by their handle
+   using SampleHandle = int32_t;
+   static constexpr SampleHandle InvalidSample = -1;
+
+   //! when all voices are busy, a sample may only steal a voice of lower or equal priority
+   enum class Priority
+   {
+      Low,
+      Normal,
+      High,
+      Critical
+   };
+
+   struct PlayInfo
+   {
+      float mVolume = 30.0f;
+      Priority mPriority = Priority::Normal;
+
+      //! when set, the sample is attenuated by its distance to the listener (given in pixels)
+      std::optional<sf::Vector2f> mPosition;
+   };
+
    static Audio* getInstance();
 
    void initializeMusicVolume();
 
-   void addSample(const std::string& sample);
+   SampleHandle addSample(const std::string& sample);
+   SampleHandle getSample(const std::string& sample) const;
+
+   void playSample(SampleHandle sample, const PlayInfo& info);
    void playSample(const std::string& name, float volume = 30.0f);
    void updateMusic();
 
+   void setListenerPosition(const sf::Vector2f& position);
+
    sf::Music& getMusic() const;
 
 
 private:
 
+   struct Sample
+   {
+      std::string mFilename;
+      std::unique_ptr<sf::SoundBuffer> mBuffer;
+   };
+
+   struct Voice
+   {
+      sf::Sound mSound;
+      SampleHandle mSample = InvalidSample;
+      Priority mPriority = Priority::Low;
+      uint64_t mStartIndex = 0;
+   };
+
    Audio();
 
    void initializeSamples();
    void initializeTracks();
 
-   std::map<std::string, sf::SoundBuffer> mSounds;
-   sf::Sound mThreads[10];
+   const sf::SoundBuffer* getBuffer(SampleHandle sample);
+   Voice* findVoice(Priority priority);
+   float computeAttenuation(const PlayInfo& info) const;
+
+   std::vector<Sample> mSamples;
+   std::map<std::string, SampleHandle> mSampleHandles;
+
+   std::vector<Voice> mVoices;
+   uint64_t mVoiceStartCounter = 0;
+
+   sf::Vector2f mListenerPosition;
 
    mutable sf::Music mMusic;
    std::vector<Track> mTracks;
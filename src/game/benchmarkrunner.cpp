@@ -0,0 +1,483 @@
+#include "benchmarkrunner.h"
+
+#include "animationpool.h"
+#include "eventserializer.h"
+#include "framework/tools/allocationtracker.h"
+#include "framework/tools/globalclock.h"
+#include "framework/tools/profiler.h"
+#include "framework/tools/timer.h"
+#include "level.h"
+#include "levels.h"
+#include "player/player.h"
+#include "projectile.h"
+#include "savestate.h"
+
+#include "json/json.hpp"
+
+#include "Box2D/Box2D.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+
+namespace
+{
+using HighResClock = std::chrono::high_resolution_clock;
+
+constexpr uint32_t defaultTickCount = 600;
+
+const std::array<const char*, 4> phaseNames = {"animations", "level", "player", "tick"};
+
+
+int64_t elapsedNs(const HighResClock::time_point& start)
+{
+   return std::chrono::duration_cast<std::chrono::nanoseconds>(HighResClock::now() - start).count();
+}
+
+
+// fnv-1a over the raw bits, so the hash only matches if the values are bit-identical
+void hashValue(uint64_t& hash, float value)
+{
+   uint32_t bits = 0;
+   std::memcpy(&bits, &value, sizeof(bits));
+
+   for (auto i = 0; i < 4; i++)
+   {
+      hash ^= (bits >> (i * 8)) & 0xff;
+      hash *= 0x100000001b3ull;
+   }
+}
+
+
+void hashBody(uint64_t& hash, const b2Body* body)
+{
+   hashValue(hash, body->GetPosition().x);
+   hashValue(hash, body->GetPosition().y);
+   hashValue(hash, body->GetAngle());
+   hashValue(hash, body->GetLinearVelocity().x);
+   hashValue(hash, body->GetLinearVelocity().y);
+   hashValue(hash, body->GetAngularVelocity());
+}
+
+
+float percentile(std::vector<int64_t> values, float p)
+{
+   if (values.empty())
+   {
+      return 0.0f;
+   }
+
+   const auto index = static_cast<size_t>(p * static_cast<float>(values.size() - 1));
+   std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(index), values.end());
+   return values[index] * 0.000001f;
+}
+}
+
+
+bool BenchmarkRunner::parseArguments(int argc, char** argv, Settings& settings)
+{
+   auto benchmark = false;
+
+   for (auto i = 1; i < argc; i++)
+   {
+      const std::string arg = argv[i];
+      const auto hasValue = (i + 1 < argc);
+
+      if (arg == "--benchmark")
+      {
+         benchmark = true;
+      }
+      else if (arg == "--replay" && hasValue)
+      {
+         settings.mReplayFilename = argv[++i];
+      }
+      else if (arg == "--report" && hasValue)
+      {
+         settings.mReportFilename = argv[++i];
+      }
+      else if (arg == "--level" && hasValue)
+      {
+         settings.mLevelIndex = static_cast<uint32_t>(std::atoi(argv[++i]));
+      }
+      else if (arg == "--checkpoint" && hasValue)
+      {
+         settings.mCheckpoint = static_cast<uint32_t>(std::atoi(argv[++i]));
+      }
+      else if (arg == "--ticks" && hasValue)
+      {
+         settings.mTickCount = static_cast<uint32_t>(std::atoi(argv[++i]));
+      }
+      else if (arg == "--allocations")
+      {
+         settings.mTrackAllocations = true;
+      }
+      else if (arg == "--assert-no-allocations")
+      {
+         settings.mTrackAllocations = true;
+         settings.mAssertNoAllocations = true;
+      }
+   }
+
+   return benchmark;
+}
+
+
+bool BenchmarkRunner::load(const Settings& settings)
+{
+   auto& replay = EventSerializer::getInstance();
+
+   if (!settings.mReplayFilename.empty())
+   {
+      if (!replay.loadReplay(settings.mReplayFilename) || !replay.startPlayback())
+      {
+         return false;
+      }
+
+      SaveState::getCurrent().mLevelIndex = replay.getReplayHeader()._level_index;
+      SaveState::getCurrent().mCheckpoint = replay.getReplayHeader()._checkpoint;
+   }
+   else
+   {
+      SaveState::getCurrent().mLevelIndex = settings.mLevelIndex;
+      SaveState::getCurrent().mCheckpoint = settings.mCheckpoint;
+
+      // without a replay the run is still reproducible, it just has no input
+      std::srand(0);
+   }
+
+   auto levels = Levels::getInstance();
+   levels.deserializeFromFile();
+
+   if (SaveState::getCurrent().mLevelIndex >= levels.mLevels.size())
+   {
+      std::cerr << "[!] invalid level index " << SaveState::getCurrent().mLevelIndex << std::endl;
+      return false;
+   }
+
+   const auto start = HighResClock::now();
+
+   mPlayer = std::make_shared<Player>();
+   mPlayer->initialize();
+
+   // same as Game::loadLevel, minus the render textures
+   mLevel = std::make_shared<Level>();
+   mLevel->setDescriptionFilename(levels.mLevels.at(SaveState::getCurrent().mLevelIndex).mLevelName);
+   mLevel->initialize();
+
+   mPlayer->setWorld(mLevel->getWorld());
+   mPlayer->initializeLevel();
+   mPlayer->updatePlayerPixelRect();
+
+   mLoadDuration = elapsedNs(start);
+
+   replay.setCallback(
+      [this](const sf::Event& event)
+      {
+         if (event.type == sf::Event::KeyPressed)
+         {
+            mPlayer->getControls().keyboardKeyPressed(event.key.code);
+         }
+         else if (event.type == sf::Event::KeyReleased)
+         {
+            mPlayer->getControls().keyboardKeyReleased(event.key.code);
+         }
+      }
+   );
+
+   return true;
+}
+
+
+void BenchmarkRunner::tick(const sf::Time& dt)
+{
+   const auto measure = [this](Phase phase, const auto& function)
+   {
+      PROFILE_SCOPE(phaseNames[phase]);
+
+      const auto allocations = AllocationTracker::getSnapshot();
+      const auto start = HighResClock::now();
+
+      function();
+
+      const auto duration = elapsedNs(start);
+      const auto allocationsAfter = AllocationTracker::getSnapshot();
+
+      auto& data = mPhases[phase];
+      data.mDurations.push_back(duration);
+      data.mAllocations += allocationsAfter.mAllocations - allocations.mAllocations;
+      data.mBytes += allocationsAfter.mBytes - allocations.mBytes;
+   };
+
+   measure(
+      PhaseAnimations,
+      [dt]()
+      {
+         AnimationPool::getInstance().updateAnimations(dt);
+         Projectile::update(dt);
+      }
+   );
+
+   measure(PhaseLevel, [this, dt](){mLevel->update(dt);});
+   measure(PhasePlayer, [this, dt](){mPlayer->update(dt);});
+}
+
+
+int BenchmarkRunner::run(const Settings& settings)
+{
+   // without the operator new replacement every count is zero and the assertion would always pass
+   if (settings.mAssertNoAllocations && !AllocationTracker::isAvailable())
+   {
+      std::cerr << "[!] --assert-no-allocations needs allocation tracking, build with CONFIG += allocation_tracker" << std::endl;
+      return 1;
+   }
+
+   if (!load(settings))
+   {
+      return -1;
+   }
+
+   auto& replay = EventSerializer::getInstance();
+   const auto replaying = replay.isPlayingReplay();
+
+   const auto ticks = (settings.mTickCount > 0)
+      ? settings.mTickCount
+      : (replaying ? replay.getReplayHeader()._tick_count : defaultTickCount);
+
+   const auto dt = replay.getTickDuration();
+
+   if (!replaying)
+   {
+      GlobalClock::getInstance()->setSimulated(true);
+   }
+
+   std::cout << "[x] running " << ticks << " ticks" << std::endl;
+
+   AllocationTracker::reset();
+   AllocationTracker::setEnabled(settings.mTrackAllocations);
+
+   std::vector<AllocationTracker::ScopeStatistics> steadyStart;
+
+   for (auto& phase : mPhases)
+   {
+      phase.mDurations.reserve(ticks);
+   }
+
+   auto executed = 0u;
+   for (; executed < ticks; executed++)
+   {
+      // the replay stops itself once all of its ticks have been played
+      if (replaying && !replay.isPlayingReplay())
+      {
+         break;
+      }
+
+      if (executed == ticks / 2)
+      {
+         steadyStart = AllocationTracker::getScopeStatistics();
+      }
+
+      const auto allocations = AllocationTracker::getSnapshot();
+      const auto start = HighResClock::now();
+
+      replay.beginTick();
+      Timer::update();
+      tick(dt);
+      replay.endTick();
+
+      if (!replaying)
+      {
+         GlobalClock::getInstance()->advance(dt);
+      }
+
+      auto& data = mPhases[PhaseTick];
+      data.mDurations.push_back(elapsedNs(start));
+
+      const auto allocationsAfter = AllocationTracker::getSnapshot();
+      const auto tickAllocations = allocationsAfter.mAllocations - allocations.mAllocations;
+      data.mAllocations += tickAllocations;
+      data.mBytes += allocationsAfter.mBytes - allocations.mBytes;
+
+      if (executed >= ticks / 2)
+      {
+         mSteadyAllocations += tickAllocations;
+      }
+
+      AllocationTracker::endFrame();
+      PROFILE_FRAME();
+   }
+
+   AllocationTracker::setEnabled(false);
+
+   // scope counters only grow, the difference to the halfway point is the steady state
+   for (auto scope : AllocationTracker::getScopeStatistics())
+   {
+      const auto it = std::find_if(
+         steadyStart.begin(),
+         steadyStart.end(),
+         [&scope](const auto& s){return s.mName == scope.mName;}
+      );
+
+      if (it != steadyStart.end())
+      {
+         scope.mAllocations -= it->mAllocations;
+         scope.mBytes -= it->mBytes;
+      }
+
+      if (scope.mAllocations > 0)
+      {
+         mSteadyScopes.push_back(scope);
+      }
+   }
+
+   replay.stopReplay();
+   GlobalClock::getInstance()->setSimulated(false);
+
+   if (!writeReport(settings, executed))
+   {
+      return -1;
+   }
+
+   if (settings.mAssertNoAllocations && mSteadyAllocations > 0)
+   {
+      std::cerr << "[!] steady state allocated " << mSteadyAllocations << " times" << std::endl;
+
+      for (const auto& scope : mSteadyScopes)
+      {
+         std::cerr << "    " << scope.mName << ": " << scope.mAllocations << " (" << scope.mBytes << " bytes)" << std::endl;
+      }
+
+      return 1;
+   }
+
+   return 0;
+}
+
+
+uint64_t BenchmarkRunner::hashPlayer() const
+{
+   uint64_t hash = 0xcbf29ce484222325ull;
+
+   if (mPlayer->getBody())
+   {
+      hashBody(hash, mPlayer->getBody());
+   }
+
+   return hash;
+}
+
+
+uint64_t BenchmarkRunner::hashWorld() const
+{
+   uint64_t hash = 0xcbf29ce484222325ull;
+
+   for (auto body = mLevel->getWorld()->GetBodyList(); body; body = body->GetNext())
+   {
+      if (body->GetType() == b2_staticBody)
+      {
+         continue;
+      }
+
+      hashBody(hash, body);
+   }
+
+   return hash;
+}
+
+
+bool BenchmarkRunner::writeReport(const Settings& settings, uint32_t ticks) const
+{
+   nlohmann::json report;
+
+   report["level"] = SaveState::getCurrent().mLevelIndex;
+   report["checkpoint"] = SaveState::getCurrent().mCheckpoint;
+   report["replay"] = settings.mReplayFilename;
+   report["ticks"] = ticks;
+   report["load_ms"] = mLoadDuration * 0.000001f;
+
+   for (auto i = 0u; i < mPhases.size(); i++)
+   {
+      const auto& data = mPhases[i];
+
+      int64_t total = 0;
+      for (auto duration : data.mDurations)
+      {
+         total += duration;
+      }
+
+      nlohmann::json phase;
+      phase["total_ms"] = total * 0.000001f;
+      phase["mean_ms"] = data.mDurations.empty() ? 0.0f : (total * 0.000001f) / data.mDurations.size();
+      phase["p50_ms"] = percentile(data.mDurations, 0.5f);
+      phase["p90_ms"] = percentile(data.mDurations, 0.9f);
+      phase["p99_ms"] = percentile(data.mDurations, 0.99f);
+      phase["max_ms"] = percentile(data.mDurations, 1.0f);
+      phase["allocations"] = data.mAllocations;
+      phase["allocated_bytes"] = data.mBytes;
+
+      report["phases"][phaseNames[i]] = phase;
+   }
+
+   report["allocations_tracked"] = AllocationTracker::isAvailable();
+   report["steady_state_allocations"] = mSteadyAllocations;
+
+   const auto frames = AllocationTracker::getFrameStatistics();
+   report["frame_allocations"] = {
+      {"max", frames.mMaxFrame},
+      {"allocating_frames", frames.mAllocatingFrames}
+   };
+
+   if (settings.mTrackAllocations)
+   {
+      for (const auto& scope : AllocationTracker::getScopeStatistics())
+      {
+         report["allocation_scopes"][scope.mName] = {
+            {"allocations", scope.mAllocations},
+            {"allocated_bytes", scope.mBytes},
+            {"max_frame", scope.mMaxFrame},
+            {"steady_state", 0}
+         };
+      }
+
+      for (const auto& scope : mSteadyScopes)
+      {
+         report["allocation_scopes"][scope.mName]["steady_state"] = scope.mAllocations;
+      }
+   }
+
+#ifndef RELEASE_BUILD
+   // the profiler statistics cover the last frames only
+   for (const auto& [name, statistics] : Profiler::getInstance().getStatistics())
+   {
+      report["scopes"][name] = {
+         {"p50_ms", statistics.mP50},
+         {"p90_ms", statistics.mP90},
+         {"p99_ms", statistics.mP99},
+         {"max_ms", statistics.mMax}
+      };
+   }
+#endif
+
+   char hash[32];
+   snprintf(hash, sizeof(hash), "%016llx", static_cast<unsigned long long>(hashPlayer()));
+   report["hashes"]["player"] = hash;
+   snprintf(hash, sizeof(hash), "%016llx", static_cast<unsigned long long>(hashWorld()));
+   report["hashes"]["world"] = hash;
+
+   const auto text = report.dump(3);
+   std::cout << text << std::endl;
+
+   std::ofstream out(settings.mReportFilename);
+   if (!out)
+   {
+      std::cerr << "[!] unable to write " << settings.mReportFilename << std::endl;
+      return false;
+   }
+
+   out << text << std::endl;
+   return true;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "framework/tools/allocationtracker.h"
+
+#include <SFML/System/Time.hpp>
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class Level;
+class Player;
+
+
+// plays a level without window, rendering, joystick and menus
+//
+// the level is loaded from the given level and checkpoint (or from the header of a
+// replay recorded with '/replay record') and simulated for a fixed number of ticks.
+// the timings of each update phase, the allocation counts and hashes of the final
+// physics state are written to a json report so runs can be compared across builds.
+// --allocations attributes the allocations to profiler scopes, --assert-no-allocations
+// additionally fails the run if the second half of it allocates at all. builds that don't
+// track allocations refuse to run the assertion rather than pass it.
+//
+// usage: deceptus --benchmark [--replay <file>] [--level <n>] [--checkpoint <n>] [--ticks <n>] [--report <file>]
+//                             [--allocations] [--assert-no-allocations]
+class BenchmarkRunner
+{
+
+public:
+
+   struct Settings
+   {
+      std::string mReplayFilename;
+      std::string mReportFilename = "benchmark.json";
+      uint32_t mLevelIndex = 0;
+      uint32_t mCheckpoint = 0;
+      uint32_t mTickCount = 0; // 0 means the length of the replay or 600 ticks without replay
+      bool mTrackAllocations = false;
+      bool mAssertNoAllocations = false;
+   };
+
+   //! returns true if the command line asks for a benchmark run
+   static bool parseArguments(int argc, char** argv, Settings& settings);
+
+   int run(const Settings& settings);
+
+
+private:
+
+   enum Phase
+   {
+      PhaseAnimations,
+      PhaseLevel,
+      PhasePlayer,
+      PhaseTick,
+      PhaseCount
+   };
+
+   struct PhaseData
+   {
+      std::vector<int64_t> mDurations; // ns per tick
+      uint64_t mAllocations = 0;
+      uint64_t mBytes = 0;
+   };
+
+   bool load(const Settings& settings);
+   void tick(const sf::Time& dt);
+   bool writeReport(const Settings& settings, uint32_t ticks) const;
+
+   uint64_t hashPlayer() const;
+   uint64_t hashWorld() const;
+
+   std::shared_ptr<Player> mPlayer;
+   std::shared_ptr<Level> mLevel;
+
+   std::array<PhaseData, PhaseCount> mPhases;
+   int64_t mLoadDuration = 0;
+   uint64_t mSteadyAllocations = 0; // allocations in the second half of the run
+   std::vector<AllocationTracker::ScopeStatistics> mSteadyScopes; // per-scope allocations in the second half
+};
+
@@ -16,7 +16,6 @@ void BitmapFont::load(
 )
 {
    mTexture = TexturePool::getInstance().get(texturePath);
-   mSprite.setTexture(*mTexture);
 
    std::ifstream file(mapPath);
 
@@ -62,12 +61,13 @@ void BitmapFont::load(
    auto y = 0;
    for (auto c : font)
    {
-      std::shared_ptr<sf::IntRect> rect = std::make_shared<sf::IntRect>();
-      rect->left = x;
-      rect->top = y;
-      rect->width = mCharWidth;
-      rect->height = mCharHeight;
-      mMap.insert(std::pair<char,std::shared_ptr<sf::IntRect>>(c, rect));
+      // like the map this used to be, the first occurrence of a character wins
+      const auto index = static_cast<uint8_t>(c);
+      if (!mGlyphMask.test(index))
+      {
+         mGlyphs[index] = sf::IntRect(x, y, mCharWidth, mCharHeight);
+         mGlyphMask.set(index);
+      }
 
       x += mCharWidth;
 
@@ -83,51 +83,79 @@ void BitmapFont::load(
 }
 
 
-std::vector<std::shared_ptr<sf::IntRect>> BitmapFont::getCoords(const std::string &text)
+void BitmapFont::update(Text& text, std::string_view string) const
 {
-   std::vector<std::shared_ptr<sf::IntRect>> coords;
-
-   for (auto c : text)
+   if (text.mValid && text.mString == string)
    {
-      auto it = mMap.find(c);
+      return;
+   }
+
+   text.mString.assign(string.data(), string.size());
+   text.mValid = true;
 
-      if (it != mMap.end())
+   // characters without a glyph are skipped, vertex storage is reused across updates
+   text.mVertices.setPrimitiveType(sf::Quads);
+   text.mVertices.resize(string.size() * 4);
+
+   auto vertex = 0u;
+   auto x = 0.0f;
+   const auto h = static_cast<float>(mCharHeight);
+   const auto w = static_cast<float>(mCharWidth);
+
+   for (auto c : string)
+   {
+      const auto index = static_cast<uint8_t>(c);
+      if (!mGlyphMask.test(index))
       {
-        coords.push_back(it->second);
+         continue;
       }
+
+      const auto& glyph = mGlyphs[index];
+      const auto left = static_cast<float>(glyph.left);
+      const auto top = static_cast<float>(glyph.top);
+
+      text.mVertices[vertex + 0] = sf::Vertex({x,     0.0f}, {left,     top});
+      text.mVertices[vertex + 1] = sf::Vertex({x + w, 0.0f}, {left + w, top});
+      text.mVertices[vertex + 2] = sf::Vertex({x + w, h},    {left + w, top + h});
+      text.mVertices[vertex + 3] = sf::Vertex({x,     h},    {left,     top + h});
+
+      vertex += 4;
+      x += w;
    }
 
-   return coords;
+   text.mVertices.resize(vertex);
+   text.mWidth = static_cast<int32_t>(x);
 }
 
 
 void BitmapFont::draw(
    sf::RenderTarget& window,
-   const std::vector<std::shared_ptr<sf::IntRect> > &coords,
+   const Text& text,
    int32_t x,
    int32_t y
-)
+) const
 {
-   auto xOffset = 0;
-   for (auto& coord : coords)
+   if (text.mVertices.getVertexCount() == 0)
    {
-      mSprite.setTextureRect(
-         sf::IntRect(
-            coord->left,
-            coord->top,
-            coord->width,
-            coord->height
-         )
-      );
-
-      mSprite.setPosition(
-         static_cast<float>(x + xOffset),
-         static_cast<float>(y)
-      );
-
-      window.draw(mSprite);
-      xOffset += mCharWidth;
+      return;
    }
 
-   mTextWidth = xOffset;
+   sf::RenderStates states;
+   states.texture = mTexture.get();
+   states.transform.translate(static_cast<float>(x), static_cast<float>(y));
+
+   window.draw(text.mVertices, states);
+}
+
+
+void BitmapFont::draw(
+   sf::RenderTarget& window,
+   Text& text,
+   std::string_view string,
+   int32_t x,
+   int32_t y
+) const
+{
+   update(text, string);
+   draw(window, text, x, y);
 }
@@ -1,29 +1,42 @@
 #pragma once
 
+#include <array>
+#include <bitset>
 #include <cstdint>
 #include <memory>
+#include <string>
+#include <string_view>
 #include <SFML/Graphics.hpp>
 #include <SFML/System.hpp>
 
 
 struct BitmapFont
 {
+   // the quads of one line of text, only rebuilt when the string changes
+   struct Text
+   {
+      std::string mString;
+      sf::VertexArray mVertices{sf::Quads};
+      int32_t mWidth = 0;
+      bool mValid = false;
+   };
+
    BitmapFont() = default;
    void load(const std::string& texture, const std::string &map);
-   std::vector<std::shared_ptr<sf::IntRect>> getCoords(const std::string& text);
 
-   void draw(
-      sf::RenderTarget& window,
-      const std::vector<std::shared_ptr<sf::IntRect>>& coords,
-      int32_t x = 0,
-      int32_t y = 0
-   );
+   //! rebuild the mesh of text if string differs from what it currently shows
+   void update(Text& text, std::string_view string) const;
+
+   //! draw a mesh built by update in a single call
+   void draw(sf::RenderTarget& window, const Text& text, int32_t x = 0, int32_t y = 0) const;
+
+   //! update and draw
+   void draw(sf::RenderTarget& window, Text& text, std::string_view string, int32_t x = 0, int32_t y = 0) const;
 
    std::shared_ptr<sf::Texture> mTexture;
-   sf::Sprite mSprite;
-   std::map<char, std::shared_ptr<sf::IntRect>> mMap;
+   std::array<sf::IntRect, 256> mGlyphs;
+   std::bitset<256> mGlyphMask;
    int32_t mCharWidth = 0;
    int32_t mCharHeight = 0;
-   int32_t mTextWidth = 0;
 };
 
@@ -146,7 +146,7 @@ void Bow::fireNow(
    _loaded_arrow->getBody()->SetAngularVelocity(0.0f);
    _loaded_arrow->getBody()->SetTransform(pos, angle);
    _loaded_arrow->getBody()->SetLinearVelocity(velocity);
-   _loaded_arrow->setProperty("damage", _damage);
+   _loaded_arrow->setProperty(PropertyKey::Damage, _damage);
 
    updateRotation(_loaded_arrow);
    copyReferenceAnimation(_loaded_arrow);
@@ -70,7 +70,7 @@ void CameraSystem::updateX(const sf::Time& dt)
 
    auto player_x = player->getPixelPositionf().x;
    auto player_y = player->getPixelPositionf().y;
-   const auto corrected = _room->correctedCamera(player_x, player_y, _focus_offset, config.getViewRatioY());
+   const auto corrected = _room && _room->correctedCamera(player_x, player_y, _focus_offset, config.getViewRatioY());
 
    const auto dx = (player_x - _x) * dt.asSeconds() * config.getCameraVelocityFactorX();
 
@@ -143,7 +143,7 @@ void CameraSystem::updateY(const sf::Time& dt)
 
    auto player_x = player->getPixelPositionf().x;
    auto player_y = player->getPixelPositionf().y + config.getPlayerOffsetY();
-   const auto corrected = _room->correctedCamera(player_x, player_y, _focus_offset, config.getViewRatioY());
+   const auto corrected = _room && _room->correctedCamera(player_x, player_y, _focus_offset, config.getViewRatioY());
 
    const auto test = player_y - view_center;
 
@@ -216,9 +216,9 @@ void CameraSystem::updatePlayerFocused()
 }
 
 
-void CameraSystem::setRoom(const std::optional<Room>& room)
+void CameraSystem::setRoom(const Room* room)
 {
-   if (_room->mId != room->mId)
+   if (_room != room)
    {
       _room_interpolation = 0.0f;
       // std::cout << "[i] reset room interpolation" << std::endl;
@@ -2,8 +2,12 @@
 
 #include "bow.h"
 #include "checkpoint.h"
+#include "displaymode.h"
 #include "eventserializer.h"
 #include "extramanager.h"
+#include "framework/tools/allocationtracker.h"
+#include "framework/tools/profiler.h"
+#include "luainterface.h"
 #include "player/player.h"
 #include "player/playerinfo.h"
 #include "savestate.h"
@@ -57,7 +61,12 @@ void Console::showHelp()
     mLog.push_back("help:");
     mLog.push_back("/cp <n> | jump to checkpoint | example: /cp 0");
     mLog.push_back("/extra <name> | give extra | available extras: climb, dash, wallslide, walljump, doublejump, invulnerable");
+    mLog.push_back("/lua <command> | lua scripts | commands: parallel");
     mLog.push_back("/playback <command> | game playback | commands: enable, disable, load, save, replay, reset");
+    mLog.push_back("/replay <command> | deterministic replay | commands: record, stop, save <filename>, play <filename>");
+#ifndef RELEASE_BUILD
+    mLog.push_back("/profiler <command> | frame profiler | commands: overlay, allocations, dump <filename>");
+#endif
     mLog.push_back("/tp <x>,<y> | teleport to position | example: /tp 100, 330");
     mLog.push_back("/weapon <weapon> | give weapon to player | available weapons: bow");
 }
@@ -225,6 +234,77 @@ void Console::execute()
          mLog.push_back("playback reset");
       }
    }
+   else if (results.at(0) == "/replay" && results.size() >= 2)
+   {
+      auto& replay = EventSerializer::getInstance();
+      const auto filename = (results.size() >= 3) ? results[2] : std::string{"replay.dat"};
+
+      if (results[1] == "record")
+      {
+         // start over from the current checkpoint so the recording is self-contained
+         replay.startRecording(SaveState::getCurrent().mLevelIndex, SaveState::getCurrent().mCheckpoint);
+         SaveState::getCurrent().mLoadLevelRequested = true;
+         mLog.push_back("replay recording started");
+      }
+      else if (results[1] == "stop")
+      {
+         replay.stopReplay();
+         mLog.push_back("replay stopped");
+      }
+      else if (results[1] == "save")
+      {
+         mLog.push_back(replay.saveReplay(filename) ? "replay saved to " + filename : "nothing to save");
+      }
+      else if (results[1] == "play")
+      {
+         if (replay.loadReplay(filename) && replay.startPlayback())
+         {
+            SaveState::getCurrent().mLevelIndex = replay.getReplayHeader()._level_index;
+            SaveState::getCurrent().mCheckpoint = replay.getReplayHeader()._checkpoint;
+            SaveState::getCurrent().mLoadLevelRequested = true;
+            mLog.push_back("replaying " + filename);
+         }
+         else
+         {
+            mLog.push_back("unable to play " + filename);
+         }
+      }
+   }
+   else if (results.at(0) == "/lua" && results.size() == 2)
+   {
+      if (results[1] == "parallel")
+      {
+         LuaInterface::instance()->setParallel(!LuaInterface::instance()->isParallel());
+         mLog.push_back(LuaInterface::instance()->isParallel() ? "parallel lua updates enabled" : "parallel lua updates disabled");
+      }
+   }
+#ifndef RELEASE_BUILD
+   else if (results.at(0) == "/profiler" && results.size() >= 2)
+   {
+      if (results[1] == "overlay")
+      {
+         DisplayMode::getInstance().enqueueToggle(Display::DisplayProfiler);
+         mLog.push_back("profiler overlay toggled");
+      }
+      else if (results[1] == "allocations")
+      {
+         AllocationTracker::setEnabled(!AllocationTracker::isEnabled());
+         mLog.push_back(AllocationTracker::isEnabled() ? "allocation tracking enabled" : "allocation tracking disabled");
+      }
+      else if (results[1] == "dump")
+      {
+         const auto filename = (results.size() > 2) ? results[2] : std::string{"trace.json"};
+         if (Profiler::getInstance().writeChromeTrace(filename))
+         {
+            mLog.push_back("trace written to " + filename);
+         }
+         else
+         {
+            mLog.push_back("could not write " + filename);
+         }
+      }
+   }
+#endif
    else if (results.at(0) == "/iddqd")
    {
       SaveState::getPlayerInfo().mExtraTable.mSkills.mSkills |= ExtraSkill::SkillInvulnerable;
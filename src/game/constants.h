@@ -93,7 +93,8 @@ enum Display {
    DisplayMap       = 0x04,
    DisplayInventory = 0x08,
    DisplayDebug     = 0x10,
-   DisplayModal     = 0x20
+   DisplayModal     = 0x20,
+   DisplayProfiler  = 0x40
 };
 
 
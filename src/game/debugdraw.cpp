@@ -321,33 +321,16 @@ void DebugDraw::debugBodies(sf::RenderTarget& target, Level* level)
                {
                   auto chain = dynamic_cast<b2ChainShape*>(shape);
 
-                  auto vertexCount = chain->m_count;
-
-                  // to debug static bodies
-                  //
-                  // if (vertexCount > 100)
-                  // {
-                  //    break;
-                  // }
-
-                  auto vertices = new b2Vec2[static_cast<size_t>(vertexCount)];
-
-                  for(auto i = 0; i < vertexCount; i++ )
+                  // static outlines are split into open chains, so draw the edges rather than a closed polygon
+                  for (auto i = 0; i < chain->m_count - 1; i++)
                   {
-                     auto vec2 = chain->m_vertices[i];
-                     vertices[i] = vec2;
-                     vertices[i].x += body->GetPosition().x;
-                     vertices[i].y += body->GetPosition().y;
+                     DrawSegment(
+                        target,
+                        chain->m_vertices[i] + body->GetPosition(),
+                        chain->m_vertices[i + 1] + body->GetPosition(),
+                        b2Color(1,0,0,1)
+                     );
                   }
-
-                  DrawPolygon(
-                     target,
-                     vertices,
-                     vertexCount,
-                     b2Color(1,0,0,1)
-                  );
-
-                  delete[] vertices;
                   break;
                }
 
@@ -1,7 +1,6 @@
 #include "detonationanimation.h"
 
 #include <cassert>
-#include <ctime>
 #include <iostream>
 #include <math.h>
 
@@ -96,8 +95,6 @@ DetonationAnimation::DetonationAnimation(
    // compute all positions
    // have one detonation per position
 
-   std::srand(static_cast<int32_t>(std::time(nullptr)));
-
    auto ring_index = 0u;
    for (auto& ring : rings)
    {
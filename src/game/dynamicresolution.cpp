@@ -0,0 +1,248 @@
+#include "dynamicresolution.h"
+
+#include <SFML/OpenGL.hpp>
+
+#include <algorithm>
+#include <iostream>
+
+
+#ifndef APIENTRY
+#define APIENTRY
+#endif
+
+
+namespace
+{
+// ARB_timer_query, core since OpenGL 3.3
+constexpr GLenum GL_TIME_ELAPSED_ = 0x88BF;
+constexpr GLenum GL_QUERY_RESULT_ = 0x8866;
+constexpr GLenum GL_QUERY_RESULT_AVAILABLE_ = 0x8867;
+
+using GenQueries = void (APIENTRY*)(GLsizei, GLuint*);
+using DeleteQueries = void (APIENTRY*)(GLsizei, const GLuint*);
+using BeginQuery = void (APIENTRY*)(GLenum, GLuint);
+using EndQuery = void (APIENTRY*)(GLenum);
+using GetQueryObjectiv = void (APIENTRY*)(GLuint, GLenum, GLint*);
+using GetQueryObjectui64v = void (APIENTRY*)(GLuint, GLenum, uint64_t*);
+
+GenQueries glGenQueries_ = nullptr;
+DeleteQueries glDeleteQueries_ = nullptr;
+BeginQuery glBeginQuery_ = nullptr;
+EndQuery glEndQuery_ = nullptr;
+GetQueryObjectiv glGetQueryObjectiv_ = nullptr;
+GetQueryObjectui64v glGetQueryObjectui64v_ = nullptr;
+
+// scales the buffers go through, one step at a time
+constexpr std::array<float, 3> scales = {1.0f, 0.75f, 0.5f};
+
+// gpu time of the level passes
+constexpr auto gpuDropMs = 12.0f;
+constexpr auto gpuRaiseMs = 6.0f;
+
+// time between two frames, a 60hz frame plus some slack
+constexpr auto frameDropMs = 18.0f;
+constexpr auto frameRaiseMs = 17.0f;
+
+// frames to wait after a change until the average has settled
+constexpr auto settleFrames = 60;
+
+// frames the average must stay below the raise threshold before going up again
+constexpr auto raiseFrames = 180;
+
+template <typename T>
+T loadFunction(const char* name, const char* fallback_name)
+{
+   auto function = sf::Context::getFunction(name);
+
+   if (!function)
+   {
+      function = sf::Context::getFunction(fallback_name);
+   }
+
+   return reinterpret_cast<T>(function);
+}
+}
+
+
+DynamicResolution::~DynamicResolution()
+{
+   if (mTimerQueries)
+   {
+      glDeleteQueries_(static_cast<GLsizei>(mQueries.size()), mQueries.data());
+   }
+}
+
+
+void DynamicResolution::setEnabled(bool enabled)
+{
+   mEnabled = enabled;
+
+   if (!mEnabled)
+   {
+      mStep = 0;
+   }
+}
+
+
+bool DynamicResolution::isEnabled() const
+{
+   return mEnabled;
+}
+
+
+float DynamicResolution::getScale() const
+{
+   return scales[mStep];
+}
+
+
+void DynamicResolution::initializeQueries()
+{
+   mQueriesInitialized = true;
+
+   glGenQueries_ = loadFunction<GenQueries>("glGenQueries", "glGenQueriesARB");
+   glDeleteQueries_ = loadFunction<DeleteQueries>("glDeleteQueries", "glDeleteQueriesARB");
+   glBeginQuery_ = loadFunction<BeginQuery>("glBeginQuery", "glBeginQueryARB");
+   glEndQuery_ = loadFunction<EndQuery>("glEndQuery", "glEndQueryARB");
+   glGetQueryObjectiv_ = loadFunction<GetQueryObjectiv>("glGetQueryObjectiv", "glGetQueryObjectivARB");
+   glGetQueryObjectui64v_ = loadFunction<GetQueryObjectui64v>("glGetQueryObjectui64v", "glGetQueryObjectui64vEXT");
+
+   mTimerQueries =
+         glGenQueries_
+      && glDeleteQueries_
+      && glBeginQuery_
+      && glEndQuery_
+      && glGetQueryObjectiv_
+      && glGetQueryObjectui64v_;
+
+   if (mTimerQueries)
+   {
+      glGenQueries_(static_cast<GLsizei>(mQueries.size()), mQueries.data());
+   }
+
+   std::cout
+      << "[x] dynamic resolution measures "
+      << (mTimerQueries ? "gpu time with timer queries" : "frame time, no timer queries available")
+      << std::endl;
+}
+
+
+void DynamicResolution::beginFrame()
+{
+   if (!mEnabled)
+   {
+      return;
+   }
+
+   if (!mQueriesInitialized)
+   {
+      initializeQueries();
+   }
+
+   if (!mTimerQueries)
+   {
+      update(mFrameClock.restart().asSeconds() * 1000.0f);
+      return;
+   }
+
+   // all queries still in flight, this frame goes unmeasured
+   if (mPendingQueries == queryCount)
+   {
+      return;
+   }
+
+   glBeginQuery_(GL_TIME_ELAPSED_, mQueries[mNextQuery]);
+   mQueryActive = true;
+}
+
+
+void DynamicResolution::endFrame()
+{
+   if (!mQueryActive)
+   {
+      return;
+   }
+
+   glEndQuery_(GL_TIME_ELAPSED_);
+   mQueryActive = false;
+
+   mNextQuery = (mNextQuery + 1) % queryCount;
+   mPendingQueries++;
+
+   collectQueries();
+}
+
+
+void DynamicResolution::collectQueries()
+{
+   // results come in the order the queries were issued, stop at the first one not done yet
+   while (mPendingQueries > 0)
+   {
+      const auto query = mQueries[(mNextQuery + queryCount - mPendingQueries) % queryCount];
+
+      GLint available = 0;
+      glGetQueryObjectiv_(query, GL_QUERY_RESULT_AVAILABLE_, &available);
+
+      if (!available)
+      {
+         break;
+      }
+
+      uint64_t elapsed_ns = 0;
+      glGetQueryObjectui64v_(query, GL_QUERY_RESULT_, &elapsed_ns);
+      mPendingQueries--;
+
+      update(static_cast<float>(elapsed_ns) / 1000000.0f);
+   }
+}
+
+
+void DynamicResolution::update(float frame_time_ms)
+{
+   // the first measurement starts the average, large spikes like level loading are clamped
+   frame_time_ms = std::min(frame_time_ms, 100.0f);
+   mAverageMs = (mAverageMs > 0.0f) ? (mAverageMs * 0.9f + frame_time_ms * 0.1f) : frame_time_ms;
+
+   mFramesSinceChange++;
+   if (mFramesSinceChange < settleFrames)
+   {
+      return;
+   }
+
+   const auto drop = mTimerQueries ? gpuDropMs : frameDropMs;
+   const auto raise = mTimerQueries ? gpuRaiseMs : frameRaiseMs;
+
+   auto step = mStep;
+
+   if (mAverageMs > drop && mStep + 1 < scales.size())
+   {
+      step++;
+   }
+   else if (mAverageMs < raise && mStep > 0)
+   {
+      mFramesBelowRaise++;
+
+      if (mFramesBelowRaise >= raiseFrames)
+      {
+         step--;
+      }
+   }
+   else
+   {
+      mFramesBelowRaise = 0;
+   }
+
+   if (step == mStep)
+   {
+      return;
+   }
+
+   mStep = step;
+   mFramesSinceChange = 0;
+   mFramesBelowRaise = 0;
+
+   std::cout
+      << "[x] dynamic resolution: " << static_cast<int32_t>(scales[mStep] * 100.0f) << "%"
+      << ", " << mAverageMs << "ms" << std::endl;
+}
+
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+#include <array>
+#include <cstdint>
+
+
+// picks the scale of the lighting, normal and atmosphere buffers from the measured frame time
+//
+// the gpu time of the level passes is measured with timer queries. the results arrive a few
+// frames late which is fine since the scale only moves in coarse steps. drivers without timer
+// queries fall back to the time between two frames, which only says something about the gpu
+// when the game is gpu bound.
+class DynamicResolution
+{
+
+public:
+
+   DynamicResolution() = default;
+   ~DynamicResolution();
+
+   DynamicResolution(const DynamicResolution&) = delete;
+   DynamicResolution& operator=(const DynamicResolution&) = delete;
+
+   void setEnabled(bool enabled);
+   bool isEnabled() const;
+
+   //! enclose the draw calls to measure
+   void beginFrame();
+   void endFrame();
+
+   //! scale for the scaled render targets, 1.0 while disabled
+   float getScale() const;
+
+
+private:
+
+   static constexpr auto queryCount = 4u;
+
+   void initializeQueries();
+   void collectQueries();
+   void update(float frame_time_ms);
+
+   bool mEnabled = false;
+
+   bool mQueriesInitialized = false;
+   bool mTimerQueries = false;
+   bool mQueryActive = false;
+   std::array<uint32_t, queryCount> mQueries = {};
+   uint32_t mNextQuery = 0;
+   uint32_t mPendingQueries = 0;
+
+   sf::Clock mFrameClock;
+
+   float mAverageMs = 0.0f;
+   size_t mStep = 0;
+   int32_t mFramesSinceChange = 0;
+   int32_t mFramesBelowRaise = 0;
+};
+
@@ -1,16 +1,18 @@
 #include "lightsystem.h"
 
 #include "framework/tmxparser/tmxobject.h"
+#include "framework/tools/profiler.h"
 #include "framework/tmxparser/tmxtools.h"
 #include "framework/tmxparser/tmxproperties.h"
 #include "framework/tmxparser/tmxproperty.h"
 #include "game/debugdraw.h"
 #include "game/level.h"
 #include "game/player/player.h"
+#include "shadowquads.h"
 #include "texturepool.h"
 
+#include <algorithm>
 #include <iostream>
-#include <math.h>
 
 #include <SFML/OpenGL.hpp>
 
@@ -25,17 +27,6 @@ static constexpr auto max_distance_m2 = 100.0f; // depends on the view dimension
 //-----------------------------------------------------------------------------
 LightSystem::LightSystem()
 {
-   // prepare unit circle for circle shapes
-   for (auto i = 0u; i < segments; i++)
-   {
-      auto angle = (2.0 * M_PI) * (i / static_cast<double>(segments));
-
-      auto x = static_cast<float>(cos(angle));
-      auto y = static_cast<float>(sin(angle));
-
-      _unit_circle[i] = b2Vec2{x, y};
-   }
-
    if (!_light_shader.loadFromFile("data/shaders/light.frag", sf::Shader::Fragment))
    {
       std::cout << "[!] error loading bump mapping shader" << std::endl;
@@ -46,149 +37,17 @@ LightSystem::LightSystem()
 //-----------------------------------------------------------------------------
 void LightSystem::drawShadowQuads(sf::RenderTarget& target, std::shared_ptr<LightSystem::LightInstance> light) const
 {
-   // do not draw lights that are too far away
-   auto player_body = Player::getCurrent()->getBody();
-
-   auto light_pos_m = light->_pos_m + light->_center_offset_m;
-
-   for (b2Body* b = Level::getCurrentLevel()->getWorld()->GetBodyList(); b; b = b->GetNext())
-   {
-      if (b == player_body)
-         continue;
-
-      if (!b->IsActive())
-      {
-         continue;
-      }
-
-      for (b2Fixture* f = b->GetFixtureList(); f; f = f->GetNext())
-      {
-         // if something doesn't collide, it probably shouldn't have any impact on lighting, too
-         if (f->IsSensor())
-         {
-            continue;
-         }
-
-         auto shape = f->GetShape();
-
-         auto shape_polygon = dynamic_cast<b2PolygonShape*>(shape);
-         auto shape_chain = dynamic_cast<b2ChainShape*>(shape);
-         auto shape_circle = dynamic_cast<b2CircleShape*>(shape);
+   _shadow_quads.clear();
+
+   ShadowQuads::append(
+      _shadow_quads,
+      Level::getCurrentLevel()->getWorld().get(),
+      Player::getCurrent()->getBody(),
+      light->_pos_m + light->_center_offset_m,
+      max_distance_m2
+   );
 
-         if (shape_circle)
-         {
-            auto center = shape_circle->GetVertex(0) + b->GetTransform().p;
-            if ((light_pos_m - center).LengthSquared() > max_distance_m2)
-               continue;
-
-            std::array<b2Vec2, segments> circle_positions;
-            for (auto i = 0u; i < segments; i++)
-            {
-               circle_positions[i] = b2Vec2{
-                  center.x + _unit_circle[i].x * shape_circle->m_radius * 1.2f,
-                  center.y + _unit_circle[i].y * shape_circle->m_radius * 1.2f
-               };
-            }
-
-            for (auto pos_current = 0u; pos_current < circle_positions.size(); pos_current++)
-            {
-               auto pos_next = pos_current + 1;
-               if (pos_next == circle_positions.size())
-               {
-                  pos_next = 0;
-               }
-
-               auto v0 = circle_positions[pos_current];
-               auto v1 = circle_positions[pos_next];
-
-               auto v0far = 10000.0f * (v0 - light_pos_m);
-               auto v1far = 10000.0f * (v1 - light_pos_m);
-
-               sf::Vertex quad[] =
-               {
-                  sf::Vertex(sf::Vector2f(v0.x, v0.y) * PPM, sf::Color::Black),
-                  sf::Vertex(sf::Vector2f(v0far.x, v0far.y) * PPM, sf::Color::Black),
-                  sf::Vertex(sf::Vector2f(v1far.x, v1far.y) * PPM, sf::Color::Black),
-                  sf::Vertex(sf::Vector2f(v1.x, v1.y) * PPM, sf::Color::Black)
-               };
-
-               target.draw(quad, 4, sf::Quads);
-            }
-         }
-         else if (shape_chain)
-         {
-            // for now it is assumed that chainshapes are static objects only.
-            // therefore no transform is applied to chainshape based objects.
-
-            for (auto pos_current = 0; pos_current < shape_chain->m_count; pos_current++)
-            {
-               auto pos_next = pos_current + 1;
-               if (pos_next == shape_chain->m_count)
-               {
-                  pos_next = 0;
-               }
-
-               auto v0 = shape_chain->m_vertices[pos_current];
-               auto v1 = shape_chain->m_vertices[pos_next];
-
-               // printf("%f\n", (lightPos - v0).LengthSquared());
-
-               if (
-                     (light_pos_m - v0).LengthSquared() > max_distance_m2
-                  && (light_pos_m - v1).LengthSquared() > max_distance_m2
-               )
-               {
-                  continue;
-               }
-
-               auto v0far = 10000.0f * (v0 - light_pos_m);
-               auto v1far = 10000.0f * (v1 - light_pos_m);
-
-               sf::Vertex quad[] =
-               {
-                  sf::Vertex(sf::Vector2f(v0.x, v0.y) * PPM, sf::Color::Black),
-                  sf::Vertex(sf::Vector2f(v0far.x, v0far.y) * PPM, sf::Color::Black),
-                  sf::Vertex(sf::Vector2f(v1far.x, v1far.y) * PPM, sf::Color::Black),
-                  sf::Vertex(sf::Vector2f(v1.x, v1.y) * PPM, sf::Color::Black)
-               };
-
-               target.draw(quad, 4, sf::Quads);
-            }
-         }
-         else if (shape_polygon)
-         {
-            for (auto pos_current = 0; pos_current < shape_polygon->GetVertexCount(); pos_current++)
-            {
-               auto pos_next = pos_current + 1;
-               if (pos_next == shape_polygon->GetVertexCount())
-               {
-                  pos_next = 0;
-               }
-
-               auto v0 = shape_polygon->GetVertex(pos_current) + b->GetTransform().p;
-
-               // printf("%f\n", (lightPos - v0).LengthSquared());
-
-               if ((light_pos_m - v0).LengthSquared() > max_distance_m2)
-                  continue;
-
-               auto v1 = shape_polygon->GetVertex(pos_next) + b->GetTransform().p;
-               auto v0far = 10000.0f * (v0 - light_pos_m);
-               auto v1far = 10000.0f * (v1 - light_pos_m);
-
-               sf::Vertex quad[] =
-               {
-                  sf::Vertex(sf::Vector2f(v0.x, v0.y) * PPM, sf::Color::Black),
-                  sf::Vertex(sf::Vector2f(v0far.x, v0far.y) * PPM, sf::Color::Black),
-                  sf::Vertex(sf::Vector2f(v1far.x, v1far.y) * PPM, sf::Color::Black),
-                  sf::Vertex(sf::Vector2f(v1.x, v1.y) * PPM, sf::Color::Black)
-               };
-
-               target.draw(quad, 4, sf::Quads);
-            }
-         }
-      }
-   }
+   target.draw(_shadow_quads);
 }
 
 
@@ -309,7 +168,7 @@ void LightSystem::updateLightShader(sf::RenderTarget& target)
 
 
 //-----------------------------------------------------------------------------
-void LightSystem::draw(sf::RenderTarget& target, sf::RenderStates /*states*/) const
+void LightSystem::collectActiveLights() const
 {
    _active_lights.clear();
 
@@ -325,8 +184,41 @@ void LightSystem::draw(sf::RenderTarget& target, sf::RenderStates /*states*/) co
          continue;
       }
 
+      // fully transparent lights neither show up in the light map nor in the shader
+      if (light->_color.a == 0)
+      {
+         continue;
+      }
+
       _active_lights.push_back(light);
+   }
+}
+
+
+//-----------------------------------------------------------------------------
+bool LightSystem::updateActiveLights()
+{
+   collectActiveLights();
+   return !_active_lights.empty();
+}
+
 
+//-----------------------------------------------------------------------------
+bool LightSystem::hasNeutralAmbient() const
+{
+   return std::all_of(_ambient_color.begin(), _ambient_color.begin() + 3, [](auto value){return value == 1.0f;});
+}
+
+
+//-----------------------------------------------------------------------------
+void LightSystem::draw(sf::RenderTarget& target, sf::RenderStates /*states*/) const
+{
+   PROFILE_SCOPE("LightSystem::draw");
+
+   collectActiveLights();
+
+   for (const auto& light : _active_lights)
+   {
       // fill stencil buffer
       glClear(GL_STENCIL_BUFFER_BIT);
       glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
@@ -354,21 +246,23 @@ void LightSystem::draw(sf::RenderTarget& target, sf::RenderStates /*states*/) co
 //-----------------------------------------------------------------------------
 void LightSystem::draw(
    sf::RenderTarget& target,
-   const std::shared_ptr<sf::RenderTexture>& color_map,
-   const std::shared_ptr<sf::RenderTexture>& light_map,
-   const std::shared_ptr<sf::RenderTexture>& normal_map
+   const sf::Texture& color_map,
+   const sf::Texture& light_map,
+   const sf::Texture& normal_map
 )
 {
+   PROFILE_SCOPE("LightSystem::draw deferred");
+
    // MOVE THIS IN FUNCTION BELOW
-   _light_shader.setUniform("color_map", color_map->getTexture());
-   _light_shader.setUniform("light_map", light_map->getTexture());
-   _light_shader.setUniform("normal_map", normal_map->getTexture());
+   _light_shader.setUniform("color_map", color_map);
+   _light_shader.setUniform("light_map", light_map);
+   _light_shader.setUniform("normal_map", normal_map);
 
    // update shader uniforms
    updateLightShader(target);
 
    sf::Sprite sprite;
-   sprite.setTexture(color_map->getTexture());
+   sprite.setTexture(color_map);
    target.draw(sprite, &_light_shader);
 }
 
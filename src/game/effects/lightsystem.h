@@ -51,21 +51,27 @@ public:
 
    void draw(
       sf::RenderTarget& target,
-      const std::shared_ptr<sf::RenderTexture>& color_map,
-      const std::shared_ptr<sf::RenderTexture>& light_map,
-      const std::shared_ptr<sf::RenderTexture>& normal_map
+      const sf::Texture& color_map,
+      const sf::Texture& light_map,
+      const sf::Texture& normal_map
    );
 
+   //! collect the lights near the player for the deferred pass, false if none of them shines
+   bool updateActiveLights();
+
+   //! true if the ambient color leaves the colors as they are when no light is active
+   bool hasNeutralAmbient() const;
+
 
 private:
 
+   void collectActiveLights() const;
    void drawShadowQuads(sf::RenderTarget &target, std::shared_ptr<LightInstance> light) const;
    void updateLightShader(sf::RenderTarget& target);
 
    mutable std::vector<std::shared_ptr<LightInstance>> _active_lights;
 
    std::array<float, 4> _ambient_color = {1.0f, 1.0f, 1.0f, 1.0f};
-   static constexpr auto segments = 20;
-   std::array<b2Vec2, segments> _unit_circle;
+   mutable sf::VertexArray _shadow_quads{sf::Quads};
 };
 
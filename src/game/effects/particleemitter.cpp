@@ -0,0 +1,492 @@
+#include "particleemitter.h"
+
+#include "framework/tmxparser/tmxobject.h"
+#include "framework/tmxparser/tmxproperties.h"
+#include "framework/tmxparser/tmxproperty.h"
+#include "framework/tmxparser/tmxtools.h"
+#include "texturepool.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <map>
+#include <math.h>
+#include <optional>
+
+
+namespace
+{
+
+void resize(int32_t size, std::initializer_list<std::vector<float>*> arrays)
+{
+   for (auto array : arrays)
+   {
+      array->resize(static_cast<size_t>(size));
+   }
+}
+
+
+// the pooled textures are shared with everything else and keep their filtering, emitters
+// asking for smoothing share a filtered copy per file so they still end up in one batch
+std::shared_ptr<sf::Texture> getSmoothTexture(const std::string& filename)
+{
+   static std::map<std::string, std::weak_ptr<sf::Texture>> textures;
+
+   auto texture = textures[filename].lock();
+   if (!texture)
+   {
+      texture = std::make_shared<sf::Texture>(*TexturePool::getInstance().get(filename));
+      texture->setSmooth(true);
+      textures[filename] = texture;
+   }
+
+   return texture;
+}
+
+}
+
+
+ParticleEmitter::ParticleEmitter(const Settings& settings, const sf::Vector2f& position)
+ : mSettings(settings),
+   mPosition(position),
+   mRandom(settings.mSeed != 0 ? settings.mSeed : static_cast<uint32_t>(std::rand()))
+{
+   if (!mSettings.mTexture.empty())
+   {
+      mTexture = mSettings.mSmooth
+         ? getSmoothTexture(mSettings.mTexture)
+         : TexturePool::getInstance().get(mSettings.mTexture);
+
+      mTextureSize = sf::Vector2f(mTexture->getSize());
+   }
+   else
+   {
+      mTextureSize = mSettings.mQuadSize;
+   }
+
+   resize(
+      mSettings.mMaxParticles,
+      {
+         &mPositionX, &mPositionY, &mOriginX, &mOriginY, &mVelocityX, &mVelocityY,
+         &mRotation, &mRotationSpeed, &mSize, &mPhase, &mAge, &mLifetime
+      }
+   );
+
+   if (mSettings.mPrewarm)
+   {
+      const auto hasBounds = (mSettings.mBounds.width > 0.0f && mSettings.mBounds.height > 0.0f);
+      const auto& area = hasBounds ? mSettings.mBounds : mSettings.mSpawnArea;
+
+      while (mCount < mSettings.mMaxParticles)
+      {
+         spawn(mPosition, area);
+      }
+   }
+}
+
+
+void ParticleEmitter::spawn(const sf::Vector2f& origin, const sf::FloatRect& area)
+{
+   if (mCount >= mSettings.mMaxParticles)
+   {
+      return;
+   }
+
+   const auto i = static_cast<size_t>(mCount++);
+
+   mOriginX[i] = origin.x + area.left + area.width * mRandom.nextFloat();
+   mOriginY[i] = origin.y + area.top + area.height * mRandom.nextFloat();
+   mPositionX[i] = mOriginX[i];
+   mPositionY[i] = mOriginY[i];
+   mVelocityX[i] = mRandom.range(mSettings.mVelocityMin.x, mSettings.mVelocityMax.x);
+   mVelocityY[i] = mRandom.range(mSettings.mVelocityMin.y, mSettings.mVelocityMax.y);
+   mRotation[i] = mRandom.range(mSettings.mRotationMin, mSettings.mRotationMax);
+   mRotationSpeed[i] = mRandom.range(mSettings.mRotationSpeedMin, mSettings.mRotationSpeedMax);
+   mSize[i] = mRandom.range(mSettings.mSizeMin, mSettings.mSizeMax);
+   mPhase[i] = mRandom.range(0.0f, 2.0f * static_cast<float>(M_PI));
+   mAge[i] = 0.0f;
+   mLifetime[i] = mRandom.range(mSettings.mLifetimeMin, mSettings.mLifetimeMax);
+}
+
+
+void ParticleEmitter::kill(int32_t index)
+{
+   const auto i = static_cast<size_t>(index);
+   const auto last = static_cast<size_t>(--mCount);
+
+   mPositionX[i] = mPositionX[last];
+   mPositionY[i] = mPositionY[last];
+   mOriginX[i] = mOriginX[last];
+   mOriginY[i] = mOriginY[last];
+   mVelocityX[i] = mVelocityX[last];
+   mVelocityY[i] = mVelocityY[last];
+   mRotation[i] = mRotation[last];
+   mRotationSpeed[i] = mRotationSpeed[last];
+   mSize[i] = mSize[last];
+   mPhase[i] = mPhase[last];
+   mAge[i] = mAge[last];
+   mLifetime[i] = mLifetime[last];
+}
+
+
+void ParticleEmitter::update(const sf::Time& dt)
+{
+   const auto t = dt.asSeconds();
+   mTime += t;
+
+   if (mSettings.mSpawnRate > 0.0f)
+   {
+      mSpawnAccumulator += mSettings.mSpawnRate * t;
+
+      while (mSpawnAccumulator >= 1.0f)
+      {
+         spawn(mPosition, mSettings.mSpawnArea);
+         mSpawnAccumulator -= 1.0f;
+      }
+   }
+
+   const auto n = mCount;
+
+   auto px = mPositionX.data();
+   auto py = mPositionY.data();
+   auto vx = mVelocityX.data();
+   auto vy = mVelocityY.data();
+
+   if (mSettings.mMotion == Motion::Linear)
+   {
+      const auto ax = mSettings.mAcceleration.x * t;
+      const auto ay = mSettings.mAcceleration.y * t;
+
+      for (auto i = 0; i < n; i++)
+      {
+         vx[i] += ax;
+         vy[i] += ay;
+      }
+
+      for (auto i = 0; i < n; i++)
+      {
+         px[i] += vx[i] * t;
+         py[i] += vy[i] * t;
+      }
+   }
+   else
+   {
+      // fake z rotation
+      const auto ox = mOriginX.data();
+      const auto oy = mOriginY.data();
+      const auto phase = mPhase.data();
+
+      for (auto i = 0; i < n; i++)
+      {
+         px[i] = ox[i] + 0.5f * (1.0f + sinf(phase[i] + mTime)) * vx[i];
+         py[i] = oy[i] + 0.5f * (1.0f + cosf(phase[i] + mTime)) * vy[i];
+      }
+   }
+
+   auto rotation = mRotation.data();
+   auto rotationSpeed = mRotationSpeed.data();
+   auto age = mAge.data();
+
+   for (auto i = 0; i < n; i++)
+   {
+      rotation[i] += rotationSpeed[i] * t;
+      age[i] += t;
+   }
+
+   // retire particles that are too old or have left the bounds
+   const auto hasLifetime = (mSettings.mLifetimeMax > 0.0f);
+   const auto hasBounds = (mSettings.mBounds.width > 0.0f && mSettings.mBounds.height > 0.0f);
+
+   if (hasLifetime || hasBounds)
+   {
+      const auto left = mPosition.x + mSettings.mBounds.left;
+      const auto top = mPosition.y + mSettings.mBounds.top;
+      const auto right = left + mSettings.mBounds.width;
+      const auto bottom = top + mSettings.mBounds.height;
+
+      for (auto i = 0; i < mCount;)
+      {
+         const auto index = static_cast<size_t>(i);
+
+         const auto expired = hasLifetime && mAge[index] >= mLifetime[index];
+
+         const auto outside =
+               hasBounds
+            && (mPositionX[index] < left || mPositionX[index] > right || mPositionY[index] < top || mPositionY[index] > bottom);
+
+         if (expired || outside)
+         {
+            kill(i);
+         }
+         else
+         {
+            i++;
+         }
+      }
+   }
+
+   if (mSettings.mRespawn)
+   {
+      while (mCount < mSettings.mMaxParticles)
+      {
+         spawn(mPosition, mSettings.mSpawnArea);
+      }
+   }
+}
+
+
+void ParticleEmitter::append(sf::VertexArray& vertices) const
+{
+   if (mCount == 0)
+   {
+      return;
+   }
+
+   const auto color = mSettings.mColor;
+   const auto offset = vertices.getVertexCount();
+
+   if (mSettings.mShape == Shape::Line)
+   {
+      vertices.resize(offset + static_cast<size_t>(mCount) * 2);
+
+      for (auto i = 0u; i < static_cast<size_t>(mCount); i++)
+      {
+         auto c = color;
+         if (mSettings.mFadeOut && mLifetime[i] > 0.0f)
+         {
+            c.a = static_cast<sf::Uint8>(color.a * std::max(0.0f, 1.0f - mAge[i] / mLifetime[i]));
+         }
+
+         auto v = &vertices[offset + i * 2];
+         v[0] = sf::Vertex{{mPositionX[i], mPositionY[i]}, c};
+         v[1] = sf::Vertex{{mPositionX[i] + mVelocityX[i] * mSize[i], mPositionY[i] + mVelocityY[i] * mSize[i]}, c};
+      }
+
+      return;
+   }
+
+   vertices.resize(offset + static_cast<size_t>(mCount) * 4);
+
+   const auto tw = mTexture ? mTextureSize.x : 0.0f;
+   const auto th = mTexture ? mTextureSize.y : 0.0f;
+
+   for (auto i = 0u; i < static_cast<size_t>(mCount); i++)
+   {
+      auto c = color;
+      if (mSettings.mFadeOut && mLifetime[i] > 0.0f)
+      {
+         c.a = static_cast<sf::Uint8>(color.a * std::max(0.0f, 1.0f - mAge[i] / mLifetime[i]));
+      }
+
+      const auto hx = 0.5f * mTextureSize.x * mSize[i];
+      const auto hy = 0.5f * mTextureSize.y * mSize[i];
+
+      const auto angle = mRotation[i] * static_cast<float>(M_PI) / 180.0f;
+      const auto cs = cosf(angle);
+      const auto sn = sinf(angle);
+
+      // rotated half axes
+      const auto ax = sf::Vector2f{ hx * cs, hx * sn};
+      const auto ay = sf::Vector2f{-hy * sn, hy * cs};
+      const auto center = sf::Vector2f{mPositionX[i], mPositionY[i]};
+
+      auto v = &vertices[offset + i * 4];
+      v[0] = sf::Vertex{center - ax - ay, c, {0.0f, 0.0f}};
+      v[1] = sf::Vertex{center + ax - ay, c, {tw, 0.0f}};
+      v[2] = sf::Vertex{center + ax + ay, c, {tw, th}};
+      v[3] = sf::Vertex{center - ax + ay, c, {0.0f, th}};
+   }
+}
+
+
+void ParticleEmitter::burst(const sf::Vector2f& position, int32_t count)
+{
+   for (auto i = 0; i < count; i++)
+   {
+      spawn(position, mSettings.mSpawnArea);
+   }
+}
+
+
+void ParticleEmitter::setPosition(const sf::Vector2f& position)
+{
+   mPosition = position;
+}
+
+
+const ParticleEmitter::Settings& ParticleEmitter::getSettings() const
+{
+   return mSettings;
+}
+
+
+const sf::Texture* ParticleEmitter::getTexture() const
+{
+   return mTexture.get();
+}
+
+
+sf::PrimitiveType ParticleEmitter::getPrimitiveType() const
+{
+   return (mSettings.mShape == Shape::Line) ? sf::Lines : sf::Quads;
+}
+
+
+sf::FloatRect ParticleEmitter::getVisibleRect() const
+{
+   if (mCount == 0)
+   {
+      return {};
+   }
+
+   const auto n = static_cast<size_t>(mCount);
+
+   const auto [minX, maxX] = std::minmax_element(mPositionX.begin(), mPositionX.begin() + static_cast<ptrdiff_t>(n));
+   const auto [minY, maxY] = std::minmax_element(mPositionY.begin(), mPositionY.begin() + static_cast<ptrdiff_t>(n));
+
+   // grow by the largest extent a single particle can have
+   auto extent = 0.0f;
+   if (mSettings.mShape == Shape::Line)
+   {
+      const auto vx = std::max(fabsf(mSettings.mVelocityMin.x), fabsf(mSettings.mVelocityMax.x));
+      const auto vy = std::max(fabsf(mSettings.mVelocityMin.y), fabsf(mSettings.mVelocityMax.y));
+      extent = std::max(vx, vy) * mSettings.mSizeMax;
+   }
+   else
+   {
+      extent = std::max(mTextureSize.x, mTextureSize.y) * mSettings.mSizeMax * 0.7072f;
+   }
+
+   return {
+      *minX - extent,
+      *minY - extent,
+      *maxX - *minX + 2.0f * extent,
+      *maxY - *minY + 2.0f * extent
+   };
+}
+
+
+int32_t ParticleEmitter::getParticleCount() const
+{
+   return mCount;
+}
+
+
+//-----------------------------------------------------------------------------
+std::shared_ptr<ParticleEmitter> ParticleEmitter::deserialize(TmxObject* tmxObject, Settings settings)
+{
+   // the spawn area defaults to the object's rectangle
+   if (settings.mSpawnArea == sf::FloatRect{})
+   {
+      settings.mSpawnArea = {0.0f, 0.0f, tmxObject->_width_px, tmxObject->_height_px};
+   }
+
+   if (tmxObject->_properties)
+   {
+      const auto& map = tmxObject->_properties->_map;
+
+      // values of another type, e.g. untyped properties tiled stores as strings, keep the default
+      auto readFloat = [&map](const std::string& key, float& value) {
+         auto it = map.find(key);
+         if (it == map.end())
+         {
+            return;
+         }
+
+         const auto& property = it->second;
+         if (property->_value_type == "float" && property->_value_float.has_value())
+         {
+            value = property->_value_float.value();
+         }
+         else if (property->_value_type == "int" && property->_value_int.has_value())
+         {
+            value = static_cast<float>(property->_value_int.value());
+         }
+      };
+
+      auto readInt = [&map](const std::string& key, int32_t& value) {
+         auto it = map.find(key);
+         if (it != map.end() && it->second->_value_type == "int" && it->second->_value_int.has_value())
+         {
+            value = it->second->_value_int.value();
+         }
+      };
+
+      auto readBool = [&map](const std::string& key, bool& value) {
+         auto it = map.find(key);
+         if (it != map.end() && it->second->_value_type == "bool" && it->second->_value_bool.has_value())
+         {
+            value = it->second->_value_bool.value();
+         }
+      };
+
+      auto readString = [&map](const std::string& key) -> std::optional<std::string> {
+         auto it = map.find(key);
+         if (it != map.end())
+         {
+            return it->second->_value_string;
+         }
+         return std::nullopt;
+      };
+
+      readInt("z", settings.mZ);
+      readInt("max_particles", settings.mMaxParticles);
+      settings.mMaxParticles = std::max(settings.mMaxParticles, 0);
+      readFloat("spawn_rate", settings.mSpawnRate);
+      readBool("respawn", settings.mRespawn);
+      readBool("prewarm", settings.mPrewarm);
+      readFloat("lifetime_min", settings.mLifetimeMin);
+      readFloat("lifetime_max", settings.mLifetimeMax);
+      readFloat("velocity_min_x", settings.mVelocityMin.x);
+      readFloat("velocity_min_y", settings.mVelocityMin.y);
+      readFloat("velocity_max_x", settings.mVelocityMax.x);
+      readFloat("velocity_max_y", settings.mVelocityMax.y);
+      readFloat("acceleration_x", settings.mAcceleration.x);
+      readFloat("acceleration_y", settings.mAcceleration.y);
+      readFloat("rotation_min", settings.mRotationMin);
+      readFloat("rotation_max", settings.mRotationMax);
+      readFloat("rotation_speed_min", settings.mRotationSpeedMin);
+      readFloat("rotation_speed_max", settings.mRotationSpeedMax);
+      readFloat("size_min", settings.mSizeMin);
+      readFloat("size_max", settings.mSizeMax);
+      readFloat("quad_width", settings.mQuadSize.x);
+      readFloat("quad_height", settings.mQuadSize.y);
+      readBool("fade_out", settings.mFadeOut);
+      readBool("smooth", settings.mSmooth);
+
+      // keep particles inside the object's rectangle
+      auto bounded = false;
+      readBool("bounded", bounded);
+      if (bounded)
+      {
+         settings.mBounds = {0.0f, 0.0f, tmxObject->_width_px, tmxObject->_height_px};
+      }
+
+      if (const auto texture = readString("texture"); texture.has_value())
+      {
+         settings.mTexture = texture.value();
+      }
+
+      if (const auto color = readString("color"); color.has_value())
+      {
+         const auto rgba = TmxTools::color(color.value());
+         settings.mColor = sf::Color{rgba[0], rgba[1], rgba[2], rgba[3]};
+      }
+
+      if (const auto blendMode = readString("blend_mode"); blendMode.has_value())
+      {
+         settings.mBlendMode = (blendMode.value() == "alpha") ? sf::BlendAlpha : sf::BlendAdd;
+      }
+
+      if (const auto shape = readString("shape"); shape.has_value())
+      {
+         settings.mShape = (shape.value() == "line") ? Shape::Line : Shape::Quad;
+      }
+
+      if (const auto motion = readString("motion"); motion.has_value())
+      {
+         settings.mMotion = (motion.value() == "orbit") ? Motion::Orbit : Motion::Linear;
+      }
+   }
+
+   return std::make_shared<ParticleEmitter>(settings, sf::Vector2f{tmxObject->_x_px, tmxObject->_y_px});
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "framework/math/fastrandom.h"
+
+#include <SFML/Graphics.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+
+struct TmxObject;
+
+
+// a set of particles sharing the same settings and material
+//
+// particle data is stored as separate arrays per attribute so the update boils down to a
+// few tight loops over floats. dead particles are swapped with the last live one so the
+// live particles are always packed at the front of the arrays.
+class ParticleEmitter
+{
+
+public:
+
+   enum class Shape
+   {
+      Quad,   // textured (or plain colored) quad, size is the texture scale
+      Line    // line from the particle position along its velocity, size is the length factor
+   };
+
+   enum class Motion
+   {
+      Linear, // position integrates velocity and acceleration
+      Orbit   // particles circle their spawn point, velocity is the orbit radius
+   };
+
+   struct Settings
+   {
+      Shape mShape = Shape::Quad;
+      Motion mMotion = Motion::Linear;
+
+      int32_t mMaxParticles = 50;
+
+      //! continuous spawn rate in particles per second
+      float mSpawnRate = 0.0f;
+
+      //! dead particles are replaced immediately
+      bool mRespawn = false;
+
+      //! fill the emitter on construction, spread across the bounds if there are any
+      bool mPrewarm = false;
+
+      //! area new particles are spawned in, relative to the emitter position
+      sf::FloatRect mSpawnArea;
+
+      //! particles leaving the bounds die, an empty rect means no bounds
+      sf::FloatRect mBounds;
+
+      //! a lifetime of 0 means particles live until they leave the bounds
+      float mLifetimeMin = 0.0f;
+      float mLifetimeMax = 0.0f;
+
+      sf::Vector2f mVelocityMin;
+      sf::Vector2f mVelocityMax;
+      sf::Vector2f mAcceleration;
+
+      float mRotationMin = 0.0f;
+      float mRotationMax = 0.0f;
+      float mRotationSpeedMin = 0.0f;
+      float mRotationSpeedMax = 0.0f;
+
+      float mSizeMin = 1.0f;
+      float mSizeMax = 1.0f;
+
+      sf::Color mColor = sf::Color::White;
+      bool mFadeOut = false;
+
+      sf::BlendMode mBlendMode = sf::BlendAdd;
+      std::string mTexture;
+      bool mSmooth = false; // linear filtering for the texture
+      sf::Vector2f mQuadSize = {1.0f, 1.0f}; // used for untextured quads
+
+      int32_t mZ = 0;
+      uint32_t mSeed = 0; // 0 takes the seed from std::rand()
+   };
+
+   ParticleEmitter(const Settings& settings, const sf::Vector2f& position = {});
+
+   void update(const sf::Time& dt);
+   void append(sf::VertexArray& vertices) const;
+
+   //! spawn count particles around the given position
+   void burst(const sf::Vector2f& position, int32_t count);
+
+   void setPosition(const sf::Vector2f& position);
+
+   const Settings& getSettings() const;
+   const sf::Texture* getTexture() const;
+   sf::PrimitiveType getPrimitiveType() const;
+   sf::FloatRect getVisibleRect() const;
+   int32_t getParticleCount() const;
+
+   static std::shared_ptr<ParticleEmitter> deserialize(TmxObject* tmxObject, Settings settings);
+
+
+private:
+
+   void spawn(const sf::Vector2f& origin, const sf::FloatRect& area);
+   void kill(int32_t index);
+
+   Settings mSettings;
+   std::shared_ptr<sf::Texture> mTexture;
+   sf::Vector2f mTextureSize;
+
+   sf::Vector2f mPosition;
+   float mTime = 0.0f;
+   float mSpawnAccumulator = 0.0f;
+   FastRandom mRandom;
+
+   int32_t mCount = 0;
+
+   std::vector<float> mPositionX;
+   std::vector<float> mPositionY;
+   std::vector<float> mOriginX;
+   std::vector<float> mOriginY;
+   std::vector<float> mVelocityX;
+   std::vector<float> mVelocityY;
+   std::vector<float> mRotation;
+   std::vector<float> mRotationSpeed;
+   std::vector<float> mSize;
+   std::vector<float> mPhase;
+   std::vector<float> mAge;
+   std::vector<float> mLifetime;
+};
+
@@ -0,0 +1,93 @@
+#include "particlesystem.h"
+
+#include <algorithm>
+
+
+void ParticleSystem::add(const std::shared_ptr<ParticleEmitter>& emitter)
+{
+   mEmitters.push_back(emitter);
+}
+
+
+void ParticleSystem::clear()
+{
+   mEmitters.clear();
+   mBatches.clear();
+}
+
+
+void ParticleSystem::update(const sf::Time& dt)
+{
+   for (auto& emitter : mEmitters)
+   {
+      emitter->update(dt);
+   }
+}
+
+
+void ParticleSystem::draw(sf::RenderTarget& target, sf::RenderStates states) const
+{
+   drawEmitters(target, states, false, 0);
+}
+
+
+void ParticleSystem::drawToZ(sf::RenderTarget& target, int32_t z, sf::RenderStates states) const
+{
+   drawEmitters(target, states, true, z);
+}
+
+
+void ParticleSystem::drawEmitters(sf::RenderTarget& target, sf::RenderStates states, bool filterZ, int32_t z) const
+{
+   const auto& view = target.getView();
+   const sf::FloatRect viewRect{view.getCenter() - view.getSize() * 0.5f, view.getSize()};
+
+   for (auto& batch : mBatches)
+   {
+      batch.mVertices.clear();
+   }
+
+   for (const auto& emitter : mEmitters)
+   {
+      if (filterZ && emitter->getSettings().mZ != z)
+      {
+         continue;
+      }
+
+      if (emitter->getParticleCount() == 0 || !emitter->getVisibleRect().intersects(viewRect))
+      {
+         continue;
+      }
+
+      auto batch = std::find_if(mBatches.begin(), mBatches.end(), [&emitter](const auto& b){
+         return
+               b.mTexture == emitter->getTexture()
+            && b.mBlendMode == emitter->getSettings().mBlendMode
+            && b.mVertices.getPrimitiveType() == emitter->getPrimitiveType();
+      });
+
+      if (batch == mBatches.end())
+      {
+         Batch b;
+         b.mTexture = emitter->getTexture();
+         b.mBlendMode = emitter->getSettings().mBlendMode;
+         b.mVertices.setPrimitiveType(emitter->getPrimitiveType());
+         mBatches.push_back(b);
+         batch = mBatches.end() - 1;
+      }
+
+      emitter->append(batch->mVertices);
+   }
+
+   for (const auto& batch : mBatches)
+   {
+      if (batch.mVertices.getVertexCount() == 0)
+      {
+         continue;
+      }
+
+      states.texture = batch.mTexture;
+      states.blendMode = batch.mBlendMode;
+      target.draw(batch.mVertices, states);
+   }
+}
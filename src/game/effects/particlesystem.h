@@ -0,0 +1,43 @@
+#pragma once
+
+#include "particleemitter.h"
+
+#include <SFML/Graphics.hpp>
+
+#include <memory>
+#include <vector>
+
+
+// owns a set of particle emitters and draws them in batches
+//
+// all visible emitters on the same z layer that share a texture, blend mode and primitive
+// type are merged into a single vertex array and drawn with one draw call.
+class ParticleSystem
+{
+
+public:
+
+   void add(const std::shared_ptr<ParticleEmitter>& emitter);
+   void clear();
+
+   void update(const sf::Time& dt);
+
+   void draw(sf::RenderTarget& target, sf::RenderStates states = sf::RenderStates::Default) const;
+   void drawToZ(sf::RenderTarget& target, int32_t z, sf::RenderStates states = sf::RenderStates::Default) const;
+
+
+private:
+
+   struct Batch
+   {
+      const sf::Texture* mTexture = nullptr;
+      sf::BlendMode mBlendMode;
+      sf::VertexArray mVertices;
+   };
+
+   void drawEmitters(sf::RenderTarget& target, sf::RenderStates states, bool filterZ, int32_t z) const;
+
+   std::vector<std::shared_ptr<ParticleEmitter>> mEmitters;
+   mutable std::vector<Batch> mBatches;
+};
+
@@ -0,0 +1,207 @@
+#include "shadowquads.h"
+
+#include "constants.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <math.h>
+#include <vector>
+
+
+namespace
+{
+constexpr auto segments = 20;
+
+
+const std::array<b2Vec2, segments>& unitCircle()
+{
+   static const auto circle = []()
+   {
+      std::array<b2Vec2, segments> positions;
+
+      for (auto i = 0u; i < segments; i++)
+      {
+         auto angle = (2.0 * M_PI) * (i / static_cast<double>(segments));
+         positions[i] = b2Vec2{static_cast<float>(cos(angle)), static_cast<float>(sin(angle))};
+      }
+
+      return positions;
+   }();
+
+   return circle;
+}
+
+
+// chains report one proxy per edge, so fixtures are collected and made unique
+class FixtureQueryCallback : public b2QueryCallback
+{
+public:
+
+   bool ReportFixture(b2Fixture* fixture) override
+   {
+      mFixtures->push_back(fixture);
+      return true;
+   }
+
+   std::vector<b2Fixture*>* mFixtures = nullptr;
+};
+
+
+std::vector<b2Fixture*>& queryFixtures(b2World* world, const b2Vec2& center, float radius)
+{
+   // lights are drawn from the main thread only, the buffer keeps its capacity across lights
+   static std::vector<b2Fixture*> fixtures;
+   fixtures.clear();
+
+   FixtureQueryCallback callback;
+   callback.mFixtures = &fixtures;
+
+   b2AABB aabb;
+   aabb.lowerBound = center - b2Vec2{radius, radius};
+   aabb.upperBound = center + b2Vec2{radius, radius};
+   world->QueryAABB(&callback, aabb);
+
+   std::sort(fixtures.begin(), fixtures.end());
+   fixtures.erase(std::unique(fixtures.begin(), fixtures.end()), fixtures.end());
+
+   return fixtures;
+}
+
+
+void appendQuad(sf::VertexArray& quads, const b2Vec2& v0, const b2Vec2& v1, const b2Vec2& light_pos_m)
+{
+   auto v0far = 10000.0f * (v0 - light_pos_m);
+   auto v1far = 10000.0f * (v1 - light_pos_m);
+
+   quads.append(sf::Vertex(sf::Vector2f(v0.x, v0.y) * PPM, sf::Color::Black));
+   quads.append(sf::Vertex(sf::Vector2f(v0far.x, v0far.y) * PPM, sf::Color::Black));
+   quads.append(sf::Vertex(sf::Vector2f(v1far.x, v1far.y) * PPM, sf::Color::Black));
+   quads.append(sf::Vertex(sf::Vector2f(v1.x, v1.y) * PPM, sf::Color::Black));
+}
+}
+
+
+void ShadowQuads::append(
+   sf::VertexArray& quads,
+   b2World* world,
+   const b2Body* ignored_body,
+   const b2Vec2& light_pos_m,
+   float max_distance_m2
+)
+{
+   const auto& unit_circle = unitCircle();
+
+   // only fixtures whose broadphase bounds are close to the light are considered,
+   // inactive bodies have no proxies and are skipped along the way
+   auto& fixtures = queryFixtures(world, light_pos_m, std::sqrt(max_distance_m2));
+
+   for (auto f : fixtures)
+   {
+      auto b = f->GetBody();
+
+      if (b == ignored_body)
+      {
+         continue;
+      }
+
+      // if something doesn't collide, it probably shouldn't have any impact on lighting, too
+      if (f->IsSensor())
+      {
+         continue;
+      }
+
+      auto shape = f->GetShape();
+
+      switch (shape->GetType())
+      {
+         case b2Shape::e_circle:
+         {
+            auto shape_circle = static_cast<b2CircleShape*>(shape);
+
+            auto center = shape_circle->GetVertex(0) + b->GetTransform().p;
+            if ((light_pos_m - center).LengthSquared() > max_distance_m2)
+            {
+               continue;
+            }
+
+            std::array<b2Vec2, segments> circle_positions;
+            for (auto i = 0u; i < segments; i++)
+            {
+               circle_positions[i] = b2Vec2{
+                  center.x + unit_circle[i].x * shape_circle->m_radius * 1.2f,
+                  center.y + unit_circle[i].y * shape_circle->m_radius * 1.2f
+               };
+            }
+
+            for (auto pos_current = 0u; pos_current < circle_positions.size(); pos_current++)
+            {
+               auto pos_next = pos_current + 1;
+               if (pos_next == circle_positions.size())
+               {
+                  pos_next = 0;
+               }
+
+               appendQuad(quads, circle_positions[pos_current], circle_positions[pos_next], light_pos_m);
+            }
+            break;
+         }
+
+         case b2Shape::e_chain:
+         {
+            // for now it is assumed that chainshapes are static objects only.
+            // therefore no transform is applied to chainshape based objects.
+            auto shape_chain = static_cast<b2ChainShape*>(shape);
+
+            // loops repeat their first vertex at the end, so walking the child edges covers
+            // loops and open chains alike
+            for (auto pos_current = 0; pos_current < shape_chain->m_count - 1; pos_current++)
+            {
+               const auto& v0 = shape_chain->m_vertices[pos_current];
+               const auto& v1 = shape_chain->m_vertices[pos_current + 1];
+
+               if (
+                     (light_pos_m - v0).LengthSquared() > max_distance_m2
+                  && (light_pos_m - v1).LengthSquared() > max_distance_m2
+               )
+               {
+                  continue;
+               }
+
+               appendQuad(quads, v0, v1, light_pos_m);
+            }
+            break;
+         }
+
+         case b2Shape::e_polygon:
+         {
+            auto shape_polygon = static_cast<b2PolygonShape*>(shape);
+
+            for (auto pos_current = 0; pos_current < shape_polygon->GetVertexCount(); pos_current++)
+            {
+               auto pos_next = pos_current + 1;
+               if (pos_next == shape_polygon->GetVertexCount())
+               {
+                  pos_next = 0;
+               }
+
+               auto v0 = shape_polygon->GetVertex(pos_current) + b->GetTransform().p;
+
+               if ((light_pos_m - v0).LengthSquared() > max_distance_m2)
+               {
+                  continue;
+               }
+
+               auto v1 = shape_polygon->GetVertex(pos_next) + b->GetTransform().p;
+               appendQuad(quads, v0, v1, light_pos_m);
+            }
+            break;
+         }
+
+         default:
+         {
+            break;
+         }
+      }
+   }
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <Box2D/Box2D.h>
+#include <SFML/Graphics.hpp>
+
+
+// shadow volumes for the light system
+//
+// every edge of every non-sensor fixture close to the light is extruded away from the
+// light into a black quad. all quads of a light are collected in one vertex array so
+// they can be rendered into the stencil buffer with a single draw call.
+namespace ShadowQuads
+{
+   void append(
+      sf::VertexArray& quads,
+      b2World* world,
+      const b2Body* ignored_body,
+      const b2Vec2& light_pos_m,
+      float max_distance_m2
+   );
+}
+
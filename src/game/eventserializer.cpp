@@ -1,7 +1,12 @@
 #include "eventserializer.h"
 
+#include "console.h"
+#include "framework/tools/globalclock.h"
+#include "gameclock.h"
 #include "gamestate.h"
 
+#include <cstdlib>
+#include <ctime>
 #include <iostream>
 #include <ostream>
 #include <fstream>
@@ -14,6 +19,9 @@ using HighResDuration = std::chrono::high_resolution_clock::duration;
 using HighResTimePoint = std::chrono::high_resolution_clock::time_point;
 using HighResClockRep = std::chrono::high_resolution_clock::rep;
 using HighResClock = std::chrono::high_resolution_clock;
+
+constexpr int32_t replay_magic = 0x594c5052; // "RPLY"
+constexpr int32_t replay_version = 1;
 }
 
 
@@ -31,6 +39,20 @@ int32_t readInt32(std::istream& stream)
 }
 
 
+void writeInt64(std::ostream& stream, int64_t value)
+{
+   stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+
+int64_t readInt64(std::istream& stream)
+{
+   int64_t value = 0;
+   stream.read(reinterpret_cast<char*>(&value), sizeof(value));
+   return value;
+}
+
+
 void writeUInt8(std::ostream& stream, uint8_t value)
 {
    stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
@@ -80,6 +102,11 @@ HighResDuration readDuration(std::istream& stream)
 
 void EventSerializer::add(const sf::Event& event)
 {
+   if (_replay_state == ReplayState::Recording && _ticking && filterReplayEvents(event))
+   {
+      _replay_events.push_back({_tick, event});
+   }
+
    if (!isEnabled())
    {
       return;
@@ -307,6 +334,257 @@ bool EventSerializer::filterMovementEvents(const sf::Event& event)
 }
 
 
+bool EventSerializer::filterReplayEvents(const sf::Event& event)
+{
+   if (event.type != sf::Event::EventType::KeyPressed && event.type != sf::Event::EventType::KeyReleased)
+   {
+      return false;
+   }
+
+   if (GameState::getInstance().getMode() != ExecutionMode::Running)
+   {
+      return false;
+   }
+
+   // keystrokes that go to the console must not end up in the replay
+   if (Console::getInstance().isActive() || event.key.code == sf::Keyboard::F12)
+   {
+      return false;
+   }
+
+   return true;
+}
+
+
+void EventSerializer::startRecording(uint32_t level_index, uint32_t checkpoint)
+{
+   stopReplay();
+
+   _replay_header = {};
+   _replay_header._seed = static_cast<uint32_t>(std::time(nullptr));
+   _replay_header._level_index = level_index;
+   _replay_header._checkpoint = checkpoint;
+   _replay_events.clear();
+
+   // the level is loaded with the same seed as well
+   std::srand(_replay_header._seed);
+
+   _replay_state = ReplayState::Recording;
+}
+
+
+bool EventSerializer::startPlayback()
+{
+   stopReplay();
+
+   if (_replay_header._tick_count == 0)
+   {
+      std::cerr << "no replay loaded" << std::endl;
+      return false;
+   }
+
+   std::srand(_replay_header._seed);
+
+   _replay_state = ReplayState::Playing;
+   return true;
+}
+
+
+void EventSerializer::stopReplay()
+{
+   if (_replay_state == ReplayState::Recording && _ticking)
+   {
+      _replay_header._tick_count = _tick;
+      std::cout << "recorded " << _replay_events.size() << " events in " << _tick << " ticks" << std::endl;
+   }
+
+   if (_ticking)
+   {
+      GlobalClock::getInstance()->setSimulated(false);
+   }
+
+   _replay_state = ReplayState::Idle;
+   _replay_index = 0;
+   _tick = 0;
+   _ticking = false;
+}
+
+
+bool EventSerializer::saveReplay(const std::string& filename)
+{
+   if (_replay_state == ReplayState::Recording)
+   {
+      stopReplay();
+   }
+
+   if (_replay_header._tick_count == 0)
+   {
+      return false;
+   }
+
+   std::ofstream out(filename, std::ios::out | std::ios::binary);
+   if (!out)
+   {
+      std::cerr << "unable to write replay to " << filename << std::endl;
+      return false;
+   }
+
+   writeInt32(out, replay_magic);
+   writeInt32(out, replay_version);
+   writeInt32(out, static_cast<int32_t>(_replay_header._seed));
+   writeInt32(out, static_cast<int32_t>(_replay_header._level_index));
+   writeInt32(out, static_cast<int32_t>(_replay_header._checkpoint));
+   writeInt32(out, static_cast<int32_t>(_replay_header._tick_count));
+   writeInt32(out, _replay_header._tick_duration_us);
+   writeInt64(out, _replay_header._start_time_us);
+   writeInt32(out, static_cast<int32_t>(_replay_events.size()));
+
+   for (const auto& event : _replay_events)
+   {
+      writeInt32(out, static_cast<int32_t>(event._tick));
+      writeEvent(out, event._event);
+   }
+
+   std::cout << "saved replay with " << _replay_events.size() << " events to " << filename << std::endl;
+   return true;
+}
+
+
+bool EventSerializer::loadReplay(const std::string& filename)
+{
+   stopReplay();
+
+   std::ifstream in(filename, std::ios::in | std::ios::binary);
+   if (!in)
+   {
+      std::cerr << "unable to read replay from " << filename << std::endl;
+      return false;
+   }
+
+   if (readInt32(in) != replay_magic || readInt32(in) != replay_version)
+   {
+      std::cerr << filename << " is not a supported replay" << std::endl;
+      return false;
+   }
+
+   _replay_header._seed = static_cast<uint32_t>(readInt32(in));
+   _replay_header._level_index = static_cast<uint32_t>(readInt32(in));
+   _replay_header._checkpoint = static_cast<uint32_t>(readInt32(in));
+   _replay_header._tick_count = static_cast<uint32_t>(readInt32(in));
+   _replay_header._tick_duration_us = readInt32(in);
+   _replay_header._start_time_us = readInt64(in);
+
+   const auto size = readInt32(in);
+
+   _replay_events.clear();
+   for (auto i = 0; i < size && in.good(); i++)
+   {
+      const auto tick = static_cast<uint32_t>(readInt32(in));
+      const auto event = readEvent(in);
+      _replay_events.push_back({tick, event});
+   }
+
+   if (!in.good() || _replay_header._tick_duration_us <= 0)
+   {
+      std::cerr << filename << " is truncated" << std::endl;
+      _replay_header = {};
+      _replay_events.clear();
+      return false;
+   }
+
+   return true;
+}
+
+
+void EventSerializer::beginTick()
+{
+   if (_replay_state == ReplayState::Idle)
+   {
+      return;
+   }
+
+   if (!_ticking)
+   {
+      // first tick, from now on everything time or random based is derived from the header
+      if (_replay_state == ReplayState::Recording)
+      {
+         _replay_header._start_time_us = GlobalClock::getInstance()->getElapsedTime().asMicroseconds();
+      }
+
+      std::srand(_replay_header._seed);
+      GlobalClock::getInstance()->setSimulated(true, sf::microseconds(_replay_header._start_time_us));
+      GameClock::getInstance().reset();
+
+      _ticking = true;
+   }
+
+   if (_replay_state != ReplayState::Playing)
+   {
+      return;
+   }
+
+   while (_replay_index < _replay_events.size() && _replay_events[_replay_index]._tick <= _tick)
+   {
+      _callback(_replay_events[_replay_index]._event);
+      _replay_index++;
+   }
+}
+
+
+void EventSerializer::endTick()
+{
+   if (!_ticking)
+   {
+      return;
+   }
+
+   GlobalClock::getInstance()->advance(getTickDuration());
+   _tick++;
+
+   if (_replay_state == ReplayState::Playing && _tick >= _replay_header._tick_count)
+   {
+      std::cout << "replay finished after " << _tick << " ticks" << std::endl;
+      stopReplay();
+   }
+}
+
+
+EventSerializer::ReplayState EventSerializer::getReplayState() const
+{
+   return _replay_state;
+}
+
+
+bool EventSerializer::isReplayActive() const
+{
+   return _replay_state != ReplayState::Idle;
+}
+
+
+bool EventSerializer::isPlayingReplay() const
+{
+   return _replay_state == ReplayState::Playing;
+}
+
+
+uint32_t EventSerializer::getTick() const
+{
+   return _tick;
+}
+
+
+sf::Time EventSerializer::getTickDuration() const
+{
+   return sf::microseconds(_replay_header._tick_duration_us);
+}
+
+
+const EventSerializer::ReplayHeader& EventSerializer::getReplayHeader() const
+{
+   return _replay_header;
+}
+
+
 void EventSerializer::setEnabled(bool enabled)
 {
    _enabled = enabled;
@@ -3,9 +3,11 @@
 #include <SFML/Graphics.hpp>
 
 #include <chrono>
+#include <cstdint>
 #include <functional>
 #include <future>
 #include <optional>
+#include <string>
 #include <thread>
 #include <vector>
 
@@ -39,6 +41,37 @@ class EventSerializer
 
       using EventCallback = std::function<void(const sf::Event& event)>;
 
+      // frame-indexed replay
+      //
+      // unlike play(), which feeds the recorded events from another thread based on wall
+      // clock time, a replay stores the simulation tick each event belongs to. the game
+      // loop calls beginTick() and endTick() around every simulation step on the main
+      // thread, runs the step with the fixed tick duration and lets the global clock
+      // advance by exactly one tick. together with the rng seed and the level/checkpoint
+      // the recording starts from, playing a replay back drives the same run again.
+      enum class ReplayState
+      {
+         Idle,
+         Recording,
+         Playing
+      };
+
+      struct ReplayHeader
+      {
+         uint32_t _seed = 0;
+         uint32_t _level_index = 0;
+         uint32_t _checkpoint = 0;
+         uint32_t _tick_count = 0;
+         int32_t _tick_duration_us = 16667;
+         int64_t _start_time_us = 0;
+      };
+
+      struct TickEvent
+      {
+         uint32_t _tick = 0;
+         sf::Event _event;
+      };
+
       void add(const sf::Event& event);
       void clear();
 
@@ -57,6 +90,30 @@ class EventSerializer
       bool isEnabled() const;
       void setEnabled(bool enabled);
 
+      //! arm a recording, the first tick starts once the given level is loaded
+      void startRecording(uint32_t level_index, uint32_t checkpoint);
+
+      //! arm playback of the loaded replay, the caller has to reload the level from the header
+      bool startPlayback();
+
+      void stopReplay();
+
+      bool saveReplay(const std::string& filename = "replay.dat");
+      bool loadReplay(const std::string& filename = "replay.dat");
+
+      //! to be called before each simulation step, injects the events of the current tick through the callback
+      void beginTick();
+
+      //! to be called after each simulation step
+      void endTick();
+
+      ReplayState getReplayState() const;
+      bool isReplayActive() const;
+      bool isPlayingReplay() const;
+      uint32_t getTick() const;
+      sf::Time getTickDuration() const;
+      const ReplayHeader& getReplayHeader() const;
+
       static EventSerializer& getInstance();
 
 
@@ -66,6 +123,7 @@ class EventSerializer
 
       void playThread();
       bool filterMovementEvents(const sf::Event& event);
+      bool filterReplayEvents(const sf::Event& event);
 
       std::optional<size_t> _max_size;
       std::vector<ChronoEvent> _events;
@@ -74,5 +132,12 @@ class EventSerializer
       bool _enabled = false;
 
       EventCallback _callback;
+
+      ReplayState _replay_state = ReplayState::Idle;
+      ReplayHeader _replay_header;
+      std::vector<TickEvent> _replay_events;
+      size_t _replay_index = 0;
+      uint32_t _tick = 0;
+      bool _ticking = false;
 };
 
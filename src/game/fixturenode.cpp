@@ -22,28 +22,53 @@ void FixtureNode::setType(const ObjectType& type)
 }
 
 
+void FixtureNode::setFlag(PropertyKey::Key flag, bool value)
+{
+   _flags.set(flag, value);
+}
+
+
 void FixtureNode::setFlag(const std::string& flag, bool value)
 {
-   _flags[flag]=value;
+   _flags.set(flag, value);
+}
+
+
+bool FixtureNode::hasFlag(PropertyKey::Key flag) const
+{
+   const auto value = _flags.find(flag);
+   return value && *value;
 }
 
 
-bool FixtureNode::hasFlag(const std::string& flag)
+bool FixtureNode::hasFlag(const std::string& flag) const
 {
-   bool value = _flags[flag];
-   return value;
+   return hasFlag(PropertyKey::find(flag));
+}
+
+
+void FixtureNode::setProperty(PropertyKey::Key key, const Variant& value)
+{
+   _properties.set(key, value);
 }
 
 
 void FixtureNode::setProperty(const std::string& key, const Variant& value)
 {
-    _properties[key] = value;
+   _properties.set(key, value);
+}
+
+
+FixtureNode::Variant FixtureNode::getProperty(PropertyKey::Key key) const
+{
+   const auto value = _properties.find(key);
+   return value ? *value : Variant{};
 }
 
 
 FixtureNode::Variant FixtureNode::getProperty(const std::string& key) const
 {
-   return _properties.find(key)->second;
+   return getProperty(PropertyKey::find(key));
 }
 
 
@@ -2,9 +2,9 @@
 
 #include "constants.h"
 #include "gamenode.h"
+#include "propertytable.h"
 
 #include <functional>
-#include <map>
 #include <memory>
 #include <string>
 #include <variant>
@@ -22,10 +22,14 @@ class FixtureNode : public GameNode
       ObjectType getType() const;
       void setType(const ObjectType &type);
 
+      void setFlag(PropertyKey::Key flag, bool value);
       void setFlag(const std::string& flag, bool value);
-      bool hasFlag(const std::string& flag);
+      bool hasFlag(PropertyKey::Key flag) const;
+      bool hasFlag(const std::string& flag) const;
 
+      void setProperty(PropertyKey::Key key, const Variant& value);
       void setProperty(const std::string& key, const Variant& value);
+      Variant getProperty(PropertyKey::Key key) const;
       Variant getProperty(const std::string& key) const;
 
       virtual void collisionWithPlayer();
@@ -35,8 +39,8 @@ class FixtureNode : public GameNode
    protected:
 
       ObjectType _type;
-      std::map<std::string, bool> _flags;
-      std::map<std::string, Variant> _properties;
+      PropertyTable<bool> _flags;
+      PropertyTable<Variant> _properties;
       CollisionCallback _collision_callback;
 };
 
@@ -9,8 +9,10 @@
 #include "eventserializer.h"
 #include "fadetransitioneffect.h"
 #include "framework/joystick/gamecontroller.h"
+#include "framework/tools/allocationtracker.h"
 #include "framework/tools/callbackmap.h"
 #include "framework/tools/globalclock.h"
+#include "framework/tools/profiler.h"
 #include "framework/tools/timer.h"
 #include "gameclock.h"
 #include "gameconfiguration.h"
@@ -289,9 +291,9 @@ void Game::loadLevel()
 
          std::cout << "[x] level loading finished" << std::endl;
 
-         _level_loading_finished = true;
-
          GameClock::getInstance().reset();
+
+         _level_loading_finished = true;
       }
    );
 }
@@ -322,6 +324,9 @@ Game::~Game()
 //----------------------------------------------------------------------------------------------------------------------
 void Game::initialize()
 {
+   // seeded once, replays reseed with the seed stored in the recording
+   std::srand(static_cast<uint32_t>(std::time(nullptr)));
+
    initializeController();
 
    _player = std::make_shared<Player>();
@@ -402,6 +407,8 @@ void Game::initialize()
 //----------------------------------------------------------------------------------------------------------------------
 void Game::draw()
 {
+   PROFILE_SCOPE("Game::draw");
+
    _fps++;
 
    _window_render_texture->clear();
@@ -448,6 +455,13 @@ void Game::draw()
       _info_layer->drawConsole(*_window_render_texture.get());
    }
 
+#ifndef RELEASE_BUILD
+   if (DisplayMode::getInstance().isSet(Display::DisplayProfiler))
+   {
+      _info_layer->drawProfiler(*_window_render_texture.get());
+   }
+#endif
+
    if (_draw_states._draw_camera_system)
    {
       DebugDraw::debugCameraSystem(*_window_render_texture.get());
@@ -677,7 +691,9 @@ void Game::updateGameState(const sf::Time& dt)
 //----------------------------------------------------------------------------------------------------------------------
 void Game::update()
 {
-   const auto dt = _delta_clock.getElapsedTime();
+   PROFILE_SCOPE("Game::update");
+
+   auto dt = _delta_clock.getElapsedTime();
    _delta_clock.restart();
 
    Audio::getInstance()->updateMusic();
@@ -709,16 +725,46 @@ void Game::update()
    }
    else if (GameState::getInstance().getMode() == ExecutionMode::Running)
    {
-      Timer::update();
+      if (!_level_loading_finished || !EventSerializer::getInstance().isReplayActive())
+      {
+         Timer::update();
+      }
 
       if (_level_loading_finished)
       {
+         // replays run with a fixed step and take their input from the recording
+         auto& replay = EventSerializer::getInstance();
+         const auto replay_active = replay.isReplayActive();
+
+         if (replay_active)
+         {
+            if (replay.getTick() == 0)
+            {
+               _player->getControls().setKeysPressed(0);
+            }
+
+            dt = replay.getTickDuration();
+            replay.beginTick();
+            Timer::update();
+         }
+
          AnimationPool::getInstance().updateAnimations(dt);
          Projectile::update(dt);
-         updateGameController();
-         updateGameControllerForGame();
+
+         if (!replay.isPlayingReplay())
+         {
+            updateGameController();
+            updateGameControllerForGame();
+         }
+
          _level->update(dt);
-         _player->update(dt);
+
+         {
+            PROFILE_SCOPE("Player::update");
+            _player->update(dt);
+         }
+
+         Audio::getInstance()->setListenerPosition(_player->getPixelPositionf());
 
          if (_draw_states._draw_test_scene)
          {
@@ -732,6 +778,11 @@ void Game::update()
 
          // this might trigger level-reloading, so this ought to be the last drawing call in the loop
          updateGameState(dt);
+
+         if (replay_active)
+         {
+            replay.endTick();
+         }
       }
    }
 
@@ -748,6 +799,9 @@ int Game::loop()
       processEvents();
       update();
       draw();
+
+      AllocationTracker::endFrame();
+      PROFILE_FRAME();
    }
 
    return 0;
@@ -961,6 +1015,13 @@ void Game::processKeyPressedEvents(const sf::Event& event)
          Player::getCurrent()->getPlayerAnimation().toggleVersion();
          break;
       }
+#ifndef RELEASE_BUILD
+      case sf::Keyboard::F8:
+      {
+         DisplayMode::getInstance().enqueueToggle(Display::DisplayProfiler);
+         break;
+      }
+#endif
       case sf::Keyboard::F12:
       {
          _draw_states._draw_console = !_draw_states._draw_console;
@@ -1129,6 +1190,20 @@ void Game::processEvents()
    sf::Event event;
    while (_window->pollEvent(event))
    {
+      // while a replay is played back the keyboard belongs to the replay, any key aborts it
+      if (
+            EventSerializer::getInstance().isPlayingReplay()
+         && (event.type == sf::Event::KeyPressed || event.type == sf::Event::KeyReleased)
+      )
+      {
+         if (event.type == sf::Event::KeyPressed)
+         {
+            EventSerializer::getInstance().stopReplay();
+         }
+
+         continue;
+      }
+
       processEvent(event);
 
       EventSerializer::getInstance().add(event);
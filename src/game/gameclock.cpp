@@ -1,5 +1,7 @@
 #include "gameclock.h"
 
+#include "framework/tools/globalclock.h"
+
 
 GameClock& GameClock::getInstance()
 {
@@ -10,13 +12,14 @@ GameClock& GameClock::getInstance()
 
 void GameClock::reset()
 {
-   _start_time = std::chrono::high_resolution_clock::now();
+   // based on the global clock so replays see the same durations
+   _start_time = GlobalClock::getInstance()->getElapsedTime();
 }
 
 
 GameClock::HighResDuration GameClock::duration() const
 {
-   const auto now = std::chrono::high_resolution_clock::now();
-   return now - _start_time;
+   const auto elapsed = GlobalClock::getInstance()->getElapsedTime() - _start_time;
+   return std::chrono::duration_cast<HighResDuration>(std::chrono::microseconds(elapsed.asMicroseconds()));
 }
 
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <SFML/System/Time.hpp>
+
 #include <chrono>
 
 class GameClock
@@ -17,6 +19,6 @@ public:
 private:
 
    GameClock() = default;
-   HighResTimePoint _start_time;
+   sf::Time _start_time;
 };
 
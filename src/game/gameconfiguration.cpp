@@ -30,10 +30,12 @@ std::string GameConfiguration::serialize()
             {"fullscreen",        mFullscreen},
             {"brightness",        mBrightness},
             {"vsync",             mVSync},
+            {"dynamic_resolution", mDynamicResolution},
 
             {"audio_volume_master", mAudioVolumeMaster},
             {"audio_volume_sfx",    mAudioVolumeSfx},
             {"audio_volume_music",  mAudioVolumeMusic},
+            {"audio_voice_count",   mAudioVoiceCount},
          }
       }
    };
@@ -56,6 +58,7 @@ void GameConfiguration::deserialize(const std::string& data)
        mFullscreen      = config["GameConfiguration"]["fullscreen"].get<bool>();
        mBrightness      = config["GameConfiguration"]["brightness"].get<float>();
        mVSync           = config["GameConfiguration"]["vsync"].get<bool>();
+       mDynamicResolution = config["GameConfiguration"].value("dynamic_resolution", mDynamicResolution);
 
        mViewScaleWidth = static_cast<float>(mViewWidth) / static_cast<float>(mVideoModeWidth);
        mViewScaleHeight = static_cast<float>(mViewHeight) / static_cast<float>(mVideoModeHeight);
@@ -63,6 +66,7 @@ void GameConfiguration::deserialize(const std::string& data)
        mAudioVolumeMaster = config["GameConfiguration"]["audio_volume_master"].get<int32_t>();
        mAudioVolumeSfx    = config["GameConfiguration"]["audio_volume_sfx"].get<int32_t>();
        mAudioVolumeMusic  = config["GameConfiguration"]["audio_volume_music"].get<int32_t>();
+       mAudioVoiceCount   = config["GameConfiguration"].value("audio_voice_count", mAudioVoiceCount);
    }
    catch (const std::exception& e)
    {
@@ -14,10 +14,12 @@ struct GameConfiguration
    float mViewScaleHeight = 1.0f;
    float mBrightness = 0.5f;
    bool mVSync = false;
+   bool mDynamicResolution = false;
 
    int32_t mAudioVolumeMaster = 50;
    int32_t mAudioVolumeSfx = 50;
    int32_t mAudioVolumeMusic = 50;
+   int32_t mAudioVoiceCount = 32;
 
    void deserializeFromFile(const std::string& filename = "data/config/game.json");
    void serializeToFile(const std::string& filename = "data/config/game.json");
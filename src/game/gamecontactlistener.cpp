@@ -67,7 +67,7 @@ void GameContactListener::processOneSidedWalls(b2Contact* contact, b2Fixture* pl
 
    // if the head bounces against the one-sided wall, disable the contact
    // until there is no more contact with the head (EndContact)
-   if (playerFixture != nullptr && (static_cast<FixtureNode*>(playerFixture->GetUserData()))->hasFlag("head"))
+   if (playerFixture != nullptr && (static_cast<FixtureNode*>(playerFixture->GetUserData()))->hasFlag(PropertyKey::Head))
    {
       contact->SetEnabled(false);
    }
@@ -160,7 +160,7 @@ void GameContactListener::BeginContact(b2Contact* contact)
          }
          case ObjectTypeProjectile:
          {
-            auto damage = std::get<int32_t>(fixtureNodeA->getProperty("damage"));
+            auto damage = std::get<int32_t>(fixtureNodeA->getProperty(PropertyKey::Damage));
 
             if (isPlayer(fixtureNodeB))
             {
@@ -233,7 +233,7 @@ void GameContactListener::BeginContact(b2Contact* contact)
             if (isPlayer(fixtureNodeB))
             {
                // printf("collision with enemy\n");
-               auto damage = std::get<int32_t>(fixtureNodeA->getProperty("damage"));
+               auto damage = std::get<int32_t>(fixtureNodeA->getProperty(PropertyKey::Damage));
                fixtureNodeA->collisionWithPlayer();
                Player::getCurrent()->damage(damage);
                break;
@@ -307,7 +307,7 @@ void GameContactListener::BeginContact(b2Contact* contact)
          }
          case ObjectTypeProjectile:
          {
-            auto damage = std::get<int32_t>(fixtureNodeB->getProperty("damage"));
+            auto damage = std::get<int32_t>(fixtureNodeB->getProperty(PropertyKey::Damage));
 
             if (isPlayer(fixtureNodeA))
             {
@@ -380,7 +380,7 @@ void GameContactListener::BeginContact(b2Contact* contact)
             if (isPlayer(fixtureNodeA))
             {
                // printf("collision with enemy\n");
-               auto damage = std::get<int32_t>(fixtureNodeB->getProperty("damage"));
+               auto damage = std::get<int32_t>(fixtureNodeB->getProperty(PropertyKey::Damage));
                fixtureNodeB->collisionWithPlayer();
                Player::getCurrent()->damage(damage);
                break;
@@ -33,3 +33,21 @@ void GameMechanism::setEnabled(bool enabled)
 {
    mEnabled = enabled;
 }
+
+
+std::vector<b2Body*> GameMechanism::getBodies() const
+{
+   return {};
+}
+
+
+bool GameMechanism::isSimulated() const
+{
+   return mSimulated;
+}
+
+
+void GameMechanism::setSimulated(bool simulated)
+{
+   mSimulated = simulated;
+}
@@ -5,7 +5,9 @@
 #include "SFML/Graphics.hpp"
 
 #include <cstdint>
+#include <vector>
 
+class b2Body;
 
 class GameMechanism
 {
@@ -23,11 +25,18 @@ class GameMechanism
       virtual int32_t getZ() const;
       virtual void setZ(const int32_t& z);
 
+      //! bodies owned by the mechanism, mechanisms returning none are always simulated
+      virtual std::vector<b2Body*> getBodies() const;
+
+      bool isSimulated() const;
+      void setSimulated(bool simulated);
+
 
    protected:
 
       int32_t mZ = 0;
       bool mEnabled = true;
+      bool mSimulated = true;
       MechanismVersion mVersion = MechanismVersion::Version1;
 };
 
@@ -4,16 +4,35 @@
 #include "console.h"
 #include "extratable.h"
 #include "gameconfiguration.h"
+#include "level.h"
 #include "framework/image/psd.h"
 #include "framework/tools/globalclock.h"
+#include "framework/tools/allocationtracker.h"
+#include "framework/tools/profiler.h"
 #include "player/player.h"
 #include "player/playerinfo.h"
 #include "savestate.h"
+#include "spatialquery.h"
 
+#include <iomanip>
 #include <iostream>
 #include <sstream>
 
 
+namespace
+{
+BitmapFont::Text& getText(std::vector<BitmapFont::Text>& texts, size_t index)
+{
+   if (index >= texts.size())
+   {
+      texts.resize(index + 1);
+   }
+
+   return texts[index];
+}
+}
+
+
 InfoLayer::InfoLayer()
 {
    mFont.load(
@@ -136,11 +155,58 @@ void InfoLayer::drawDebugInfo(sf::RenderTarget& window)
    sf::View view(sf::FloatRect(0.0f, 0.0f, static_cast<float>(w), static_cast<float>(h)));
    window.setView(view);
 
-   std::stringstream stream;
    auto pos = Player::getCurrent()->getPixelPositionf();
-   stream << "player pos: " << static_cast<int>(pos.x / PIXELS_PER_TILE) << ", " << static_cast<int>(pos.y / PIXELS_PER_TILE);
 
-   mFont.draw(window, mFont.getCoords(stream.str()), 510, 5);
+   // awake/active/total bodies, simulated/managed objects (state changes this frame)
+   char text[128];
+   snprintf(
+      text,
+      sizeof(text),
+      "player pos: %d, %d",
+      static_cast<int>(pos.x / PIXELS_PER_TILE),
+      static_cast<int>(pos.y / PIXELS_PER_TILE)
+   );
+
+   mFont.draw(window, mDebugText, text, 510, 5);
+
+   auto level = Level::getCurrentLevel();
+   if (!level)
+   {
+      return;
+   }
+
+   const auto s = level->getSimulationRegion().getStatistics();
+   const auto& q = SpatialQuery::getInstance().getStatistics();
+
+   snprintf(
+      text,
+      sizeof(text),
+      "bodies: %d/%d/%d, contacts: %d, proxies: %d, joints: %d, queries: %d (%d cached)",
+      s.mAwakeBodies,
+      s.mActiveBodies,
+      s.mBodies,
+      s.mContacts,
+      s.mProxies,
+      s.mJoints,
+      q.mQueries,
+      q.mCacheHits
+   );
+
+   mFont.draw(window, mWorldText, text, 5, h - 33);
+
+   snprintf(
+      text,
+      sizeof(text),
+      "objects: %d/%d (%d), step: %.2fms, solve: %.2fms, broadphase: %.2fms",
+      s.mSimulatedObjects,
+      s.mSimulatedObjects + s.mSleepingObjects,
+      s.mTransitions,
+      s.mProfile.step,
+      s.mProfile.solve,
+      s.mProfile.broadphase
+   );
+
+   mFont.draw(window, mSimulationText, text, 5, h - 19);
 }
 
 
@@ -157,23 +223,72 @@ void InfoLayer::drawConsole(sf::RenderTarget& window)
    const auto& commands = console.getLog();
 
    static const auto offset = 320;
-   auto y = 0;
+   auto y = 0u;
    for (auto it = commands.crbegin(); it != commands.crend(); ++it)
    {
-      mFont.draw(window, mFont.getCoords(*it), 5, offset - ( (y + 1) * 14));
+      mFont.draw(window, getText(mConsoleText, y), *it, 5, offset - ( (static_cast<int32_t>(y) + 1) * 14));
       y++;
    }
 
-   auto bitmapFont = mFont.getCoords(command);
-   mFont.draw(window, bitmapFont, 5, offset);
+   mFont.draw(window, mCommandText, command, 5, offset);
 
    // draw cursor
    auto elapsed = GlobalClock::getInstance()->getElapsedTime();
    if (static_cast<int32_t>(elapsed.asSeconds()) % 2 == 0)
    {
-      mFont.draw(window, mFont.getCoords("_"), mFont.mTextWidth + 5, offset);
+      mFont.draw(window, mCursorText, "_", mCommandText.mWidth + 5, offset);
+   }
+}
+
+
+#ifndef RELEASE_BUILD
+void InfoLayer::drawProfiler(sf::RenderTarget& window)
+{
+   auto w = GameConfiguration::getInstance().mViewWidth;
+   auto h = GameConfiguration::getInstance().mViewHeight;
+
+   sf::View view(sf::FloatRect(0.0f, 0.0f, static_cast<float>(w), static_cast<float>(h)));
+   window.setView(view);
+
+   auto line = 0u;
+   mFont.draw(window, getText(mProfilerText, line++), "scope: last, p50, p90, p99, max (ms)", 5, 5);
+
+   auto y = 19;
+   for (const auto& [name, s] : Profiler::getInstance().getStatistics())
+   {
+      std::ostringstream stream;
+      stream
+         << std::fixed << std::setprecision(2)
+         << name << ": " << s.mLast << ", " << s.mP50 << ", " << s.mP90 << ", " << s.mP99 << ", " << s.mMax;
+
+      mFont.draw(window, getText(mProfilerText, line++), stream.str(), 5, y);
+      y += 14;
+   }
+
+   if (!AllocationTracker::isEnabled())
+   {
+      return;
+   }
+
+   const auto frames = AllocationTracker::getFrameStatistics();
+
+   std::ostringstream header;
+   header << "allocations: last frame " << frames.mLastFrame << ", max " << frames.mMaxFrame << " (scope: last, max)";
+
+   y += 14;
+   mFont.draw(window, getText(mProfilerText, line++), header.str(), 5, y);
+   y += 14;
+
+   for (const auto& scope : AllocationTracker::getScopeStatistics())
+   {
+      std::ostringstream stream;
+      stream << scope.mName << ": " << scope.mLastFrame << ", " << scope.mMaxFrame;
+
+      mFont.draw(window, getText(mProfilerText, line++), stream.str(), 5, y);
+      y += 14;
    }
 }
+#endif
 
 
 void InfoLayer::setLoading(bool loading)
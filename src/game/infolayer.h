@@ -8,6 +8,7 @@
 #include <SFML/System.hpp>
 
 #include <memory>
+#include <vector>
 
 
 class InfoLayer
@@ -20,12 +21,25 @@ public:
    void drawDebugInfo(sf::RenderTarget& window);
    void drawConsole(sf::RenderTarget& window);
 
+#ifndef RELEASE_BUILD
+   void drawProfiler(sf::RenderTarget& window);
+#endif
+
    void setLoading(bool loading);
 
 private:
 
    BitmapFont mFont;
 
+   // text meshes, kept across frames so unchanged lines are not rebuilt
+   BitmapFont::Text mDebugText;
+   BitmapFont::Text mWorldText;
+   BitmapFont::Text mSimulationText;
+   BitmapFont::Text mCommandText;
+   BitmapFont::Text mCursorText;
+   std::vector<BitmapFont::Text> mConsoleText;
+   std::vector<BitmapFont::Text> mProfilerText;
+
    bool mLoading = false;
    sf::Time mShowTime;
 
@@ -15,6 +15,7 @@
 #include "framework/math/sfmlmath.h"
 #include "framework/tools/checksum.h"
 #include "framework/tools/globalclock.h"
+#include "framework/tools/profiler.h"
 #include "gameconfiguration.h"
 #include "gamecontactlistener.h"
 #include "leveldescription.h"
@@ -35,6 +36,7 @@
 #include "mechanisms/spikeball.h"
 #include "mechanisms/spikes.h"
 #include "meshtools.h"
+#include "physics/islandsolver.h"
 #include "physics/physicsconfiguration.h"
 #include "player/player.h"
 #include "savestate.h"
@@ -107,12 +109,6 @@ void Level::initializeTextures()
 {
    GameConfiguration& gameConfig = GameConfiguration::getInstance();
 
-   // since stencil buffers are used, it is required to enable them explicitly
-   sf::ContextSettings stencilContextSettings;
-   stencilContextSettings.stencilBits = 8;
-
-   mLevelBackgroundRenderTexture.reset();
-
    mAtmosphereShader.reset();
    mGammaShader.reset();
    mBlurShader.reset();
@@ -128,56 +124,28 @@ void Level::initializeTextures()
    const auto textureWidth = static_cast<int32_t>(sizeRatio * gameConfig.mViewWidth);
    const auto textureHeight = static_cast<int32_t>(sizeRatio * gameConfig.mViewHeight);
 
-   mLevelBackgroundRenderTexture = std::make_shared<sf::RenderTexture>();
-   mLevelBackgroundRenderTexture->create(
-      static_cast<uint32_t>(textureWidth),
-      static_cast<uint32_t>(textureHeight)
-   );
-
-   mLevelRenderTexture = std::make_shared<sf::RenderTexture>();
-   mLevelRenderTexture->create(
-      static_cast<uint32_t>(textureWidth),
-      static_cast<uint32_t>(textureHeight),
-      stencilContextSettings // the lights require stencils
-   );
+   // the render textures are created by the scheduler once a pass needs them
+   mRenderPasses.setSize(static_cast<uint32_t>(textureWidth), static_cast<uint32_t>(textureHeight));
 
-   mLightingTexture = std::make_shared<sf::RenderTexture>();
-   mLightingTexture->create(
-      static_cast<uint32_t>(textureWidth),
-      static_cast<uint32_t>(textureHeight),
-      stencilContextSettings // the lights require stencils
-   );
-
-   mNormalTexture = std::make_shared<sf::RenderTexture>();
-   mNormalTexture->create(
-      static_cast<uint32_t>(textureWidth),
-      static_cast<uint32_t>(textureHeight)
-   );
+   if (mLevelTarget < 0)
+   {
+      // the lights require stencils. the color buffers stay at native resolution, the
+      // atmosphere, normal and light maps may go down with dynamic resolution
+      mAtmosphereTarget = mRenderPasses.addTarget("atmosphere", false, true);
+      mBackgroundTarget = mRenderPasses.addTarget("level background");
+      mLevelTarget = mRenderPasses.addTarget("level", true);
+      mNormalTarget = mRenderPasses.addTarget("normal", false, true);
+      mLightTarget = mRenderPasses.addTarget("light", true, true);
+      mDeferredTarget = mRenderPasses.addTarget("deferred");
+   }
 
-   mDeferredTexture = std::make_shared<sf::RenderTexture>();
-   mDeferredTexture->create(
-      static_cast<uint32_t>(textureWidth),
-      static_cast<uint32_t>(textureHeight)
-   );
+   mDynamicResolution.setEnabled(gameConfig.mDynamicResolution);
 
-   mAtmosphereShader = std::make_unique<AtmosphereShader>(textureWidth, textureHeight);
+   mAtmosphereShader = std::make_unique<AtmosphereShader>();
    mGammaShader = std::make_unique<GammaShader>();
    mBlurShader = std::make_unique<BlurShader>(textureWidth, textureHeight);
    mDeathShader = std::make_unique<DeathShader>(textureWidth, textureHeight);
 
-   // keep track of those textures
-   mRenderTextures.clear();
-   mRenderTextures.push_back(mLevelRenderTexture);
-   mRenderTextures.push_back(mLevelBackgroundRenderTexture);
-   mRenderTextures.push_back(mLightingTexture);
-   mRenderTextures.push_back(mNormalTexture);
-   mRenderTextures.push_back(mDeferredTexture);
-
-   for (const auto& fb : mRenderTextures)
-   {
-      std::cout << "[x] created render texture: " << fb->getSize().x << " x " << fb->getSize().y << std::endl;
-   }
-
    mAtmosphereShader->initialize();
    mGammaShader->initialize();
    mBlurShader->initialize();
@@ -204,6 +172,13 @@ Level::Level()
    GameContactListener::getInstance()->reset();
    mWorld->SetContactListener(GameContactListener::getInstance());
 
+   if (PhysicsConfiguration::getInstance().mParallelIslands)
+   {
+      mWorld->SetSolverExecutor(&IslandSolver::getInstance());
+   }
+
+   mWorld->SetWideContactSolver(PhysicsConfiguration::getInstance().mWideContactSolver);
+
    sCurrentLevel = this;
 
    mLightSystem = std::make_shared<LightSystem>();
@@ -232,6 +207,13 @@ Level::Level()
       &mSpikeBalls,
       &mSpikes,
    };
+
+   addRoomChangedCallback([](const Room* /*previous*/, const Room* current){
+         std::cout << "[i] player moved to room: " << (current ? current->mName : "undefined") << std::endl;
+         CameraSystem::getCameraSystem().setRoom(current);
+         LuaInterface::instance()->playerEnteredRoom(current);
+      }
+   );
 }
 
 
@@ -240,6 +222,9 @@ Level::~Level()
 {
    std::cout << "[x] deleting current level" << std::endl;
 
+   // the camera points into mRooms, the next level might start outside of all rooms
+   CameraSystem::getCameraSystem().setRoom(nullptr);
+
    // properly delete point map
    for (auto& kv : mPointMap)
    {
@@ -454,7 +439,12 @@ void Level::loadTmx()
             else if (objectGroup->_name == "smoke")
             {
                auto smoke = SmokeEffect::deserialize(tmxObject, objectGroup);
-               mSmokeEffect.push_back(smoke);
+               mParticleSystem.add(smoke);
+            }
+            else if (objectGroup->_name == "particles")
+            {
+               auto emitter = ParticleEmitter::deserialize(tmxObject, {});
+               mParticleSystem.add(emitter);
             }
             else if (objectGroup->_name == "spike_balls")
             {
@@ -604,6 +594,8 @@ void Level::loadTmx()
    mMap->setDoors(mDoors);
    mMap->setPortals(mPortals);
 
+   mRoomIndex.build(mRooms);
+
    if (!mAtmosphere.mTileMap)
    {
       std::cerr << "[E] fatal: no physics layer (called 'physics') found!" << std::endl;
@@ -662,6 +654,29 @@ void Level::initialize()
    loadCheckpoint();
 
    spawnEnemies();
+
+   initializeSimulationRegion();
+}
+
+
+//-----------------------------------------------------------------------------
+void Level::initializeSimulationRegion()
+{
+   mSimulationRegion.clear();
+   mSimulationRegion.setWorld(mWorld);
+
+   for (auto mechanismVector : mMechanisms)
+   {
+      for (auto& mechanism : *mechanismVector)
+      {
+         mSimulationRegion.add(mechanism);
+      }
+   }
+
+   for (auto& enemy : mEnemies)
+   {
+      mSimulationRegion.add(enemy);
+   }
 }
 
 
@@ -724,7 +739,7 @@ void Level::spawnEnemies()
 
          if (jsonDescription.mGeneratePatrolPath)
          {
-            it->second.addPaths(mWorldChains);
+            it->second.addPaths(mStaticChains.getLoops());
          }
 
          if (!it->second.mPixelPath.empty())
@@ -763,7 +778,7 @@ void Level::spawnEnemies()
 
          if (jsonDescription.mGeneratePatrolPath)
          {
-            it.second.addPaths(mWorldChains);
+            it.second.addPaths(mStaticChains.getLoops());
          }
 
          if (!it.second.mPixelPath.empty())
@@ -865,19 +880,21 @@ void Level::updateCameraSystem(const sf::Time& dt)
 {
    auto& cameraSystem = CameraSystem::getCameraSystem();
 
-   // update room
-   mCurrentRoom = Room::find(Player::getCurrent()->getPixelPositionf(), mRooms);
-   const auto prevRoomId = mCurrentRoomId;
-   mCurrentRoomId = mCurrentRoom.has_value() ? mCurrentRoom->mId : -1;
+   // update room, the player mostly stays in the room it was in so that one is tested first
+   const auto playerPosition = Player::getCurrent()->getPixelPositionf();
+   const auto previousRoom = mCurrentRoom;
 
-   if (prevRoomId != mCurrentRoomId)
+   if (!mCurrentRoom || mCurrentRoom->findRect(playerPosition) == mCurrentRoom->mRects.end())
    {
-      std::cout
-         << "[i] player moved to room: "
-         << (mCurrentRoom.has_value() ? mCurrentRoom->mName : "undefined")
-         << std::endl;
+      mCurrentRoom = mRoomIndex.find(playerPosition);
+   }
 
-      cameraSystem.setRoom(mCurrentRoom);
+   if (previousRoom != mCurrentRoom)
+   {
+      for (const auto& callback : mRoomChangedCallbacks)
+      {
+         callback(previousRoom, mCurrentRoom);
+      }
    }
 
    // update camera system
@@ -885,6 +902,20 @@ void Level::updateCameraSystem(const sf::Time& dt)
 }
 
 
+//-----------------------------------------------------------------------------
+const Room* Level::getCurrentRoom() const
+{
+   return mCurrentRoom;
+}
+
+
+//-----------------------------------------------------------------------------
+void Level::addRoomChangedCallback(const RoomChangedCallback& callback)
+{
+   mRoomChangedCallbacks.push_back(callback);
+}
+
+
 //-----------------------------------------------------------------------------
 void Level::drawNormalMap()
 {
@@ -899,24 +930,23 @@ void Level::drawNormalMap()
    //   bump_map_save_counter++;
    //   if (bump_map_save_counter % 60 == 0)
    //   {
-   //      mNormalTexture->getTexture().copyToImage().saveToFile("normal_map.png");
+   //      normalTexture.getTexture().copyToImage().saveToFile("normal_map.png");
    //   }
 }
 
 
 //-----------------------------------------------------------------------------
-void Level::drawLightMap()
+void Level::drawLightMap(sf::RenderTarget& target)
 {
-   mLightingTexture->clear();
-   mLightingTexture->setView(*mLevelView);
-   mLightSystem->draw(*mLightingTexture, {});
-   mLightingTexture->display();
+   target.clear();
+   target.setView(*mLevelView);
+   mLightSystem->draw(target, {});
 
    //   static int32_t light_map_save_counter = 0;
    //   light_map_save_counter++;
    //   if (light_map_save_counter % 60 == 0)
    //   {
-   //      mLightingTexture->getTexture().copyToImage().saveToFile("light_map.png");
+   //      lightTexture.getTexture().copyToImage().saveToFile("light_map.png");
    //   }
 }
 
@@ -963,8 +993,8 @@ void Level::drawPlayer(sf::RenderTarget& color, sf::RenderTarget& normal)
          sf::FloatRect(
             0.0f,
             0.0f,
-            static_cast<float>(mLevelRenderTexture->getSize().x),
-            static_cast<float>(mLevelRenderTexture->getSize().y)
+            static_cast<float>(color.getSize().x),
+            static_cast<float>(color.getSize().y)
          )
       );
 
@@ -997,10 +1027,7 @@ void Level::drawLayers(
    {
       mStaticLight->drawToZ(target, {}, z);
 
-      for (const auto& smoke : mSmokeEffect)
-      {
-         smoke->drawToZ(target, {}, z);
-      }
+      mParticleSystem.drawToZ(target, z);
 
       // TODO: it's not expected that tiles are in different z layers
       //       and then unify them in one big loop
@@ -1019,7 +1046,7 @@ void Level::drawLayers(
          {
             if (mechanism->getZ() == z)
             {
-               mechanism->draw(target, *mNormalTexture.get());
+               mechanism->draw(target, normal);
             }
          }
       }
@@ -1039,7 +1066,7 @@ void Level::drawLayers(
          mAo.draw(target);
 
          // draw player
-         drawPlayer(target, *mNormalTexture.get());
+         drawPlayer(target, normal);
       }
 
       for (auto& layer : mImageLayers)
@@ -1132,19 +1159,19 @@ void Level::takeScreenshot(const std::string& basename, sf::RenderTexture& textu
 
 
 //----------------------------------------------------------------------------------------------------------------------
-void Level::drawDebugInformation()
+void Level::drawDebugInformation(sf::RenderTarget& target)
 {
    if (DisplayMode::getInstance().isSet(Display::DisplayDebug))
    {
-      drawStaticChains(*mLevelRenderTexture.get());
-      DebugDraw::debugBodies(*mLevelRenderTexture.get(), this);
-      DebugDraw::drawRect(*mLevelRenderTexture.get(), Player::getCurrent()->getPlayerPixelRect());
+      drawStaticChains(target);
+      DebugDraw::debugBodies(target, this);
+      DebugDraw::drawRect(target, Player::getCurrent()->getPlayerPixelRect());
 
       for (const auto& room : mRooms)
       {
          for (const auto& rect : room.mRects)
          {
-            DebugDraw::drawRect(*mLevelRenderTexture.get(), rect, sf::Color::Yellow);
+            DebugDraw::drawRect(target, rect, sf::Color::Yellow);
          }
       }
    }
@@ -1152,25 +1179,25 @@ void Level::drawDebugInformation()
 
 
 //-----------------------------------------------------------------------------
-void Level::displayTextures()
+void Level::displayTextures(sf::RenderTexture& color, sf::RenderTexture& normal)
 {
    // display the whole texture
    sf::View view(
       sf::FloatRect(
          0.0f,
          0.0f,
-         static_cast<float>(mLevelRenderTexture->getSize().x),
-         static_cast<float>(mLevelRenderTexture->getSize().y)
+         static_cast<float>(color.getSize().x),
+         static_cast<float>(color.getSize().y)
       )
    );
 
    view.setViewport(sf::FloatRect(0.0f, 0.0f, 1.0f, 1.0f));
 
-   mLevelRenderTexture->setView(view);
-   mLevelRenderTexture->display();
+   color.setView(view);
+   color.display();
 
-   mNormalTexture->setView(*mLevelView);
-   mNormalTexture->display();
+   normal.setView(*mLevelView);
+   normal.display();
 }
 
 
@@ -1185,7 +1212,7 @@ void Level::drawGlowLayer()
 }
 
 
-void Level::drawGlowSprite()
+void Level::drawGlowSprite([[maybe_unused]] sf::RenderTexture& target)
 {
 #ifdef GLOW_ENABLED
    sf::Sprite blurSprite(mBlurShader->getRenderTexture()->getTexture());
@@ -1211,7 +1238,8 @@ void Level::drawGlowSprite()
 
    sf::RenderStates statesAdd;
    statesAdd.blendMode = sf::BlendAdd;
-   mLevelRenderTexture->draw(blurScaleSprite, statesAdd);
+   target.setView(target.getDefaultView());
+   target.draw(blurScaleSprite, statesAdd);
 #endif
 }
 
@@ -1219,112 +1247,247 @@ void Level::drawGlowSprite()
 //-----------------------------------------------------------------------------
 // Level Rendering Flow
 //
-//    textures/render targets:
-//    - atmosphere texture
-//    - level background texture
-//    - level texture
+//    render targets (handed out by the render pass scheduler, see initializeTextures):
+//    - atmosphere
+//    - level background
+//    - level (color)
+//    - normal
+//    - light
+//    - deferred
 //    - window
 //
-//    01) draw atmosphere (air / water)                           -> atmosphere texture
-//    02) draw parallax info                                      -> level background texture
-//    03) draw level background with atmosphere shader enabled    -> background texture
+//    01) draw atmosphere (air / water)                           -> atmosphere
+//    02) draw parallax info                                      -> level background
+//    03) draw level background                                   -> level background, normal
 //        - layers z=0..15
-//    04) draw level background                                   -> level texture
-//    05) draw level foreground                                   -> level texture
+//    04) draw level background with atmosphere shader enabled    -> level
+//    05) draw level foreground                                   -> level, normal
 //        - layers z=16..50
 //        - additive lights
-//        - smoke (z=20)
+//        - particles (smoke defaults to z=20)
 //        - mechanisms
 //        - ambient occlusion
 //        - images with varying blend modes
 //        - player
-//    06) draw raycast lights                                     -> level texture
-//    07) draw projectiles                                        -> level texture
-//    08) flash and bounce -> move level texture
-//    09) draw level texture with gamma shader enabled            -> straight to window
+//        - projectiles
+//    06) draw raycast lights                                     -> light
+//    07) combine level, light and normal with the ambient color  -> deferred
+//    08) flash and bounce -> move deferred texture
+//    09) draw deferred texture with gamma shader enabled         -> straight to window
 //    10) draw level map (if enabled)                             -> straight to window
 //
+//    with dynamic resolution enabled atmosphere, normal and light are rendered at a lower
+//    resolution picked from the measured gpu time, the passes reading them upsample them.
+//
+//    passes nobody needs are dropped each frame:
+//    - without atmosphere tiles in view 01) and 04) are skipped, 03) draws into level
+//    - without active lights 06) is skipped
+//    - without active lights and with a neutral ambient color 07) is skipped as well,
+//      the gamma pass then reads the level texture
+//
 void Level::draw(
    const std::shared_ptr<sf::RenderTexture>& window,
    bool screenshot
 )
 {
+   PROFILE_SCOPE("Level::draw");
+
    mScreenshot = screenshot;
 
-   // render atmosphere to atmosphere texture, that texture is used in the shader only
-   mAtmosphereShader->getRenderTexture()->clear();
-   drawAtmosphereLayer(*mAtmosphereShader->getRenderTexture().get());
-   mAtmosphereShader->getRenderTexture()->display();
-   takeScreenshot("screenshot_atmosphere", *mAtmosphereShader->getRenderTexture().get());
-
-   // render glowing elements
-   drawGlowLayer();
-
-   // render layers affected by the atmosphere
-   mLevelBackgroundRenderTexture->clear();
-   mNormalTexture->clear();
-
-   drawParallaxMaps(*mLevelBackgroundRenderTexture.get());
-   drawLayers(
-      *mLevelBackgroundRenderTexture.get(),
-      *mNormalTexture.get(),
-      ZDepthBackgroundMin,
-      ZDepthBackgroundMax
+   mDynamicResolution.beginFrame();
+   mRenderPasses.setScale(mDynamicResolution.getScale());
+
+   const sf::FloatRect viewRect(
+      mLevelView->getCenter() - mLevelView->getSize() * 0.5f,
+      mLevelView->getSize()
    );
-   mLevelBackgroundRenderTexture->display();
-   takeScreenshot("screenshot_level_background", *mLevelBackgroundRenderTexture.get());
 
-   // draw the atmospheric parts into the level texture
-   sf::Sprite backgroundSprite(mLevelBackgroundRenderTexture->getTexture());
-   mAtmosphereShader->update();
-   mLevelRenderTexture->draw(backgroundSprite, &mAtmosphereShader->getShader());
+   const auto atmosphere = mAtmosphere.mTileMap && mAtmosphere.hasTilesInRect(viewRect);
+   const auto lights = mLightSystem->updateActiveLights();
+   const auto deferred = lights || !mLightSystem->hasNeutralAmbient();
+
+   // render atmosphere to atmosphere texture, that texture is used in the shader only
+   if (atmosphere)
+   {
+      RenderPassScheduler::Pass pass;
+      pass.mName = "Level::draw atmosphere";
+      pass.mWrites = {mAtmosphereTarget};
+      pass.mExecute = [this](){
+         // the shader compares the colors of the atmosphere tiles, blending them would blur
+         // the water surface into something else
+         auto& atmosphereTexture = mRenderPasses.getTexture(mAtmosphereTarget);
+         atmosphereTexture.setSmooth(false);
+         atmosphereTexture.clear();
+         drawAtmosphereLayer(atmosphereTexture);
+         atmosphereTexture.display();
+         takeScreenshot("screenshot_atmosphere", atmosphereTexture);
+      };
+
+      mRenderPasses.addPass(std::move(pass));
+   }
 
-   drawGlowSprite();
+   // render glowing elements and the layers affected by the atmosphere
+   {
+      const auto backgroundTarget = atmosphere ? mBackgroundTarget : mLevelTarget;
+
+      RenderPassScheduler::Pass pass;
+      pass.mName = "Level::draw background";
+      pass.mWrites = {backgroundTarget, mNormalTarget};
+      pass.mExecute = [this, atmosphere, backgroundTarget](){
+         drawGlowLayer();
+
+         auto& backgroundTexture = mRenderPasses.getTexture(backgroundTarget);
+         auto& normalTexture = mRenderPasses.getTexture(mNormalTarget);
+         backgroundTexture.clear();
+         normalTexture.clear();
+
+         drawParallaxMaps(backgroundTexture);
+         drawLayers(
+            backgroundTexture,
+            normalTexture,
+            ZDepthBackgroundMin,
+            ZDepthBackgroundMax
+         );
+
+         if (atmosphere)
+         {
+            backgroundTexture.display();
+            takeScreenshot("screenshot_level_background", backgroundTexture);
+         }
+      };
+
+      mRenderPasses.addPass(std::move(pass));
+   }
+
+   // draw the atmospheric parts into the level texture
+   if (atmosphere)
+   {
+      RenderPassScheduler::Pass pass;
+      pass.mName = "Level::draw atmosphere composite";
+      pass.mReads = {mBackgroundTarget, mAtmosphereTarget};
+      pass.mWrites = {mLevelTarget};
+      pass.mExecute = [this](){
+         auto& levelTexture = mRenderPasses.getTexture(mLevelTarget);
+         levelTexture.setView(levelTexture.getDefaultView());
+
+         sf::Sprite backgroundSprite(mRenderPasses.getTexture(mBackgroundTarget).getTexture());
+         mAtmosphereShader->setPhysicsTexture(mRenderPasses.getTexture(mAtmosphereTarget).getTexture());
+         mAtmosphereShader->update();
+         levelTexture.draw(backgroundSprite, &mAtmosphereShader->getShader());
+      };
+
+      mRenderPasses.addPass(std::move(pass));
+   }
 
    // draw the level layers into the level texture
-   drawLayers(
-      *mLevelRenderTexture.get(),
-      *mNormalTexture.get(),
-      ZDepthForegroundMin,
-      ZDepthForegroundMax
-   );
+   {
+      RenderPassScheduler::Pass pass;
+      pass.mName = "Level::draw foreground";
+      pass.mReads = {mLevelTarget};
+      pass.mWrites = {mLevelTarget, mNormalTarget};
+      pass.mExecute = [this](){
+         auto& levelTexture = mRenderPasses.getTexture(mLevelTarget);
+         auto& normalTexture = mRenderPasses.getTexture(mNormalTarget);
+
+         drawGlowSprite(levelTexture);
+
+         drawLayers(
+            levelTexture,
+            normalTexture,
+            ZDepthForegroundMin,
+            ZDepthForegroundMax
+         );
 
-   Weapon::drawProjectileHitAnimations(*mLevelRenderTexture.get());
-   AnimationPlayer::getInstance().draw(*mLevelRenderTexture.get());
+         Weapon::drawProjectileHitAnimations(levelTexture);
+         AnimationPlayer::getInstance().draw(levelTexture);
 
-   drawDebugInformation();
+         drawDebugInformation(levelTexture);
 
-   displayTextures();
+         displayTextures(levelTexture, normalTexture);
 
-   drawLightMap();
+         takeScreenshot("map_color",  levelTexture);
+         takeScreenshot("map_normal", normalTexture);
+      };
 
-   mLightSystem->draw(
-      *mDeferredTexture.get(),
-      mLevelRenderTexture,
-      mLightingTexture,
-      mNormalTexture
-   );
+      mRenderPasses.addPass(std::move(pass));
+   }
 
-   mDeferredTexture->display();
+   if (lights)
+   {
+      RenderPassScheduler::Pass pass;
+      pass.mName = "Level::draw light map";
+      pass.mWrites = {mLightTarget};
+      pass.mExecute = [this](){
+         auto& lightTexture = mRenderPasses.getTexture(mLightTarget);
+         drawLightMap(lightTexture);
+         lightTexture.display();
+         takeScreenshot("map_light", lightTexture);
+      };
+
+      mRenderPasses.addPass(std::move(pass));
+   }
 
-   takeScreenshot("map_color",    *mLevelRenderTexture.get());
-   takeScreenshot("map_light",    *mLightingTexture.get());
-   takeScreenshot("map_normal",   *mNormalTexture.get());
-   takeScreenshot("map_deferred", *mDeferredTexture.get());
+   if (deferred)
+   {
+      RenderPassScheduler::Pass pass;
+      pass.mName = "Level::draw lighting";
+      pass.mReads = {mLevelTarget};
+      pass.mWrites = {mDeferredTarget};
 
-   auto levelTextureSprite = sf::Sprite(mDeferredTexture->getTexture());
-   mGammaShader->setTexture(mDeferredTexture->getTexture());
+      if (lights)
+      {
+         pass.mReads.push_back(mLightTarget);
+         pass.mReads.push_back(mNormalTarget);
+      }
 
-   levelTextureSprite.setPosition(mBoomEffect.mBoomOffsetX, mBoomEffect.mBoomOffsetY);
-   levelTextureSprite.scale(mViewToTextureScale, mViewToTextureScale);
+      pass.mExecute = [this, lights](){
+         const auto& levelTexture = mRenderPasses.getTexture(mLevelTarget).getTexture();
 
-   mGammaShader->update();
-   window->draw(levelTextureSprite, &mGammaShader->getGammaShader());
+         // without any light the shader only applies the ambient color, light and normal map
+         // are not sampled then
+         const auto& lightTexture = lights ? mRenderPasses.getTexture(mLightTarget).getTexture() : levelTexture;
+         const auto& normalTexture = lights ? mRenderPasses.getTexture(mNormalTarget).getTexture() : levelTexture;
+
+         auto& deferredTexture = mRenderPasses.getTexture(mDeferredTarget);
+         mLightSystem->draw(deferredTexture, levelTexture, lightTexture, normalTexture);
+         deferredTexture.display();
+         takeScreenshot("map_deferred", deferredTexture);
+      };
+
+      mRenderPasses.addPass(std::move(pass));
+   }
 
-   if (DisplayMode::getInstance().isSet(Display::DisplayMap))
    {
-      mMap->draw(*window.get());
+      const auto finalTarget = deferred ? mDeferredTarget : mLevelTarget;
+
+      RenderPassScheduler::Pass pass;
+      pass.mName = "Level::draw gamma";
+      pass.mReads = {finalTarget};
+      pass.mOutput = true;
+      pass.mExecute = [this, window, finalTarget](){
+         const auto& finalTexture = mRenderPasses.getTexture(finalTarget).getTexture();
+
+         auto levelTextureSprite = sf::Sprite(finalTexture);
+         mGammaShader->setTexture(finalTexture);
+
+         levelTextureSprite.setPosition(mBoomEffect.mBoomOffsetX, mBoomEffect.mBoomOffsetY);
+         levelTextureSprite.scale(mViewToTextureScale, mViewToTextureScale);
+
+         mGammaShader->update();
+         window->draw(levelTextureSprite, &mGammaShader->getGammaShader());
+
+         if (DisplayMode::getInstance().isSet(Display::DisplayMap))
+         {
+            mMap->draw(*window.get());
+         }
+      };
+
+      mRenderPasses.addPass(std::move(pass));
    }
+
+   mRenderPasses.execute();
+
+   mDynamicResolution.endFrame();
 }
 
 
@@ -1350,15 +1513,28 @@ std::shared_ptr<LightSystem> Level::getLightSystem() const
 //-----------------------------------------------------------------------------
 void Level::update(const sf::Time& dt)
 {
+   PROFILE_SCOPE("Level::update");
+
    // clear conveyor belt state
    ConveyorBelt::update();
 
    updateCameraSystem(dt);
    updateViews();
 
+   {
+      PROFILE_SCOPE("SimulationRegion::update");
+      mSimulationRegion.update(
+         sf::FloatRect(mLevelView->getCenter() - mLevelView->getSize() * 0.5f, mLevelView->getSize()),
+         mCurrentRoom
+      );
+   }
+
    // 80.0f * dt / 60.f
    // http://www.iforce2d.net/b2dtut/worlds
-   mWorld->Step(PhysicsConfiguration::getInstance().mTimeStep, 8, 3);
+   {
+      PROFILE_SCOPE("b2World::Step");
+      mWorld->Step(PhysicsConfiguration::getInstance().mTimeStep, 8, 3);
+   }
 
    CameraPane::getInstance().update();
    mBoomEffect.update(dt);
@@ -1373,26 +1549,36 @@ void Level::update(const sf::Time& dt)
       tileMap->update(dt);
    }
 
+   MovingPlatform::updatePaths();
+
    for (auto mechanismVector : mMechanisms)
    {
       for (auto& mechanism : *mechanismVector)
       {
+         if (!mechanism->isSimulated())
+         {
+            continue;
+         }
+
          mechanism->update(dt);
       }
    }
 
-   LuaInterface::instance()->update(dt);
+   LuaInterface::instance()->update(dt, mCurrentRoom);
 
    updatePlayerLight();
 
+   mMap->reveal(Player::getCurrent()->getPixelPositionf());
+
    mStaticLight->update(GlobalClock::getInstance()->getElapsedTime(), 0.0f, 0.0f);
 
-   for (const auto& smoke : mSmokeEffect)
+   mParticleSystem.update(dt);
+
+   // not created when running headless
+   if (mDeathShader)
    {
-      smoke->update(GlobalClock::getInstance()->getElapsedTime(), 0.0f, 0.0f);
+      mDeathShader->update(dt);
    }
-
-   mDeathShader->update(dt);
 }
 
 
@@ -1403,36 +1589,44 @@ const std::shared_ptr<b2World>& Level::getWorld() const
 }
 
 
+//-----------------------------------------------------------------------------
+const SimulationRegion& Level::getSimulationRegion() const
+{
+   return mSimulationRegion;
+}
+
+
+//-----------------------------------------------------------------------------
+const StaticChains& Level::getStaticChains() const
+{
+   return mStaticChains;
+}
+
+
 //-----------------------------------------------------------------------------
 void Level::addChainToWorld(
    const std::vector<b2Vec2>& chain,
    ObjectType object_type
 )
 {
-   // it's easier to store all the physics chains in a separate data structure
+   // the static chains keep the whole loops as well, it's easier to store them there
    // than to parse the box2d world every time we want those loops.
-   mWorldChains.push_back(chain);
-
-   b2ChainShape chainShape;
-   chainShape.CreateLoop(&chain.at(0), static_cast<int32_t>(chain.size()));
-
-   b2FixtureDef fixtureDef;
-   fixtureDef.density = 0.0f;
-   fixtureDef.friction = 0.2f;
-   fixtureDef.shape = &chainShape;
-
-   b2BodyDef bodyDef;
-   bodyDef.position.Set(0, 0);
-   bodyDef.type = b2_staticBody;
+   const auto& physicsConfig = PhysicsConfiguration::getInstance();
 
-   b2Body* body = mWorld->CreateBody(&bodyDef);
-
-   auto fixture = body->CreateFixture(&fixtureDef);
+   const auto fixtures = mStaticChains.add(
+      mWorld.get(),
+      chain,
+      physicsConfig.mStaticChainCellSizePx / PPM,
+      physicsConfig.mStaticChainMaxEdges
+   );
 
-   auto objectData = new FixtureNode(this);
-   objectData->setType(object_type);
+   for (auto fixture : fixtures)
+   {
+      auto objectData = new FixtureNode(this);
+      objectData->setType(object_type);
 
-   fixture->SetUserData(static_cast<void*>(objectData));
+      fixture->SetUserData(static_cast<void*>(objectData));
+   }
 }
 
 
@@ -6,6 +6,7 @@
 #include "boomeffect.h"
 #include "camerasystem.h"
 #include "constants.h"
+#include "dynamicresolution.h"
 #include "enemy.h"
 #include "framework/joystick/gamecontrollerinfo.h"
 #include "gamenode.h"
@@ -13,7 +14,11 @@
 #include "luanode.h"
 #include "mechanisms/portal.h"
 #include "physics/physics.h"
+#include "physics/simulationregion.h"
+#include "physics/staticchains.h"
+#include "renderpassscheduler.h"
 #include "room.h"
+#include "roomindex.h"
 #include "shaders/atmosphereshader.h"
 #include "shaders/blurshader.h"
 #include "shaders/deathshader.h"
@@ -23,6 +28,7 @@
 
 // effects
 #include "effects/lightsystem.h"
+#include "effects/particlesystem.h"
 #include "effects/smokeeffect.h"
 #include "effects/staticlight.h"
 
@@ -35,6 +41,7 @@
 #include "Box2D/Box2D.h"
 
 // std
+#include <functional>
 #include <list>
 #include <map>
 #include <memory>
@@ -64,6 +71,9 @@ class Level : public GameNode
 
 public:
 
+   //! called once the player moved to another room, rooms are nullptr outside of all rooms
+   using RoomChangedCallback = std::function<void(const Room* previous, const Room* current)>;
+
    Level();
    virtual ~Level();
 
@@ -86,7 +96,7 @@ public:
    void drawAtmosphereLayer(sf::RenderTarget& target);
    void drawBlurLayer(sf::RenderTarget& target);
    void drawNormalMap();
-   void drawLightMap();
+   void drawLightMap(sf::RenderTarget& target);
    void drawPlayer(sf::RenderTarget& color, sf::RenderTarget& normal);
 
    const std::shared_ptr<b2World>& getWorld() const;
@@ -120,6 +130,13 @@ public:
 
    std::shared_ptr<LightSystem> getLightSystem() const;
 
+   const SimulationRegion& getSimulationRegion() const;
+
+   const StaticChains& getStaticChains() const;
+
+   const Room* getCurrentRoom() const;
+   void addRoomChangedCallback(const RoomChangedCallback& callback);
+
 
 protected:
 
@@ -164,17 +181,21 @@ protected:
 
    void takeScreenshot(const std::string& basename, sf::RenderTexture &texture);
    void updatePlayerLight();
-
-   std::vector<Room> mRooms;
-   std::optional<Room> mCurrentRoom;
-   int32_t mCurrentRoomId = -1;
-
-   std::shared_ptr<sf::RenderTexture> mLevelRenderTexture;
-   std::shared_ptr<sf::RenderTexture> mLevelBackgroundRenderTexture;
-   std::shared_ptr<sf::RenderTexture> mLightingTexture;
-   std::shared_ptr<sf::RenderTexture> mNormalTexture;
-   std::shared_ptr<sf::RenderTexture> mDeferredTexture;
-   std::vector<std::shared_ptr<sf::RenderTexture>> mRenderTextures;
+   void initializeSimulationRegion();
+
+   std::vector<Room> mRooms; // must not change after loading, the index points into it
+   RoomIndex mRoomIndex;
+   const Room* mCurrentRoom = nullptr;
+   std::vector<RoomChangedCallback> mRoomChangedCallbacks;
+
+   RenderPassScheduler mRenderPasses;
+   RenderPassScheduler::Target mAtmosphereTarget = -1;
+   RenderPassScheduler::Target mBackgroundTarget = -1;
+   RenderPassScheduler::Target mLevelTarget = -1;
+   RenderPassScheduler::Target mNormalTarget = -1;
+   RenderPassScheduler::Target mLightTarget = -1;
+   RenderPassScheduler::Target mDeferredTarget = -1;
+   DynamicResolution mDynamicResolution;
 
    float mViewToTextureScale = 1.0f;
    std::shared_ptr<sf::View> mLevelView;
@@ -227,7 +248,7 @@ protected:
    std::shared_ptr<LightSystem> mLightSystem;
    std::shared_ptr<StaticLight> mStaticLight;
    std::shared_ptr<LightSystem::LightInstance> mPlayerLight;
-   std::vector<std::shared_ptr<SmokeEffect>> mSmokeEffect;
+   ParticleSystem mParticleSystem;
 
    AmbientOcclusion mAo;
    std::vector<std::shared_ptr<ImageLayer>> mImageLayers;
@@ -244,14 +265,15 @@ protected:
    std::map<b2Body*, size_t> mPointCountMap;
 
    std::shared_ptr<b2World> mWorld = nullptr;
-   std::vector<std::vector<b2Vec2>> mWorldChains;
+   StaticChains mStaticChains;
+   SimulationRegion mSimulationRegion;
 
    static Level* sCurrentLevel;
 
 private:
-   void drawDebugInformation();
-   void displayTextures();
+   void drawDebugInformation(sf::RenderTarget& target);
+   void displayTextures(sf::RenderTexture& color, sf::RenderTexture& normal);
    void drawGlowLayer();
-   void drawGlowSprite();
+   void drawGlowSprite(sf::RenderTexture& target);
 };
 
@@ -9,12 +9,29 @@
 #include "mechanisms/door.h"
 #include "mechanisms/portal.h"
 #include "player/player.h"
-#include "texturepool.h"
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <sstream>
 
 
+namespace
+{
+// pages are square, a multiple of the 16px map grid
+constexpr auto pageSize = 256u;
+
+// pages kept on the gpu, a 640x360 view touches up to 12 of them
+constexpr auto maxPages = 24u;
+
+// the fog of war is stored per block of map pixels
+constexpr auto revealBlockSize = 8u;
+
+// radius around the player uncovered while walking around, in map pixels
+constexpr auto revealRadius = 64.0f;
+}
+
+
 LevelMap::LevelMap()
 {
    mFont.load(
@@ -65,14 +82,30 @@ void LevelMap::loadLevelTextures(
    const std::filesystem::path& outlines
 )
 {
-   mLevelGridTexture = TexturePool::getInstance().get(grid.string());
-   mLevelGridSprite.setTexture(*mLevelGridTexture);
+   mPages.clear();
+
+   // the images stay on the cpu, large levels easily exceed the maximum texture size
+   if (!mLevelGridImage.loadFromFile(grid.string()))
+   {
+      std::cerr << "[E] could not load map grid: " << grid.string() << std::endl;
+   }
+
+   if (!mLevelOutlineImage.loadFromFile(outlines.string()))
+   {
+      std::cerr << "[E] could not load map outlines: " << outlines.string() << std::endl;
+   }
 
-   mLevelOutlineTexture = TexturePool::getInstance().get(outlines.string());
-   mLevelOutlineSprite.setTexture(*mLevelOutlineTexture);
+   mLevelSize = mLevelGridImage.getSize();
 
-   // that render texture should have the same size as our level textures
-   mLevelRenderTexture.create(mLevelGridTexture->getSize().x, mLevelGridTexture->getSize().y);
+   mRevealedSize.x = (mLevelSize.x + revealBlockSize - 1) / revealBlockSize;
+   mRevealedSize.y = (mLevelSize.y + revealBlockSize - 1) / revealBlockSize;
+   mRevealed.assign(mRevealedSize.x * mRevealedSize.y, 0);
+
+   // that render texture only covers the visible part of the map
+   mLevelRenderTexture.create(
+      static_cast<uint32_t>(GameConfiguration::getInstance().mViewWidth),
+      static_cast<uint32_t>(GameConfiguration::getInstance().mViewHeight)
+   );
 }
 
 
@@ -81,27 +114,59 @@ void LevelMap::draw(sf::RenderTarget& window, sf::RenderStates states)
    auto w = GameConfiguration::getInstance().mViewWidth;
    auto h = GameConfiguration::getInstance().mViewHeight;
 
+   mFrame++;
+
    sf::Vector2f center;
    center += Player::getCurrent()->getPixelPositionf() * 0.125f;
    center += CameraPane::getInstance().getLookVector();
-   center.x += mLevelGridSprite.getTexture()->getSize().x / 2.0f;
-   center.y += mLevelGridSprite.getTexture()->getSize().y / 2.0f;
+   center.x += w / 2.0f;
+   center.y += h / 2.0f;
    center.x -= 220.0f;
    center.y -= 80.0f;
 
    sf::View levelView;
-   levelView.setSize(static_cast<float>(mLevelGridSprite.getTexture()->getSize().x), static_cast<float>(mLevelGridSprite.getTexture()->getSize().y));
+   levelView.setSize(static_cast<float>(w), static_cast<float>(h));
    levelView.setCenter(center);
    levelView.zoom(mZoom); // 1.5f works well, too
-   mLevelGridSprite.setColor(sf::Color{70, 70, 140, 255});
-   mLevelOutlineSprite.setColor(sf::Color{255, 255, 255, 80});
-   mLevelRenderTexture.clear();
-   mLevelRenderTexture.draw(mLevelGridSprite, sf::BlendMode{sf::BlendAdd});
-   mLevelRenderTexture.draw(mLevelOutlineSprite, sf::BlendMode{sf::BlendAdd});
-   drawLevelItems(mLevelRenderTexture);
+
    mLevelRenderTexture.setView(levelView);
+   mLevelRenderTexture.clear();
+
+   // draw the pages within the view, the fog multiplies away what hasn't been visited yet
+   const auto pageCountX = static_cast<int32_t>((mLevelSize.x + pageSize - 1) / pageSize);
+   const auto pageCountY = static_cast<int32_t>((mLevelSize.y + pageSize - 1) / pageSize);
+
+   const auto viewTopLeft = levelView.getCenter() - levelView.getSize() * 0.5f;
+   const auto viewBottomRight = levelView.getCenter() + levelView.getSize() * 0.5f;
+
+   const auto pageX0 = std::max(static_cast<int32_t>(std::floor(viewTopLeft.x / pageSize)), 0);
+   const auto pageY0 = std::max(static_cast<int32_t>(std::floor(viewTopLeft.y / pageSize)), 0);
+   const auto pageX1 = std::min(static_cast<int32_t>(std::floor(viewBottomRight.x / pageSize)), pageCountX - 1);
+   const auto pageY1 = std::min(static_cast<int32_t>(std::floor(viewBottomRight.y / pageSize)), pageCountY - 1);
+
+   for (auto y = pageY0; y <= pageY1; y++)
+   {
+      for (auto x = pageX0; x <= pageX1; x++)
+      {
+         auto& page = getPage(x, y);
+         const auto position = sf::Vector2f(static_cast<float>(x * pageSize), static_cast<float>(y * pageSize));
+
+         sf::Sprite pageSprite(page.mTexture.getTexture());
+         pageSprite.setPosition(position);
+         mLevelRenderTexture.draw(pageSprite);
+
+         sf::Sprite fogSprite(page.mFog);
+         fogSprite.setPosition(position);
+         fogSprite.setScale(static_cast<float>(revealBlockSize), static_cast<float>(revealBlockSize));
+         mLevelRenderTexture.draw(fogSprite, sf::BlendMultiply);
+      }
+   }
+
+   drawPlayer(mLevelRenderTexture);
    mLevelRenderTexture.display();
 
+   evictPages();
+
    // std::cout << "dx/dy: " << CameraPane::getInstance().getLookVector().x << " " << CameraPane::getInstance().getLookVector().y << std::endl;
 
    auto levelTextureSprite = sf::Sprite(mLevelRenderTexture.getTexture());
@@ -146,27 +211,202 @@ void LevelMap::draw(sf::RenderTarget& window, sf::RenderStates states)
 }
 
 
+void LevelMap::reveal(const sf::Vector2f& player_position_px)
+{
+   if (mRevealed.empty())
+   {
+      return;
+   }
+
+   const auto center = player_position_px * 0.125f / static_cast<float>(revealBlockSize);
+   const auto radius = revealRadius / static_cast<float>(revealBlockSize);
+
+   const auto x0 = std::max(static_cast<int32_t>(center.x - radius), 0);
+   const auto y0 = std::max(static_cast<int32_t>(center.y - radius), 0);
+   const auto x1 = std::min(static_cast<int32_t>(center.x + radius), static_cast<int32_t>(mRevealedSize.x) - 1);
+   const auto y1 = std::min(static_cast<int32_t>(center.y + radius), static_cast<int32_t>(mRevealedSize.y) - 1);
+
+   constexpr auto blocksPerPage = static_cast<int32_t>(pageSize / revealBlockSize);
+
+   for (auto y = y0; y <= y1; y++)
+   {
+      for (auto x = x0; x <= x1; x++)
+      {
+         const auto dx = x + 0.5f - center.x;
+         const auto dy = y + 0.5f - center.y;
+
+         if (dx * dx + dy * dy > radius * radius)
+         {
+            continue;
+         }
+
+         auto& revealed = mRevealed[static_cast<size_t>(y) * mRevealedSize.x + static_cast<size_t>(x)];
+         if (revealed)
+         {
+            continue;
+         }
+
+         revealed = 255;
+
+         auto it = mPages.find({x / blocksPerPage, y / blocksPerPage});
+         if (it != mPages.end())
+         {
+            it->second->mFogDirty = true;
+         }
+      }
+   }
+}
+
+
+LevelMap::Page& LevelMap::getPage(int32_t x, int32_t y)
+{
+   auto& page = mPages[{x, y}];
+
+   if (!page)
+   {
+      page = std::make_unique<Page>();
+      page->mTexture.create(pageSize, pageSize);
+      page->mFog.create(pageSize / revealBlockSize, pageSize / revealBlockSize);
+      page->mFog.setSmooth(true);
+   }
+
+   if (page->mDirty)
+   {
+      compositePage(*page, x, y);
+   }
+
+   if (page->mFogDirty)
+   {
+      updateFog(*page, x, y);
+   }
+
+   page->mLastUsed = mFrame;
+
+   return *page;
+}
+
+
+void LevelMap::compositePage(Page& page, int32_t x, int32_t y)
+{
+   const sf::IntRect rect(
+      x * static_cast<int32_t>(pageSize),
+      y * static_cast<int32_t>(pageSize),
+      static_cast<int32_t>(pageSize),
+      static_cast<int32_t>(pageSize)
+   );
+
+   // textures are clamped to the image bounds at the right and bottom of the level
+   sf::Texture gridTexture;
+   gridTexture.loadFromImage(mLevelGridImage, rect);
+   sf::Sprite gridSprite(gridTexture);
+   gridSprite.setPosition(static_cast<float>(rect.left), static_cast<float>(rect.top));
+   gridSprite.setColor(sf::Color{70, 70, 140, 255});
+
+   page.mTexture.setView(sf::View(sf::FloatRect(rect)));
+   page.mTexture.clear();
+   page.mTexture.draw(gridSprite, sf::BlendMode{sf::BlendAdd});
+
+   // an empty area would load the whole image
+   const auto outlineSize = mLevelOutlineImage.getSize();
+   if (rect.left < static_cast<int32_t>(outlineSize.x) && rect.top < static_cast<int32_t>(outlineSize.y))
+   {
+      sf::Texture outlineTexture;
+      outlineTexture.loadFromImage(mLevelOutlineImage, rect);
+      sf::Sprite outlineSprite(outlineTexture);
+      outlineSprite.setPosition(static_cast<float>(rect.left), static_cast<float>(rect.top));
+      outlineSprite.setColor(sf::Color{255, 255, 255, 80});
+      page.mTexture.draw(outlineSprite, sf::BlendMode{sf::BlendAdd});
+   }
+
+   drawLevelItems(page.mTexture, rect);
+   page.mTexture.display();
+
+   page.mDirty = false;
+}
+
+
+void LevelMap::updateFog(Page& page, int32_t x, int32_t y)
+{
+   const auto size = page.mFog.getSize();
+   std::vector<sf::Uint8> pixels(size.x * size.y * 4, 255);
+
+   for (auto j = 0u; j < size.y; j++)
+   {
+      for (auto i = 0u; i < size.x; i++)
+      {
+         const auto bx = static_cast<uint32_t>(x) * size.x + i;
+         const auto by = static_cast<uint32_t>(y) * size.y + j;
+
+         const auto value = (bx < mRevealedSize.x && by < mRevealedSize.y) ? mRevealed[by * mRevealedSize.x + bx] : 0;
+
+         auto pixel = &pixels[(j * size.x + i) * 4];
+         pixel[0] = value;
+         pixel[1] = value;
+         pixel[2] = value;
+      }
+   }
+
+   page.mFog.update(pixels.data());
+   page.mFogDirty = false;
+}
+
+
+void LevelMap::evictPages()
+{
+   // drop the pages that haven't been looked at for the longest time
+   while (mPages.size() > maxPages)
+   {
+      auto oldest = std::min_element(mPages.begin(), mPages.end(), [](const auto& a, const auto& b){
+         return a.second->mLastUsed < b.second->mLastUsed;
+      });
+
+      if (oldest->second->mLastUsed == mFrame)
+      {
+         break;
+      }
+
+      mPages.erase(oldest);
+   }
+}
+
+
+void LevelMap::invalidatePages()
+{
+   for (auto& page : mPages)
+   {
+      page.second->mDirty = true;
+   }
+}
+
+
 void LevelMap::setDoors(const std::vector<std::shared_ptr<GameMechanism>>& doors)
 {
    mDoors = doors;
+   invalidatePages();
 }
 
 
 void LevelMap::setPortals(const std::vector<std::shared_ptr<GameMechanism>>& portals)
 {
    mPortals = portals;
+   invalidatePages();
 }
 
 
-void LevelMap::drawLevelItems(sf::RenderTarget& target, sf::RenderStates)
+void LevelMap::drawLevelItems(sf::RenderTarget& target, const sf::IntRect& rect)
 {
    float scale = 3.0f;
 
-   // draw grid
-   for (auto y = 0u; y < target.getSize().y; y += 16)
+   const auto left = static_cast<float>(rect.left);
+   const auto top = static_cast<float>(rect.top);
+   const auto right = static_cast<float>(std::min(rect.left + rect.width, static_cast<int32_t>(mLevelSize.x)));
+   const auto bottom = static_cast<float>(std::min(rect.top + rect.height, static_cast<int32_t>(mLevelSize.y)));
+
+   // draw grid, the page size is a multiple of the grid size
+   for (auto y = rect.top; y < bottom; y += 16)
    {
-      sf::Vertex a(sf::Vector2f(0.0f, static_cast<float>(y)));
-      sf::Vertex b(sf::Vector2f(static_cast<float>(target.getSize().x), static_cast<float>(y)));
+      sf::Vertex a(sf::Vector2f(left, static_cast<float>(y)));
+      sf::Vertex b(sf::Vector2f(right, static_cast<float>(y)));
       a.color.a = 30;
       b.color.a = 30;
 
@@ -175,10 +415,10 @@ void LevelMap::drawLevelItems(sf::RenderTarget& target, sf::RenderStates)
       target.draw(line, 2, sf::Lines);
    }
 
-   for (auto x = 0u; x < target.getSize().x; x += 16)
+   for (auto x = rect.left; x < right; x += 16)
    {
-      sf::Vertex a(sf::Vector2f(static_cast<float>(x), 0.0f));
-      sf::Vertex b(sf::Vector2f(static_cast<float>(x), static_cast<float>(target.getSize().y)));
+      sf::Vertex a(sf::Vector2f(static_cast<float>(x), top));
+      sf::Vertex b(sf::Vector2f(static_cast<float>(x), bottom));
       a.color.a = 30;
       b.color.a = 30;
 
@@ -232,7 +472,11 @@ void LevelMap::drawLevelItems(sf::RenderTarget& target, sf::RenderStates)
 
       target.draw(&quad[0], 4, sf::Quads);
    }
+}
+
 
+void LevelMap::drawPlayer(sf::RenderTarget& target)
+{
    // draw player
    auto playerWidth = 5.0f;
    auto playerHeight = 4;
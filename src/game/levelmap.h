@@ -7,6 +7,7 @@
 #include <SFML/System.hpp>
 
 #include <filesystem>
+#include <map>
 #include <memory>
 #include <vector>
 
@@ -25,24 +26,51 @@ class LevelMap
 
       void draw(sf::RenderTarget& window, sf::RenderStates = sf::RenderStates::Default);
 
+      //! uncover the map around the player, call once per frame
+      void reveal(const sf::Vector2f& player_position_px);
+
       void setDoors(const std::vector<std::shared_ptr<GameMechanism>>& doors);
       void setPortals(const std::vector<std::shared_ptr<GameMechanism>>& portals);
 
 
    private:
 
-      void drawLevelItems(sf::RenderTarget& window, sf::RenderStates = sf::RenderStates::Default);
+      // the map is cut into pages of a fixed size, only the pages around the viewed area
+      // are kept on the gpu. a page is composited once and again when doors or portals change.
+      struct Page
+      {
+         sf::RenderTexture mTexture;
+         sf::Texture mFog;
+         bool mDirty = true;
+         bool mFogDirty = true;
+         uint64_t mLastUsed = 0;
+      };
+
+      Page& getPage(int32_t x, int32_t y);
+      void compositePage(Page& page, int32_t x, int32_t y);
+      void updateFog(Page& page, int32_t x, int32_t y);
+      void evictPages();
+      void invalidatePages();
+
+      void drawLevelItems(sf::RenderTarget& target, const sf::IntRect& rect);
+      void drawPlayer(sf::RenderTarget& target);
 
       BitmapFont mFont;
       std::map<std::string, std::shared_ptr<Layer>> mLayers;
 
       sf::RenderTexture mLevelRenderTexture;
 
-      std::shared_ptr<sf::Texture> mLevelGridTexture;
-      sf::Sprite mLevelGridSprite;
+      // cpu side copies of the physics grid and the outlines, pages are cut from those
+      sf::Image mLevelGridImage;
+      sf::Image mLevelOutlineImage;
+      sf::Vector2u mLevelSize;
+
+      std::map<std::pair<int32_t, int32_t>, std::unique_ptr<Page>> mPages;
+      uint64_t mFrame = 0;
 
-      std::shared_ptr<sf::Texture> mLevelOutlineTexture;
-      sf::Sprite mLevelOutlineSprite;
+      // one byte per block of the map, 0 while hidden
+      std::vector<uint8_t> mRevealed;
+      sf::Vector2u mRevealedSize;
 
       std::vector<std::shared_ptr<GameMechanism>> mDoors;
       std::vector<std::shared_ptr<GameMechanism>> mPortals;
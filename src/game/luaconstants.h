@@ -8,6 +8,7 @@
 #define FUNCTION_RETRIEVE_PROPERTIES   "retrieveProperties"
 #define FUNCTION_UPDATE                "update"
 #define FUNCTION_PLAYER_MOVED_TO       "playerMovedTo"
+#define FUNCTION_PLAYER_ENTERED_ROOM   "playerEnteredRoom"
 #define FUNCTION_SET_PATH              "setPath"
 #define FUNCTION_SET_START_POSITION    "setStartPosition"
 #define FUNCTION_TIMEOUT               "timeout"
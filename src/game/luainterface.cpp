@@ -1,15 +1,32 @@
 #include "luainterface.h"
 
+#include "framework/tools/profiler.h"
+#include "framework/tools/workerpool.h"
+#include "player/player.h"
+#include "spatialquery.h"
+
 // lua
 #include "lua/lua.hpp"
 
 // stl
+#include <algorithm>
 #include <sstream>
 
 
 LuaInterface* LuaInterface::sInstance = nullptr;
 
 
+namespace
+{
+// squared distances from the player in px that select the update interval of a node
+constexpr auto reducedRateDistance = 640.0f * 640.0f;
+constexpr auto lowRateDistance = 1280.0f * 1280.0f;
+
+constexpr auto reducedRateInterval = 2;
+constexpr auto lowRateInterval = 4;
+}
+
+
 
 LuaInterface *LuaInterface::instance()
 {
@@ -42,24 +59,138 @@ void LuaInterface::removeObject(const std::shared_ptr<LuaNode>& node)
 }
 
 
-void LuaInterface::update(const sf::Time& dt)
+int32_t LuaInterface::getUpdateInterval(
+   const std::shared_ptr<LuaNode>& node,
+   const sf::Vector2f& playerPosition,
+   const Room* playerRoom
+) const
+{
+   // scripts that need to see every frame can opt out of throttling
+   if (node->getPropertyBool(PropertyKey::UpdateEveryFrame))
+   {
+      return 1;
+   }
+
+   if (playerRoom && playerRoom->findRect(node->mPosition) != playerRoom->mRects.end())
+   {
+      return 1;
+   }
+
+   const auto delta = node->mPosition - playerPosition;
+   const auto distance = delta.x * delta.x + delta.y * delta.y;
+
+   if (distance < reducedRateDistance)
+   {
+      return 1;
+   }
+
+   return (distance < lowRateDistance) ? reducedRateInterval : lowRateInterval;
+}
+
+
+void LuaInterface::update(const sf::Time& dt, const Room* playerRoom)
 {
-   for (auto it = mObjectList.begin(); it != mObjectList.end();)
+   PROFILE_SCOPE("LuaInterface::update");
+
+   // nodes are scheduled in tiers:
+   // - close to the player or in the player's room, scripts are called every frame
+   // - farther away they are called every 2nd or 4th frame with the accumulated time,
+   //   staggered by their id so the calls are spread evenly across frames
+   // - dormant nodes (outside the simulation region) are not updated at all
+   const auto playerPosition = Player::getCurrent()->getPixelPositionf();
+
+   mFrame++;
+
+   mDispatches.clear();
+
+   for (auto& object : mObjectList)
+   {
+      if (!object->mSimulated)
+      {
+         continue;
+      }
+
+      object->mAccumulatedTime += dt;
+
+      // one call into lua per node, queued events are not held back by throttling
+      const auto interval = static_cast<uint32_t>(getUpdateInterval(object, playerPosition, playerRoom));
+      const auto tick = ((mFrame + static_cast<uint32_t>(object->mId)) % interval == 0);
+      mDispatches.push_back({object.get(), tick, tick || object->hasPendingEvents()});
+   }
+
+   // every node owns its lua state so scripts can run side by side. while they do, the
+   // world is only read (queries, positions) and calls that change the engine are recorded
+   // by the node. they are applied afterwards in node order, so the outcome does not depend
+   // on the thread count or on which script finished first.
+   // identical spatial queries issued by several scripts are answered once per dispatch, that
+   // only holds while engine calls are deferred, i.e. the scripts run in parallel
+   SpatialQuery::getInstance().beginFrame(mParallel);
+
+   if (mParallel)
+   {
+      PROFILE_SCOPE("LuaInterface::dispatch");
+
+      WorkerPool::getInstance().parallelFor(
+         mDispatches.size(),
+         [this](size_t index)
+         {
+            const auto& dispatch = mDispatches[index];
+            if (dispatch.mCall)
+            {
+               dispatch.mNode->mRecordCommands = true;
+               dispatch.mNode->luaDispatch(dispatch.mTick, dispatch.mNode->mAccumulatedTime);
+               dispatch.mNode->mRecordCommands = false;
+            }
+         }
+      );
+   }
+   else
+   {
+      PROFILE_SCOPE("LuaInterface::dispatch");
+
+      for (const auto& dispatch : mDispatches)
+      {
+         if (dispatch.mCall)
+         {
+            dispatch.mNode->luaDispatch(dispatch.mTick, dispatch.mNode->mAccumulatedTime);
+         }
+      }
+   }
+
+   SpatialQuery::getInstance().endFrame();
+
+   for (const auto& dispatch : mDispatches)
    {
-      auto object = *it;
+      auto object = dispatch.mNode;
+
+      object->applyCommands();
+
+      if (dispatch.mTick)
+      {
+         object->mAccumulatedTime = sf::Time::Zero;
+      }
 
-      object->luaMovedTo();
-      object->luaPlayerMovedTo();
-      object->luaUpdate(dt);
       object->updateVelocity();
       object->updatePosition();
       object->updateWeapons(dt);
-
-      if (!object->mBody)
-         it = mObjectList.erase(it);
-      else
-         ++it;
    }
+
+   mObjectList.erase(
+      std::remove_if(mObjectList.begin(), mObjectList.end(), [](const auto& object){return !object->mBody;}),
+      mObjectList.end()
+   );
+}
+
+
+void LuaInterface::setParallel(bool parallel)
+{
+   mParallel = parallel;
+}
+
+
+bool LuaInterface::isParallel() const
+{
+   return mParallel;
 }
 
 
@@ -83,6 +214,21 @@ std::shared_ptr<LuaNode> LuaInterface::getObject(lua_State* state)
 }
 
 
+void LuaInterface::playerEnteredRoom(const Room* room)
+{
+   const auto roomId = room ? room->mId : -1;
+
+   // sleeping nodes are not dispatched, their events would only pile up
+   for (auto& object : mObjectList)
+   {
+      if (object->mSimulated)
+      {
+         object->luaPlayerEnteredRoom(roomId);
+      }
+   }
+}
+
+
 void LuaInterface::requestMap(std::shared_ptr<LuaNode> obj)
 {
    printf("requestMap: obj: %d\n", obj->mId);
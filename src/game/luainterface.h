@@ -8,6 +8,7 @@
 #include "SFML/Graphics.hpp"
 
 #include "luanode.h"
+#include "room.h"
 
 
 class LuaInterface
@@ -22,7 +23,15 @@ public:
 
    void initialize();
 
-   void update(const sf::Time& dt);
+   //! the room the player is in keeps all enemies inside it at full update rate
+   void update(const sf::Time& dt, const Room* playerRoom = nullptr);
+
+   //! pass a room change on to the scripts' playerEnteredRoom callback
+   void playerEnteredRoom(const Room* room);
+
+   //! run the scripts on the worker pool, engine calls are deferred and applied in node order
+   void setParallel(bool parallel);
+   bool isParallel() const;
 
    void requestMap(std::shared_ptr<LuaNode> obj);
 
@@ -37,7 +46,24 @@ private:
 
    explicit LuaInterface();
 
+   int32_t getUpdateInterval(
+      const std::shared_ptr<LuaNode>& node,
+      const sf::Vector2f& playerPosition,
+      const Room* playerRoom
+   ) const;
+
    static LuaInterface* sInstance;
    std::vector<std::shared_ptr<LuaNode>> mObjectList;
+   uint32_t mFrame = 0;
+   bool mParallel = false;
+
+   struct Dispatch
+   {
+      LuaNode* mNode = nullptr;
+      bool mTick = false; // per-frame callbacks are due
+      bool mCall = false; // tick or queued events
+   };
+
+   std::vector<Dispatch> mDispatches;
 };
 
@@ -31,6 +31,140 @@ namespace  {
    uint16_t categoryBits = CategoryEnemyWalkThrough;                // I am a ...
    uint16_t maskBitsStanding = CategoryBoundary | CategoryFriendly; // I collide with ...
    int16_t groupIndex = 0;                                          // 0 is default
+
+   // called once with the script's callbacks, returns the function that LuaNode::luaDispatch
+   // calls every frame: it receives the tick flag, the node and player positions, dt and
+   // the queued events as (type, value) pairs. the callbacks are looked up only once.
+   const char* dispatcherSource = R"(
+      local movedTo, playerMovedTo, update, hit, timeout, collisionWithPlayer, playerEnteredRoom = ...
+
+      return function(tick, x, y, playerX, playerY, dt, ...)
+         for i = 1, select('#', ...), 2 do
+            local event, value = select(i, ...)
+            if event == 1 then
+               if hit then hit(value) end
+            elseif event == 2 then
+               if timeout then timeout(value) end
+            elseif event == 3 then
+               if collisionWithPlayer then collisionWithPlayer() end
+            elseif event == 4 then
+               if playerEnteredRoom then playerEnteredRoom(value) end
+            end
+         end
+
+         if tick then
+            if movedTo then movedTo(x, y) end
+            if playerMovedTo then playerMovedTo(playerX, playerY) end
+            update(dt)
+         end
+      end
+   )";
+
+   // read-only view on a path, behaves like the flat x, y, x, y, ... table scripts used to get
+   constexpr auto pathViewMetatable = "LuaNode.PathView";
+
+   struct PathView
+   {
+      const std::vector<sf::Vector2f>* mPath = nullptr;
+   };
+
+   lua_Integer pathViewLength(lua_State* state)
+   {
+      auto view = static_cast<PathView*>(luaL_checkudata(state, 1, pathViewMetatable));
+      return static_cast<lua_Integer>(view->mPath->size() * 2);
+   }
+
+   bool pushPathViewValue(lua_State* state, lua_Integer index)
+   {
+      auto view = static_cast<PathView*>(luaL_checkudata(state, 1, pathViewMetatable));
+
+      if (index < 1 || index > pathViewLength(state))
+      {
+         return false;
+      }
+
+      const auto& position = (*view->mPath)[static_cast<size_t>((index - 1) / 2)];
+      lua_pushnumber(state, static_cast<double>(((index - 1) % 2 == 0) ? position.x : position.y));
+      return true;
+   }
+
+   int32_t pathViewIndex(lua_State* state)
+   {
+      auto isInteger = 0;
+      const auto index = lua_tointegerx(state, 2, &isInteger);
+
+      if (!isInteger || !pushPathViewValue(state, index))
+      {
+         lua_pushnil(state);
+      }
+
+      return 1;
+   }
+
+   int32_t pathViewLen(lua_State* state)
+   {
+      lua_pushinteger(state, pathViewLength(state));
+      return 1;
+   }
+
+   int32_t pathViewNext(lua_State* state)
+   {
+      const auto index = lua_isnil(state, 2) ? 1 : (lua_tointeger(state, 2) + 1);
+
+      lua_pushinteger(state, index);
+      if (!pushPathViewValue(state, index))
+      {
+         lua_pushnil(state);
+         return 1;
+      }
+
+      return 2;
+   }
+
+   int32_t pathViewPairs(lua_State* state)
+   {
+      lua_pushcfunction(state, pathViewNext);
+      lua_pushvalue(state, 1);
+      lua_pushnil(state);
+      return 3;
+   }
+
+   // read-only view on the hits of a node's last spatial query, the same userdata is handed
+   // out by every query so scripts don't create garbage per query
+   constexpr auto queryResultMetatable = "LuaNode.QueryResult";
+
+   struct QueryResultView
+   {
+      const std::vector<SpatialQuery::Hit>* mHits = nullptr;
+   };
+
+   int32_t queryResultLen(lua_State* state)
+   {
+      auto view = static_cast<QueryResultView*>(luaL_checkudata(state, 1, queryResultMetatable));
+      lua_pushinteger(state, static_cast<lua_Integer>(view->mHits->size()));
+      return 1;
+   }
+
+   // hits:get(i) returns fixture type, body id, x, y and the ray fraction of hit i (1-based)
+   int32_t queryResultGet(lua_State* state)
+   {
+      auto view = static_cast<QueryResultView*>(luaL_checkudata(state, 1, queryResultMetatable));
+      const auto index = luaL_checkinteger(state, 2);
+
+      if (index < 1 || index > static_cast<lua_Integer>(view->mHits->size()))
+      {
+         lua_pushnil(state);
+         return 1;
+      }
+
+      const auto& hit = (*view->mHits)[static_cast<size_t>(index - 1)];
+      lua_pushinteger(state, hit.mType);
+      lua_pushinteger(state, hit.mBodyId);
+      lua_pushnumber(state, static_cast<double>(hit.mX));
+      lua_pushnumber(state, static_cast<double>(hit.mY));
+      lua_pushnumber(state, static_cast<double>(hit.mFraction));
+      return 5;
+   }
 }
 
 
@@ -48,34 +182,42 @@ namespace  {
  */
 int32_t updateProperties(lua_State* state)
 {
+   std::shared_ptr<LuaNode> node = OBJINSTANCE;
+
+   if (!node)
+   {
+      return 0;
+   }
+
    lua_pushnil(state);
 
    while(lua_next(state, -2) != 0)
    {
-      std::string key = lua_tostring(state, -2);
+      // the key is interned once here, the engine reads the property by key from then on
+      const auto key = PropertyKey::intern(lua_tostring(state, -2));
 
       if (lua_isboolean(state, -1)) // bool
       {
-         OBJINSTANCE->mProperties[key] = static_cast<bool>(lua_toboolean(state, -1));
-         // printf("%s = %d\n", key.c_str(), lua_toboolean(state, -1));
+         node->mProperties.set(key, static_cast<bool>(lua_toboolean(state, -1)));
+         // printf("%s = %d\n", PropertyKey::getName(key).c_str(), lua_toboolean(state, -1));
       }
       if (lua_isnumber(state, -1))
       {
          if (lua_isinteger(state, -1)) // int64
          {
-            OBJINSTANCE->mProperties[key] = static_cast<int64_t>(lua_tointeger(state, -1));
-            // printf("%s = %lld\n", key.c_str(), lua_tointeger(state, -1));
+            node->mProperties.set(key, static_cast<int64_t>(lua_tointeger(state, -1)));
+            // printf("%s = %lld\n", PropertyKey::getName(key).c_str(), lua_tointeger(state, -1));
          }
          else // double
          {
-            OBJINSTANCE->mProperties[key] = lua_tonumber(state, -1);
-            // printf("%s = %f\n", key.c_str(), lua_tonumber(state, -1));
+            node->mProperties.set(key, lua_tonumber(state, -1));
+            // printf("%s = %f\n", PropertyKey::getName(key).c_str(), lua_tonumber(state, -1));
          }
       }
       else if (lua_isstring(state, -1)) // string
       {
-         OBJINSTANCE->mProperties[key] = std::string(lua_tostring(state, -1));
-         // printf("%s = %s\n", key.c_str(), lua_tostring(state, -1));
+         node->mProperties.set(key, std::string(lua_tostring(state, -1)));
+         // printf("%s = %s\n", PropertyKey::getName(key).c_str(), lua_tostring(state, -1));
       }
 
       // process nested tables
@@ -88,7 +230,7 @@ int32_t updateProperties(lua_State* state)
       lua_pop(state, 1);
    }
 
-   OBJINSTANCE->synchronizeProperties();
+   node->execute([node](){node->synchronizeProperties();});
 
    return 0;
 }
@@ -148,23 +290,48 @@ int32_t queryAABB(lua_State* state)
 
    if (argc == 4)
    {
-      b2AABB aabb;
+      auto x1 = static_cast<float>(lua_tointeger(state, 1));
+      auto y1 = static_cast<float>(lua_tointeger(state, 2));
+      auto x2 = static_cast<float>(lua_tointeger(state, 3));
+      auto y2 = static_cast<float>(lua_tointeger(state, 4));
+
+      std::shared_ptr<LuaNode> node = OBJINSTANCE;
+
+      if (!node)
+      {
+         return 0;
+      }
 
-      b2Vec2 lower;
-      b2Vec2 upper;
+      const auto hitCount = node->queryAABB(x1, y1, x2, y2);
+      lua_pushinteger(state, hitCount);
+      return 1;
+   }
 
-      auto x1 = static_cast<float>(lua_tointeger(state, 1) * MPP);
-      auto y1 = static_cast<float>(lua_tointeger(state, 2) * MPP);
-      auto x2 = static_cast<float>(lua_tointeger(state, 3) * MPP);
-      auto y2 = static_cast<float>(lua_tointeger(state, 4) * MPP);
+   return 0;
+}
 
-      lower.Set(x1, y1);
-      upper.Set(x2, y2);
 
-      aabb.lowerBound = lower;
-      aabb.upperBound = upper;
+/**
+ * @brief queryAABBHits do an aabb query and return what was hit
+ * @param state lua state
+ *    param 1: aabb x1
+ *    param 2: aabb y1
+ *    param 3: aabb x2
+ *    param 4: aabb y2
+ *    return hit buffer, #hits is the hit count, hits:get(i) returns type, body id, x, y, fraction
+ * @return 1 if the buffer was pushed
+ */
+int32_t queryAABBHits(lua_State* state)
+{
+   // number of function arguments are on top of the stack.
+   auto argc = lua_gettop(state);
 
-      // std::cout << "x: " << aabb.GetCenter().x << " y: " << aabb.GetCenter().y << std::endl;
+   if (argc == 4)
+   {
+      auto x1 = static_cast<float>(lua_tonumber(state, 1));
+      auto y1 = static_cast<float>(lua_tonumber(state, 2));
+      auto x2 = static_cast<float>(lua_tonumber(state, 3));
+      auto y2 = static_cast<float>(lua_tonumber(state, 4));
 
       std::shared_ptr<LuaNode> node = OBJINSTANCE;
 
@@ -173,8 +340,8 @@ int32_t queryAABB(lua_State* state)
          return 0;
       }
 
-      const auto hitCount = node->queryAABB(aabb);
-      lua_pushinteger(state, hitCount);
+      node->queryAABB(x1, y1, x2, y2);
+      node->pushQueryResult();
       return 1;
    }
 
@@ -199,16 +366,48 @@ int32_t queryRayCast(lua_State* state)
 
    if (argc == 4)
    {
-      b2Vec2 p1;
-      b2Vec2 p2;
+      auto x1 = static_cast<float>(lua_tointeger(state, 1));
+      auto y1 = static_cast<float>(lua_tointeger(state, 2));
+      auto x2 = static_cast<float>(lua_tointeger(state, 3));
+      auto y2 = static_cast<float>(lua_tointeger(state, 4));
+
+      std::shared_ptr<LuaNode> node = OBJINSTANCE;
+
+      if (!node)
+      {
+         return 0;
+      }
+
+      const auto hitCount = node->queryRaycast(x1, y1, x2, y2);
+      lua_pushinteger(state, hitCount);
+      return 1;
+   }
 
-      auto x1 = static_cast<float>(lua_tointeger(state, 1) * MPP);
-      auto y1 = static_cast<float>(lua_tointeger(state, 2) * MPP);
-      auto x2 = static_cast<float>(lua_tointeger(state, 3) * MPP);
-      auto y2 = static_cast<float>(lua_tointeger(state, 4) * MPP);
+   return 0;
+}
+
+
+/**
+ * @brief queryRayCastHit do a raycast and return the closest hit
+ * @param state lua state
+ *    param 1 x1
+ *    param 2 y1
+ *    param 3 x2
+ *    param 4 y2
+ *    return hit buffer with the closest hit or no hit at all
+ * @return 1 if the buffer was pushed
+ */
+int32_t queryRayCastHit(lua_State* state)
+{
+   // number of function arguments are on top of the stack.
+   auto argc = lua_gettop(state);
 
-      p1.Set(x1, y1);
-      p2.Set(x2, y2);
+   if (argc == 4)
+   {
+      auto x1 = static_cast<float>(lua_tonumber(state, 1));
+      auto y1 = static_cast<float>(lua_tonumber(state, 2));
+      auto x2 = static_cast<float>(lua_tonumber(state, 3));
+      auto y2 = static_cast<float>(lua_tonumber(state, 4));
 
       std::shared_ptr<LuaNode> node = OBJINSTANCE;
 
@@ -217,8 +416,50 @@ int32_t queryRayCast(lua_State* state)
          return 0;
       }
 
-      const auto hitCount = node->queryRaycast(p1, p2);
-      lua_pushinteger(state, hitCount);
+      node->queryRaycast(x1, y1, x2, y2);
+      node->pushQueryResult();
+      return 1;
+   }
+
+   return 0;
+}
+
+
+/**
+ * @brief queryRayFan cast a fan of rays, e.g. for a cone of vision
+ * @param state lua state
+ *    param 1 x origin
+ *    param 2 y origin
+ *    param 3 angle of the center ray in radians
+ *    param 4 angle covered by the fan in radians
+ *    param 5 ray length
+ *    param 6 ray count
+ *    return hit buffer with one hit per ray, rays without hit have type -1 and end at their end point
+ * @return 1 if the buffer was pushed
+ */
+int32_t queryRayFan(lua_State* state)
+{
+   // number of function arguments are on top of the stack.
+   auto argc = lua_gettop(state);
+
+   if (argc == 6)
+   {
+      auto x = static_cast<float>(lua_tonumber(state, 1));
+      auto y = static_cast<float>(lua_tonumber(state, 2));
+      auto angle = static_cast<float>(lua_tonumber(state, 3));
+      auto spread = static_cast<float>(lua_tonumber(state, 4));
+      auto length = static_cast<float>(lua_tonumber(state, 5));
+      auto count = static_cast<int32_t>(lua_tointeger(state, 6));
+
+      std::shared_ptr<LuaNode> node = OBJINSTANCE;
+
+      if (!node)
+      {
+         return 0;
+      }
+
+      node->queryRayFan(x, y, angle, spread, length, count);
+      node->pushQueryResult();
       return 1;
    }
 
@@ -246,7 +487,7 @@ int32_t setDamage(lua_State* state)
          return 0;
       }
 
-      node->setDamage(damage);
+      node->execute([node, damage](){node->setDamage(damage);});
    }
 
    return 0;
@@ -295,7 +536,7 @@ int32_t makeDynamic(lua_State* state)
       return 0;
    }
 
-   node->makeDynamic();
+   node->execute([node](){node->makeDynamic();});
    return 0;
 }
 
@@ -314,7 +555,7 @@ int32_t makeStatic(lua_State* state)
       return 0;
    }
 
-   node->makeStatic();
+   node->execute([node](){node->makeStatic();});
    return 0;
 }
 
@@ -342,7 +583,7 @@ int32_t setGravityScale(lua_State* state)
          return 0;
       }
 
-      node->setGravityScale(scale);
+      node->execute([node, scale](){node->setGravityScale(scale);});
    }
 
    return 0;
@@ -372,7 +613,7 @@ int32_t setActive(lua_State* state)
          return 0;
       }
 
-      node->setActive(active);
+      node->execute([node, active](){node->setActive(active);});
    }
 
    return 0;
@@ -465,7 +706,7 @@ int32_t setLinearVelocity(lua_State* state)
          return 0;
       }
 
-      node->setLinearVelocity(b2Vec2{vx, vy});
+      node->execute([node, vx, vy](){node->setLinearVelocity(b2Vec2{vx, vy});});
    }
 
    return 0;
@@ -491,7 +732,6 @@ int32_t damage(lua_State* state)
       auto dx = static_cast<float>(lua_tonumber(state, 2));
       auto dy = static_cast<float>(lua_tonumber(state, 3));
 
-      std::cout << "damage: " << damage << " dx: " << dx << " dy: " << dy << std::endl;
 
       std::shared_ptr<LuaNode> node = OBJINSTANCE;
 
@@ -500,7 +740,13 @@ int32_t damage(lua_State* state)
          return 0;
       }
 
-      node->damage(damage, dx, dy);
+      node->execute(
+         [node, damage, dx, dy]()
+         {
+            std::cout << "damage: " << damage << " dx: " << dx << " dy: " << dy << std::endl;
+            node->damage(damage, dx, dy);
+         }
+      );
    }
 
    return 0;
@@ -535,7 +781,7 @@ int32_t damageRadius(lua_State* state)
          return 0;
       }
 
-      node->damageRadius(damage, x, y, radius);
+      node->execute([node, damage, x, y, radius](){node->damageRadius(damage, x, y, radius);});
    }
 
    return 0;
@@ -569,7 +815,7 @@ int32_t setTransform(lua_State* state)
       }
 
       b2Vec2 pos{x / PPM, y / PPM};
-      node->setTransform(pos, angle);
+      node->execute([node, pos, angle](){node->setTransform(pos, angle);});
    }
 
    return 0;
@@ -688,7 +934,7 @@ int32_t boom(lua_State* state)
          return 0;
       }
 
-      node->boom(x, y, intensity);
+      node->execute([node, x, y, intensity](){node->boom(x, y, intensity);});
    }
 
    return 0;
@@ -719,7 +965,7 @@ int32_t playDetonationAnimation(lua_State* state)
          return 0;
       }
 
-      node->playDetonationAnimation(x, y);
+      node->execute([node, x, y](){node->playDetonationAnimation(x, y);});
    }
 
    return 0;
@@ -751,7 +997,7 @@ int32_t addShapeCircle(lua_State* state)
          return 0;
       }
 
-      node->addShapeCircle(r, x, y);
+      node->execute([node, r, x, y](){node->addShapeCircle(r, x, y);});
    }
 
    return 0;
@@ -785,7 +1031,7 @@ int32_t addShapeRect(lua_State* state)
          return 0;
       }
 
-      node->addShapeRect(width, height, x, y);
+      node->execute([node, width, height, x, y](){node->addShapeRect(width, height, x, y);});
    }
 
    return 0;
@@ -805,26 +1051,23 @@ int32_t addShapePoly(lua_State* state)
 
    if (argc >= 2 && (argc % 2 == 0))
    {
-      auto size = argc / 2;
-      b2Vec2* poly = new b2Vec2[static_cast<uint32_t>(size)];
-      auto polyIndex = 0;
+      std::vector<b2Vec2> poly;
+      poly.reserve(static_cast<size_t>(argc / 2));
       for (auto i = 0; i < argc; i += 2)
       {
          auto x = static_cast<float>(lua_tonumber(state, i));
          auto y = static_cast<float>(lua_tonumber(state, i + 1));
-         poly[polyIndex].Set(x, y);
-         polyIndex++;
+         poly.emplace_back(x, y);
       }
 
       std::shared_ptr<LuaNode> node = OBJINSTANCE;
 
       if (!node)
       {
-         delete[] poly;
          return 0;
       }
 
-      node->addShapePoly(poly, size);
+      node->execute([node, poly](){node->addShapePoly(poly.data(), static_cast<int32_t>(poly.size()));});
    }
 
    return 0;
@@ -895,8 +1138,16 @@ int32_t addWeapon(lua_State* state)
       return 0;
    }
 
-   auto weapon = WeaponFactory::create(node->mBody, weapon_type, std::move(shape), fireInterval, damage);
-   node->addWeapon(std::move(weapon));
+   // std::function needs a copyable capture
+   auto shapeHolder = std::make_shared<std::unique_ptr<b2Shape>>(std::move(shape));
+
+   node->execute(
+      [node, weapon_type, shapeHolder, fireInterval, damage]()
+      {
+         auto weapon = WeaponFactory::create(node->mBody, weapon_type, std::move(*shapeHolder), fireInterval, damage);
+         node->addWeapon(std::move(weapon));
+      }
+   );
 
    return 0;
 }
@@ -933,7 +1184,7 @@ int32_t fireWeapon(lua_State* state)
          return 0;
       }
 
-      node->fireWeapon(index, {posX, posY}, {dirX, dirY});
+      node->execute([node, index, posX, posY, dirX, dirY](){node->fireWeapon(index, {posX, posY}, {dirX, dirY});});
    }
 
    return 0;
@@ -988,8 +1239,14 @@ int32_t updateProjectileTexture(lua_State* state)
       {
          return 0;
       }
-      const auto& texture = TexturePool::getInstance().get(path);
-      node->mWeapons[index]->setProjectileAnimation(texture, rect);
+
+      node->execute(
+         [node, index, path, rect]()
+         {
+            const auto& texture = TexturePool::getInstance().get(path);
+            node->mWeapons[index]->setProjectileAnimation(texture, rect);
+         }
+      );
    }
 
    return 0;
@@ -1035,29 +1292,34 @@ int32_t updateProjectileAnimation(lua_State* state)
          return 0;
       }
 
-      auto texture = TexturePool::getInstance().get(path);
-
-      sf::Vector2f frame_origin{frame_origin_x, frame_origin_y};
-
-      // assume identical frame times for now
-      std::vector<sf::Time> frame_times;
-      for (auto i = 0u; i < frame_count; i++)
-      {
-         frame_times.push_back(sf::seconds(time_per_frame_s));
-      }
-
-      AnimationFrameData frame_data(
-         texture,
-         frame_origin,
-         frame_width,
-         frame_height,
-         frame_count,
-         frames_per_row,
-         frame_times,
-         start_frame
+      node->execute(
+         [=]()
+         {
+            auto texture = TexturePool::getInstance().get(path);
+
+            sf::Vector2f frame_origin{frame_origin_x, frame_origin_y};
+
+            // assume identical frame times for now
+            std::vector<sf::Time> frame_times;
+            for (auto i = 0u; i < frame_count; i++)
+            {
+               frame_times.push_back(sf::seconds(time_per_frame_s));
+            }
+
+            AnimationFrameData frame_data(
+               texture,
+               frame_origin,
+               frame_width,
+               frame_height,
+               frame_count,
+               frames_per_row,
+               frame_times,
+               start_frame
+            );
+
+            node->mWeapons[weapon_index]->setProjectileAnimation(frame_data);
+         }
       );
-
-      node->mWeapons[weapon_index]->setProjectileAnimation(frame_data);
    }
 
    return 0;
@@ -1087,9 +1349,14 @@ int32_t timer(lua_State* state)
          return 0;
       }
 
-      Timer::add(
-         std::chrono::milliseconds(delay),
-         [node, timerId](){node->luaTimeout(timerId);}
+      node->execute(
+         [node, delay, timerId]()
+         {
+            Timer::add(
+               std::chrono::milliseconds(delay),
+               [node, timerId](){node->luaTimeout(timerId);}
+            );
+         }
       );
    }
 
@@ -1110,8 +1377,15 @@ int32_t addSample(lua_State* state)
 
    if (argc == 1)
    {
-      auto sample = lua_tostring(state, 1);
-      Audio::getInstance()->addSample(sample);
+      std::string sample = lua_tostring(state, 1);
+      std::shared_ptr<LuaNode> node = OBJINSTANCE;
+
+      if (!node)
+      {
+         return 0;
+      }
+
+      node->execute([sample](){Audio::getInstance()->addSample(sample);});
    }
 
    return 0;
@@ -1132,10 +1406,21 @@ int32_t playSample(lua_State* state)
 
    if (argc == 2)
    {
-      auto sample = lua_tostring(state, 1);
+      std::string sample = lua_tostring(state, 1);
       auto volume = static_cast<float>(lua_tonumber(state, 2));
+      std::shared_ptr<LuaNode> node = OBJINSTANCE;
+
+      if (!node)
+      {
+         return 0;
+      }
+
+      // enemies far away from the player shouldn't be heard at full volume
+      Audio::PlayInfo info;
+      info.mVolume = volume;
+      info.mPosition = node->mPosition;
 
-      Audio::getInstance()->playSample(sample, volume);
+      node->execute([sample, info](){Audio::getInstance()->playSample(Audio::getInstance()->getSample(sample), info);});
    }
 
    return 0;
@@ -1155,8 +1440,15 @@ int32_t debug(lua_State* state)
 
    if (argc == 1)
    {
-      const char* message = lua_tostring(state, 1);
-      puts(message);
+      std::string message = lua_tostring(state, 1);
+      std::shared_ptr<LuaNode> node = OBJINSTANCE;
+
+      if (!node)
+      {
+         return 0;
+      }
+
+      node->execute([message](){puts(message.c_str());});
    }
 
    return 0;
@@ -1190,16 +1482,6 @@ int32_t registerHitAnimation(lua_State* state)
       auto frames_per_row        = static_cast<uint32_t>(lua_tointeger(state, 7));
       auto start_frame           = static_cast<uint32_t>(lua_tointeger(state, 8));
 
-      ProjectileHitAnimation::addReferenceAnimation(
-         path,
-         frame_width,
-         frame_height,
-         std::chrono::duration<float, std::chrono::seconds::period>{time_per_frame_s},
-         frame_count,
-         frames_per_row,
-         start_frame
-      );
-
       std::shared_ptr<LuaNode> node = OBJINSTANCE;
 
       if (!node)
@@ -1207,7 +1489,22 @@ int32_t registerHitAnimation(lua_State* state)
          return 0;
       }
 
-      node->mWeapons[weapon_index]->setProjectileIdentifier(path.string());
+      node->execute(
+         [=]()
+         {
+            ProjectileHitAnimation::addReferenceAnimation(
+               path,
+               frame_width,
+               frame_height,
+               std::chrono::duration<float, std::chrono::seconds::period>{time_per_frame_s},
+               frame_count,
+               frames_per_row,
+               start_frame
+            );
+
+            node->mWeapons[weapon_index]->setProjectileIdentifier(path.string());
+         }
+      );
    }
 
    return 0;
@@ -1270,7 +1567,7 @@ int32_t die(lua_State* state)
       return 0;
    }
 
-   node->luaDie();
+   node->execute([node](){node->luaDie();});
    return 0;
 }
 
@@ -1295,7 +1592,7 @@ int32_t die(lua_State* state)
 
 void LuaNode::setupTexture()
 {
-   std::string spriteName = std::get<std::string>(mProperties["sprite"]);
+   const auto spriteName = mProperties.get<std::string>(PropertyKey::Sprite);
 
    mTexture = TexturePool::getInstance().get(spriteName);
 
@@ -1406,7 +1703,10 @@ void LuaNode::setupLua()
    lua_register(mState, "playDetonationAnimation", ::playDetonationAnimation);
    lua_register(mState, "playSample", ::playSample);
    lua_register(mState, "queryAABB", ::queryAABB);
+   lua_register(mState, "queryAABBHits", ::queryAABBHits);
    lua_register(mState, "queryRayCast", ::queryRayCast);
+   lua_register(mState, "queryRayCastHit", ::queryRayCastHit);
+   lua_register(mState, "queryRayFan", ::queryRayFan);
    lua_register(mState, "registerHitAnimation", ::registerHitAnimation);
    lua_register(mState, "setActive", ::setActive);
    lua_register(mState, "setDamage", ::setDamage);
@@ -1426,6 +1726,29 @@ void LuaNode::setupLua()
    // make standard libraries available in the Lua object
    luaL_openlibs(mState);
 
+   luaL_newmetatable(mState, pathViewMetatable);
+   lua_pushcfunction(mState, pathViewIndex);
+   lua_setfield(mState, -2, "__index");
+   lua_pushcfunction(mState, pathViewLen);
+   lua_setfield(mState, -2, "__len");
+   lua_pushcfunction(mState, pathViewPairs);
+   lua_setfield(mState, -2, "__pairs");
+   lua_pop(mState, 1);
+
+   luaL_newmetatable(mState, queryResultMetatable);
+   lua_newtable(mState);
+   lua_pushcfunction(mState, queryResultGet);
+   lua_setfield(mState, -2, "get");
+   lua_setfield(mState, -2, "__index");
+   lua_pushcfunction(mState, queryResultLen);
+   lua_setfield(mState, -2, "__len");
+   lua_pop(mState, 1);
+
+   auto queryResult = static_cast<QueryResultView*>(lua_newuserdata(mState, sizeof(QueryResultView)));
+   queryResult->mHits = &mQueryHits;
+   luaL_setmetatable(mState, queryResultMetatable);
+   mQueryResultRef = luaL_ref(mState, LUA_REGISTRYINDEX);
+
    // load program
    auto result = luaL_loadfile(mState, mScriptName.c_str());
    if (result == LUA_OK)
@@ -1444,6 +1767,7 @@ void LuaNode::setupLua()
          luaInitialize();
          luaRetrieveProperties();
          luaSendPatrolPath();
+         setupDispatcher();
       }
    }
    else
@@ -1489,25 +1813,6 @@ void LuaNode::luaInitialize()
 }
 
 
-/**
- * @brief LuaNode::luaUpdate update the lua node
- * @param dt delta time, passed to luanode in seconds
- * callback name: update
- */
-void LuaNode::luaUpdate(const sf::Time& dt)
-{
-   lua_getglobal(mState, FUNCTION_UPDATE);
-   lua_pushnumber(mState, dt.asSeconds());
-
-   auto result = lua_pcall(mState, 1, 0, 0);
-
-   if (result != LUA_OK)
-   {
-      error(mState, FUNCTION_UPDATE);
-   }
-}
-
-
 /**
  * @brief LuaNode::luaWriteProperty write a property of the luanode
  * @param key property key
@@ -1533,42 +1838,146 @@ void LuaNode::luaWriteProperty(const std::string& key, const std::string& value)
 
 
 /**
- * @brief LuaNode::luaHit luanode got hit by something
+ * @brief LuaNode::luaHit luanode got hit by something, queued until the next dispatch
  * @param damage amount of damage from 0..100 while 100 is fatal
  * callback name: hit
  */
 void LuaNode::luaHit(int32_t damage)
 {
-   // std::cout << "thing was hit: " << damage << std::endl;
+   mEvents.emplace_back(Event::Hit, damage);
+}
 
-   lua_getglobal(mState, FUNCTION_HIT);
-   if (lua_isfunction(mState, -1) )
+
+/**
+ * @brief LuaNode::luaCollisionWithPlayer indicate collision with player, queued until the next dispatch
+ * callback name: collisionWithPlayer
+ */
+void LuaNode::luaCollisionWithPlayer()
+{
+   mEvents.emplace_back(Event::CollisionWithPlayer, 0);
+}
+
+
+/**
+ * @brief LuaNode::luaPlayerEnteredRoom indicate the player moved to another room, queued until the next dispatch
+ * @param roomId id of the room the player is in now, -1 if the player is outside all rooms
+ * callback name: playerEnteredRoom
+ */
+void LuaNode::luaPlayerEnteredRoom(int32_t roomId)
+{
+   mEvents.emplace_back(Event::PlayerEnteredRoom, roomId);
+}
+
+
+/**
+ * @brief LuaNode::setupDispatcher look up the script's callbacks once and keep the dispatch function in the registry
+ */
+void LuaNode::setupDispatcher()
+{
+   mEvents.reserve(8);
+
+   if (luaL_loadstring(mState, dispatcherSource) != LUA_OK)
    {
-      lua_pushinteger(mState, damage);
+      error(mState);
+   }
 
-      auto result = lua_pcall(mState, 1, 0, 0);
-      if (result != LUA_OK)
-      {
-         error(mState, FUNCTION_HIT);
+   for (auto name : {
+         FUNCTION_MOVED_TO,
+         FUNCTION_PLAYER_MOVED_TO,
+         FUNCTION_UPDATE,
+         FUNCTION_HIT,
+         FUNCTION_TIMEOUT,
+         FUNCTION_COLLISION_WITH_PLAYER,
+         FUNCTION_PLAYER_ENTERED_ROOM
       }
+   )
+   {
+      lua_getglobal(mState, name);
    }
+
+   if (lua_pcall(mState, 7, 1, 0) != LUA_OK)
+   {
+      error(mState);
+   }
+
+   mDispatcherRef = luaL_ref(mState, LUA_REGISTRYINDEX);
+}
+
+
+bool LuaNode::hasPendingEvents() const
+{
+   return !mEvents.empty();
 }
 
 
 /**
- * @brief LuaNode::luaCollisionWithPlayer indicate collision with player
- * callback name: collisionWithPlayer
+ * @brief LuaNode::applyCommands run the engine calls a script made while commands were recorded
  */
-void LuaNode::luaCollisionWithPlayer()
+void LuaNode::applyCommands()
 {
-   lua_getglobal(mState, FUNCTION_COLLISION_WITH_PLAYER);
-   if (lua_isfunction(mState, -1) )
+   // commands may queue further commands or events, so take the buffer first
+   auto commands = std::move(mCommands);
+   mCommands.clear();
+
+   for (auto& command : commands)
    {
-      auto result = lua_pcall(mState, 0, 0, 0);
-      if (result != LUA_OK)
-      {
-         error(mState, FUNCTION_COLLISION_WITH_PLAYER);
-      }
+      command();
+   }
+
+   // hand the storage back to keep the capacity
+   commands.clear();
+   if (mCommands.empty())
+   {
+      mCommands.swap(commands);
+   }
+}
+
+
+/**
+ * @brief LuaNode::luaDispatch deliver queued events and the per-frame callbacks in one call
+ * @param tick if set, movedTo, playerMovedTo and update are called after the events
+ * @param dt delta time passed to update, in seconds
+ * callback names: hit, timeout, collisionWithPlayer, playerEnteredRoom, movedTo, playerMovedTo, update
+ */
+void LuaNode::luaDispatch(bool tick, const sf::Time& dt)
+{
+   if (mDispatcherRef <= 0)
+   {
+      return;
+   }
+
+   const auto eventCount = static_cast<int32_t>(mEvents.size());
+   const auto argumentCount = 6 + 2 * eventCount;
+
+   if (!lua_checkstack(mState, argumentCount + 1))
+   {
+      std::cerr << "[!] too many queued events for " << mScriptName << std::endl;
+      mEvents.clear();
+      return;
+   }
+
+   const auto playerPosition = Player::getCurrent()->getPixelPositionf();
+
+   lua_rawgeti(mState, LUA_REGISTRYINDEX, mDispatcherRef);
+   lua_pushboolean(mState, tick);
+   lua_pushnumber(mState, static_cast<double>(mPosition.x));
+   lua_pushnumber(mState, static_cast<double>(mPosition.y));
+   lua_pushnumber(mState, static_cast<double>(playerPosition.x));
+   lua_pushnumber(mState, static_cast<double>(playerPosition.y));
+   lua_pushnumber(mState, static_cast<double>(dt.asSeconds()));
+
+   for (const auto& [event, value] : mEvents)
+   {
+      lua_pushinteger(mState, static_cast<lua_Integer>(event));
+      lua_pushinteger(mState, value);
+   }
+
+   // callbacks may queue new events, those go out with the next dispatch
+   mEvents.clear();
+
+   if (lua_pcall(mState, argumentCount, 0, 0) != LUA_OK)
+   {
+      error(mState, FUNCTION_UPDATE);
    }
 }
 
@@ -1670,33 +2079,6 @@ void LuaNode::luaSetStartPosition()
 }
 
 
-/**
- * @brief LuaNode::luaPlayerMovedTo engine moved player to a certain position
- * callback name: playerMovedTo
- * lua param x: x position of player position (double)
- * lua param y: y position of player position (double)
- */
-void LuaNode::luaPlayerMovedTo()
-{
-   const auto pos =  Player::getCurrent()->getPixelPositionf();
-
-   lua_getglobal(mState, FUNCTION_PLAYER_MOVED_TO);
-
-   if (lua_isfunction(mState, -1))
-   {
-      lua_pushnumber(mState, pos.x);
-      lua_pushnumber(mState, pos.y);
-
-      auto result = lua_pcall(mState, 2, 0, 0);
-
-      if (result != LUA_OK)
-      {
-         error(mState, FUNCTION_PLAYER_MOVED_TO);
-      }
-   }
-}
-
-
 /**
  * @brief LuaNode::luaRetrieveProperties instruct lua node to retrieve properties now
  * callback name: retrieveProperties
@@ -1716,41 +2098,29 @@ void LuaNode::luaRetrieveProperties()
 
 
 /**
- * @brief LuaNode::luaTimeout timeout timer fired
+ * @brief LuaNode::luaTimeout timeout timer fired, queued until the next dispatch
  * @param timerId timer id of timeout timer
  * callback name: timeout
  * lua param timerId: id of timeout timer
  */
 void LuaNode::luaTimeout(int32_t timerId)
 {
-   lua_getglobal(mState, FUNCTION_TIMEOUT);
-   lua_pushinteger(mState, timerId);
-
-   auto result = lua_pcall(mState, 1, 0, 0);
-
-   if (result != LUA_OK)
-   {
-      error(mState, FUNCTION_TIMEOUT);
-   }
+   mEvents.emplace_back(Event::Timeout, timerId);
 }
 
 
 /**
  * @brief LuaNode::luaSendPath inject a path into the current lua state
+ * the path is not copied, lua gets a view that supports indexing, # and pairs like the
+ * flat x, y, x, y, ... table it replaces. vec must outlive the lua state.
  * @param vec vector of 2d vectors
  */
 void LuaNode::luaSendPath(const std::vector<sf::Vector2f>& vec)
 {
-   lua_newtable(mState);
+   auto view = static_cast<PathView*>(lua_newuserdata(mState, sizeof(PathView)));
+   view->mPath = &vec;
 
-   int32_t i = 0;
-   for (const auto& v : vec)
-   {
-      lua_pushnumber(mState, v.x); // push x
-      lua_rawseti(mState,-2,++i);
-      lua_pushnumber(mState, v.y); // push y
-      lua_rawseti(mState,-2,++i);
-   }
+   luaL_setmetatable(mState, pathViewMetatable);
 }
 
 
@@ -1862,7 +2232,7 @@ void LuaNode::setDamage(int32_t damage)
       }
 
       auto fixtureNode = static_cast<FixtureNode*>(fixture->GetUserData());
-      fixtureNode->setProperty("damage", damage);
+      fixtureNode->setProperty(PropertyKey::Damage, damage);
    }
 }
 
@@ -1879,96 +2249,84 @@ void LuaNode::makeStatic()
 }
 
 
-class LuaQueryCallback : public b2QueryCallback
+int32_t LuaNode::queryAABB(float x1, float y1, float x2, float y2)
 {
-   public:
+   SpatialQuery::getInstance().queryAABB(Level::getCurrentLevel()->getWorld().get(), x1, y1, x2, y2, mQueryHits);
+   return static_cast<int32_t>(mQueryHits.size());
+}
 
-      std::vector<b2Body*> mBodies;
 
-      bool ReportFixture(b2Fixture* fixture)
-      {
-         mBodies.push_back(fixture->GetBody());
-
-         // to keep going to find all fixtures in the query area
-         return true;
-      }
-};
+int32_t LuaNode::queryRaycast(float x1, float y1, float x2, float y2)
+{
+   SpatialQuery::getInstance().rayCast(Level::getCurrentLevel()->getWorld().get(), x1, y1, x2, y2, mQueryHits);
+   return static_cast<int32_t>(mQueryHits.size());
+}
 
 
-int32_t LuaNode::queryAABB(const b2AABB& aabb)
+int32_t LuaNode::queryRayFan(float x, float y, float angle, float spread, float length, int32_t count)
 {
-   LuaQueryCallback queryCallback;
-   Level::getCurrentLevel()->getWorld()->QueryAABB(&queryCallback, aabb);
+   SpatialQuery::getInstance().rayFan(
+      Level::getCurrentLevel()->getWorld().get(),
+      x,
+      y,
+      angle,
+      spread,
+      length,
+      count,
+      mQueryHits
+   );
 
-   // std::cout << queryCallback.mBodies.size() << std::endl;
-   return static_cast<int32_t>(queryCallback.mBodies.size());
+   return static_cast<int32_t>(mQueryHits.size());
 }
 
 
-class LuaRaycastCallback : public b2RayCastCallback
+void LuaNode::pushQueryResult()
 {
-   public:
+   lua_rawgeti(mState, LUA_REGISTRYINDEX, mQueryResultRef);
+}
 
-      std::vector<b2Body*> mBodies;
 
-      float ReportFixture(
-         b2Fixture* fixture,
-         const b2Vec2& /*point*/,
-         const b2Vec2& /*normal*/,
-         float32 /*fraction*/
-      )
-      {
-         mBodies.push_back(fixture->GetBody());
-         return 0.0f;
-      }
-};
+bool LuaNode::getPropertyBool(PropertyKey::Key key) const
+{
+   return mProperties.get<bool>(key, false);
+}
 
 
-int32_t LuaNode::queryRaycast(const b2Vec2& point1, const b2Vec2& point2)
+bool LuaNode::getPropertyBool(const std::string& key) const
 {
-   LuaRaycastCallback queryCallback;
-   Level::getCurrentLevel()->getWorld()->RayCast(&queryCallback, point1, point2);
+   return getPropertyBool(PropertyKey::find(key));
+}
+
 
-   // std::cout << queryCallback.mBodies.size() << std::endl;
-   return static_cast<int32_t>(queryCallback.mBodies.size());
+double LuaNode::getPropertyDouble(PropertyKey::Key key) const
+{
+   return mProperties.get<double>(key, 0.0);
 }
 
 
-bool LuaNode::getPropertyBool(const std::string& key)
+double LuaNode::getPropertyDouble(const std::string& key) const
 {
-   auto value = false;
-   auto it = mProperties.find(key);
-   if (it !=  mProperties.end())
-      value = std::get<bool>(it->second);
-   return value;
+   return getPropertyDouble(PropertyKey::find(key));
 }
 
 
-double LuaNode::getPropertyDouble(const std::string& key)
+int64_t LuaNode::getPropertyInt64(PropertyKey::Key key) const
 {
-   auto value = 0.0;
-   auto it = mProperties.find(key);
-   if (it !=  mProperties.end())
-      value = std::get<double>(it->second);
-   return value;
+   return mProperties.get<int64_t>(key, 0);
 }
 
 
-int64_t LuaNode::getPropertyInt64(const std::string &key)
+int64_t LuaNode::getPropertyInt64(const std::string& key) const
 {
-   auto value = 0LL;
-   auto it = mProperties.find(key);
-   if (it !=  mProperties.end())
-      value = std::get<int64_t>(it->second);
-   return value;
+   return getPropertyInt64(PropertyKey::find(key));
 }
 
 
 void LuaNode::setupBody()
 {
-   auto staticBody = getPropertyBool("staticBody");
-   auto damage = static_cast<int32_t>(getPropertyInt64("damage"));
-   auto sensor = static_cast<bool>(getPropertyBool("sensor"));
+   auto staticBody = getPropertyBool(PropertyKey::StaticBody);
+   auto damage = static_cast<int32_t>(getPropertyInt64(PropertyKey::Damage));
+   auto sensor = getPropertyBool(PropertyKey::Sensor);
 
    mBody->SetTransform(b2Vec2{mStartPosition.x * MPP, mStartPosition.y * MPP}, 0.0f);
    mBody->SetFixedRotation(true);
@@ -1991,7 +2349,7 @@ void LuaNode::setupBody()
       b2Fixture* fixture = mBody->CreateFixture(&fd);
       FixtureNode* fixtureNode = new FixtureNode(this);
       fixtureNode->setType(ObjectTypeEnemy);
-      fixtureNode->setProperty("damage", damage);
+      fixtureNode->setProperty(PropertyKey::Damage, damage);
       fixtureNode->setCollisionCallback([this](){luaCollisionWithPlayer();});
       fixture->SetUserData(static_cast<void*>(fixtureNode));
 
@@ -2060,20 +2418,8 @@ void LuaNode::updateVelocity()
       return;
    }
 
-   auto velocityMax = 0.0;
-   auto acceleration = 0.0;
-
-   auto velIt = mProperties.find("velocity_walk_max");
-   if (velIt != mProperties.end())
-   {
-      velocityMax = *std::get_if<double>(&(velIt->second));
-   }
-
-   auto accIt = mProperties.find("acceleration_ground");
-   if (accIt != mProperties.end())
-   {
-      acceleration = *std::get_if<double>(&(accIt->second));
-   }
+   const auto velocityMax = getPropertyDouble(PropertyKey::VelocityWalkMax);
+   const auto acceleration = getPropertyDouble(PropertyKey::AccelerationGround);
 
    auto desiredVel = 0.0f;
    auto velocity = mBody->GetLinearVelocity();
@@ -1,10 +1,12 @@
 #pragma once
 
 #include <atomic>
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
 #include <variant>
+#include <vector>
 
 // box2d
 #include "Box2D/Box2D.h"
@@ -15,12 +17,23 @@
 // game
 #include "leveldescription.h"
 #include "gamenode.h"
+#include "propertytable.h"
+#include "spatialquery.h"
 #include "weapon.h"
 
 struct lua_State;
 
 struct LuaNode : public GameNode
 {
+   // callbacks that are queued and passed to the script with the next dispatch
+   enum class Event : int32_t
+   {
+      Hit = 1,
+      Timeout = 2,
+      CollisionWithPlayer = 3,
+      PlayerEnteredRoom = 4
+   };
+
    LuaNode(const std::string &filename);
    ~LuaNode();
 
@@ -73,11 +86,17 @@ struct LuaNode : public GameNode
    //! make the body a static object
    void makeStatic();
 
-   //! query bodies within a given aabb
-   int32_t queryAABB(const b2AABB& aabb);
+   //! query fixtures within a given aabb (px), the hits go to mQueryHits
+   int32_t queryAABB(float x1, float y1, float x2, float y2);
+
+   //! cast a ray between two points (px), the closest hit goes to mQueryHits
+   int32_t queryRaycast(float x1, float y1, float x2, float y2);
+
+   //! cast count rays spread over an angle (radians), one hit per ray goes to mQueryHits
+   int32_t queryRayFan(float x, float y, float angle, float spread, float length, int32_t count);
 
-   //! cast a ray between two points
-   int32_t queryRaycast(const b2Vec2& point1, const b2Vec2& point2);
+   //! push the userdata through which scripts read mQueryHits
+   void pushQueryResult();
 
    //! activate or deactivate a body
    void setActive(bool active);
@@ -109,30 +128,60 @@ struct LuaNode : public GameNode
    void luaInitialize();
    void luaMovedTo();
    void luaSetStartPosition();
-   void luaPlayerMovedTo();
    void luaRetrieveProperties();
    void luaSendPath(const std::vector<sf::Vector2f> &vec);
    void luaSendPatrolPath();
    void luaTimeout(int32_t timerId);
-   void luaUpdate(const sf::Time& dt);
    void luaWriteProperty(const std::string& key, const std::string& value);
    void luaCollisionWithPlayer();
+   void luaPlayerEnteredRoom(int32_t roomId);
+
+   //! pass queued events and, if tick is set, the per-frame callbacks to the script in a single call
+   void luaDispatch(bool tick, const sf::Time& dt);
+   bool hasPendingEvents() const;
+
+   //! run an engine call right away or, while commands are recorded, queue it for applyCommands
+   template <typename T>
+   void execute(T&& command)
+   {
+      if (mRecordCommands)
+      {
+         mCommands.emplace_back(std::forward<T>(command));
+      }
+      else
+      {
+         command();
+      }
+   }
+
+   //! run the engine calls queued while the script was executed off the main thread
+   void applyCommands();
 
    // property accessors
    void synchronizeProperties();
-   bool getPropertyBool(const std::string& key);
-   double getPropertyDouble(const std::string& key);
-   int64_t getPropertyInt64(const std::string& key);
+   bool getPropertyBool(PropertyKey::Key key) const;
+   bool getPropertyBool(const std::string& key) const;
+   double getPropertyDouble(PropertyKey::Key key) const;
+   double getPropertyDouble(const std::string& key) const;
+   int64_t getPropertyInt64(PropertyKey::Key key) const;
+   int64_t getPropertyInt64(const std::string& key) const;
 
    // box2d related
    void setupBody();
    void stopScript();
+   void setupDispatcher();
 
    // members
    int32_t mId = -1;
    int32_t mKeysPressed = 0;
    std::string mScriptName;
    lua_State* mState = nullptr;
+   int32_t mDispatcherRef = 0; // registry reference of the dispatch function, 0 if there is none
+   std::vector<std::pair<Event, int32_t>> mEvents;
+   bool mRecordCommands = false;
+   std::vector<std::function<void()>> mCommands;
+   std::vector<SpatialQuery::Hit> mQueryHits; // results of the last query
+   int32_t mQueryResultRef = 0;               // registry reference of the userdata reading mQueryHits
    EnemyDescription mEnemyDescription;
 
    // visualization
@@ -147,10 +196,12 @@ struct LuaNode : public GameNode
    // physics
    b2Body* mBody = nullptr;
    b2BodyDef* mBodyDef = nullptr;
+   bool mSimulated = true; // false while the node sleeps outside the simulation region
+   sf::Time mAccumulatedTime; // time since the script's last update call
    std::vector<b2Shape*> mShapes;
    std::vector<std::unique_ptr<Weapon>> mWeapons;
 
-   std::map<std::string, std::variant<std::string, int64_t, double, bool>> mProperties;
+   PropertyTable<std::variant<std::string, int64_t, double, bool>> mProperties;
 
    // static
    static std::atomic<int32_t> sNextId;
@@ -127,6 +127,12 @@ void Crusher::update(const sf::Time& dt)
 }
 
 
+std::vector<b2Body*> Crusher::getBodies() const
+{
+   return {mBody};
+}
+
+
 //-----------------------------------------------------------------------------
 void Crusher::updateState()
 {
@@ -35,6 +35,13 @@ void MoveableBox::update(const sf::Time& /*dt*/)
 }
 
 
+//--------------------------------------------------------------------------------------------------
+std::vector<b2Body*> MoveableBox::getBodies() const
+{
+   return {mBody};
+}
+
+
 // box: pos: 5160 x 1056 size: 48 x 48
 // box: pos: 5376 x 1080 size: 24 x 24
 
@@ -22,6 +22,9 @@
 #include "Box2D/Box2D.h"
 
 
+PathBatch MovingPlatform::sPathBatch;
+
+
 //-----------------------------------------------------------------------------
 MovingPlatform::MovingPlatform(GameNode *parent)
  : GameNode(parent)
@@ -84,6 +87,13 @@ b2Body* MovingPlatform::getBody()
 }
 
 
+//-----------------------------------------------------------------------------
+std::vector<b2Body*> MovingPlatform::getBodies() const
+{
+   return {_body};
+}
+
+
 //-----------------------------------------------------------------------------
 void MovingPlatform::setEnabled(bool enabled)
 {
@@ -161,6 +171,9 @@ std::vector<std::shared_ptr<GameMechanism>> MovingPlatform::load(
 )
 {
    std::vector<std::shared_ptr<GameMechanism>> movingPlatforms;
+
+   // paths of a previous level
+   sPathBatch.clear();
    const auto tilesize = sf::Vector2u(tileSet->_tile_width_px, tileSet->_tile_height_px);
    const auto tiles    = layer->_data;
    const auto width    = layer->_width_px;
@@ -302,10 +315,20 @@ void MovingPlatform::link(const std::vector<std::shared_ptr<GameMechanism>>& pla
 
          i++;
       }
+
+      platform->_interpolation.bake();
+      platform->_path_follower = sPathBatch.addFollower(sPathBatch.addPath(platform->_interpolation));
    }
 }
 
 
+//-----------------------------------------------------------------------------
+void MovingPlatform::updatePaths()
+{
+   sPathBatch.update(PhysicsConfiguration::getInstance().mTimeStep);
+}
+
+
    //  |                 |
    //  |              ____
    //  |        __----
@@ -350,9 +373,15 @@ void MovingPlatform::update(const sf::Time& dt)
 {
    updateLeverLag(dt);
 
-   _interpolation.update(_body->GetPosition());
+   if (_path_follower >= 0)
+   {
+      // the batch has moved the follower already, steer the body so it gets there with the next step.
+      // the speed applies to the next batch update, a platform that sleeps doesn't move on.
+      const auto target = sPathBatch.getPosition(_path_follower);
+      _body->SetLinearVelocity((1.0f / PhysicsConfiguration::getInstance().mTimeStep) * (target - _body->GetPosition()));
 
-   _body->SetLinearVelocity(_lever_lag * TIMESTEP_ERROR * (PPM / 60.0f) * _interpolation.getVelocity());
+      sPathBatch.setSpeed(_path_follower, _lever_lag * TIMESTEP_ERROR * (PPM / 60.0f));
+   }
 
    auto pos = 0;
    auto horizontal = (_width  > 1) ? 1 : 0;
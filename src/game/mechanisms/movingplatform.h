@@ -1,5 +1,6 @@
 #pragma once
 
+#include "framework/math/pathbatch.h"
 #include "framework/math/pathinterpolation.h"
 #include "gamemechanism.h"
 #include "gamenode.h"
@@ -31,8 +32,12 @@ public:
 
    static void link(const std::vector<std::shared_ptr<GameMechanism>>& platforms, TmxObject* tmxObject);
 
+   //! move all platforms along their paths, call once per frame before updating them
+   static void updatePaths();
+
    void draw(sf::RenderTarget& color, sf::RenderTarget& normal) override;
    void update(const sf::Time& dt) override;
+   std::vector<b2Body*> getBodies() const override;
 
    void setupBody(const std::shared_ptr<b2World>& world);
    void addSprite(const sf::Sprite&);
@@ -69,5 +74,10 @@ private:
    bool _initialized = false;
    PathInterpolation _interpolation;
    std::vector<sf::Vector2f> _pixel_path;
+
+   // link() places the keys so the body origin travels through them
+   PathBatch::Follower _path_follower = -1;
+
+   static PathBatch sPathBatch;
 };
 
@@ -232,6 +232,14 @@ void Rope::setup(TmxObject* tmx_object, const std::shared_ptr<b2World>& world)
 }
 
 
+std::vector<b2Body*> Rope::getBodies() const
+{
+   auto bodies = _chain_elements;
+   bodies.push_back(_anchor_a_body);
+   return bodies;
+}
+
+
 sf::Vector2i Rope::getPixelPosition() const
 {
    return _position_px;
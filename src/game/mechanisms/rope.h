@@ -19,6 +19,7 @@ class Rope : public GameMechanism, public GameNode
 
       void draw(sf::RenderTarget& color, sf::RenderTarget& normal) override;
       void update(const sf::Time& dt) override;
+      std::vector<b2Body*> getBodies() const override;
 
       virtual void setup(TmxObject* tmxObject, const std::shared_ptr<b2World>& world);
 
@@ -216,6 +216,15 @@ void SpikeBall::setup(TmxObject* tmx_object, const std::shared_ptr<b2World>& wor
 }
 
 
+std::vector<b2Body*> SpikeBall::getBodies() const
+{
+   auto bodies = _chain_elements;
+   bodies.push_back(_anchor_body);
+   bodies.push_back(_ball_body);
+   return bodies;
+}
+
+
 sf::Vector2i SpikeBall::getPixelPosition() const
 {
    return _pixel_position;
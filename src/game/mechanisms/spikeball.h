@@ -33,6 +33,7 @@ class SpikeBall : public GameMechanism, public GameNode
 
       void draw(sf::RenderTarget& color, sf::RenderTarget& normal) override;
       void update(const sf::Time& dt) override;
+      std::vector<b2Body*> getBodies() const override;
 
       void setup(TmxObject* tmxObject, const std::shared_ptr<b2World>& world);
 
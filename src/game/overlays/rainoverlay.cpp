@@ -2,10 +2,6 @@
 
 #include "game/gameconfiguration.h"
 
-#include <cstdlib>
-#include <iostream>
-#include <ctime>
-
 
 namespace
 {
@@ -30,71 +26,44 @@ namespace
 
 RainOverlay::RainOverlay()
 {
-   std::srand(static_cast<uint32_t>(std::time(nullptr))); // use current time as seed for random generator
-
-   for (auto a = 0; a < dropCount; a++)
-   {
-      mDrops.push_back(RainDrop());
-   }
-
-   mRenderTexture.create(static_cast<uint32_t>(w), static_cast<uint32_t>(h));
-}
-
-
-void RainOverlay::draw(sf::RenderTarget& window, sf::RenderStates /*states*/)
-{
-   static const auto color = sf::Color{174, 194, 224, 30};
-
-   mRenderTexture.clear();
+   ParticleEmitter::Settings settings;
 
-   sf::View view(sf::FloatRect(0.0f, 0.0f, static_cast<float>(w), static_cast<float>(h)));
-   window.setView(view);
+   settings.mShape = ParticleEmitter::Shape::Line;
+   settings.mMaxParticles = dropCount;
+   settings.mRespawn = true;
+   settings.mPrewarm = true;
 
-   sf::Vertex line[2];
+   // drops are respawned above the screen, they die once they leave it to the right or bottom
+   settings.mSpawnArea = {startOffsetX, startOffsetY, w * widthStretchFactor, 0.0f};
+   settings.mBounds = {startOffsetX, startOffsetY, w - startOffsetX, h - startOffsetY};
 
-   for (auto& d : mDrops)
-   {
-      line[0] = sf::Vertex{sf::Vector2f{d.mPos.x, d.mPos.y}, color};
-      line[1] = sf::Vertex{sf::Vector2f{d.mPos.x + d.mLength * d.mDir.x, d.mPos.y + d.mLength * d.mDir.y}, color};
+   settings.mVelocityMin = sf::Vector2f{fixedDirectionX, fixedDirectionY} * velocityFactor;
+   settings.mVelocityMax = sf::Vector2f{
+      fixedDirectionX + 100.0f * randomizeFactorX,
+      fixedDirectionY + 100.0f * randomizeFactorY
+   } * velocityFactor;
 
-      mRenderTexture.draw(line, 2, sf::Lines);
-   }
+   // the line length is given relative to the velocity
+   settings.mSizeMin = fixedLength / velocityFactor;
+   settings.mSizeMax = (fixedLength + 100.0f * randomizeFactorLength) / velocityFactor;
 
-   mRenderTexture.setView(view);
-   mRenderTexture.display();
+   settings.mColor = sf::Color{174, 194, 224, 30};
+   settings.mBlendMode = sf::BlendAdd;
 
-   auto sprite = sf::Sprite(mRenderTexture.getTexture());
-   window.draw(sprite, sf::BlendMode{sf::BlendAdd});
+   mParticles.add(std::make_shared<ParticleEmitter>(settings));
 }
 
 
-void RainOverlay::update(const sf::Time& dt)
+void RainOverlay::draw(sf::RenderTarget& window, sf::RenderStates states)
 {
-   for (auto& p : mDrops)
-   {
-      p.mPos += p.mDir * dt.asSeconds() * velocityFactor;
-
-      if (p.mPos.x > w || p.mPos.y > h)
-      {
-         p.mPos.x = static_cast<float>(std::rand() % w) * widthStretchFactor + startOffsetX;
-         p.mPos.y = startOffsetY;
-      }
-   }
+   sf::View view(sf::FloatRect(0.0f, 0.0f, static_cast<float>(w), static_cast<float>(h)));
+   window.setView(view);
+
+   mParticles.draw(window, states);
 }
 
 
-RainOverlay::RainDrop::RainDrop()
+void RainOverlay::update(const sf::Time& dt)
 {
-   mPos.x = static_cast<float>(std::rand() % w);
-   mPos.y = static_cast<float>(std::rand() % h);
-
-   mLength = (std::rand() % 100) * randomizeFactorLength + fixedLength;
-
-   auto randX = (std::rand() % 100) * randomizeFactorX;
-   auto randY = (std::rand() % 100) * randomizeFactorY;
-
-   mDir.x = randX + fixedDirectionX;
-   mDir.y = randY + fixedDirectionY;
+   mParticles.update(dt);
 }
-
-
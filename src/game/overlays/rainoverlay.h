@@ -2,8 +2,7 @@
 
 #include "weatheroverlay.h"
 
-#include <cstdint>
-#include <vector>
+#include "effects/particlesystem.h"
 
 #include <SFML/Graphics.hpp>
 
@@ -13,16 +12,6 @@ class RainOverlay : public WeatherOverlay
 
 public:
 
-   struct RainDrop
-   {
-      RainDrop();
-
-      sf::Vector2f mPos;
-      sf::Vector2f mDir;
-      float mLength = 0.0f;
-   };
-
-
    RainOverlay();
 
    void draw(sf::RenderTarget& window, sf::RenderStates states = sf::RenderStates::Default);
@@ -30,7 +19,6 @@ public:
 
 private:
 
-   sf::RenderTexture mRenderTexture;
-   std::vector<RainDrop> mDrops;
+   ParticleSystem mParticles;
 };
 
@@ -0,0 +1,28 @@
+#include "islandsolver.h"
+
+#include "framework/tools/workerpool.h"
+
+
+IslandSolver& IslandSolver::getInstance()
+{
+   static IslandSolver solver;
+   return solver;
+}
+
+
+int32 IslandSolver::GetThreadCount() const
+{
+   return static_cast<int32>(WorkerPool::getInstance().getThreadCount());
+}
+
+
+void IslandSolver::ParallelFor(int32 count, b2SolverTask* task)
+{
+   WorkerPool::getInstance().parallelFor(
+      static_cast<size_t>(count),
+      [task](size_t index)
+      {
+         task->Execute(static_cast<int32>(index), static_cast<int32>(WorkerPool::getThreadIndex()));
+      }
+   );
+}
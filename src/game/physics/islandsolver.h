@@ -0,0 +1,20 @@
+#pragma once
+
+#include "Box2D/Box2D.h"
+
+
+// runs box2d's island solver on the worker pool
+//
+// the world groups islands that share a static body and hands out one group per task,
+// contact listener callbacks stay on the main thread (see b2World::SetSolverExecutor).
+class IslandSolver : public b2SolverExecutor
+{
+
+public:
+
+   static IslandSolver& getInstance();
+
+   int32 GetThreadCount() const override;
+   void ParallelFor(int32 count, b2SolverTask* task) override;
+};
+
@@ -43,6 +43,13 @@ std::string PhysicsConfiguration::serialize()
             {"player_jump_speed_factor",             mPlayerJumpSpeedFactor},
             {"player_dash_steps",                    mPlayerDashSteps},
             {"player_dash_factor",                   mPlayerDashFactor},
+            {"simulation_region_enabled",            mSimulationRegionEnabled},
+            {"simulation_region_activation_margin_px",   mSimulationRegionActivationMarginPx},
+            {"simulation_region_deactivation_margin_px", mSimulationRegionDeactivationMarginPx},
+            {"static_chain_cell_size_px",            mStaticChainCellSizePx},
+            {"static_chain_max_edges",               mStaticChainMaxEdges},
+            {"parallel_islands",                     mParallelIslands},
+            {"wide_contact_solver",                  mWideContactSolver},
          }
       }
    };
@@ -77,6 +84,16 @@ void PhysicsConfiguration::deserialize(const std::string& data)
    mPlayerJumpSpeedFactor        = config["PhysicsConfiguration"]["player_jump_speed_factor"].get<float>();
    mPlayerDashSteps              = config["PhysicsConfiguration"]["player_dash_steps"].get<int32_t>();
    mPlayerDashFactor             = config["PhysicsConfiguration"]["player_dash_factor"].get<float>();
+
+   mSimulationRegionEnabled              = config["PhysicsConfiguration"]["simulation_region_enabled"].get<bool>();
+   mSimulationRegionActivationMarginPx   = config["PhysicsConfiguration"]["simulation_region_activation_margin_px"].get<float>();
+   mSimulationRegionDeactivationMarginPx = config["PhysicsConfiguration"]["simulation_region_deactivation_margin_px"].get<float>();
+
+   mStaticChainCellSizePx = config["PhysicsConfiguration"]["static_chain_cell_size_px"].get<float>();
+   mStaticChainMaxEdges   = config["PhysicsConfiguration"]["static_chain_max_edges"].get<int32_t>();
+
+   mParallelIslands = config["PhysicsConfiguration"]["parallel_islands"].get<bool>();
+   mWideContactSolver = config["PhysicsConfiguration"]["wide_contact_solver"].get<bool>();
 }
 
 
@@ -29,6 +29,16 @@ struct PhysicsConfiguration
    int32_t mPlayerDashSteps = 20;
    float mPlayerDashFactor = 3.0f;
 
+   bool mSimulationRegionEnabled = true;
+   float mSimulationRegionActivationMarginPx = 320.0f;
+   float mSimulationRegionDeactivationMarginPx = 480.0f;
+
+   float mStaticChainCellSizePx = 512.0f;
+   int32_t mStaticChainMaxEdges = 64;
+
+   bool mParallelIslands = false;
+   bool mWideContactSolver = false;
+
    void deserializeFromFile(const std::string& filename = "data/config/physics.json");
    void serializeToFile(const std::string& filename = "data/config/physics.json");
 
@@ -0,0 +1,232 @@
+#include "simulationregion.h"
+
+#include "constants.h"
+#include "gamemechanism.h"
+#include "luanode.h"
+#include "physicsconfiguration.h"
+
+#include <algorithm>
+
+
+namespace
+{
+// bodies are tracked by their position, this pads for their extent
+constexpr auto boundsPaddingPx = static_cast<float>(2 * PIXELS_PER_TILE);
+
+
+sf::FloatRect inflate(const sf::FloatRect& rect, float margin)
+{
+   return {rect.left - margin, rect.top - margin, rect.width + 2.0f * margin, rect.height + 2.0f * margin};
+}
+
+
+bool overlapsRoom(const sf::FloatRect& bounds, const Room* room)
+{
+   if (!room)
+   {
+      return false;
+   }
+
+   return std::any_of(room->mRects.begin(), room->mRects.end(), [&bounds](const auto& rect){return rect.intersects(bounds);});
+}
+}
+
+
+void SimulationRegion::setWorld(const std::shared_ptr<b2World>& world)
+{
+   mWorld = world;
+}
+
+
+void SimulationRegion::clear()
+{
+   mEntries.clear();
+   mTransitions = 0;
+}
+
+
+void SimulationRegion::add(const std::shared_ptr<GameMechanism>& mechanism)
+{
+   Entry entry;
+   entry.mBodies = mechanism->getBodies();
+   entry.mBodies.erase(std::remove(entry.mBodies.begin(), entry.mBodies.end(), nullptr), entry.mBodies.end());
+
+   // mechanisms without bodies are cheap to update and always simulated
+   if (entry.mBodies.empty())
+   {
+      return;
+   }
+
+   entry.mMechanism = mechanism;
+   updateBounds(entry);
+   mEntries.push_back(std::move(entry));
+}
+
+
+void SimulationRegion::add(const std::shared_ptr<LuaNode>& node)
+{
+   Entry entry;
+   entry.mNode = node;
+   updateBounds(entry);
+   mEntries.push_back(std::move(entry));
+}
+
+
+void SimulationRegion::updateBounds(Entry& entry) const
+{
+   // lua nodes may destroy and recreate their body at any time
+   if (entry.mNode)
+   {
+      entry.mBodies.clear();
+
+      if (entry.mNode->mBody)
+      {
+         entry.mBodies.push_back(entry.mNode->mBody);
+      }
+   }
+
+   if (entry.mBodies.empty())
+   {
+      return;
+   }
+
+   auto x0 = entry.mBodies.front()->GetPosition().x;
+   auto y0 = entry.mBodies.front()->GetPosition().y;
+   auto x1 = x0;
+   auto y1 = y0;
+
+   for (auto body : entry.mBodies)
+   {
+      const auto& pos = body->GetPosition();
+      x0 = std::min(x0, pos.x);
+      y0 = std::min(y0, pos.y);
+      x1 = std::max(x1, pos.x);
+      y1 = std::max(y1, pos.y);
+   }
+
+   entry.mBounds = inflate(sf::FloatRect(x0 * PPM, y0 * PPM, (x1 - x0) * PPM, (y1 - y0) * PPM), boundsPaddingPx);
+}
+
+
+void SimulationRegion::setActive(Entry& entry, bool active)
+{
+   entry.mActive = active;
+   mTransitions++;
+
+   // bodies their owner deactivated (e.g. a script calling setActive(false)) stay inactive
+   if (active)
+   {
+      for (auto body : entry.mDeactivatedBodies)
+      {
+         if (std::find(entry.mBodies.begin(), entry.mBodies.end(), body) != entry.mBodies.end())
+         {
+            body->SetActive(true);
+         }
+      }
+
+      entry.mDeactivatedBodies.clear();
+   }
+   else
+   {
+      for (auto body : entry.mBodies)
+      {
+         if (body->IsActive())
+         {
+            body->SetActive(false);
+            entry.mDeactivatedBodies.push_back(body);
+         }
+      }
+   }
+
+   if (entry.mMechanism)
+   {
+      entry.mMechanism->setSimulated(active);
+   }
+
+   if (entry.mNode)
+   {
+      entry.mNode->mSimulated = active;
+   }
+}
+
+
+void SimulationRegion::update(const sf::FloatRect& view, const Room* room)
+{
+   const auto& config = PhysicsConfiguration::getInstance();
+
+   mTransitions = 0;
+
+   for (auto& entry : mEntries)
+   {
+      if (!config.mSimulationRegionEnabled)
+      {
+         if (!entry.mActive)
+         {
+            setActive(entry, true);
+         }
+
+         continue;
+      }
+
+      // sleeping bodies don't move, only the bounds of active entries need an update
+      if (entry.mActive || entry.mNode)
+      {
+         updateBounds(entry);
+      }
+
+      if (entry.mBodies.empty())
+      {
+         continue;
+      }
+
+      const auto inRoom = overlapsRoom(entry.mBounds, room);
+
+      if (entry.mActive)
+      {
+         if (!inRoom && !inflate(view, config.mSimulationRegionDeactivationMarginPx).intersects(entry.mBounds))
+         {
+            setActive(entry, false);
+         }
+      }
+      else
+      {
+         if (inRoom || inflate(view, config.mSimulationRegionActivationMarginPx).intersects(entry.mBounds))
+         {
+            setActive(entry, true);
+         }
+      }
+   }
+}
+
+
+SimulationRegion::Statistics SimulationRegion::getStatistics() const
+{
+   Statistics statistics;
+
+   for (const auto& entry : mEntries)
+   {
+      (entry.mActive ? statistics.mSimulatedObjects : statistics.mSleepingObjects)++;
+   }
+
+   statistics.mTransitions = mTransitions;
+
+   if (!mWorld)
+   {
+      return statistics;
+   }
+
+   statistics.mBodies = mWorld->GetBodyCount();
+   statistics.mContacts = mWorld->GetContactCount();
+   statistics.mProxies = mWorld->GetProxyCount();
+   statistics.mJoints = mWorld->GetJointCount();
+   statistics.mProfile = mWorld->GetProfile();
+
+   for (auto body = mWorld->GetBodyList(); body; body = body->GetNext())
+   {
+      statistics.mActiveBodies += body->IsActive() ? 1 : 0;
+      statistics.mAwakeBodies += (body->IsActive() && body->IsAwake()) ? 1 : 0;
+   }
+
+   return statistics;
+}
+
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "room.h"
+
+#include "Box2D/Box2D.h"
+
+#include <SFML/Graphics/Rect.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class GameMechanism;
+class LuaNode;
+
+
+// keeps the simulation close to the camera
+//
+// mechanisms that own bodies and lua nodes far away from the camera are put to sleep:
+// their bodies are deactivated (b2Body::SetActive), which removes them from the broadphase
+// and the solver, and their update calls are skipped. an object wakes up once its bounds
+// come closer to the view than the activation margin and goes back to sleep when it is
+// farther away than the larger deactivation margin, so objects at the border don't flap
+// between both states. everything overlapping the room the camera is in stays active.
+class SimulationRegion
+{
+
+public:
+
+   struct Statistics
+   {
+      int32_t mBodies = 0;
+      int32_t mActiveBodies = 0;
+      int32_t mAwakeBodies = 0;
+      int32_t mContacts = 0;
+      int32_t mProxies = 0;
+      int32_t mJoints = 0;
+
+      int32_t mSimulatedObjects = 0;
+      int32_t mSleepingObjects = 0;
+      int32_t mTransitions = 0; // objects that changed state during the last update
+
+      b2Profile mProfile = {}; // timings of the last b2World::Step in ms
+   };
+
+   void setWorld(const std::shared_ptr<b2World>& world);
+   void clear();
+
+   void add(const std::shared_ptr<GameMechanism>& mechanism);
+   void add(const std::shared_ptr<LuaNode>& node);
+
+   void update(const sf::FloatRect& view, const Room* room);
+
+   //! world counters are gathered on request, the overlay is the only one to need them
+   Statistics getStatistics() const;
+
+
+private:
+
+   struct Entry
+   {
+      std::shared_ptr<GameMechanism> mMechanism;
+      std::shared_ptr<LuaNode> mNode;
+      std::vector<b2Body*> mBodies;
+      std::vector<b2Body*> mDeactivatedBodies; // bodies switched off by the region, not by their owner
+      sf::FloatRect mBounds;
+      bool mActive = true;
+   };
+
+   void updateBounds(Entry& entry) const;
+   void setActive(Entry& entry, bool active);
+
+   std::shared_ptr<b2World> mWorld;
+   std::vector<Entry> mEntries;
+   int32_t mTransitions = 0;
+};
+
@@ -0,0 +1,192 @@
+#include "staticchains.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace
+{
+using Cell = std::pair<int32_t, int32_t>;
+
+
+Cell cellOf(const b2Vec2& a, const b2Vec2& b, float cell_size_m)
+{
+   const auto center = 0.5f * (a + b);
+
+   return {
+      static_cast<int32_t>(std::floor(center.x / cell_size_m)),
+      static_cast<int32_t>(std::floor(center.y / cell_size_m))
+   };
+}
+
+
+b2Fixture* createFixture(b2Body* body, const b2ChainShape& shape)
+{
+   b2FixtureDef fixtureDef;
+   fixtureDef.density = 0.0f;
+   fixtureDef.friction = 0.2f;
+   fixtureDef.shape = &shape;
+
+   return body->CreateFixture(&fixtureDef);
+}
+}
+
+
+void StaticChains::clear()
+{
+   // the bodies are owned by the world
+   mLoops.clear();
+   mSegments.clear();
+   mBodies.clear();
+   mStatistics = {};
+}
+
+
+b2Body* StaticChains::getBody(b2World* world, const Cell& cell)
+{
+   auto it = mBodies.find(cell);
+   if (it != mBodies.end())
+   {
+      return it->second;
+   }
+
+   b2BodyDef bodyDef;
+   bodyDef.position.Set(0, 0);
+   bodyDef.type = b2_staticBody;
+
+   auto body = world->CreateBody(&bodyDef);
+   mBodies[cell] = body;
+   mStatistics.mBodies++;
+
+   return body;
+}
+
+
+std::vector<b2Fixture*> StaticChains::add(
+   b2World* world,
+   const std::vector<b2Vec2>& loop,
+   float cell_size_m,
+   int32_t max_edges
+)
+{
+   std::vector<b2Fixture*> fixtures;
+
+   const auto count = static_cast<int32_t>(loop.size());
+   if (count < 3)
+   {
+      return fixtures;
+   }
+
+   const auto loopIndex = mLoops.size();
+   mLoops.push_back(loop);
+   mStatistics.mLoops++;
+
+   // edge i runs from vertex i to vertex i + 1
+   std::vector<Cell> cells;
+   cells.reserve(loop.size());
+   for (auto i = 0; i < count; i++)
+   {
+      cells.push_back(cellOf(loop[static_cast<size_t>(i)], loop[static_cast<size_t>((i + 1) % count)], cell_size_m));
+   }
+
+   const auto singleCell = std::all_of(cells.begin(), cells.end(), [&cells](const auto& cell){return cell == cells.front();});
+
+   if (singleCell && count <= max_edges)
+   {
+      b2ChainShape chainShape;
+      chainShape.CreateLoop(loop.data(), count);
+
+      auto fixture = createFixture(getBody(world, cells.front()), chainShape);
+      mSegments[fixture] = {loopIndex, 0};
+      fixtures.push_back(fixture);
+
+      mStatistics.mChains++;
+      mStatistics.mMaxEdges = std::max(mStatistics.mMaxEdges, count);
+      return fixtures;
+   }
+
+   // start at a cell border so the walk doesn't cut a run in two at the end of the loop
+   auto start = 0;
+   for (auto i = 0; i < count; i++)
+   {
+      if (cells[static_cast<size_t>(i)] != cells[static_cast<size_t>((i + count - 1) % count)])
+      {
+         start = i;
+         break;
+      }
+   }
+
+   const auto vertex = [&loop, count](int32_t index) -> const b2Vec2&
+   {
+      return loop[static_cast<size_t>(((index % count) + count) % count)];
+   };
+
+   std::vector<b2Vec2> vertices;
+
+   auto first = start;
+   while (first < start + count)
+   {
+      const auto& cell = cells[static_cast<size_t>(first % count)];
+
+      auto last = first + 1;
+      while (
+            last < start + count
+         && last - first < max_edges
+         && cells[static_cast<size_t>(last % count)] == cell
+      )
+      {
+         last++;
+      }
+
+      // edges [first, last) need the vertices first..last
+      vertices.clear();
+      for (auto i = first; i <= last; i++)
+      {
+         vertices.push_back(vertex(i));
+      }
+
+      b2ChainShape chainShape;
+      chainShape.CreateChain(vertices.data(), static_cast<int32_t>(vertices.size()));
+      chainShape.SetPrevVertex(vertex(first - 1));
+      chainShape.SetNextVertex(vertex(last + 1));
+
+      auto fixture = createFixture(getBody(world, cell), chainShape);
+      mSegments[fixture] = {loopIndex, first % count};
+      fixtures.push_back(fixture);
+
+      mStatistics.mChains++;
+      mStatistics.mMaxEdges = std::max(mStatistics.mMaxEdges, last - first);
+
+      first = last;
+   }
+
+   return fixtures;
+}
+
+
+const std::vector<std::vector<b2Vec2>>& StaticChains::getLoops() const
+{
+   return mLoops;
+}
+
+
+std::optional<b2Vec2> StaticChains::getLoopVertex(const b2Fixture* fixture, int32_t index) const
+{
+   auto it = mSegments.find(fixture);
+   if (it == mSegments.end())
+   {
+      return std::nullopt;
+   }
+
+   const auto& loop = mLoops[it->second.mLoop];
+   const auto count = static_cast<int32_t>(loop.size());
+   const auto wrapped = (((it->second.mFirst + index) % count) + count) % count;
+
+   return loop[static_cast<size_t>(wrapped)];
+}
+
+
+const StaticChains::Statistics& StaticChains::getStatistics() const
+{
+   return mStatistics;
+}
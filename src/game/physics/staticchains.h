@@ -0,0 +1,69 @@
+#pragma once
+
+#include "Box2D/Box2D.h"
+
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+
+// static level outlines split into spatially bounded chains
+//
+// a merged outline may run across the whole level. a looped b2ChainShape of that size
+// makes everything that walks its vertices (shadows, climbing, debug drawing) touch the
+// entire level. instead every loop is cut into open chains whose edges lie in the same
+// world cell and which have a bounded edge count. the cut chains get the neighbouring
+// vertices of the loop as ghost vertices so bodies slide across the seams without
+// snagging. loops that already fit into a cell are kept as they are.
+// all chains of a cell share one static body.
+class StaticChains
+{
+
+public:
+
+   struct Statistics
+   {
+      int32_t mLoops = 0;
+      int32_t mChains = 0;
+      int32_t mBodies = 0;
+      int32_t mMaxEdges = 0;
+   };
+
+   void clear();
+
+   //! add a closed outline, returns the fixtures created for it
+   std::vector<b2Fixture*> add(
+      b2World* world,
+      const std::vector<b2Vec2>& loop,
+      float cell_size_m,
+      int32_t max_edges
+   );
+
+   //! all outlines as they were passed to add
+   const std::vector<std::vector<b2Vec2>>& getLoops() const;
+
+   //! vertex of the outline a fixture was cut from, index is relative to the fixture's first vertex and wraps
+   std::optional<b2Vec2> getLoopVertex(const b2Fixture* fixture, int32_t index) const;
+
+   const Statistics& getStatistics() const;
+
+
+private:
+
+   struct Segment
+   {
+      size_t mLoop = 0;
+      int32_t mFirst = 0;
+   };
+
+   b2Body* getBody(b2World* world, const std::pair<int32_t, int32_t>& cell);
+
+   std::vector<std::vector<b2Vec2>> mLoops;
+   std::unordered_map<const b2Fixture*, Segment> mSegments;
+   std::map<std::pair<int32_t, int32_t>, b2Body*> mBodies;
+   Statistics mStatistics;
+};
+
@@ -1,9 +1,9 @@
 #include "player.h"
 
-#include "animationpool.h"
 #include "audio.h"
 #include "camerapane.h"
 #include "displaymode.h"
+#include "effects/particleemitter.h"
 #include "gamecontactlistener.h"
 #include "gamecontrollerintegration.h"
 #include "gamestate.h"
@@ -33,6 +33,8 @@ namespace  {
    uint16_t maskBitsStanding = CategoryBoundary | CategoryEnemyCollideWith;
    uint16_t maskBitsCrouching = CategoryEnemyCollideWith;
    int16_t groupIndex = 0;
+
+   static const auto dustParticleCount = 12;
 }
 
 
@@ -106,6 +108,32 @@ void Player::initialize()
 
    mWeaponSystem->initialize();
 
+   ParticleEmitter::Settings dust;
+   dust.mMaxParticles = dustParticleCount * 4;
+   dust.mSpawnArea = {-8.0f, 4.0f, 16.0f, 6.0f};
+   dust.mLifetimeMin = 0.25f;
+   dust.mLifetimeMax = 0.45f;
+   dust.mVelocityMin = {-10.0f, -40.0f};
+   dust.mVelocityMax = {50.0f, -10.0f};
+   dust.mAcceleration = {0.0f, 60.0f};
+   dust.mSizeMin = 1.0f;
+   dust.mSizeMax = 2.0f;
+   dust.mColor = sf::Color{200, 190, 170, 160};
+   dust.mFadeOut = true;
+   dust.mBlendMode = sf::BlendAlpha;
+
+   // the dust is kicked up behind the player, one emitter per direction
+   mDustLeft = std::make_shared<ParticleEmitter>(dust);
+
+   std::swap(dust.mVelocityMin.x, dust.mVelocityMax.x);
+   dust.mVelocityMin.x = -dust.mVelocityMin.x;
+   dust.mVelocityMax.x = -dust.mVelocityMax.x;
+   mDustRight = std::make_shared<ParticleEmitter>(dust);
+
+   mDustParticles.clear();
+   mDustParticles.add(mDustLeft);
+   mDustParticles.add(mDustRight);
+
    mJump.mDustAnimation = std::bind(&Player::playDustAnimation, this);
    mJump.mRemoveClimbJoint = std::bind(&PlayerClimb::removeClimbJoint, mClimb);
    mControls.addKeypressedCallback([this](sf::Keyboard::Key key){keyPressed(key);});
@@ -255,11 +283,7 @@ void Player::draw(sf::RenderTarget& color, sf::RenderTarget& normal)
       current_cycle->draw(color, normal);
    }
 
-   AnimationPool::getInstance().drawAnimations(
-      color,
-      normal,
-      {"player_jump_dust_l", "player_jump_dust_r"}
-   );
+   mDustParticles.draw(color);
 }
 
 
@@ -360,7 +384,7 @@ void Player::createFeet()
 
       auto objectDataFeet = new FixtureNode(this);
       objectDataFeet->setType(ObjectTypePlayer);
-      objectDataFeet->setFlag("foot", true);
+      objectDataFeet->setFlag(PropertyKey::Foot, true);
       foot->SetUserData(static_cast<void*>(objectDataFeet));
    }
 
@@ -478,7 +502,7 @@ void Player::createBody()
 
    FixtureNode* objectDataHead = new FixtureNode(this);
    objectDataHead->setType(ObjectTypePlayer);
-   objectDataHead->setFlag("head", true);
+   objectDataHead->setFlag(PropertyKey::Head, true);
    mBodyFixture->SetUserData(static_cast<void*>(objectDataHead));
 
    // mBody->Dump();
@@ -741,13 +765,7 @@ float Player::getAcceleration() const
 //----------------------------------------------------------------------------------------------------------------------
 void Player::playDustAnimation()
 {
-   AnimationPool::getInstance().add(
-      mPointsToLeft
-       ? "player_jump_dust_l"
-       : "player_jump_dust_r",
-      mPixelPositionf.x,
-      mPixelPositionf.y
-   );
+   (mPointsToLeft ? mDustLeft : mDustRight)->burst(mPixelPositionf, dustParticleCount);
 }
 
 
@@ -1156,7 +1174,8 @@ void Player::damage(int damage, const sf::Vector2f& force)
    {
       mDamageInitialized = true;
 
-      Audio::getInstance()->playSample("hurt.wav");
+      static const auto hurt = Audio::getInstance()->addSample("hurt.wav");
+      Audio::getInstance()->playSample(hurt, {30.0f, Audio::Priority::High, {}});
 
       // not converting this to PPM to make the effect of the applied force more visible
       auto body = getBody();
@@ -1254,8 +1273,9 @@ void Player::updateFootsteps()
 
          if (mTime.asSeconds() > mNextFootStepTime)
          {
-            // play footstep
-            Audio::getInstance()->playSample("footstep.wav", 0.05f);
+            // play footstep; those are the first to give up their voice in busy scenes
+            static const auto footstep = Audio::getInstance()->addSample("footstep.wav");
+            Audio::getInstance()->playSample(footstep, {0.05f, Audio::Priority::Low, {}});
             mNextFootStepTime = mTime.asSeconds() + 1.0f / vel;
          }
       }
@@ -1432,6 +1452,8 @@ void Player::update(const sf::Time& dt)
    updatePortal();
    updatePreviousBodyState();
    updateWeapons(dt);
+
+   mDustParticles.update(dt);
 }
 
 
@@ -1703,7 +1725,8 @@ void Player::die()
 
    updateDeadFixtures();
 
-   Audio::getInstance()->playSample("death.wav");
+   static const auto death = Audio::getInstance()->addSample("death.wav");
+   Audio::getInstance()->playSample(death, {30.0f, Audio::Priority::Critical, {}});
 }
 
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "constants.h"
+#include "effects/particlesystem.h"
 #include "extramanager.h"
 #include "extratable.h"
 #include "gamenode.h"
@@ -237,6 +238,10 @@ private:
 
    std::deque<PositionedAnimation> mLastAnimations;
 
+   ParticleSystem mDustParticles;
+   std::shared_ptr<ParticleEmitter> mDustLeft;  // jumps while pointing to the left
+   std::shared_ptr<ParticleEmitter> mDustRight;
+
    static Player* sCurrent;
 };
 
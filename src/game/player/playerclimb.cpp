@@ -1,6 +1,7 @@
 #include "playerclimb.h"
 
 #include "audio.h"
+#include "level.h"
 #include "savestate.h"
 
 namespace
@@ -167,7 +168,7 @@ void PlayerClimb::update(b2Body* playerBody, const PlayerControls& controls, boo
                   }
 
                   // is the analyzed edge actually climbable?
-                  if (!isClimbableEdge(shape, index))
+                  if (!isClimbableEdge(fixture, index))
                   {
                      continue;
                   }
@@ -222,15 +223,21 @@ void PlayerClimb::update(b2Body* playerBody, const PlayerControls& controls, boo
 
                   Audio::getInstance()->playSample("impact.wav");
                   mClimbJoint = playerBody->GetWorld()->CreateJoint(&jointDefinition);
-               }
 
-               // no need to continue processing
-               break;
+                  // no need to continue processing
+                  break;
+               }
             }
 
             fixture = fixture->GetNext();
          }
       }
+
+      // static outlines are split into several chains, the same corner may show up twice
+      if (mClimbJoint)
+      {
+         break;
+      }
    }
 
    // mDistanceJoint->SetLength(distanceJoint.GetLength() * 0.99f);
@@ -250,7 +257,7 @@ void PlayerClimb::removeClimbJoint()
 
 
 //----------------------------------------------------------------------------------------------------------------------
-bool PlayerClimb::isClimbableEdge(b2ChainShape* shape, int i)
+bool PlayerClimb::isClimbableEdge(b2Fixture* fixture, int i)
 {
    /*
       climbable edges:
@@ -310,29 +317,38 @@ bool PlayerClimb::isClimbableEdge(b2ChainShape* shape, int i)
 
    */
 
-   // the last vertex of a shape is duplicated for some weird reson.
-   // probably needs some more investigation. for now it's just not taken into regard
-   shape->m_count--;
+   auto shape = static_cast<b2ChainShape*>(fixture->GetShape());
+
+   // level outlines are cut into several chains, their neighbours are looked up in the whole outline
+   const auto& staticChains = Level::getCurrentLevel()->getStaticChains();
 
-   auto index = [shape](int i) -> int {
-      if (i >= shape->m_count)
+   // a loop repeats its first vertex at the end, that one is not taken into regard
+   const auto count = shape->m_count - 1;
+
+   auto vertex = [&](int offset) -> b2Vec2 {
+      const auto loopVertex = staticChains.getLoopVertex(fixture, i + offset);
+      if (loopVertex.has_value())
       {
-         return i - shape->m_count;
+         return *loopVertex;
       }
-      if (i < 0)
+
+      auto index = i + offset;
+      if (index >= count)
       {
-         return shape->m_count + i;
+         index -= count;
       }
-      return i;
+      if (index < 0)
+      {
+         index += count;
+      }
+      return shape->m_vertices[index];
    };
 
-   auto pp = shape->m_vertices[index(i - 2)];
-   auto p = shape->m_vertices[index(i - 1)];
+   auto pp = vertex(-2);
+   auto p = vertex(-1);
    auto c = shape->m_vertices[i];
-   auto n = shape->m_vertices[index(i + 1)];
-   auto nn = shape->m_vertices[index(i + 2)];
-
-   shape->m_count++;
+   auto n = vertex(1);
+   auto nn = vertex(2);
 
    auto climbable =
          (p.y > c.y && (fabs(n.x - c.x) > 0.001f) && pp.y > p.y)
@@ -5,7 +5,7 @@
 #include <functional>
 
 class b2Joint;
-class b2ChainShape;
+class b2Fixture;
 
 struct PlayerClimb
 {
@@ -13,7 +13,7 @@ struct PlayerClimb
 
    void update(b2Body* body, const PlayerControls& controls, bool inAir);
    void removeClimbJoint();
-   bool isClimbableEdge(b2ChainShape* shape, int currIndex);
+   bool isClimbableEdge(b2Fixture* fixture, int currIndex);
    bool edgeMatchesMovement(const b2Vec2 &edgeDir);
    bool isClimbing() const;
    b2Joint* mClimbJoint = nullptr;
@@ -0,0 +1,103 @@
+#include "propertykey.h"
+
+#include <array>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+
+namespace
+{
+
+// names of the known keys, in the order of PropertyKey::Known
+constexpr std::array<const char*, PropertyKey::KnownCount> knownNames = {
+   "acceleration_ground",
+   "damage",
+   "foot",
+   "head",
+   "sensor",
+   "sprite",
+   "staticBody",
+   "updateEveryFrame",
+   "velocity_walk_max",
+};
+
+
+struct Registry
+{
+   Registry()
+   {
+      for (auto name : knownNames)
+      {
+         add(name);
+      }
+   }
+
+   PropertyKey::Key add(const std::string& name)
+   {
+      const auto key = static_cast<PropertyKey::Key>(mNames.size());
+      mNames.push_back(name);
+      mKeys[name] = key;
+      return key;
+   }
+
+   std::shared_mutex mMutex;
+   std::unordered_map<std::string, PropertyKey::Key> mKeys;
+   std::deque<std::string> mNames; // a deque so getName can hand out references
+};
+
+
+Registry& registry()
+{
+   static Registry sRegistry;
+   return sRegistry;
+}
+
+}
+
+
+PropertyKey::Key PropertyKey::intern(const std::string& name)
+{
+   auto& r = registry();
+
+   {
+      std::shared_lock<std::shared_mutex> lock(r.mMutex);
+      const auto it = r.mKeys.find(name);
+      if (it != r.mKeys.end())
+      {
+         return it->second;
+      }
+   }
+
+   std::unique_lock<std::shared_mutex> lock(r.mMutex);
+
+   // another thread might have added the name in the meantime
+   const auto it = r.mKeys.find(name);
+   if (it != r.mKeys.end())
+   {
+      return it->second;
+   }
+
+   return r.add(name);
+}
+
+
+PropertyKey::Key PropertyKey::find(const std::string& name)
+{
+   auto& r = registry();
+
+   std::shared_lock<std::shared_mutex> lock(r.mMutex);
+   const auto it = r.mKeys.find(name);
+   return (it != r.mKeys.end()) ? it->second : -1;
+}
+
+
+const std::string& PropertyKey::getName(Key key)
+{
+   auto& r = registry();
+
+   std::shared_lock<std::shared_mutex> lock(r.mMutex);
+   return r.mNames[static_cast<size_t>(key)];
+}
+
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+
+// property names interned to small integers
+//
+// engine code addresses properties by key so reading one is an index into a vector instead
+// of string compares down a map. keys the engine reads itself are known at compile time,
+// names only scripts use get a key the first time they show up. interning is thread-safe
+// since scripts may set their properties from the worker pool.
+class PropertyKey
+{
+
+public:
+
+   using Key = int32_t;
+
+   enum Known : Key
+   {
+      AccelerationGround,
+      Damage,
+      Foot,
+      Head,
+      Sensor,
+      Sprite,
+      StaticBody,
+      UpdateEveryFrame,
+      VelocityWalkMax,
+      KnownCount
+   };
+
+   //! key of a name, the name is added if it is new
+   static Key intern(const std::string& name);
+
+   //! key of a name, -1 if the name was never interned
+   static Key find(const std::string& name);
+
+   static const std::string& getName(Key key);
+};
+
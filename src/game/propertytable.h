@@ -0,0 +1,75 @@
+#pragma once
+
+#include "propertykey.h"
+
+#include <optional>
+#include <string>
+#include <variant>
+#include <vector>
+
+
+// properties stored in slots indexed by their interned key
+//
+// reads by key are a bounds check and an index. the overloads taking a name are the slow
+// path for code that only has the string, looking up a name never interns it.
+template <typename Variant>
+class PropertyTable
+{
+
+public:
+
+   void set(PropertyKey::Key key, const Variant& value)
+   {
+      const auto index = static_cast<size_t>(key);
+
+      if (index >= mSlots.size())
+      {
+         mSlots.resize(index + 1);
+      }
+
+      mSlots[index] = value;
+   }
+
+   void set(const std::string& name, const Variant& value)
+   {
+      set(PropertyKey::intern(name), value);
+   }
+
+   //! value of a property, nullptr if it was never set
+   const Variant* find(PropertyKey::Key key) const
+   {
+      const auto index = static_cast<size_t>(key);
+
+      if (key < 0 || index >= mSlots.size() || !mSlots[index].has_value())
+      {
+         return nullptr;
+      }
+
+      return &(*mSlots[index]);
+   }
+
+   const Variant* find(const std::string& name) const
+   {
+      return find(PropertyKey::find(name));
+   }
+
+   //! value of a property, the fallback if it was never set or holds another type
+   template <typename T>
+   T get(PropertyKey::Key key, const T& fallback = {}) const
+   {
+      const auto value = find(key);
+      const auto typed = value ? std::get_if<T>(value) : nullptr;
+      return typed ? *typed : fallback;
+   }
+
+   void clear()
+   {
+      mSlots.clear();
+   }
+
+
+private:
+
+   std::vector<std::optional<Variant>> mSlots;
+};
+
@@ -0,0 +1,300 @@
+#include "renderpassscheduler.h"
+
+#include "framework/tools/profiler.h"
+
+#include <algorithm>
+#include <iostream>
+
+
+namespace
+{
+// textures nobody asked for during this many frames are released
+constexpr auto idleFrames = 600u;
+}
+
+
+void RenderPassScheduler::setSize(uint32_t width, uint32_t height)
+{
+   if (mSize.x == width && mSize.y == height)
+   {
+      return;
+   }
+
+   mSize = {width, height};
+   mPool.clear();
+   mStatistics.mTextures = 0;
+}
+
+
+const sf::Vector2u& RenderPassScheduler::getSize() const
+{
+   return mSize;
+}
+
+
+void RenderPassScheduler::setScale(float scale)
+{
+   // textures of the previous scale are left to the idle release
+   mScale = std::clamp(scale, 0.1f, 1.0f);
+}
+
+
+float RenderPassScheduler::getScale() const
+{
+   return mScale;
+}
+
+
+RenderPassScheduler::Target RenderPassScheduler::addTarget(const std::string& name, bool stencil, bool scaled)
+{
+   TargetInfo info;
+   info.mName = name;
+   info.mStencil = stencil;
+   info.mScaled = scaled;
+   mTargets.push_back(info);
+
+   return static_cast<Target>(mTargets.size() - 1);
+}
+
+
+void RenderPassScheduler::addPass(Pass pass)
+{
+   mPasses.push_back(std::move(pass));
+}
+
+
+void RenderPassScheduler::execute()
+{
+   mFrame++;
+
+   for (auto& target : mTargets)
+   {
+      target.mFirstPass = -1;
+      target.mLastPass = -1;
+      target.mTexture = -1;
+   }
+
+   // a pass is needed if it's an output or a later needed pass reads what it writes.
+   // writes don't end the need for earlier writers since passes usually draw on top.
+   std::vector<bool> read(mTargets.size(), false);
+   std::vector<size_t> live;
+
+   for (auto i = mPasses.size(); i-- > 0;)
+   {
+      const auto& pass = mPasses[i];
+
+      const auto needed = pass.mOutput || std::any_of(
+         pass.mWrites.begin(),
+         pass.mWrites.end(),
+         [&read](auto target){return read[static_cast<size_t>(target)];}
+      );
+
+      if (!needed)
+      {
+         continue;
+      }
+
+      live.push_back(i);
+
+      for (auto target : pass.mReads)
+      {
+         read[static_cast<size_t>(target)] = true;
+      }
+   }
+
+   std::reverse(live.begin(), live.end());
+
+   // lifetimes of the targets that are read, counted in live passes
+   for (auto index = 0u; index < live.size(); index++)
+   {
+      const auto& pass = mPasses[live[index]];
+
+      const auto touch = [&](Target target)
+      {
+         if (!read[static_cast<size_t>(target)])
+         {
+            return;
+         }
+
+         auto& info = mTargets[static_cast<size_t>(target)];
+         if (info.mFirstPass < 0)
+         {
+            info.mFirstPass = static_cast<int32_t>(index);
+         }
+
+         info.mLastPass = static_cast<int32_t>(index);
+      };
+
+      std::for_each(pass.mReads.begin(), pass.mReads.end(), touch);
+      std::for_each(pass.mWrites.begin(), pass.mWrites.end(), touch);
+   }
+
+   assignTextures();
+
+   mStatistics.mPasses = static_cast<int32_t>(mPasses.size());
+   mStatistics.mCulledPasses = static_cast<int32_t>(mPasses.size() - live.size());
+
+   for (auto index = 0u; index < live.size(); index++)
+   {
+      // a texture starting a new target gets a clean view, the previous user may have changed it
+      for (const auto& target : mTargets)
+      {
+         if (target.mFirstPass == static_cast<int32_t>(index) && target.mTexture >= 0)
+         {
+            auto& texture = *mPool[static_cast<size_t>(target.mTexture)].mTexture;
+            texture.setView(texture.getDefaultView());
+         }
+      }
+
+      const auto& pass = mPasses[live[index]];
+
+      PROFILE_SCOPE(pass.mName);
+      pass.mExecute();
+   }
+
+   mPasses.clear();
+
+   releaseIdleTextures();
+}
+
+
+void RenderPassScheduler::assignTextures()
+{
+   for (auto& texture : mPool)
+   {
+      texture.mBusyUntil = -1;
+   }
+
+   std::vector<size_t> order;
+   for (auto i = 0u; i < mTargets.size(); i++)
+   {
+      if (mTargets[i].mFirstPass >= 0)
+      {
+         order.push_back(i);
+      }
+   }
+
+   std::stable_sort(order.begin(), order.end(), [this](auto a, auto b){
+      return mTargets[a].mFirstPass < mTargets[b].mFirstPass;
+   });
+
+   const sf::Vector2u scaledSize{
+      std::max(static_cast<uint32_t>(static_cast<float>(mSize.x) * mScale), 1u),
+      std::max(static_cast<uint32_t>(static_cast<float>(mSize.y) * mScale), 1u)
+   };
+
+   for (auto i : order)
+   {
+      auto& target = mTargets[i];
+      target.mTexture = acquireTexture(target.mScaled ? scaledSize : mSize, target.mStencil, target.mFirstPass);
+
+      auto& texture = mPool[static_cast<size_t>(target.mTexture)];
+      texture.mBusyUntil = target.mLastPass;
+      texture.mLastFrame = mFrame;
+
+      // scaled targets are stretched over the full size ones when sampled, the others are
+      // pixel art and sampled 1:1
+      texture.mTexture->setSmooth(target.mScaled);
+   }
+
+   mStatistics.mTargets = static_cast<int32_t>(order.size());
+   mStatistics.mTextures = static_cast<int32_t>(mPool.size());
+}
+
+
+int32_t RenderPassScheduler::acquireTexture(const sf::Vector2u& size, bool stencil, int32_t first_pass)
+{
+   // a texture of the same kind first, stencil targets can't live without one while the
+   // others don't mind an unused stencil buffer
+   auto fallback = -1;
+
+   for (auto i = 0u; i < mPool.size(); i++)
+   {
+      const auto& texture = mPool[i];
+      if (texture.mBusyUntil >= first_pass || texture.mSize != size)
+      {
+         continue;
+      }
+
+      if (texture.mStencil == stencil)
+      {
+         return static_cast<int32_t>(i);
+      }
+
+      if (texture.mStencil && fallback < 0)
+      {
+         fallback = static_cast<int32_t>(i);
+      }
+   }
+
+   if (fallback >= 0)
+   {
+      return fallback;
+   }
+
+   sf::ContextSettings settings;
+   settings.stencilBits = stencil ? 8 : 0;
+
+   PoolTexture texture;
+   texture.mTexture = std::make_unique<sf::RenderTexture>();
+   texture.mTexture->create(size.x, size.y, settings);
+   texture.mSize = size;
+   texture.mStencil = stencil;
+   mPool.push_back(std::move(texture));
+
+   std::cout
+      << "[x] created render texture: " << size.x << " x " << size.y
+      << (stencil ? " (stencil)" : "")
+      << ", " << mPool.size() << " in pool"
+      << std::endl;
+
+   return static_cast<int32_t>(mPool.size() - 1);
+}
+
+
+void RenderPassScheduler::releaseIdleTextures()
+{
+   const auto idle = std::remove_if(mPool.begin(), mPool.end(), [this](const auto& texture){
+      return mFrame - texture.mLastFrame > idleFrames;
+   });
+
+   if (idle == mPool.end())
+   {
+      return;
+   }
+
+   // the targets are reassigned at the start of the next frame so the indices may move
+   mPool.erase(idle, mPool.end());
+   mStatistics.mTextures = static_cast<int32_t>(mPool.size());
+}
+
+
+sf::RenderTexture& RenderPassScheduler::getTexture(Target target)
+{
+   const auto index = mTargets[static_cast<size_t>(target)].mTexture;
+   if (index >= 0)
+   {
+      return *mPool[static_cast<size_t>(index)].mTexture;
+   }
+
+   if (!mSink)
+   {
+      mSink = std::make_unique<sf::RenderTexture>();
+      mSink->create(1, 1);
+   }
+
+   return *mSink;
+}
+
+
+bool RenderPassScheduler::isUsed(Target target) const
+{
+   return mTargets[static_cast<size_t>(target)].mTexture >= 0;
+}
+
+
+const RenderPassScheduler::Statistics& RenderPassScheduler::getStatistics() const
+{
+   return mStatistics;
+}
+
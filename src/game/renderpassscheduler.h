@@ -0,0 +1,111 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+// schedules the render passes of a frame
+//
+// every frame the passes are declared in the order they run, together with the render
+// targets they read and write. walking backwards from the passes that draw to the screen
+// (the outputs), a pass is kept only if a later kept pass reads one of its targets, so
+// whole chains of passes nobody needs disappear.
+//
+// the targets are transient, they only live from the first to the last pass using them.
+// targets whose lifetimes don't overlap share one render texture, the pool holds no more
+// textures than targets are alive at the same time. a shared texture keeps whatever its
+// previous user left in it so the first pass writing a target must clear or fully cover
+// it. targets that are written but never read are backed by a 1x1 texture.
+//
+// scaled targets get textures of the pool size multiplied by the current scale. they are
+// drawn with the same views as the full size targets and sampled with linear filtering
+// so whoever reads them upsamples them.
+class RenderPassScheduler
+{
+
+public:
+
+   using Target = int32_t;
+
+   struct Pass
+   {
+      const char* mName = nullptr; // static storage, used as profiler scope
+      std::vector<Target> mReads;
+      std::vector<Target> mWrites;
+      bool mOutput = false;        // draws outside the scheduler, never culled
+      std::function<void()> mExecute;
+   };
+
+   struct Statistics
+   {
+      int32_t mPasses = 0;
+      int32_t mCulledPasses = 0;
+      int32_t mTargets = 0;
+      int32_t mTextures = 0;
+   };
+
+   //! size of every texture in the pool, a different size drops the pool
+   void setSize(uint32_t width, uint32_t height);
+   const sf::Vector2u& getSize() const;
+
+   //! size of the scaled targets relative to the pool size, in (0..1]
+   void setScale(float scale);
+   float getScale() const;
+
+   //! declare a target once, stencil targets only go to textures with a stencil buffer
+   Target addTarget(const std::string& name, bool stencil = false, bool scaled = false);
+
+   void addPass(Pass pass);
+
+   //! cull and run the passes added since the last call
+   void execute();
+
+   //! texture behind a target, only valid while the passes execute
+   sf::RenderTexture& getTexture(Target target);
+
+   //! whether a pass that survived culling reads the target
+   bool isUsed(Target target) const;
+
+   const Statistics& getStatistics() const;
+
+
+private:
+
+   struct TargetInfo
+   {
+      std::string mName;
+      bool mStencil = false;
+      bool mScaled = false;
+      int32_t mFirstPass = -1;
+      int32_t mLastPass = -1;
+      int32_t mTexture = -1;
+   };
+
+   struct PoolTexture
+   {
+      std::unique_ptr<sf::RenderTexture> mTexture;
+      sf::Vector2u mSize;
+      bool mStencil = false;
+      int32_t mBusyUntil = -1;
+      uint64_t mLastFrame = 0;
+   };
+
+   void assignTextures();
+   int32_t acquireTexture(const sf::Vector2u& size, bool stencil, int32_t first_pass);
+   void releaseIdleTextures();
+
+   sf::Vector2u mSize;
+   float mScale = 1.0f;
+   std::vector<TargetInfo> mTargets;
+   std::vector<Pass> mPasses;
+   std::vector<PoolTexture> mPool;
+   std::unique_ptr<sf::RenderTexture> mSink;
+   uint64_t mFrame = 0;
+   Statistics mStatistics;
+};
+
@@ -168,15 +168,15 @@ bool Room::correctedCamera(float& x, float& y, float focusOffset, float viewRati
 }
 
 
-std::optional<Room> Room::computeCurrentRoom(const sf::Vector2f& cameraCenter, const std::vector<Room>& rooms) const
+const Room* Room::computeCurrentRoom(const sf::Vector2f& cameraCenter, const std::vector<Room>& rooms) const
 {
    return Room::find(cameraCenter, rooms);
 }
 
 
-std::optional<Room> Room::find(const sf::Vector2f& p, const std::vector<Room>& rooms)
+const Room* Room::find(const sf::Vector2f& p, const std::vector<Room>& rooms)
 {
-   const auto roomIt = std::find_if(rooms.begin(), rooms.end(), [p, rooms](const Room& r){
+   const auto roomIt = std::find_if(rooms.begin(), rooms.end(), [p](const Room& r){
          const auto& it = r.findRect(p);
          return (it != r.mRects.end());
       }
@@ -184,10 +184,10 @@ std::optional<Room> Room::find(const sf::Vector2f& p, const std::vector<Room>& r
 
    if (roomIt == rooms.end())
    {
-      return {};
+      return nullptr;
    }
 
-   return *roomIt;
+   return &(*roomIt);
 }
 
 
@@ -1,6 +1,5 @@
 #pragma once
 
-#include <optional>
 #include <map>
 #include <string>
 #include <vector>
@@ -14,11 +13,11 @@ struct Room
    Room(const sf::FloatRect& rect);
 
    static void deserialize(TmxObject* tmxObject, std::vector<Room>& rooms);
-   static std::optional<Room> find(const sf::Vector2f& p, const std::vector<Room>& rooms);
+   static const Room* find(const sf::Vector2f& p, const std::vector<Room>& rooms);
 
    std::vector<sf::FloatRect>::const_iterator findRect(const sf::Vector2f& p) const;
    bool correctedCamera(float& x, float& y, float focusOffset, float viewRatioY) const;
-   std::optional<Room> computeCurrentRoom(const sf::Vector2f& cameraCenter, const std::vector<Room>& rooms) const;
+   const Room* computeCurrentRoom(const sf::Vector2f& cameraCenter, const std::vector<Room>& rooms) const;
 
    std::vector<sf::FloatRect> mRects;
    std::string mName;
@@ -0,0 +1,135 @@
+#include "roomindex.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace
+{
+constexpr auto cellSize = 512.0f;
+}
+
+
+void RoomIndex::clear()
+{
+   mOrigin = {};
+   mColumns = 0;
+   mRows = 0;
+   mCellStart.clear();
+   mEntries.clear();
+}
+
+
+void RoomIndex::build(const std::vector<Room>& rooms)
+{
+   clear();
+
+   auto left = 0.0f;
+   auto top = 0.0f;
+   auto right = 0.0f;
+   auto bottom = 0.0f;
+   auto first = true;
+
+   for (const auto& room : rooms)
+   {
+      for (const auto& rect : room.mRects)
+      {
+         left = first ? rect.left : std::min(left, rect.left);
+         top = first ? rect.top : std::min(top, rect.top);
+         right = first ? rect.left + rect.width : std::max(right, rect.left + rect.width);
+         bottom = first ? rect.top + rect.height : std::max(bottom, rect.top + rect.height);
+         first = false;
+      }
+   }
+
+   if (first)
+   {
+      return;
+   }
+
+   mOrigin = {left, top};
+   mColumns = std::max(1, static_cast<int32_t>(std::ceil((right - left) / cellSize)));
+   mRows = std::max(1, static_cast<int32_t>(std::ceil((bottom - top) / cellSize)));
+
+   const auto cellRange = [this](const sf::FloatRect& rect, int32_t& x0, int32_t& y0, int32_t& x1, int32_t& y1){
+      x0 = std::clamp(static_cast<int32_t>((rect.left - mOrigin.x) / cellSize), 0, mColumns - 1);
+      y0 = std::clamp(static_cast<int32_t>((rect.top - mOrigin.y) / cellSize), 0, mRows - 1);
+      x1 = std::clamp(static_cast<int32_t>((rect.left + rect.width - mOrigin.x) / cellSize), 0, mColumns - 1);
+      y1 = std::clamp(static_cast<int32_t>((rect.top + rect.height - mOrigin.y) / cellSize), 0, mRows - 1);
+   };
+
+   // count the entries per cell first, then fill them in, so every cell is a contiguous range
+   mCellStart.assign(static_cast<size_t>(mColumns * mRows + 1), 0);
+
+   for (const auto& room : rooms)
+   {
+      for (const auto& rect : room.mRects)
+      {
+         int32_t x0, y0, x1, y1;
+         cellRange(rect, x0, y0, x1, y1);
+
+         for (auto y = y0; y <= y1; y++)
+         {
+            for (auto x = x0; x <= x1; x++)
+            {
+               mCellStart[static_cast<size_t>(y * mColumns + x + 1)]++;
+            }
+         }
+      }
+   }
+
+   for (auto i = 1u; i < mCellStart.size(); i++)
+   {
+      mCellStart[i] += mCellStart[i - 1];
+   }
+
+   mEntries.resize(mCellStart.back());
+   auto fill = mCellStart;
+
+   for (const auto& room : rooms)
+   {
+      for (const auto& rect : room.mRects)
+      {
+         int32_t x0, y0, x1, y1;
+         cellRange(rect, x0, y0, x1, y1);
+
+         for (auto y = y0; y <= y1; y++)
+         {
+            for (auto x = x0; x <= x1; x++)
+            {
+               mEntries[fill[static_cast<size_t>(y * mColumns + x)]++] = {rect, &room};
+            }
+         }
+      }
+   }
+}
+
+
+const Room* RoomIndex::find(const sf::Vector2f& p) const
+{
+   if (mEntries.empty())
+   {
+      return nullptr;
+   }
+
+   const auto x = static_cast<int32_t>(std::floor((p.x - mOrigin.x) / cellSize));
+   const auto y = static_cast<int32_t>(std::floor((p.y - mOrigin.y) / cellSize));
+
+   if (x < 0 || y < 0 || x >= mColumns || y >= mRows)
+   {
+      return nullptr;
+   }
+
+   const auto cell = static_cast<size_t>(y * mColumns + x);
+
+   for (auto i = mCellStart[cell]; i < mCellStart[cell + 1]; i++)
+   {
+      if (mEntries[i].mRect.contains(p))
+      {
+         return mEntries[i].mRoom;
+      }
+   }
+
+   return nullptr;
+}
+
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "room.h"
+
+#include <SFML/Graphics/Rect.hpp>
+
+#include <cstdint>
+#include <vector>
+
+
+// finds the room containing a position without walking all rooms
+//
+// the level is covered by a uniform grid, every cell lists the room rects overlapping it.
+// a lookup only tests the rects of a single cell. rooms are at least as large as the
+// screen so a cell rarely holds more than a few rects.
+//
+// the index points into the room vector it was built from, that vector must not change
+// as long as the index is used.
+class RoomIndex
+{
+
+public:
+
+   void build(const std::vector<Room>& rooms);
+   void clear();
+
+   //! room containing the position, nullptr if there is none
+   const Room* find(const sf::Vector2f& p) const;
+
+
+private:
+
+   struct Entry
+   {
+      sf::FloatRect mRect;
+      const Room* mRoom = nullptr;
+   };
+
+   sf::Vector2f mOrigin;
+   int32_t mColumns = 0;
+   int32_t mRows = 0;
+
+   // entries of cell i are mEntries[mCellStart[i]] .. mEntries[mCellStart[i + 1] - 1]
+   std::vector<uint32_t> mCellStart;
+   std::vector<Entry> mEntries;
+};
+
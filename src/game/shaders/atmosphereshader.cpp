@@ -5,27 +5,6 @@
 #include <iostream>
 
 
-//----------------------------------------------------------------------------------------------------------------------
-AtmosphereShader::AtmosphereShader(
-   uint32_t textureWidth,
-   uint32_t textureHeight
-)
-{
-   mRenderTexture = std::make_shared<sf::RenderTexture>();
-   mRenderTexture->create(
-      static_cast<uint32_t>(textureWidth),
-      static_cast<uint32_t>(textureHeight)
-   );
-}
-
-
-//----------------------------------------------------------------------------------------------------------------------
-AtmosphereShader::~AtmosphereShader()
-{
-   mRenderTexture.reset();
-}
-
-
 //----------------------------------------------------------------------------------------------------------------------
 void AtmosphereShader::initialize()
 {
@@ -46,7 +25,6 @@ void AtmosphereShader::initialize()
 
    mShader.setUniform("currentTexture", sf::Shader::CurrentTexture);
    mShader.setUniform("distortionMapTexture", mDistortionMap);
-   mShader.setUniform("physicsTexture", mRenderTexture->getTexture());
 }
 
 
@@ -61,9 +39,9 @@ void AtmosphereShader::update()
 
 
 //----------------------------------------------------------------------------------------------------------------------
-const std::shared_ptr<sf::RenderTexture>& AtmosphereShader::getRenderTexture() const
+void AtmosphereShader::setPhysicsTexture(const sf::Texture& texture)
 {
-   return mRenderTexture;
+   mShader.setUniform("physicsTexture", texture);
 }
 
 
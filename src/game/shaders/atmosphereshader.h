@@ -6,24 +6,18 @@
 class AtmosphereShader
 {
    public:
-      AtmosphereShader(
-         uint32_t textureWidth,
-         uint32_t textureHeight
-      );
-
-      ~AtmosphereShader();
 
       void initialize();
       void update();
 
-      const std::shared_ptr<sf::RenderTexture>& getRenderTexture() const;
+      //! texture with the atmosphere tiles of the current view
+      void setPhysicsTexture(const sf::Texture& texture);
+
       const sf::Shader& getShader() const;
 
 
    private:
 
-      std::shared_ptr<sf::RenderTexture> mRenderTexture;
-
       sf::Shader mShader;
       sf::Texture mDistortionMap;
 
@@ -0,0 +1,294 @@
+#include "spatialquery.h"
+
+#include "constants.h"
+#include "fixturenode.h"
+#include "luanode.h"
+
+#include <cmath>
+#include <functional>
+
+
+namespace
+{
+
+SpatialQuery::Hit makeHit(b2Fixture* fixture, const b2Vec2& point, float fraction)
+{
+   SpatialQuery::Hit hit;
+   hit.mX = point.x * PPM;
+   hit.mY = point.y * PPM;
+   hit.mFraction = fraction;
+
+   auto fixtureNode = static_cast<FixtureNode*>(fixture->GetUserData());
+   if (fixtureNode)
+   {
+      hit.mType = static_cast<int32_t>(fixtureNode->getType());
+
+      auto luaNode = dynamic_cast<LuaNode*>(fixtureNode->getParent());
+      if (luaNode)
+      {
+         hit.mBodyId = luaNode->mId;
+      }
+   }
+
+   return hit;
+}
+
+
+class AABBCallback : public b2QueryCallback
+{
+   public:
+
+      explicit AABBCallback(std::vector<SpatialQuery::Hit>& hits)
+       : mHits(hits)
+      {
+      }
+
+      bool ReportFixture(b2Fixture* fixture) override
+      {
+         mHits.push_back(makeHit(fixture, fixture->GetBody()->GetPosition(), 0.0f));
+
+         // to keep going to find all fixtures in the query area
+         return true;
+      }
+
+      std::vector<SpatialQuery::Hit>& mHits;
+};
+
+
+class ClosestRayCallback : public b2RayCastCallback
+{
+   public:
+
+      float32 ReportFixture(b2Fixture* fixture, const b2Vec2& point, const b2Vec2& /*normal*/, float32 fraction) override
+      {
+         mFixture = fixture;
+         mPoint = point;
+         mFraction = fraction;
+
+         // clip the ray so only closer fixtures are reported from now on
+         return fraction;
+      }
+
+      b2Fixture* mFixture = nullptr;
+      b2Vec2 mPoint;
+      float32 mFraction = 1.0f;
+};
+
+}
+
+
+SpatialQuery& SpatialQuery::getInstance()
+{
+   static SpatialQuery sInstance;
+   return sInstance;
+}
+
+
+bool SpatialQuery::Key::operator==(const Key& other) const
+{
+   return
+         mKind == other.mKind
+      && mX1 == other.mX1
+      && mY1 == other.mY1
+      && mX2 == other.mX2
+      && mY2 == other.mY2;
+}
+
+
+size_t SpatialQuery::KeyHash::operator()(const Key& key) const
+{
+   std::hash<float> hash;
+
+   auto seed = static_cast<size_t>(key.mKind);
+   for (auto value : {key.mX1, key.mY1, key.mX2, key.mY2})
+   {
+      seed ^= hash(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+   }
+
+   return seed;
+}
+
+
+void SpatialQuery::beginFrame(bool caching)
+{
+   std::lock_guard<std::mutex> guard(mMutex);
+
+   mLookup.clear();
+   mResultCount = 0;
+   mFrameStatistics = {};
+   mCaching = caching;
+}
+
+
+void SpatialQuery::endFrame()
+{
+   std::lock_guard<std::mutex> guard(mMutex);
+
+   mCaching = false;
+   mStatistics = mFrameStatistics;
+}
+
+
+const SpatialQuery::Statistics& SpatialQuery::getStatistics() const
+{
+   return mStatistics;
+}
+
+
+bool SpatialQuery::findCached(const Key& key, std::vector<Hit>& hits)
+{
+   std::lock_guard<std::mutex> guard(mMutex);
+
+   mFrameStatistics.mQueries++;
+
+   if (!mCaching)
+   {
+      return false;
+   }
+
+   const auto it = mLookup.find(key);
+   if (it == mLookup.end())
+   {
+      return false;
+   }
+
+   mFrameStatistics.mCacheHits++;
+
+   const auto& cached = mResults[it->second];
+   hits.insert(hits.end(), cached.begin(), cached.end());
+   return true;
+}
+
+
+void SpatialQuery::storeCached(const Key& key, const std::vector<Hit>& hits, size_t first)
+{
+   std::lock_guard<std::mutex> guard(mMutex);
+
+   // another thread might have answered the same query in the meantime
+   if (!mCaching || mLookup.count(key) > 0)
+   {
+      return;
+   }
+
+   if (mResultCount == mResults.size())
+   {
+      mResults.emplace_back();
+   }
+
+   auto& cached = mResults[mResultCount];
+   cached.assign(hits.begin() + static_cast<std::ptrdiff_t>(first), hits.end());
+
+   mLookup[key] = mResultCount;
+   mResultCount++;
+}
+
+
+void SpatialQuery::queryAABBUncached(b2World* world, const Key& key, std::vector<Hit>& hits)
+{
+   b2AABB aabb;
+   aabb.lowerBound.Set(key.mX1 * MPP, key.mY1 * MPP);
+   aabb.upperBound.Set(key.mX2 * MPP, key.mY2 * MPP);
+
+   AABBCallback callback(hits);
+   world->QueryAABB(&callback, aabb);
+}
+
+
+void SpatialQuery::rayCastUncached(b2World* world, const Key& key, std::vector<Hit>& hits)
+{
+   const b2Vec2 p1{key.mX1 * MPP, key.mY1 * MPP};
+   const b2Vec2 p2{key.mX2 * MPP, key.mY2 * MPP};
+
+   // box2d asserts on zero length rays
+   if ((p2 - p1).LengthSquared() <= 0.0f)
+   {
+      return;
+   }
+
+   ClosestRayCallback callback;
+   world->RayCast(&callback, p1, p2);
+
+   if (callback.mFixture)
+   {
+      hits.push_back(makeHit(callback.mFixture, callback.mPoint, callback.mFraction));
+   }
+}
+
+
+void SpatialQuery::queryAABB(b2World* world, float x1, float y1, float x2, float y2, std::vector<Hit>& hits)
+{
+   hits.clear();
+
+   const Key key{Kind::AABB, x1, y1, x2, y2};
+
+   if (findCached(key, hits))
+   {
+      return;
+   }
+
+   queryAABBUncached(world, key, hits);
+   storeCached(key, hits, 0);
+}
+
+
+void SpatialQuery::rayCast(b2World* world, float x1, float y1, float x2, float y2, std::vector<Hit>& hits)
+{
+   hits.clear();
+
+   const Key key{Kind::Ray, x1, y1, x2, y2};
+
+   if (findCached(key, hits))
+   {
+      return;
+   }
+
+   rayCastUncached(world, key, hits);
+   storeCached(key, hits, 0);
+}
+
+
+void SpatialQuery::rayFan(
+   b2World* world,
+   float x,
+   float y,
+   float angle,
+   float spread,
+   float length,
+   int32_t count,
+   std::vector<Hit>& hits
+)
+{
+   hits.clear();
+
+   if (count <= 0)
+   {
+      return;
+   }
+
+   const auto start = (count > 1) ? (angle - spread * 0.5f) : angle;
+   const auto step = (count > 1) ? (spread / static_cast<float>(count - 1)) : 0.0f;
+
+   for (auto i = 0; i < count; i++)
+   {
+      const auto rayAngle = start + step * static_cast<float>(i);
+      const Key key{Kind::Ray, x, y, x + std::cos(rayAngle) * length, y + std::sin(rayAngle) * length};
+
+      // every ray gets a slot, rays that don't hit anything end at their end point
+      const auto first = hits.size();
+
+      if (!findCached(key, hits))
+      {
+         rayCastUncached(world, key, hits);
+         storeCached(key, hits, first);
+      }
+
+      if (hits.size() == first)
+      {
+         Hit miss;
+         miss.mX = key.mX2;
+         miss.mY = key.mY2;
+         hits.push_back(miss);
+      }
+   }
+}
+
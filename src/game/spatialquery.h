@@ -0,0 +1,108 @@
+#pragma once
+
+#include "Box2D/Box2D.h"
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+
+// box and ray queries against the box2d broadphase for the lua scripts
+//
+// enemies of the same kind tend to ask the same questions in the same frame, so while the
+// lua nodes are dispatched on the worker pool the results are cached and identical queries
+// are answered from the cache. the world is read only then since engine calls are deferred
+// until all scripts are done. dispatched one after another, scripts change the world right
+// away and their queries are never cached. the cache is shared by all worker threads.
+//
+// positions go in and come out in pixels.
+class SpatialQuery
+{
+
+public:
+
+   struct Hit
+   {
+      int32_t mType = -1;       // ObjectType of the fixture, -1 if it has none
+      int32_t mBodyId = -1;     // id of the lua node owning the fixture, -1 for anything else
+      float mX = 0.0f;          // ray hit point or body position for box queries
+      float mY = 0.0f;
+      float mFraction = 1.0f;   // distance along the ray in 0..1, 1 if nothing was hit
+   };
+
+   struct Statistics
+   {
+      int32_t mQueries = 0;
+      int32_t mCacheHits = 0;
+   };
+
+   static SpatialQuery& getInstance();
+
+   //! enclose the lua dispatch, queries are only cached in between and only if caching is set
+   void beginFrame(bool caching);
+   void endFrame();
+
+   //! all fixtures whose aabb overlaps the box
+   void queryAABB(b2World* world, float x1, float y1, float x2, float y2, std::vector<Hit>& hits);
+
+   //! closest fixture along the ray, hits stays empty if there is none
+   void rayCast(b2World* world, float x1, float y1, float x2, float y2, std::vector<Hit>& hits);
+
+   //! count rays spread evenly over the angle range (radians), one hit per ray
+   void rayFan(
+      b2World* world,
+      float x,
+      float y,
+      float angle,
+      float spread,
+      float length,
+      int32_t count,
+      std::vector<Hit>& hits
+   );
+
+   const Statistics& getStatistics() const;
+
+
+private:
+
+   SpatialQuery() = default;
+
+   enum class Kind : int32_t
+   {
+      AABB,
+      Ray
+   };
+
+   struct Key
+   {
+      Kind mKind;
+      float mX1;
+      float mY1;
+      float mX2;
+      float mY2;
+
+      bool operator==(const Key& other) const;
+   };
+
+   struct KeyHash
+   {
+      size_t operator()(const Key& key) const;
+   };
+
+   bool findCached(const Key& key, std::vector<Hit>& hits);
+   void storeCached(const Key& key, const std::vector<Hit>& hits, size_t first);
+
+   void queryAABBUncached(b2World* world, const Key& key, std::vector<Hit>& hits);
+   void rayCastUncached(b2World* world, const Key& key, std::vector<Hit>& hits);
+
+   std::mutex mMutex;
+   bool mCaching = false;
+   std::unordered_map<Key, size_t, KeyHash> mLookup;
+   std::deque<std::vector<Hit>> mResults; // kept across frames to keep their capacity
+   size_t mResultCount = 0;
+   Statistics mStatistics;
+   Statistics mFrameStatistics;
+};
+
@@ -113,8 +113,6 @@ void SquareMarcher::deserialize()
 
 void SquareMarcher::scan()
 {
-   std::srand(static_cast<uint32_t>(std::time(nullptr)));
-
    std::ifstream fileIn(mCachePath);
    if (fileIn.fail())
    {
@@ -13,7 +13,6 @@
 #include "framework/tmxparser/tmxtileset.h"
 #include "framework/tmxparser/tmxproperties.h"
 #include "framework/tmxparser/tmxproperty.h"
-#include "player/player.h"
 #include "texturepool.h"
 
 
@@ -75,7 +74,7 @@ bool TileMap::load(
       _normal_map = TexturePool::getInstance().get(normal_map_path);
    }
 
-   auto parallax_scale = 1.0f;
+   _parallax_scale = 1.0f;
    if (layer->_properties)
    {
       auto& map = layer->_properties->_map;
@@ -83,7 +82,7 @@ bool TileMap::load(
       auto itParallaxValue = map.find("parallax");
       if (itParallaxValue != map.end())
       {
-         parallax_scale = itParallaxValue->second->_value_float.value();
+         _parallax_scale = itParallaxValue->second->_value_float.value();
       }
    }
 
@@ -182,8 +181,8 @@ bool TileMap::load(
             else
             {
                // if no animation is available, just store the tile in the static buffer
-               const auto bx = static_cast<int32_t>((tx / parallax_scale) / blockSize);
-               const auto by = static_cast<int32_t>((ty / parallax_scale) / blockSize);
+               const auto bx = static_cast<int32_t>((tx / _parallax_scale) / blockSize);
+               const auto by = static_cast<int32_t>((ty / _parallax_scale) / blockSize);
 
                auto y_it = _vertices_static_blocks.find(by);
                if (y_it == _vertices_static_blocks.end())
@@ -263,8 +262,9 @@ void TileMap::drawVertices(sf::RenderTarget &target, sf::RenderStates states) co
 {
    states.transform *= getTransform();
 
-   // draw the vertex arrays
-   const auto& pos = Player::getCurrent()->getPixelPositioni();
+   // draw the vertex arrays of the blocks around the view center, parallax layers
+   // are drawn with a scaled view so their blocks are stored in unscaled coordinates
+   const auto pos = sf::Vector2i(target.getView().getCenter() / _parallax_scale);
 
    int32_t bx = (pos.x / PIXELS_PER_TILE) / blockSize;
    int32_t by = (pos.y / PIXELS_PER_TILE) / blockSize;
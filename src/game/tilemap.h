@@ -86,5 +86,6 @@ private:
 
    int _z = 0;
    bool _visible = true;
+   float _parallax_scale = 1.0f;
 };
 
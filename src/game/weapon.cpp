@@ -87,7 +87,7 @@ void Weapon::fireNow(
    // create a projectile animation copy from the reference animation
    copyReferenceAnimation(projectile);
 
-   projectile->setProperty("damage", _damage);
+   projectile->setProperty(PropertyKey::Damage, _damage);
    projectile->setBody(_body);
 
    projectile->addDestroyedCallback([this, projectile](){
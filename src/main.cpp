@@ -3,6 +3,7 @@
 #include <chrono>
 #include <sstream>
 
+#include "game/benchmarkrunner.h"
 #include "game/constants.h"
 #include "game/preloader.h"
 #include "game/test.h"
@@ -27,9 +28,16 @@ void debugAuthors()
 }
 
 
-int main(int /*argc*/, char** /*argv*/)
+int main(int argc, char** argv)
 {
    debugAuthors();
+
+   BenchmarkRunner::Settings benchmarkSettings;
+   if (BenchmarkRunner::parseArguments(argc, argv, benchmarkSettings))
+   {
+      return BenchmarkRunner().run(benchmarkSettings);
+   }
+
    Test test;
    Game game;
    game.initialize();
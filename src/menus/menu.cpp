@@ -18,12 +18,35 @@
 #include "game/gamecontrollerintegration.h"
 #include "framework/joystick/gamecontroller.h"
 
+#include <algorithm>
 #include <iostream>
+#include <map>
 
 
 std::shared_ptr<Menu> Menu::sInstance;
 
 
+namespace
+{
+   // the screens that can be reached from a given screen; those are decoded
+   // in the background while the user is still looking at the current one
+   const std::map<Menu::MenuType, std::vector<Menu::MenuType>> sNeighbours = {
+      {Menu::MenuType::Main,         {Menu::MenuType::FileSelect, Menu::MenuType::Options}},
+      {Menu::MenuType::FileSelect,   {Menu::MenuType::NameSelect, Menu::MenuType::Main}},
+      {Menu::MenuType::NameSelect,   {Menu::MenuType::FileSelect}},
+      {Menu::MenuType::Options,      {Menu::MenuType::Controls, Menu::MenuType::Video, Menu::MenuType::Audio,
+                                      Menu::MenuType::Game, Menu::MenuType::Achievements, Menu::MenuType::Credits}},
+      {Menu::MenuType::Controls,     {Menu::MenuType::Options}},
+      {Menu::MenuType::Video,        {Menu::MenuType::Options}},
+      {Menu::MenuType::Audio,        {Menu::MenuType::Options}},
+      {Menu::MenuType::Game,         {Menu::MenuType::Options}},
+      {Menu::MenuType::Achievements, {Menu::MenuType::Options}},
+      {Menu::MenuType::Credits,      {Menu::MenuType::Options}},
+      {Menu::MenuType::Pause,        {Menu::MenuType::Options, Menu::MenuType::Main}},
+   };
+}
+
+
 Menu::Menu()
 {
    mMenuMain = std::make_shared<MenuScreenMain>();
@@ -50,10 +73,7 @@ Menu::Menu()
    mMenus.push_back(mMenuCredits);
    mMenus.push_back(mMenuPause);
 
-   for (auto& screen : mMenus)
-   {
-      screen->load();
-   }
+   // the screens are loaded on demand when they are shown, see show()
 }
 
 
@@ -141,6 +161,9 @@ void Menu::show(Menu::MenuType menu)
 
    if (mCurrentMenu)
    {
+      mCurrentMenu->load();
+      updateResidentScreens();
+
       mCurrentMenu->showEvent();
       DisplayMode::getInstance().enqueueSet(DisplayMainMenu);
    }
@@ -153,6 +176,36 @@ void Menu::show(Menu::MenuType menu)
 }
 
 
+void Menu::updateResidentScreens()
+{
+   const auto it = sNeighbours.find(mCurrentType);
+   const auto& neighbours = (it != sNeighbours.end()) ? it->second : std::vector<MenuType>{};
+
+   // release the textures of all screens that are out of reach
+   for (auto& screen : mMenus)
+   {
+      if (screen == mCurrentMenu)
+      {
+         continue;
+      }
+
+      const auto reachable = std::any_of(neighbours.begin(), neighbours.end(), [this, &screen](auto type){
+         return getMenuScreen(type) == screen;
+      });
+
+      if (!reachable)
+      {
+         screen->unload();
+      }
+   }
+
+   for (auto type : neighbours)
+   {
+      getMenuScreen(type)->prefetch();
+   }
+}
+
+
 void Menu::hide()
 {
    if (mCurrentMenu)
@@ -55,6 +55,8 @@ public:
 
 private:
 
+   void updateResidentScreens();
+
    MenuType mCurrentType = MenuType::None;
    MenuType mPreviousType = MenuType::None;
 
@@ -1,6 +1,6 @@
 #include "menuscreen.h"
 
-#include "framework/image/psd.h"
+#include "framework/image/psdatlas.h"
 #include "game/gamecontrollerintegration.h"
 
 #include <iostream>
@@ -48,48 +48,127 @@ void MenuScreen::setFilename(const std::string& filename)
 
 void MenuScreen::load()
 {
-   PSD psd;
-   psd.setColorFormat(PSD::ColorFormat::ABGR);
-   psd.load(mFilename);
+   if (isLoaded())
+   {
+      return;
+   }
+
+   std::shared_ptr<PSDAtlas> atlas;
+
+   if (mPrefetch.valid())
+   {
+      atlas = mPrefetch.get();
+   }
+   else
+   {
+      atlas = std::make_shared<PSDAtlas>();
+      atlas->load(mFilename);
+   }
+
+   for (const auto& page : atlas->getPages())
+   {
+      auto texture = std::make_shared<sf::Texture>();
+      texture->create(static_cast<uint32_t>(page.mWidth), static_cast<uint32_t>(page.mHeight));
+      texture->update(reinterpret_cast<const sf::Uint8*>(page.mData.data()));
+      mPages.push_back(texture);
+   }
+
+   // the layers survive an unload so the screen's state is preserved,
+   // in that case only the textures need to be re-attached
+   const auto initialLoad = mLayerStack.empty();
 
-   // std::cout << mFilename << std::endl;
+   createLayers(*atlas);
+   mLoaded = true;
 
-   for (const auto& layer : psd.getLayers())
+   if (initialLoad)
    {
-      // skip groups
-      if (layer.getSectionDivider() != PSD::Layer::SectionDivider::None)
+      loadingFinished();
+   }
+}
+
+
+void MenuScreen::prefetch()
+{
+   if (isLoaded() || mPrefetch.valid())
+   {
+      return;
+   }
+
+   // decoding the psd doesn't touch any gl resources so it's safe to do that on a
+   // separate thread; the texture upload happens in load() on the main thread
+   mPrefetch = std::async(
+      std::launch::async, [filename = mFilename](){
+         auto atlas = std::make_shared<PSDAtlas>();
+         atlas->load(filename);
+         return atlas;
+      }
+   );
+}
+
+
+void MenuScreen::unload()
+{
+   for (auto& layer : mLayerStack)
+   {
+      layer->mTexture.reset();
+   }
+
+   mPages.clear();
+   mLoaded = false;
+}
+
+
+bool MenuScreen::isLoaded() const
+{
+   return mLoaded;
+}
+
+
+void MenuScreen::createLayers(const PSDAtlas& atlas)
+{
+   const auto& entries = atlas.getEntries();
+
+   for (auto i = 0u; i < entries.size(); i++)
+   {
+      const auto& entry = entries[i];
+
+      // empty layers don't occupy any space inside the atlas
+      const auto page = static_cast<size_t>(entry.mPage);
+      auto texture = (page < mPages.size()) ? mPages[page] : nullptr;
+
+      if (i < mLayerStack.size())
       {
+         auto& layer = mLayerStack[i];
+         layer->mTexture = texture;
+
+         if (texture)
+         {
+            layer->mSprite->setTexture(*texture, false);
+         }
+
          continue;
       }
 
-      // std::cout << layer.getName() << std::endl;
-
       auto tmp = std::make_shared<Layer>();
       // tmp.mVisible = layer.isVisible();
 
-      auto texture = std::make_shared<sf::Texture>();
       auto sprite = std::make_shared<sf::Sprite>();
-      auto opacity = layer.getOpacity();
 
-      texture->create(static_cast<uint32_t>(layer.getWidth()), static_cast<uint32_t>(layer.getHeight()));
-      texture->update(reinterpret_cast<const sf::Uint8*>(layer.getImage().getData().data()));
+      if (texture)
+      {
+         sprite->setTexture(*texture);
+      }
 
-      sprite->setTexture(*texture, true);
-      sprite->setPosition(static_cast<float>(layer.getLeft()), static_cast<float>(layer.getTop()));
-      sprite->setColor(sf::Color(255u, 255u, 255u, static_cast<uint8_t>(opacity)));
+      sprite->setTextureRect({entry.mAtlasX, entry.mAtlasY, entry.mWidth, entry.mHeight});
+      sprite->setPosition(static_cast<float>(entry.mLeft), static_cast<float>(entry.mTop));
+      sprite->setColor(sf::Color(255u, 255u, 255u, entry.mOpacity));
 
       tmp->mTexture = texture;
       tmp->mSprite = sprite;
 
-      // std::cout << "    " << layer.getName() << std::endl;
-
       mLayerStack.push_back(tmp);
-      mLayers[layer.getName()] = tmp;
+      mLayers[entry.mName] = tmp;
    }
-
-   // std::cout << "---------" << std::endl;
-
-   loadingFinished();
 }
 
 
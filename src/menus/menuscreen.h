@@ -1,11 +1,14 @@
 #pragma once
 
+#include <future>
 #include <memory>
 #include <string>
 #include <vector>
 
 #include "framework/image/layer.h"
 
+class PSDAtlas;
+
 
 class MenuScreen
 {
@@ -24,6 +27,9 @@ public:
    void setFilename(const std::string& filename);
 
    void load();
+   void prefetch();
+   void unload();
+   bool isLoaded() const;
    virtual void loadingFinished();
 
    virtual void keyboardKeyPressed(sf::Keyboard::Key key);
@@ -39,5 +45,14 @@ protected:
    std::string mFilename;
    std::vector<std::shared_ptr<Layer>> mLayerStack;
    std::map<std::string, std::shared_ptr<Layer>> mLayers;
+
+
+private:
+
+   void createLayers(const PSDAtlas& atlas);
+
+   std::future<std::shared_ptr<PSDAtlas>> mPrefetch;
+   std::vector<std::shared_ptr<sf::Texture>> mPages;
+   bool mLoaded = false;
 };
 
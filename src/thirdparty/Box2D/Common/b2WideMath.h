@@ -0,0 +1,171 @@
+/*
+* Copyright (c) 2006-2011 Erin Catto http://www.box2d.org
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+* 1. The origin of this software must not be misrepresented; you must not
+* claim that you wrote the original software. If you use this software
+* in a product, an acknowledgment in the product documentation would be
+* appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+* misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef B2_WIDE_MATH_H
+#define B2_WIDE_MATH_H
+
+#include <Box2D/Common/b2Settings.h>
+
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define B2_SIMD_SSE2 1
+#include <emmintrin.h>
+#else
+#define B2_SIMD_SSE2 0
+#endif
+
+/// Number of lanes processed by the wide contact solver.
+#define b2_simdWidth 4
+
+/// Four floats processed together. Comparisons return lane masks (all bits set or cleared)
+/// which can be combined with b2AndW/b2OrW and used with b2BlendW.
+#if B2_SIMD_SSE2
+
+struct b2FloatW
+{
+	__m128 v;
+};
+
+inline b2FloatW b2ZeroW() { return { _mm_setzero_ps() }; }
+inline b2FloatW b2SplatW(float32 s) { return { _mm_set1_ps(s) }; }
+inline b2FloatW b2SetW(float32 a, float32 b, float32 c, float32 d) { return { _mm_setr_ps(a, b, c, d) }; }
+inline b2FloatW b2LoadW(const float32* values) { return { _mm_loadu_ps(values) }; }
+inline void b2StoreW(float32* values, b2FloatW a) { _mm_storeu_ps(values, a.v); }
+
+inline b2FloatW b2AddW(b2FloatW a, b2FloatW b) { return { _mm_add_ps(a.v, b.v) }; }
+inline b2FloatW b2SubW(b2FloatW a, b2FloatW b) { return { _mm_sub_ps(a.v, b.v) }; }
+inline b2FloatW b2MulW(b2FloatW a, b2FloatW b) { return { _mm_mul_ps(a.v, b.v) }; }
+inline b2FloatW b2DivW(b2FloatW a, b2FloatW b) { return { _mm_div_ps(a.v, b.v) }; }
+inline b2FloatW b2SqrtW(b2FloatW a) { return { _mm_sqrt_ps(a.v) }; }
+inline b2FloatW b2MinW(b2FloatW a, b2FloatW b) { return { _mm_min_ps(a.v, b.v) }; }
+inline b2FloatW b2MaxW(b2FloatW a, b2FloatW b) { return { _mm_max_ps(a.v, b.v) }; }
+
+inline b2FloatW b2GreaterEqualW(b2FloatW a, b2FloatW b) { return { _mm_cmpge_ps(a.v, b.v) }; }
+inline b2FloatW b2GreaterW(b2FloatW a, b2FloatW b) { return { _mm_cmpgt_ps(a.v, b.v) }; }
+inline b2FloatW b2LessW(b2FloatW a, b2FloatW b) { return { _mm_cmplt_ps(a.v, b.v) }; }
+inline b2FloatW b2AndW(b2FloatW a, b2FloatW b) { return { _mm_and_ps(a.v, b.v) }; }
+inline b2FloatW b2OrW(b2FloatW a, b2FloatW b) { return { _mm_or_ps(a.v, b.v) }; }
+
+/// Lanes of b where the mask is set, lanes of a elsewhere.
+inline b2FloatW b2BlendW(b2FloatW a, b2FloatW b, b2FloatW mask)
+{
+	return { _mm_or_ps(_mm_andnot_ps(mask.v, a.v), _mm_and_ps(mask.v, b.v)) };
+}
+
+#else
+
+struct b2FloatW
+{
+	float32 v[b2_simdWidth];
+};
+
+inline b2FloatW b2SetW(float32 a, float32 b, float32 c, float32 d) { return { { a, b, c, d } }; }
+inline b2FloatW b2SplatW(float32 s) { return b2SetW(s, s, s, s); }
+inline b2FloatW b2ZeroW() { return b2SplatW(0.0f); }
+inline b2FloatW b2LoadW(const float32* values) { return b2SetW(values[0], values[1], values[2], values[3]); }
+inline void b2StoreW(float32* values, b2FloatW a) { std::memcpy(values, a.v, sizeof(a.v)); }
+
+#define B2_WIDE_BINARY(name, expression) \
+	inline b2FloatW name(b2FloatW a, b2FloatW b) \
+	{ \
+		b2FloatW r; \
+		for (int32 i = 0; i < b2_simdWidth; ++i) { float32 x = a.v[i]; float32 y = b.v[i]; r.v[i] = (expression); } \
+		return r; \
+	}
+
+inline float32 b2MaskW(bool condition)
+{
+	uint32 bits = condition ? 0xffffffffu : 0u;
+	float32 mask;
+	std::memcpy(&mask, &bits, sizeof(mask));
+	return mask;
+}
+
+inline uint32 b2BitsW(float32 value)
+{
+	uint32 bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	return bits;
+}
+
+inline float32 b2FromBitsW(uint32 bits)
+{
+	float32 value;
+	std::memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+B2_WIDE_BINARY(b2AddW, x + y)
+B2_WIDE_BINARY(b2SubW, x - y)
+B2_WIDE_BINARY(b2MulW, x * y)
+B2_WIDE_BINARY(b2DivW, x / y)
+B2_WIDE_BINARY(b2MinW, y < x ? y : x)
+B2_WIDE_BINARY(b2MaxW, x < y ? y : x)
+B2_WIDE_BINARY(b2GreaterEqualW, b2MaskW(x >= y))
+B2_WIDE_BINARY(b2GreaterW, b2MaskW(x > y))
+B2_WIDE_BINARY(b2LessW, b2MaskW(x < y))
+B2_WIDE_BINARY(b2AndW, b2FromBitsW(b2BitsW(x) & b2BitsW(y)))
+B2_WIDE_BINARY(b2OrW, b2FromBitsW(b2BitsW(x) | b2BitsW(y)))
+
+#undef B2_WIDE_BINARY
+
+inline b2FloatW b2SqrtW(b2FloatW a)
+{
+	b2FloatW r;
+	for (int32 i = 0; i < b2_simdWidth; ++i) { r.v[i] = std::sqrt(a.v[i]); }
+	return r;
+}
+
+inline b2FloatW b2BlendW(b2FloatW a, b2FloatW b, b2FloatW mask)
+{
+	b2FloatW r;
+	for (int32 i = 0; i < b2_simdWidth; ++i) { r.v[i] = b2BitsW(mask.v[i]) ? b.v[i] : a.v[i]; }
+	return r;
+}
+
+#endif
+
+/// Multiply and add, a + b * c.
+inline b2FloatW b2MulAddW(b2FloatW a, b2FloatW b, b2FloatW c) { return b2AddW(a, b2MulW(b, c)); }
+
+/// Multiply and subtract, a - b * c.
+inline b2FloatW b2MulSubW(b2FloatW a, b2FloatW b, b2FloatW c) { return b2SubW(a, b2MulW(b, c)); }
+
+/// Clamp every lane of a to [low, high].
+inline b2FloatW b2ClampW(b2FloatW a, b2FloatW low, b2FloatW high) { return b2MaxW(low, b2MinW(a, high)); }
+
+/// Two dimensional vector of wide floats.
+struct b2Vec2W
+{
+	b2FloatW x, y;
+};
+
+inline b2FloatW b2DotW(const b2Vec2W& a, const b2Vec2W& b)
+{
+	return b2AddW(b2MulW(a.x, b.x), b2MulW(a.y, b.y));
+}
+
+/// Cross product of two vectors, a scalar.
+inline b2FloatW b2CrossW(const b2Vec2W& a, const b2Vec2W& b)
+{
+	return b2SubW(b2MulW(a.x, b.y), b2MulW(a.y, b.x));
+}
+
+#endif
@@ -23,6 +23,9 @@
 #include <Box2D/Dynamics/b2Fixture.h>
 #include <Box2D/Dynamics/b2World.h>
 #include <Box2D/Common/b2StackAllocator.h>
+#include <Box2D/Common/b2WideMath.h>
+
+#include <algorithm>
 
 #define B2_DEBUG_SOLVER 0
 
@@ -43,6 +46,47 @@ struct b2ContactPositionConstraint
 	int32 pointCount;
 };
 
+// b2_simdWidth velocity constraints without a shared movable body, one lane per constraint.
+// The second point of single point constraints has zero mass and impulse so it doesn't
+// contribute.
+struct b2WideVelocityConstraint
+{
+	b2Vec2W normal;
+	b2FloatW invMassA, invMassB;
+	b2FloatW invIA, invIB;
+	b2FloatW friction;
+	b2FloatW tangentSpeed;
+	b2Vec2W rA1, rB1, rA2, rB2;
+	b2FloatW normalMass1, normalMass2;
+	b2FloatW tangentMass1, tangentMass2;
+	b2FloatW velocityBias1, velocityBias2;
+	b2FloatW normalImpulse1, normalImpulse2;
+	b2FloatW tangentImpulse1, tangentImpulse2;
+	b2FloatW K11, K12, K22;
+	b2FloatW normalMass11, normalMass12, normalMass22;
+	b2FloatW blockSolve;
+	int32 indexA[b2_simdWidth];
+	int32 indexB[b2_simdWidth];
+	int32 constraint[b2_simdWidth];
+};
+
+// Position constraints of the same constraints as the matching b2WideVelocityConstraint.
+struct b2WidePositionConstraint
+{
+	b2Vec2W localPoint1, localPoint2;
+	b2Vec2W localNormal;
+	b2Vec2W localPoint;
+	b2Vec2W localCenterA, localCenterB;
+	b2FloatW invMassA, invMassB;
+	b2FloatW invIA, invIB;
+	b2FloatW radiusA, radiusB;
+	b2FloatW faceB;
+	b2FloatW circles;
+	b2FloatW twoPoints;
+	int32 indexA[b2_simdWidth];
+	int32 indexB[b2_simdWidth];
+};
+
 b2ContactSolver::b2ContactSolver(b2ContactSolverDef* def)
 {
 	m_step = def->step;
@@ -53,6 +97,12 @@ b2ContactSolver::b2ContactSolver(b2ContactSolverDef* def)
 	m_positions = def->positions;
 	m_velocities = def->velocities;
 	m_contacts = def->contacts;
+	m_wideMemory = nullptr;
+	m_wideVelocityConstraints = nullptr;
+	m_widePositionConstraints = nullptr;
+	m_wideCount = 0;
+	m_scalarIndices = nullptr;
+	m_scalarCount = 0;
 
 	// Initialize position independent portions of the constraints.
 	for (int32 i = 0; i < m_count; ++i)
@@ -132,6 +182,12 @@ b2ContactSolver::b2ContactSolver(b2ContactSolverDef* def)
 
 b2ContactSolver::~b2ContactSolver()
 {
+	if (m_wideMemory != nullptr)
+	{
+		m_allocator->Free(m_wideMemory);
+		m_allocator->Free(m_scalarIndices);
+	}
+
 	m_allocator->Free(m_velocityConstraints);
 	m_allocator->Free(m_positionConstraints);
 }
@@ -246,6 +302,11 @@ void b2ContactSolver::InitializeVelocityConstraints()
 			}
 		}
 	}
+
+	if (m_step.wideContactSolver && m_wideMemory == nullptr)
+	{
+		PrepareWideConstraints();
+	}
 }
 
 void b2ContactSolver::WarmStart()
@@ -290,319 +351,364 @@ void b2ContactSolver::WarmStart()
 
 void b2ContactSolver::SolveVelocityConstraints()
 {
+	if (m_wideCount > 0 || m_scalarIndices != nullptr)
+	{
+		// Batches of constraints with distinct bodies first, then the ones that didn't fit into a batch.
+		for (int32 i = 0; i < m_wideCount; ++i)
+		{
+			SolveVelocityConstraintsWide(m_wideVelocityConstraints + i);
+		}
+
+		for (int32 i = 0; i < m_scalarCount; ++i)
+		{
+			SolveVelocityConstraint(m_velocityConstraints + m_scalarIndices[i]);
+		}
+
+		return;
+	}
+
 	for (int32 i = 0; i < m_count; ++i)
 	{
-		b2ContactVelocityConstraint* vc = m_velocityConstraints + i;
+		SolveVelocityConstraint(m_velocityConstraints + i);
+	}
+}
 
-		int32 indexA = vc->indexA;
-		int32 indexB = vc->indexB;
-		float32 mA = vc->invMassA;
-		float32 iA = vc->invIA;
-		float32 mB = vc->invMassB;
-		float32 iB = vc->invIB;
-		int32 pointCount = vc->pointCount;
+void b2ContactSolver::SolveVelocityConstraint(b2ContactVelocityConstraint* vc)
+{
+	int32 indexA = vc->indexA;
+	int32 indexB = vc->indexB;
+	float32 mA = vc->invMassA;
+	float32 iA = vc->invIA;
+	float32 mB = vc->invMassB;
+	float32 iB = vc->invIB;
+	int32 pointCount = vc->pointCount;
+
+	b2Vec2 vA = m_velocities[indexA].v;
+	float32 wA = m_velocities[indexA].w;
+	b2Vec2 vB = m_velocities[indexB].v;
+	float32 wB = m_velocities[indexB].w;
+
+	b2Vec2 normal = vc->normal;
+	b2Vec2 tangent = b2Cross(normal, 1.0f);
+	float32 friction = vc->friction;
+
+	b2Assert(pointCount == 1 || pointCount == 2);
+
+	// Solve tangent constraints first because non-penetration is more important
+	// than friction.
+	for (int32 j = 0; j < pointCount; ++j)
+	{
+		b2VelocityConstraintPoint* vcp = vc->points + j;
 
-		b2Vec2 vA = m_velocities[indexA].v;
-		float32 wA = m_velocities[indexA].w;
-		b2Vec2 vB = m_velocities[indexB].v;
-		float32 wB = m_velocities[indexB].w;
+		// Relative velocity at contact
+		b2Vec2 dv = vB + b2Cross(wB, vcp->rB) - vA - b2Cross(wA, vcp->rA);
 
-		b2Vec2 normal = vc->normal;
-		b2Vec2 tangent = b2Cross(normal, 1.0f);
-		float32 friction = vc->friction;
+		// Compute tangent force
+		float32 vt = b2Dot(dv, tangent) - vc->tangentSpeed;
+		float32 lambda = vcp->tangentMass * (-vt);
 
-		b2Assert(pointCount == 1 || pointCount == 2);
+		// b2Clamp the accumulated force
+		float32 maxFriction = friction * vcp->normalImpulse;
+		float32 newImpulse = b2Clamp(vcp->tangentImpulse + lambda, -maxFriction, maxFriction);
+		lambda = newImpulse - vcp->tangentImpulse;
+		vcp->tangentImpulse = newImpulse;
 
-		// Solve tangent constraints first because non-penetration is more important
-		// than friction.
-		for (int32 j = 0; j < pointCount; ++j)
+		// Apply contact impulse
+		b2Vec2 P = lambda * tangent;
+
+		vA -= mA * P;
+		wA -= iA * b2Cross(vcp->rA, P);
+
+		vB += mB * P;
+		wB += iB * b2Cross(vcp->rB, P);
+	}
+
+	// Solve normal constraints
+	if (pointCount == 1 || g_blockSolve == false)
+	{
+		for (int32 i = 0; i < pointCount; ++i)
 		{
-			b2VelocityConstraintPoint* vcp = vc->points + j;
+			b2VelocityConstraintPoint* vcp = vc->points + i;
 
 			// Relative velocity at contact
 			b2Vec2 dv = vB + b2Cross(wB, vcp->rB) - vA - b2Cross(wA, vcp->rA);
 
-			// Compute tangent force
-			float32 vt = b2Dot(dv, tangent) - vc->tangentSpeed;
-			float32 lambda = vcp->tangentMass * (-vt);
+			// Compute normal impulse
+			float32 vn = b2Dot(dv, normal);
+			float32 lambda = -vcp->normalMass * (vn - vcp->velocityBias);
 
-			// b2Clamp the accumulated force
-			float32 maxFriction = friction * vcp->normalImpulse;
-			float32 newImpulse = b2Clamp(vcp->tangentImpulse + lambda, -maxFriction, maxFriction);
-			lambda = newImpulse - vcp->tangentImpulse;
-			vcp->tangentImpulse = newImpulse;
+			// b2Clamp the accumulated impulse
+			float32 newImpulse = b2Max(vcp->normalImpulse + lambda, 0.0f);
+			lambda = newImpulse - vcp->normalImpulse;
+			vcp->normalImpulse = newImpulse;
 
 			// Apply contact impulse
-			b2Vec2 P = lambda * tangent;
-
+			b2Vec2 P = lambda * normal;
 			vA -= mA * P;
 			wA -= iA * b2Cross(vcp->rA, P);
 
 			vB += mB * P;
 			wB += iB * b2Cross(vcp->rB, P);
 		}
-
-		// Solve normal constraints
-		if (pointCount == 1 || g_blockSolve == false)
-		{
-			for (int32 i = 0; i < pointCount; ++i)
-			{
-				b2VelocityConstraintPoint* vcp = vc->points + i;
-
-				// Relative velocity at contact
-				b2Vec2 dv = vB + b2Cross(wB, vcp->rB) - vA - b2Cross(wA, vcp->rA);
-
-				// Compute normal impulse
-				float32 vn = b2Dot(dv, normal);
-				float32 lambda = -vcp->normalMass * (vn - vcp->velocityBias);
-
-				// b2Clamp the accumulated impulse
-				float32 newImpulse = b2Max(vcp->normalImpulse + lambda, 0.0f);
-				lambda = newImpulse - vcp->normalImpulse;
-				vcp->normalImpulse = newImpulse;
-
-				// Apply contact impulse
-				b2Vec2 P = lambda * normal;
-				vA -= mA * P;
-				wA -= iA * b2Cross(vcp->rA, P);
-
-				vB += mB * P;
-				wB += iB * b2Cross(vcp->rB, P);
-			}
-		}
-		else
+	}
+	else
+	{
+		// Block solver developed in collaboration with Dirk Gregorius (back in 01/07 on Box2D_Lite).
+		// Build the mini LCP for this contact patch
+		//
+		// vn = A * x + b, vn >= 0, , vn >= 0, x >= 0 and vn_i * x_i = 0 with i = 1..2
+		//
+		// A = J * W * JT and J = ( -n, -r1 x n, n, r2 x n )
+		// b = vn0 - velocityBias
+		//
+		// The system is solved using the "Total enumeration method" (s. Murty). The complementary constraint vn_i * x_i
+		// implies that we must have in any solution either vn_i = 0 or x_i = 0. So for the 2D contact problem the cases
+		// vn1 = 0 and vn2 = 0, x1 = 0 and x2 = 0, x1 = 0 and vn2 = 0, x2 = 0 and vn1 = 0 need to be tested. The first valid
+		// solution that satisfies the problem is chosen.
+		// 
+		// In order to account of the accumulated impulse 'a' (because of the iterative nature of the solver which only requires
+		// that the accumulated impulse is clamped and not the incremental impulse) we change the impulse variable (x_i).
+		//
+		// Substitute:
+		// 
+		// x = a + d
+		// 
+		// a := old total impulse
+		// x := new total impulse
+		// d := incremental impulse 
+		//
+		// For the current iteration we extend the formula for the incremental impulse
+		// to compute the new total impulse:
+		//
+		// vn = A * d + b
+		//    = A * (x - a) + b
+		//    = A * x + b - A * a
+		//    = A * x + b'
+		// b' = b - A * a;
+
+		b2VelocityConstraintPoint* cp1 = vc->points + 0;
+		b2VelocityConstraintPoint* cp2 = vc->points + 1;
+
+		b2Vec2 a(cp1->normalImpulse, cp2->normalImpulse);
+		b2Assert(a.x >= 0.0f && a.y >= 0.0f);
+
+		// Relative velocity at contact
+		b2Vec2 dv1 = vB + b2Cross(wB, cp1->rB) - vA - b2Cross(wA, cp1->rA);
+		b2Vec2 dv2 = vB + b2Cross(wB, cp2->rB) - vA - b2Cross(wA, cp2->rA);
+
+		// Compute normal velocity
+		float32 vn1 = b2Dot(dv1, normal);
+		float32 vn2 = b2Dot(dv2, normal);
+
+		b2Vec2 b;
+		b.x = vn1 - cp1->velocityBias;
+		b.y = vn2 - cp2->velocityBias;
+
+		// Compute b'
+		b -= b2Mul(vc->K, a);
+
+		const float32 k_errorTol = 1e-3f;
+		B2_NOT_USED(k_errorTol);
+
+		for (;;)
 		{
-			// Block solver developed in collaboration with Dirk Gregorius (back in 01/07 on Box2D_Lite).
-			// Build the mini LCP for this contact patch
 			//
-			// vn = A * x + b, vn >= 0, , vn >= 0, x >= 0 and vn_i * x_i = 0 with i = 1..2
+			// Case 1: vn = 0
 			//
-			// A = J * W * JT and J = ( -n, -r1 x n, n, r2 x n )
-			// b = vn0 - velocityBias
+			// 0 = A * x + b'
 			//
-			// The system is solved using the "Total enumeration method" (s. Murty). The complementary constraint vn_i * x_i
-			// implies that we must have in any solution either vn_i = 0 or x_i = 0. So for the 2D contact problem the cases
-			// vn1 = 0 and vn2 = 0, x1 = 0 and x2 = 0, x1 = 0 and vn2 = 0, x2 = 0 and vn1 = 0 need to be tested. The first valid
-			// solution that satisfies the problem is chosen.
-			// 
-			// In order to account of the accumulated impulse 'a' (because of the iterative nature of the solver which only requires
-			// that the accumulated impulse is clamped and not the incremental impulse) we change the impulse variable (x_i).
+			// Solve for x:
 			//
-			// Substitute:
-			// 
-			// x = a + d
-			// 
-			// a := old total impulse
-			// x := new total impulse
-			// d := incremental impulse 
-			//
-			// For the current iteration we extend the formula for the incremental impulse
-			// to compute the new total impulse:
+			// x = - inv(A) * b'
 			//
-			// vn = A * d + b
-			//    = A * (x - a) + b
-			//    = A * x + b - A * a
-			//    = A * x + b'
-			// b' = b - A * a;
-
-			b2VelocityConstraintPoint* cp1 = vc->points + 0;
-			b2VelocityConstraintPoint* cp2 = vc->points + 1;
-
-			b2Vec2 a(cp1->normalImpulse, cp2->normalImpulse);
-			b2Assert(a.x >= 0.0f && a.y >= 0.0f);
-
-			// Relative velocity at contact
-			b2Vec2 dv1 = vB + b2Cross(wB, cp1->rB) - vA - b2Cross(wA, cp1->rA);
-			b2Vec2 dv2 = vB + b2Cross(wB, cp2->rB) - vA - b2Cross(wA, cp2->rA);
-
-			// Compute normal velocity
-			float32 vn1 = b2Dot(dv1, normal);
-			float32 vn2 = b2Dot(dv2, normal);
-
-			b2Vec2 b;
-			b.x = vn1 - cp1->velocityBias;
-			b.y = vn2 - cp2->velocityBias;
-
-			// Compute b'
-			b -= b2Mul(vc->K, a);
+			b2Vec2 x = - b2Mul(vc->normalMass, b);
 
-			const float32 k_errorTol = 1e-3f;
-			B2_NOT_USED(k_errorTol);
-
-			for (;;)
+			if (x.x >= 0.0f && x.y >= 0.0f)
 			{
-				//
-				// Case 1: vn = 0
-				//
-				// 0 = A * x + b'
-				//
-				// Solve for x:
-				//
-				// x = - inv(A) * b'
-				//
-				b2Vec2 x = - b2Mul(vc->normalMass, b);
-
-				if (x.x >= 0.0f && x.y >= 0.0f)
-				{
-					// Get the incremental impulse
-					b2Vec2 d = x - a;
+				// Get the incremental impulse
+				b2Vec2 d = x - a;
 
-					// Apply incremental impulse
-					b2Vec2 P1 = d.x * normal;
-					b2Vec2 P2 = d.y * normal;
-					vA -= mA * (P1 + P2);
-					wA -= iA * (b2Cross(cp1->rA, P1) + b2Cross(cp2->rA, P2));
+				// Apply incremental impulse
+				b2Vec2 P1 = d.x * normal;
+				b2Vec2 P2 = d.y * normal;
+				vA -= mA * (P1 + P2);
+				wA -= iA * (b2Cross(cp1->rA, P1) + b2Cross(cp2->rA, P2));
 
-					vB += mB * (P1 + P2);
-					wB += iB * (b2Cross(cp1->rB, P1) + b2Cross(cp2->rB, P2));
+				vB += mB * (P1 + P2);
+				wB += iB * (b2Cross(cp1->rB, P1) + b2Cross(cp2->rB, P2));
 
-					// Accumulate
-					cp1->normalImpulse = x.x;
-					cp2->normalImpulse = x.y;
+				// Accumulate
+				cp1->normalImpulse = x.x;
+				cp2->normalImpulse = x.y;
 
 #if B2_DEBUG_SOLVER == 1
-					// Postconditions
-					dv1 = vB + b2Cross(wB, cp1->rB) - vA - b2Cross(wA, cp1->rA);
-					dv2 = vB + b2Cross(wB, cp2->rB) - vA - b2Cross(wA, cp2->rA);
+				// Postconditions
+				dv1 = vB + b2Cross(wB, cp1->rB) - vA - b2Cross(wA, cp1->rA);
+				dv2 = vB + b2Cross(wB, cp2->rB) - vA - b2Cross(wA, cp2->rA);
 
-					// Compute normal velocity
-					vn1 = b2Dot(dv1, normal);
-					vn2 = b2Dot(dv2, normal);
+				// Compute normal velocity
+				vn1 = b2Dot(dv1, normal);
+				vn2 = b2Dot(dv2, normal);
 
-					b2Assert(b2Abs(vn1 - cp1->velocityBias) < k_errorTol);
-					b2Assert(b2Abs(vn2 - cp2->velocityBias) < k_errorTol);
+				b2Assert(b2Abs(vn1 - cp1->velocityBias) < k_errorTol);
+				b2Assert(b2Abs(vn2 - cp2->velocityBias) < k_errorTol);
 #endif
-					break;
-				}
+				break;
+			}
 
-				//
-				// Case 2: vn1 = 0 and x2 = 0
-				//
-				//   0 = a11 * x1 + a12 * 0 + b1' 
-				// vn2 = a21 * x1 + a22 * 0 + b2'
-				//
-				x.x = - cp1->normalMass * b.x;
-				x.y = 0.0f;
-				vn1 = 0.0f;
-				vn2 = vc->K.ex.y * x.x + b.y;
-
-				if (x.x >= 0.0f && vn2 >= 0.0f)
-				{
-					// Get the incremental impulse
-					b2Vec2 d = x - a;
+			//
+			// Case 2: vn1 = 0 and x2 = 0
+			//
+			//   0 = a11 * x1 + a12 * 0 + b1' 
+			// vn2 = a21 * x1 + a22 * 0 + b2'
+			//
+			x.x = - cp1->normalMass * b.x;
+			x.y = 0.0f;
+			vn1 = 0.0f;
+			vn2 = vc->K.ex.y * x.x + b.y;
 
-					// Apply incremental impulse
-					b2Vec2 P1 = d.x * normal;
-					b2Vec2 P2 = d.y * normal;
-					vA -= mA * (P1 + P2);
-					wA -= iA * (b2Cross(cp1->rA, P1) + b2Cross(cp2->rA, P2));
+			if (x.x >= 0.0f && vn2 >= 0.0f)
+			{
+				// Get the incremental impulse
+				b2Vec2 d = x - a;
 
-					vB += mB * (P1 + P2);
-					wB += iB * (b2Cross(cp1->rB, P1) + b2Cross(cp2->rB, P2));
+				// Apply incremental impulse
+				b2Vec2 P1 = d.x * normal;
+				b2Vec2 P2 = d.y * normal;
+				vA -= mA * (P1 + P2);
+				wA -= iA * (b2Cross(cp1->rA, P1) + b2Cross(cp2->rA, P2));
 
-					// Accumulate
-					cp1->normalImpulse = x.x;
-					cp2->normalImpulse = x.y;
+				vB += mB * (P1 + P2);
+				wB += iB * (b2Cross(cp1->rB, P1) + b2Cross(cp2->rB, P2));
+
+				// Accumulate
+				cp1->normalImpulse = x.x;
+				cp2->normalImpulse = x.y;
 
 #if B2_DEBUG_SOLVER == 1
-					// Postconditions
-					dv1 = vB + b2Cross(wB, cp1->rB) - vA - b2Cross(wA, cp1->rA);
+				// Postconditions
+				dv1 = vB + b2Cross(wB, cp1->rB) - vA - b2Cross(wA, cp1->rA);
 
-					// Compute normal velocity
-					vn1 = b2Dot(dv1, normal);
+				// Compute normal velocity
+				vn1 = b2Dot(dv1, normal);
 
-					b2Assert(b2Abs(vn1 - cp1->velocityBias) < k_errorTol);
+				b2Assert(b2Abs(vn1 - cp1->velocityBias) < k_errorTol);
 #endif
-					break;
-				}
+				break;
+			}
 
 
-				//
-				// Case 3: vn2 = 0 and x1 = 0
-				//
-				// vn1 = a11 * 0 + a12 * x2 + b1' 
-				//   0 = a21 * 0 + a22 * x2 + b2'
-				//
-				x.x = 0.0f;
-				x.y = - cp2->normalMass * b.y;
-				vn1 = vc->K.ey.x * x.y + b.x;
-				vn2 = 0.0f;
+			//
+			// Case 3: vn2 = 0 and x1 = 0
+			//
+			// vn1 = a11 * 0 + a12 * x2 + b1' 
+			//   0 = a21 * 0 + a22 * x2 + b2'
+			//
+			x.x = 0.0f;
+			x.y = - cp2->normalMass * b.y;
+			vn1 = vc->K.ey.x * x.y + b.x;
+			vn2 = 0.0f;
 
-				if (x.y >= 0.0f && vn1 >= 0.0f)
-				{
-					// Resubstitute for the incremental impulse
-					b2Vec2 d = x - a;
+			if (x.y >= 0.0f && vn1 >= 0.0f)
+			{
+				// Resubstitute for the incremental impulse
+				b2Vec2 d = x - a;
 
-					// Apply incremental impulse
-					b2Vec2 P1 = d.x * normal;
-					b2Vec2 P2 = d.y * normal;
-					vA -= mA * (P1 + P2);
-					wA -= iA * (b2Cross(cp1->rA, P1) + b2Cross(cp2->rA, P2));
+				// Apply incremental impulse
+				b2Vec2 P1 = d.x * normal;
+				b2Vec2 P2 = d.y * normal;
+				vA -= mA * (P1 + P2);
+				wA -= iA * (b2Cross(cp1->rA, P1) + b2Cross(cp2->rA, P2));
 
-					vB += mB * (P1 + P2);
-					wB += iB * (b2Cross(cp1->rB, P1) + b2Cross(cp2->rB, P2));
+				vB += mB * (P1 + P2);
+				wB += iB * (b2Cross(cp1->rB, P1) + b2Cross(cp2->rB, P2));
 
-					// Accumulate
-					cp1->normalImpulse = x.x;
-					cp2->normalImpulse = x.y;
+				// Accumulate
+				cp1->normalImpulse = x.x;
+				cp2->normalImpulse = x.y;
 
 #if B2_DEBUG_SOLVER == 1
-					// Postconditions
-					dv2 = vB + b2Cross(wB, cp2->rB) - vA - b2Cross(wA, cp2->rA);
+				// Postconditions
+				dv2 = vB + b2Cross(wB, cp2->rB) - vA - b2Cross(wA, cp2->rA);
 
-					// Compute normal velocity
-					vn2 = b2Dot(dv2, normal);
+				// Compute normal velocity
+				vn2 = b2Dot(dv2, normal);
 
-					b2Assert(b2Abs(vn2 - cp2->velocityBias) < k_errorTol);
+				b2Assert(b2Abs(vn2 - cp2->velocityBias) < k_errorTol);
 #endif
-					break;
-				}
-
-				//
-				// Case 4: x1 = 0 and x2 = 0
-				// 
-				// vn1 = b1
-				// vn2 = b2;
-				x.x = 0.0f;
-				x.y = 0.0f;
-				vn1 = b.x;
-				vn2 = b.y;
-
-				if (vn1 >= 0.0f && vn2 >= 0.0f )
-				{
-					// Resubstitute for the incremental impulse
-					b2Vec2 d = x - a;
+				break;
+			}
 
-					// Apply incremental impulse
-					b2Vec2 P1 = d.x * normal;
-					b2Vec2 P2 = d.y * normal;
-					vA -= mA * (P1 + P2);
-					wA -= iA * (b2Cross(cp1->rA, P1) + b2Cross(cp2->rA, P2));
+			//
+			// Case 4: x1 = 0 and x2 = 0
+			// 
+			// vn1 = b1
+			// vn2 = b2;
+			x.x = 0.0f;
+			x.y = 0.0f;
+			vn1 = b.x;
+			vn2 = b.y;
+
+			if (vn1 >= 0.0f && vn2 >= 0.0f )
+			{
+				// Resubstitute for the incremental impulse
+				b2Vec2 d = x - a;
 
-					vB += mB * (P1 + P2);
-					wB += iB * (b2Cross(cp1->rB, P1) + b2Cross(cp2->rB, P2));
+				// Apply incremental impulse
+				b2Vec2 P1 = d.x * normal;
+				b2Vec2 P2 = d.y * normal;
+				vA -= mA * (P1 + P2);
+				wA -= iA * (b2Cross(cp1->rA, P1) + b2Cross(cp2->rA, P2));
 
-					// Accumulate
-					cp1->normalImpulse = x.x;
-					cp2->normalImpulse = x.y;
+				vB += mB * (P1 + P2);
+				wB += iB * (b2Cross(cp1->rB, P1) + b2Cross(cp2->rB, P2));
 
-					break;
-				}
+				// Accumulate
+				cp1->normalImpulse = x.x;
+				cp2->normalImpulse = x.y;
 
-				// No solution, give up. This is hit sometimes, but it doesn't seem to matter.
 				break;
 			}
-		}
 
-		m_velocities[indexA].v = vA;
-		m_velocities[indexA].w = wA;
-		m_velocities[indexB].v = vB;
-		m_velocities[indexB].w = wB;
+			// No solution, give up. This is hit sometimes, but it doesn't seem to matter.
+			break;
+		}
 	}
+
+	m_velocities[indexA].v = vA;
+	m_velocities[indexA].w = wA;
+	m_velocities[indexB].v = vB;
+	m_velocities[indexB].w = wB;
 }
 
 void b2ContactSolver::StoreImpulses()
 {
+	// The batches keep their own copy of the impulses.
+	for (int32 i = 0; i < m_wideCount; ++i)
+	{
+		const b2WideVelocityConstraint* wc = m_wideVelocityConstraints + i;
+
+		float32 normalImpulse1[b2_simdWidth], normalImpulse2[b2_simdWidth];
+		float32 tangentImpulse1[b2_simdWidth], tangentImpulse2[b2_simdWidth];
+		b2StoreW(normalImpulse1, wc->normalImpulse1);
+		b2StoreW(normalImpulse2, wc->normalImpulse2);
+		b2StoreW(tangentImpulse1, wc->tangentImpulse1);
+		b2StoreW(tangentImpulse2, wc->tangentImpulse2);
+
+		for (int32 lane = 0; lane < b2_simdWidth; ++lane)
+		{
+			b2ContactVelocityConstraint* vc = m_velocityConstraints + wc->constraint[lane];
+			vc->points[0].normalImpulse = normalImpulse1[lane];
+			vc->points[0].tangentImpulse = tangentImpulse1[lane];
+
+			if (vc->pointCount == 2)
+			{
+				vc->points[1].normalImpulse = normalImpulse2[lane];
+				vc->points[1].tangentImpulse = tangentImpulse2[lane];
+			}
+		}
+	}
+
 	for (int32 i = 0; i < m_count; ++i)
 	{
 		b2ContactVelocityConstraint* vc = m_velocityConstraints + i;
@@ -672,78 +778,101 @@ bool b2ContactSolver::SolvePositionConstraints()
 {
 	float32 minSeparation = 0.0f;
 
-	for (int32 i = 0; i < m_count; ++i)
+	if (m_wideCount > 0 || m_scalarIndices != nullptr)
 	{
-		b2ContactPositionConstraint* pc = m_positionConstraints + i;
+		for (int32 i = 0; i < m_wideCount; ++i)
+		{
+			minSeparation = b2Min(minSeparation, SolvePositionConstraintsWide(m_widePositionConstraints + i));
+		}
 
-		int32 indexA = pc->indexA;
-		int32 indexB = pc->indexB;
-		b2Vec2 localCenterA = pc->localCenterA;
-		float32 mA = pc->invMassA;
-		float32 iA = pc->invIA;
-		b2Vec2 localCenterB = pc->localCenterB;
-		float32 mB = pc->invMassB;
-		float32 iB = pc->invIB;
-		int32 pointCount = pc->pointCount;
+		for (int32 i = 0; i < m_scalarCount; ++i)
+		{
+			minSeparation = b2Min(minSeparation, SolvePositionConstraint(m_positionConstraints + m_scalarIndices[i]));
+		}
+	}
+	else
+	{
+		for (int32 i = 0; i < m_count; ++i)
+		{
+			minSeparation = b2Min(minSeparation, SolvePositionConstraint(m_positionConstraints + i));
+		}
+	}
 
-		b2Vec2 cA = m_positions[indexA].c;
-		float32 aA = m_positions[indexA].a;
+	// We can't expect minSpeparation >= -b2_linearSlop because we don't
+	// push the separation above -b2_linearSlop.
+	return minSeparation >= -3.0f * b2_linearSlop;
+}
 
-		b2Vec2 cB = m_positions[indexB].c;
-		float32 aB = m_positions[indexB].a;
+// Solve a single position constraint, returns the smallest separation found.
+float32 b2ContactSolver::SolvePositionConstraint(b2ContactPositionConstraint* pc)
+{
+	float32 minSeparation = 0.0f;
 
-		// Solve normal constraints
-		for (int32 j = 0; j < pointCount; ++j)
-		{
-			b2Transform xfA, xfB;
-			xfA.q.Set(aA);
-			xfB.q.Set(aB);
-			xfA.p = cA - b2Mul(xfA.q, localCenterA);
-			xfB.p = cB - b2Mul(xfB.q, localCenterB);
+	int32 indexA = pc->indexA;
+	int32 indexB = pc->indexB;
+	b2Vec2 localCenterA = pc->localCenterA;
+	float32 mA = pc->invMassA;
+	float32 iA = pc->invIA;
+	b2Vec2 localCenterB = pc->localCenterB;
+	float32 mB = pc->invMassB;
+	float32 iB = pc->invIB;
+	int32 pointCount = pc->pointCount;
 
-			b2PositionSolverManifold psm;
-			psm.Initialize(pc, xfA, xfB, j);
-			b2Vec2 normal = psm.normal;
+	b2Vec2 cA = m_positions[indexA].c;
+	float32 aA = m_positions[indexA].a;
 
-			b2Vec2 point = psm.point;
-			float32 separation = psm.separation;
+	b2Vec2 cB = m_positions[indexB].c;
+	float32 aB = m_positions[indexB].a;
 
-			b2Vec2 rA = point - cA;
-			b2Vec2 rB = point - cB;
+	// Solve normal constraints
+	for (int32 j = 0; j < pointCount; ++j)
+	{
+		b2Transform xfA, xfB;
+		xfA.q.Set(aA);
+		xfB.q.Set(aB);
+		xfA.p = cA - b2Mul(xfA.q, localCenterA);
+		xfB.p = cB - b2Mul(xfB.q, localCenterB);
 
-			// Track max constraint error.
-			minSeparation = b2Min(minSeparation, separation);
+		b2PositionSolverManifold psm;
+		psm.Initialize(pc, xfA, xfB, j);
+		b2Vec2 normal = psm.normal;
 
-			// Prevent large corrections and allow slop.
-			float32 C = b2Clamp(b2_baumgarte * (separation + b2_linearSlop), -b2_maxLinearCorrection, 0.0f);
+		b2Vec2 point = psm.point;
+		float32 separation = psm.separation;
 
-			// Compute the effective mass.
-			float32 rnA = b2Cross(rA, normal);
-			float32 rnB = b2Cross(rB, normal);
-			float32 K = mA + mB + iA * rnA * rnA + iB * rnB * rnB;
+		b2Vec2 rA = point - cA;
+		b2Vec2 rB = point - cB;
 
-			// Compute normal impulse
-			float32 impulse = K > 0.0f ? - C / K : 0.0f;
+		// Track max constraint error.
+		minSeparation = b2Min(minSeparation, separation);
 
-			b2Vec2 P = impulse * normal;
+		// Prevent large corrections and allow slop.
+		float32 C = b2Clamp(b2_baumgarte * (separation + b2_linearSlop), -b2_maxLinearCorrection, 0.0f);
 
-			cA -= mA * P;
-			aA -= iA * b2Cross(rA, P);
+		// Compute the effective mass.
+		float32 rnA = b2Cross(rA, normal);
+		float32 rnB = b2Cross(rB, normal);
+		float32 K = mA + mB + iA * rnA * rnA + iB * rnB * rnB;
 
-			cB += mB * P;
-			aB += iB * b2Cross(rB, P);
-		}
+		// Compute normal impulse
+		float32 impulse = K > 0.0f ? - C / K : 0.0f;
 
-		m_positions[indexA].c = cA;
-		m_positions[indexA].a = aA;
+		b2Vec2 P = impulse * normal;
 
-		m_positions[indexB].c = cB;
-		m_positions[indexB].a = aB;
+		cA -= mA * P;
+		aA -= iA * b2Cross(rA, P);
+
+		cB += mB * P;
+		aB += iB * b2Cross(rB, P);
 	}
 
-	// We can't expect minSpeparation >= -b2_linearSlop because we don't
-	// push the separation above -b2_linearSlop.
-	return minSeparation >= -3.0f * b2_linearSlop;
+	m_positions[indexA].c = cA;
+	m_positions[indexA].a = aA;
+
+	m_positions[indexB].c = cB;
+	m_positions[indexB].a = aB;
+
+	return minSeparation;
 }
 
 // Sequential position solver for position constraints.
@@ -836,3 +965,616 @@ bool b2ContactSolver::SolveTOIPositionConstraints(int32 toiIndexA, int32 toiInde
 	// push the separation above -b2_linearSlop.
 	return minSeparation >= -1.5f * b2_linearSlop;
 }
+
+#define b2_wideLanes(lanes, member) b2SetW(lanes[0].member, lanes[1].member, lanes[2].member, lanes[3].member)
+
+// Lane mask from one flag per lane.
+static inline b2FloatW b2LaneMaskW(bool a, bool b, bool c, bool d)
+{
+	return b2GreaterW(b2SetW(a ? 1.0f : 0.0f, b ? 1.0f : 0.0f, c ? 1.0f : 0.0f, d ? 1.0f : 0.0f), b2ZeroW());
+}
+
+// Velocity of point r on body B relative to body A, vB + wB x rB - vA - wA x rA.
+static inline b2Vec2W b2RelativeVelocityW(const b2Vec2W& vA, b2FloatW wA, const b2Vec2W& rA,
+										  const b2Vec2W& vB, b2FloatW wB, const b2Vec2W& rB)
+{
+	b2Vec2W dv;
+	dv.x = b2AddW(b2SubW(b2SubW(vB.x, b2MulW(wB, rB.y)), vA.x), b2MulW(wA, rA.y));
+	dv.y = b2SubW(b2SubW(b2AddW(vB.y, b2MulW(wB, rB.x)), vA.y), b2MulW(wA, rA.x));
+	return dv;
+}
+
+static inline void b2ApplyImpulseW(b2Vec2W& vA, b2FloatW& wA, b2Vec2W& vB, b2FloatW& wB,
+								   const b2WideVelocityConstraint* wc, const b2Vec2W& rA, const b2Vec2W& rB, const b2Vec2W& P)
+{
+	vA.x = b2MulSubW(vA.x, wc->invMassA, P.x);
+	vA.y = b2MulSubW(vA.y, wc->invMassA, P.y);
+	wA = b2MulSubW(wA, wc->invIA, b2CrossW(rA, P));
+
+	vB.x = b2MulAddW(vB.x, wc->invMassB, P.x);
+	vB.y = b2MulAddW(vB.y, wc->invMassB, P.y);
+	wB = b2MulAddW(wB, wc->invIB, b2CrossW(rB, P));
+}
+
+void b2ContactSolver::PrepareWideConstraints()
+{
+	if (m_count < 2 * b2_simdWidth)
+	{
+		return;
+	}
+
+	int32 bodyCount = 0;
+	for (int32 i = 0; i < m_count; ++i)
+	{
+		const b2ContactVelocityConstraint* vc = m_velocityConstraints + i;
+		bodyCount = b2Max(bodyCount, b2Max(vc->indexA, vc->indexB) + 1);
+	}
+
+	// Upper bound, every batch is full. The wide types need 16 byte alignment which the
+	// stack allocator doesn't guarantee.
+	const int32 maxBatchCount = m_count / b2_simdWidth;
+	const int32 velocitySize = maxBatchCount * sizeof(b2WideVelocityConstraint);
+	const int32 positionSize = maxBatchCount * sizeof(b2WidePositionConstraint);
+	const uintptr_t alignment = 16;
+
+	m_scalarIndices = (int32*)m_allocator->Allocate(m_count * sizeof(int32));
+	m_wideMemory = m_allocator->Allocate(velocitySize + positionSize + (int32)alignment);
+
+	uintptr_t aligned = ((uintptr_t)m_wideMemory + alignment - 1) & ~(alignment - 1);
+	m_wideVelocityConstraints = (b2WideVelocityConstraint*)aligned;
+	m_widePositionConstraints = (b2WidePositionConstraint*)(aligned + velocitySize);
+
+	// Greedy coloring, a constraint gets the first color none of its movable bodies has
+	// been given yet. Static and kinematic bodies are only read so they may appear in
+	// any number of lanes.
+	const int32 k_colorCount = 32;
+	uint32* bodyColors = (uint32*)m_allocator->Allocate(bodyCount * sizeof(uint32));
+	int32* colors = (int32*)m_allocator->Allocate(m_count * sizeof(int32));
+	int32* order = (int32*)m_allocator->Allocate(m_count * sizeof(int32));
+	int32 colorStarts[k_colorCount + 2] = { 0 };
+
+	for (int32 i = 0; i < bodyCount; ++i)
+	{
+		bodyColors[i] = 0;
+	}
+
+	for (int32 i = 0; i < m_count; ++i)
+	{
+		const b2ContactVelocityConstraint* vc = m_velocityConstraints + i;
+		bool movableA = vc->invMassA > 0.0f || vc->invIA > 0.0f;
+		bool movableB = vc->invMassB > 0.0f || vc->invIB > 0.0f;
+
+		uint32 used = (movableA ? bodyColors[vc->indexA] : 0) | (movableB ? bodyColors[vc->indexB] : 0);
+
+		int32 color = k_colorCount;
+		for (int32 c = 0; c < k_colorCount; ++c)
+		{
+			if ((used & (1u << c)) == 0)
+			{
+				color = c;
+				break;
+			}
+		}
+
+		if (color < k_colorCount)
+		{
+			if (movableA)
+			{
+				bodyColors[vc->indexA] |= 1u << color;
+			}
+
+			if (movableB)
+			{
+				bodyColors[vc->indexB] |= 1u << color;
+			}
+		}
+
+		colors[i] = color;
+		++colorStarts[color + 1];
+	}
+
+	for (int32 c = 0; c <= k_colorCount; ++c)
+	{
+		colorStarts[c + 1] += colorStarts[c];
+	}
+
+	{
+		int32 next[k_colorCount + 1];
+		for (int32 c = 0; c <= k_colorCount; ++c)
+		{
+			next[c] = colorStarts[c];
+		}
+
+		for (int32 i = 0; i < m_count; ++i)
+		{
+			order[next[colors[i]]++] = i;
+		}
+	}
+
+	m_wideCount = 0;
+	m_scalarCount = 0;
+
+	for (int32 c = 0; c <= k_colorCount; ++c)
+	{
+		int32 start = colorStarts[c];
+		int32 count = colorStarts[c + 1] - start;
+		int32 wideEnd = c < k_colorCount ? start + count - count % b2_simdWidth : start;
+
+		for (int32 i = start; i < wideEnd; i += b2_simdWidth)
+		{
+			b2WideVelocityConstraint* wc = m_wideVelocityConstraints + m_wideCount;
+			b2WidePositionConstraint* wp = m_widePositionConstraints + m_wideCount;
+			++m_wideCount;
+
+			// Copies with the unused second point cleared.
+			b2ContactVelocityConstraint vcs[b2_simdWidth];
+			b2ContactPositionConstraint pcs[b2_simdWidth];
+			bool blockSolve[b2_simdWidth];
+			bool faceB[b2_simdWidth];
+			bool circles[b2_simdWidth];
+			bool twoPoints[b2_simdWidth];
+
+			for (int32 lane = 0; lane < b2_simdWidth; ++lane)
+			{
+				int32 index = order[i + lane];
+				vcs[lane] = m_velocityConstraints[index];
+				pcs[lane] = m_positionConstraints[index];
+
+				wc->indexA[lane] = vcs[lane].indexA;
+				wc->indexB[lane] = vcs[lane].indexB;
+				wc->constraint[lane] = index;
+				wp->indexA[lane] = pcs[lane].indexA;
+				wp->indexB[lane] = pcs[lane].indexB;
+
+				if (vcs[lane].pointCount < 2)
+				{
+					b2VelocityConstraintPoint* vcp = vcs[lane].points + 1;
+					vcp->rA.SetZero();
+					vcp->rB.SetZero();
+					vcp->normalImpulse = 0.0f;
+					vcp->tangentImpulse = 0.0f;
+					vcp->normalMass = 0.0f;
+					vcp->tangentMass = 0.0f;
+					vcp->velocityBias = 0.0f;
+				}
+
+				if (pcs[lane].pointCount < 2)
+				{
+					pcs[lane].localPoints[1].SetZero();
+				}
+
+				blockSolve[lane] = vcs[lane].pointCount == 2 && g_blockSolve;
+				if (blockSolve[lane] == false)
+				{
+					vcs[lane].K.SetZero();
+					vcs[lane].normalMass.SetZero();
+				}
+
+				faceB[lane] = pcs[lane].type == b2Manifold::e_faceB;
+				circles[lane] = pcs[lane].type == b2Manifold::e_circles;
+				twoPoints[lane] = pcs[lane].pointCount == 2;
+			}
+
+			wc->normal.x = b2_wideLanes(vcs, normal.x);
+			wc->normal.y = b2_wideLanes(vcs, normal.y);
+			wc->invMassA = b2_wideLanes(vcs, invMassA);
+			wc->invMassB = b2_wideLanes(vcs, invMassB);
+			wc->invIA = b2_wideLanes(vcs, invIA);
+			wc->invIB = b2_wideLanes(vcs, invIB);
+			wc->friction = b2_wideLanes(vcs, friction);
+			wc->tangentSpeed = b2_wideLanes(vcs, tangentSpeed);
+			wc->rA1.x = b2_wideLanes(vcs, points[0].rA.x);
+			wc->rA1.y = b2_wideLanes(vcs, points[0].rA.y);
+			wc->rB1.x = b2_wideLanes(vcs, points[0].rB.x);
+			wc->rB1.y = b2_wideLanes(vcs, points[0].rB.y);
+			wc->rA2.x = b2_wideLanes(vcs, points[1].rA.x);
+			wc->rA2.y = b2_wideLanes(vcs, points[1].rA.y);
+			wc->rB2.x = b2_wideLanes(vcs, points[1].rB.x);
+			wc->rB2.y = b2_wideLanes(vcs, points[1].rB.y);
+			wc->normalMass1 = b2_wideLanes(vcs, points[0].normalMass);
+			wc->normalMass2 = b2_wideLanes(vcs, points[1].normalMass);
+			wc->tangentMass1 = b2_wideLanes(vcs, points[0].tangentMass);
+			wc->tangentMass2 = b2_wideLanes(vcs, points[1].tangentMass);
+			wc->velocityBias1 = b2_wideLanes(vcs, points[0].velocityBias);
+			wc->velocityBias2 = b2_wideLanes(vcs, points[1].velocityBias);
+			wc->normalImpulse1 = b2_wideLanes(vcs, points[0].normalImpulse);
+			wc->normalImpulse2 = b2_wideLanes(vcs, points[1].normalImpulse);
+			wc->tangentImpulse1 = b2_wideLanes(vcs, points[0].tangentImpulse);
+			wc->tangentImpulse2 = b2_wideLanes(vcs, points[1].tangentImpulse);
+			wc->K11 = b2_wideLanes(vcs, K.ex.x);
+			wc->K12 = b2_wideLanes(vcs, K.ey.x);
+			wc->K22 = b2_wideLanes(vcs, K.ey.y);
+			wc->normalMass11 = b2_wideLanes(vcs, normalMass.ex.x);
+			wc->normalMass12 = b2_wideLanes(vcs, normalMass.ey.x);
+			wc->normalMass22 = b2_wideLanes(vcs, normalMass.ey.y);
+			wc->blockSolve = b2LaneMaskW(blockSolve[0], blockSolve[1], blockSolve[2], blockSolve[3]);
+
+			wp->localPoint1.x = b2_wideLanes(pcs, localPoints[0].x);
+			wp->localPoint1.y = b2_wideLanes(pcs, localPoints[0].y);
+			wp->localPoint2.x = b2_wideLanes(pcs, localPoints[1].x);
+			wp->localPoint2.y = b2_wideLanes(pcs, localPoints[1].y);
+			wp->localNormal.x = b2_wideLanes(pcs, localNormal.x);
+			wp->localNormal.y = b2_wideLanes(pcs, localNormal.y);
+			wp->localPoint.x = b2_wideLanes(pcs, localPoint.x);
+			wp->localPoint.y = b2_wideLanes(pcs, localPoint.y);
+			wp->localCenterA.x = b2_wideLanes(pcs, localCenterA.x);
+			wp->localCenterA.y = b2_wideLanes(pcs, localCenterA.y);
+			wp->localCenterB.x = b2_wideLanes(pcs, localCenterB.x);
+			wp->localCenterB.y = b2_wideLanes(pcs, localCenterB.y);
+			wp->invMassA = b2_wideLanes(pcs, invMassA);
+			wp->invMassB = b2_wideLanes(pcs, invMassB);
+			wp->invIA = b2_wideLanes(pcs, invIA);
+			wp->invIB = b2_wideLanes(pcs, invIB);
+			wp->radiusA = b2_wideLanes(pcs, radiusA);
+			wp->radiusB = b2_wideLanes(pcs, radiusB);
+			wp->faceB = b2LaneMaskW(faceB[0], faceB[1], faceB[2], faceB[3]);
+			wp->circles = b2LaneMaskW(circles[0], circles[1], circles[2], circles[3]);
+			wp->twoPoints = b2LaneMaskW(twoPoints[0], twoPoints[1], twoPoints[2], twoPoints[3]);
+		}
+
+		for (int32 i = wideEnd; i < start + count; ++i)
+		{
+			m_scalarIndices[m_scalarCount++] = order[i];
+		}
+	}
+
+	m_allocator->Free(order);
+	m_allocator->Free(colors);
+	m_allocator->Free(bodyColors);
+
+	if (m_wideCount == 0)
+	{
+		// Nothing to batch, keep the sequential solver.
+		m_allocator->Free(m_wideMemory);
+		m_allocator->Free(m_scalarIndices);
+		m_wideMemory = nullptr;
+		m_wideVelocityConstraints = nullptr;
+		m_widePositionConstraints = nullptr;
+		m_scalarIndices = nullptr;
+		m_scalarCount = 0;
+		return;
+	}
+
+	// Keep the leftovers in their original order.
+	std::sort(m_scalarIndices, m_scalarIndices + m_scalarCount);
+}
+
+void b2ContactSolver::SolveVelocityConstraintsWide(b2WideVelocityConstraint* wc)
+{
+	float32 vAx[b2_simdWidth], vAy[b2_simdWidth], wAs[b2_simdWidth];
+	float32 vBx[b2_simdWidth], vBy[b2_simdWidth], wBs[b2_simdWidth];
+
+	for (int32 lane = 0; lane < b2_simdWidth; ++lane)
+	{
+		const b2Velocity& velocityA = m_velocities[wc->indexA[lane]];
+		const b2Velocity& velocityB = m_velocities[wc->indexB[lane]];
+		vAx[lane] = velocityA.v.x;
+		vAy[lane] = velocityA.v.y;
+		wAs[lane] = velocityA.w;
+		vBx[lane] = velocityB.v.x;
+		vBy[lane] = velocityB.v.y;
+		wBs[lane] = velocityB.w;
+	}
+
+	b2Vec2W vA = { b2LoadW(vAx), b2LoadW(vAy) };
+	b2FloatW wA = b2LoadW(wAs);
+	b2Vec2W vB = { b2LoadW(vBx), b2LoadW(vBy) };
+	b2FloatW wB = b2LoadW(wBs);
+
+	const b2Vec2W& normal = wc->normal;
+	b2Vec2W tangent = { normal.y, b2SubW(b2ZeroW(), normal.x) };
+	const b2FloatW zero = b2ZeroW();
+
+	// Solve tangent constraints first because non-penetration is more important
+	// than friction.
+	{
+		b2Vec2W dv = b2RelativeVelocityW(vA, wA, wc->rA1, vB, wB, wc->rB1);
+		b2FloatW vt = b2SubW(b2DotW(dv, tangent), wc->tangentSpeed);
+		b2FloatW lambda = b2MulW(wc->tangentMass1, b2SubW(zero, vt));
+
+		b2FloatW maxFriction = b2MulW(wc->friction, wc->normalImpulse1);
+		b2FloatW newImpulse = b2ClampW(b2AddW(wc->tangentImpulse1, lambda), b2SubW(zero, maxFriction), maxFriction);
+		lambda = b2SubW(newImpulse, wc->tangentImpulse1);
+		wc->tangentImpulse1 = newImpulse;
+
+		b2Vec2W P = { b2MulW(lambda, tangent.x), b2MulW(lambda, tangent.y) };
+		b2ApplyImpulseW(vA, wA, vB, wB, wc, wc->rA1, wc->rB1, P);
+	}
+
+	{
+		b2Vec2W dv = b2RelativeVelocityW(vA, wA, wc->rA2, vB, wB, wc->rB2);
+		b2FloatW vt = b2SubW(b2DotW(dv, tangent), wc->tangentSpeed);
+		b2FloatW lambda = b2MulW(wc->tangentMass2, b2SubW(zero, vt));
+
+		b2FloatW maxFriction = b2MulW(wc->friction, wc->normalImpulse2);
+		b2FloatW newImpulse = b2ClampW(b2AddW(wc->tangentImpulse2, lambda), b2SubW(zero, maxFriction), maxFriction);
+		lambda = b2SubW(newImpulse, wc->tangentImpulse2);
+		wc->tangentImpulse2 = newImpulse;
+
+		b2Vec2W P = { b2MulW(lambda, tangent.x), b2MulW(lambda, tangent.y) };
+		b2ApplyImpulseW(vA, wA, vB, wB, wc, wc->rA2, wc->rB2, P);
+	}
+
+	// Both normal solvers run on every lane, blockSolve picks the result.
+	b2Vec2W sequentialVA = vA;
+	b2FloatW sequentialWA = wA;
+	b2Vec2W sequentialVB = vB;
+	b2FloatW sequentialWB = wB;
+	b2FloatW sequentialImpulse1 = wc->normalImpulse1;
+	b2FloatW sequentialImpulse2 = wc->normalImpulse2;
+
+	{
+		b2Vec2W dv = b2RelativeVelocityW(sequentialVA, sequentialWA, wc->rA1, sequentialVB, sequentialWB, wc->rB1);
+		b2FloatW vn = b2DotW(dv, normal);
+		b2FloatW lambda = b2MulW(b2SubW(zero, wc->normalMass1), b2SubW(vn, wc->velocityBias1));
+
+		b2FloatW newImpulse = b2MaxW(b2AddW(sequentialImpulse1, lambda), zero);
+		lambda = b2SubW(newImpulse, sequentialImpulse1);
+		sequentialImpulse1 = newImpulse;
+
+		b2Vec2W P = { b2MulW(lambda, normal.x), b2MulW(lambda, normal.y) };
+		b2ApplyImpulseW(sequentialVA, sequentialWA, sequentialVB, sequentialWB, wc, wc->rA1, wc->rB1, P);
+	}
+
+	{
+		b2Vec2W dv = b2RelativeVelocityW(sequentialVA, sequentialWA, wc->rA2, sequentialVB, sequentialWB, wc->rB2);
+		b2FloatW vn = b2DotW(dv, normal);
+		b2FloatW lambda = b2MulW(b2SubW(zero, wc->normalMass2), b2SubW(vn, wc->velocityBias2));
+
+		b2FloatW newImpulse = b2MaxW(b2AddW(sequentialImpulse2, lambda), zero);
+		lambda = b2SubW(newImpulse, sequentialImpulse2);
+		sequentialImpulse2 = newImpulse;
+
+		b2Vec2W P = { b2MulW(lambda, normal.x), b2MulW(lambda, normal.y) };
+		b2ApplyImpulseW(sequentialVA, sequentialWA, sequentialVB, sequentialWB, wc, wc->rA2, wc->rB2, P);
+	}
+
+	// Block solver, see SolveVelocityConstraint for the derivation. All four cases are
+	// evaluated and the first valid one wins, lanes without a valid case keep their impulse.
+	{
+		b2FloatW a1 = wc->normalImpulse1;
+		b2FloatW a2 = wc->normalImpulse2;
+
+		b2Vec2W dv1 = b2RelativeVelocityW(vA, wA, wc->rA1, vB, wB, wc->rB1);
+		b2Vec2W dv2 = b2RelativeVelocityW(vA, wA, wc->rA2, vB, wB, wc->rB2);
+
+		b2FloatW vn1 = b2DotW(dv1, normal);
+		b2FloatW vn2 = b2DotW(dv2, normal);
+
+		// b' = b - K * a
+		b2FloatW bx = b2SubW(b2SubW(vn1, wc->velocityBias1), b2AddW(b2MulW(wc->K11, a1), b2MulW(wc->K12, a2)));
+		b2FloatW by = b2SubW(b2SubW(vn2, wc->velocityBias2), b2AddW(b2MulW(wc->K12, a1), b2MulW(wc->K22, a2)));
+
+		b2FloatW x1 = a1;
+		b2FloatW x2 = a2;
+
+		// Case 4: x1 = 0 and x2 = 0
+		b2FloatW valid = b2AndW(b2GreaterEqualW(bx, zero), b2GreaterEqualW(by, zero));
+		x1 = b2BlendW(x1, zero, valid);
+		x2 = b2BlendW(x2, zero, valid);
+
+		// Case 3: vn2 = 0 and x1 = 0
+		b2FloatW case3x2 = b2SubW(zero, b2MulW(wc->normalMass2, by));
+		b2FloatW case3vn1 = b2AddW(b2MulW(wc->K12, case3x2), bx);
+		valid = b2AndW(b2GreaterEqualW(case3x2, zero), b2GreaterEqualW(case3vn1, zero));
+		x1 = b2BlendW(x1, zero, valid);
+		x2 = b2BlendW(x2, case3x2, valid);
+
+		// Case 2: vn1 = 0 and x2 = 0
+		b2FloatW case2x1 = b2SubW(zero, b2MulW(wc->normalMass1, bx));
+		b2FloatW case2vn2 = b2AddW(b2MulW(wc->K12, case2x1), by);
+		valid = b2AndW(b2GreaterEqualW(case2x1, zero), b2GreaterEqualW(case2vn2, zero));
+		x1 = b2BlendW(x1, case2x1, valid);
+		x2 = b2BlendW(x2, zero, valid);
+
+		// Case 1: vn = 0, x = - inv(A) * b'
+		b2FloatW case1x1 = b2SubW(zero, b2AddW(b2MulW(wc->normalMass11, bx), b2MulW(wc->normalMass12, by)));
+		b2FloatW case1x2 = b2SubW(zero, b2AddW(b2MulW(wc->normalMass12, bx), b2MulW(wc->normalMass22, by)));
+		valid = b2AndW(b2GreaterEqualW(case1x1, zero), b2GreaterEqualW(case1x2, zero));
+		x1 = b2BlendW(x1, case1x1, valid);
+		x2 = b2BlendW(x2, case1x2, valid);
+
+		// Apply incremental impulse
+		b2FloatW d1 = b2SubW(x1, a1);
+		b2FloatW d2 = b2SubW(x2, a2);
+		b2Vec2W P1 = { b2MulW(d1, normal.x), b2MulW(d1, normal.y) };
+		b2Vec2W P2 = { b2MulW(d2, normal.x), b2MulW(d2, normal.y) };
+		b2Vec2W P = { b2AddW(P1.x, P2.x), b2AddW(P1.y, P2.y) };
+
+		vA.x = b2MulSubW(vA.x, wc->invMassA, P.x);
+		vA.y = b2MulSubW(vA.y, wc->invMassA, P.y);
+		wA = b2MulSubW(wA, wc->invIA, b2AddW(b2CrossW(wc->rA1, P1), b2CrossW(wc->rA2, P2)));
+
+		vB.x = b2MulAddW(vB.x, wc->invMassB, P.x);
+		vB.y = b2MulAddW(vB.y, wc->invMassB, P.y);
+		wB = b2MulAddW(wB, wc->invIB, b2AddW(b2CrossW(wc->rB1, P1), b2CrossW(wc->rB2, P2)));
+
+		wc->normalImpulse1 = b2BlendW(sequentialImpulse1, x1, wc->blockSolve);
+		wc->normalImpulse2 = b2BlendW(sequentialImpulse2, x2, wc->blockSolve);
+	}
+
+	vA.x = b2BlendW(sequentialVA.x, vA.x, wc->blockSolve);
+	vA.y = b2BlendW(sequentialVA.y, vA.y, wc->blockSolve);
+	wA = b2BlendW(sequentialWA, wA, wc->blockSolve);
+	vB.x = b2BlendW(sequentialVB.x, vB.x, wc->blockSolve);
+	vB.y = b2BlendW(sequentialVB.y, vB.y, wc->blockSolve);
+	wB = b2BlendW(sequentialWB, wB, wc->blockSolve);
+
+	b2StoreW(vAx, vA.x);
+	b2StoreW(vAy, vA.y);
+	b2StoreW(wAs, wA);
+	b2StoreW(vBx, vB.x);
+	b2StoreW(vBy, vB.y);
+	b2StoreW(wBs, wB);
+
+	// The lanes don't share a movable body. Static and kinematic bodies get their
+	// unchanged velocity written back.
+	for (int32 lane = 0; lane < b2_simdWidth; ++lane)
+	{
+		b2Velocity& velocityA = m_velocities[wc->indexA[lane]];
+		b2Velocity& velocityB = m_velocities[wc->indexB[lane]];
+		velocityA.v.Set(vAx[lane], vAy[lane]);
+		velocityA.w = wAs[lane];
+		velocityB.v.Set(vBx[lane], vBy[lane]);
+		velocityB.w = wBs[lane];
+	}
+}
+
+float32 b2ContactSolver::SolvePositionConstraintsWide(b2WidePositionConstraint* wp)
+{
+	float32 cAx[b2_simdWidth], cAy[b2_simdWidth], aAs[b2_simdWidth];
+	float32 cBx[b2_simdWidth], cBy[b2_simdWidth], aBs[b2_simdWidth];
+
+	for (int32 lane = 0; lane < b2_simdWidth; ++lane)
+	{
+		const b2Position& positionA = m_positions[wp->indexA[lane]];
+		const b2Position& positionB = m_positions[wp->indexB[lane]];
+		cAx[lane] = positionA.c.x;
+		cAy[lane] = positionA.c.y;
+		aAs[lane] = positionA.a;
+		cBx[lane] = positionB.c.x;
+		cBy[lane] = positionB.c.y;
+		aBs[lane] = positionB.a;
+	}
+
+	b2Vec2W cA = { b2LoadW(cAx), b2LoadW(cAy) };
+	b2FloatW aA = b2LoadW(aAs);
+	b2Vec2W cB = { b2LoadW(cBx), b2LoadW(cBy) };
+	b2FloatW aB = b2LoadW(aBs);
+
+	const b2FloatW zero = b2ZeroW();
+	b2FloatW minSeparation = zero;
+
+	for (int32 j = 0; j < b2_maxManifoldPoints; ++j)
+	{
+		// The angles change after every point, the rotations are computed per lane.
+		float32 sA[b2_simdWidth], cosA[b2_simdWidth], sB[b2_simdWidth], cosB[b2_simdWidth];
+		b2StoreW(aAs, aA);
+		b2StoreW(aBs, aB);
+		for (int32 lane = 0; lane < b2_simdWidth; ++lane)
+		{
+			b2Rot qA(aAs[lane]);
+			b2Rot qB(aBs[lane]);
+			sA[lane] = qA.s;
+			cosA[lane] = qA.c;
+			sB[lane] = qB.s;
+			cosB[lane] = qB.c;
+		}
+
+		b2FloatW qAs = b2LoadW(sA), qAc = b2LoadW(cosA);
+		b2FloatW qBs = b2LoadW(sB), qBc = b2LoadW(cosB);
+
+		// xf.p = c - q * localCenter
+		b2Vec2W pA = {
+			b2SubW(cA.x, b2SubW(b2MulW(qAc, wp->localCenterA.x), b2MulW(qAs, wp->localCenterA.y))),
+			b2SubW(cA.y, b2AddW(b2MulW(qAs, wp->localCenterA.x), b2MulW(qAc, wp->localCenterA.y)))
+		};
+		b2Vec2W pB = {
+			b2SubW(cB.x, b2SubW(b2MulW(qBc, wp->localCenterB.x), b2MulW(qBs, wp->localCenterB.y))),
+			b2SubW(cB.y, b2AddW(b2MulW(qBs, wp->localCenterB.x), b2MulW(qBc, wp->localCenterB.y)))
+		};
+
+		// The reference frame is A for faceA and circles, B for faceB.
+		b2FloatW refS = b2BlendW(qAs, qBs, wp->faceB), refC = b2BlendW(qAc, qBc, wp->faceB);
+		b2FloatW incS = b2BlendW(qBs, qAs, wp->faceB), incC = b2BlendW(qBc, qAc, wp->faceB);
+		b2Vec2W refP = { b2BlendW(pA.x, pB.x, wp->faceB), b2BlendW(pA.y, pB.y, wp->faceB) };
+		b2Vec2W incP = { b2BlendW(pB.x, pA.x, wp->faceB), b2BlendW(pB.y, pA.y, wp->faceB) };
+
+		const b2Vec2W& localClipPoint = j == 0 ? wp->localPoint1 : wp->localPoint2;
+
+		b2Vec2W planePoint = {
+			b2AddW(refP.x, b2SubW(b2MulW(refC, wp->localPoint.x), b2MulW(refS, wp->localPoint.y))),
+			b2AddW(refP.y, b2AddW(b2MulW(refS, wp->localPoint.x), b2MulW(refC, wp->localPoint.y)))
+		};
+		b2Vec2W clipPoint = {
+			b2AddW(incP.x, b2SubW(b2MulW(incC, localClipPoint.x), b2MulW(incS, localClipPoint.y))),
+			b2AddW(incP.y, b2AddW(b2MulW(incS, localClipPoint.x), b2MulW(incC, localClipPoint.y)))
+		};
+
+		b2Vec2W faceNormal = {
+			b2SubW(b2MulW(refC, wp->localNormal.x), b2MulW(refS, wp->localNormal.y)),
+			b2AddW(b2MulW(refS, wp->localNormal.x), b2MulW(refC, wp->localNormal.y))
+		};
+
+		// Circles use the normalized direction between the centers, b2Vec2::Normalize
+		// leaves tiny vectors as they are.
+		b2Vec2W d = { b2SubW(clipPoint.x, planePoint.x), b2SubW(clipPoint.y, planePoint.y) };
+		b2FloatW length = b2SqrtW(b2DotW(d, d));
+		b2FloatW normalizable = b2GreaterEqualW(length, b2SplatW(b2_epsilon));
+		b2FloatW invLength = b2BlendW(b2SplatW(1.0f), b2DivW(b2SplatW(1.0f), b2BlendW(b2SplatW(1.0f), length, normalizable)), normalizable);
+		b2Vec2W circleNormal = { b2MulW(d.x, invLength), b2MulW(d.y, invLength) };
+
+		b2Vec2W normal = {
+			b2BlendW(faceNormal.x, circleNormal.x, wp->circles),
+			b2BlendW(faceNormal.y, circleNormal.y, wp->circles)
+		};
+
+		b2FloatW separation = b2SubW(b2SubW(b2DotW(d, normal), wp->radiusA), wp->radiusB);
+
+		b2Vec2W point = {
+			b2BlendW(clipPoint.x, b2MulW(b2SplatW(0.5f), b2AddW(planePoint.x, clipPoint.x)), wp->circles),
+			b2BlendW(clipPoint.y, b2MulW(b2SplatW(0.5f), b2AddW(planePoint.y, clipPoint.y)), wp->circles)
+		};
+
+		// Ensure normal points from A to B
+		normal.x = b2BlendW(normal.x, b2SubW(zero, normal.x), wp->faceB);
+		normal.y = b2BlendW(normal.y, b2SubW(zero, normal.y), wp->faceB);
+
+		b2FloatW active = j == 0 ? b2GreaterEqualW(zero, zero) : wp->twoPoints;
+
+		b2Vec2W rA = { b2SubW(point.x, cA.x), b2SubW(point.y, cA.y) };
+		b2Vec2W rB = { b2SubW(point.x, cB.x), b2SubW(point.y, cB.y) };
+
+		// Track max constraint error.
+		minSeparation = b2BlendW(minSeparation, b2MinW(minSeparation, separation), active);
+
+		// Prevent large corrections and allow slop.
+		b2FloatW C = b2ClampW(b2MulW(b2SplatW(b2_baumgarte), b2AddW(separation, b2SplatW(b2_linearSlop))),
+							  b2SplatW(-b2_maxLinearCorrection), zero);
+
+		// Compute the effective mass.
+		b2FloatW rnA = b2CrossW(rA, normal);
+		b2FloatW rnB = b2CrossW(rB, normal);
+		b2FloatW K = b2AddW(b2AddW(wp->invMassA, wp->invMassB),
+							b2AddW(b2MulW(wp->invIA, b2MulW(rnA, rnA)), b2MulW(wp->invIB, b2MulW(rnB, rnB))));
+
+		// Compute normal impulse, inactive lanes don't move
+		b2FloatW solvable = b2AndW(b2GreaterW(K, zero), active);
+		b2FloatW impulse = b2BlendW(zero, b2SubW(zero, b2DivW(C, b2BlendW(b2SplatW(1.0f), K, solvable))), solvable);
+
+		b2Vec2W P = { b2MulW(impulse, normal.x), b2MulW(impulse, normal.y) };
+
+		cA.x = b2MulSubW(cA.x, wp->invMassA, P.x);
+		cA.y = b2MulSubW(cA.y, wp->invMassA, P.y);
+		aA = b2MulSubW(aA, wp->invIA, b2CrossW(rA, P));
+
+		cB.x = b2MulAddW(cB.x, wp->invMassB, P.x);
+		cB.y = b2MulAddW(cB.y, wp->invMassB, P.y);
+		aB = b2MulAddW(aB, wp->invIB, b2CrossW(rB, P));
+	}
+
+	b2StoreW(cAx, cA.x);
+	b2StoreW(cAy, cA.y);
+	b2StoreW(aAs, aA);
+	b2StoreW(cBx, cB.x);
+	b2StoreW(cBy, cB.y);
+	b2StoreW(aBs, aB);
+
+	float32 separations[b2_simdWidth];
+	b2StoreW(separations, minSeparation);
+
+	float32 result = 0.0f;
+	for (int32 lane = 0; lane < b2_simdWidth; ++lane)
+	{
+		b2Position& positionA = m_positions[wp->indexA[lane]];
+		b2Position& positionB = m_positions[wp->indexB[lane]];
+		positionA.c.Set(cAx[lane], cAy[lane]);
+		positionA.a = aAs[lane];
+		positionB.c.Set(cBx[lane], cBy[lane]);
+		positionB.a = aBs[lane];
+
+		result = b2Min(result, separations[lane]);
+	}
+
+	return result;
+}
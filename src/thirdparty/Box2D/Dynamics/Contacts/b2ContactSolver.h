@@ -27,6 +27,8 @@ class b2Contact;
 class b2Body;
 class b2StackAllocator;
 struct b2ContactPositionConstraint;
+struct b2WideVelocityConstraint;
+struct b2WidePositionConstraint;
 
 struct b2VelocityConstraintPoint
 {
@@ -81,6 +83,15 @@ public:
 	bool SolvePositionConstraints();
 	bool SolveTOIPositionConstraints(int32 toiIndexA, int32 toiIndexB);
 
+	void SolveVelocityConstraint(b2ContactVelocityConstraint* vc);
+	float32 SolvePositionConstraint(b2ContactPositionConstraint* pc);
+
+	/// Group the constraints into batches of b2_simdWidth constraints that don't share a
+	/// movable body. Constraints that don't fill a batch are solved one by one afterwards.
+	void PrepareWideConstraints();
+	void SolveVelocityConstraintsWide(b2WideVelocityConstraint* wc);
+	float32 SolvePositionConstraintsWide(b2WidePositionConstraint* wc);
+
 	b2TimeStep m_step;
 	b2Position* m_positions;
 	b2Velocity* m_velocities;
@@ -89,6 +100,13 @@ public:
 	b2ContactVelocityConstraint* m_velocityConstraints;
 	b2Contact** m_contacts;
 	int m_count;
+
+	void* m_wideMemory;
+	b2WideVelocityConstraint* m_wideVelocityConstraints;
+	b2WidePositionConstraint* m_widePositionConstraints;
+	int32 m_wideCount;
+	int32* m_scalarIndices;
+	int32 m_scalarCount;
 };
 
 #endif
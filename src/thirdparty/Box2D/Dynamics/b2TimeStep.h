@@ -43,6 +43,7 @@ struct b2TimeStep
 	int32 velocityIterations;
 	int32 positionIterations;
 	bool warmStarting;
+	bool wideContactSolver;	// solve batches of independent contacts with b2WideMath
 };
 
 /// This is an internal structure.
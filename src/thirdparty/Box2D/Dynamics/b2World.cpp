@@ -38,6 +38,7 @@ b2World::b2World(const b2Vec2& gravity)
 {
 	m_destructionListener = nullptr;
 	g_debugDraw = nullptr;
+	m_solverExecutor = nullptr;
 
 	m_bodyList = nullptr;
 	m_jointList = nullptr;
@@ -48,6 +49,7 @@ b2World::b2World(const b2Vec2& gravity)
 	m_warmStarting = true;
 	m_continuousPhysics = true;
 	m_subStepping = false;
+	m_wideContactSolver = false;
 
 	m_stepComplete = true;
 
@@ -99,6 +101,11 @@ void b2World::SetContactListener(b2ContactListener* listener)
 	m_contactManager.m_contactListener = listener;
 }
 
+void b2World::SetSolverExecutor(b2SolverExecutor* executor)
+{
+	m_solverExecutor = executor;
+}
+
 void b2World::SetDebugDraw(b2Draw* debugDraw)
 {
 	g_debugDraw = debugDraw;
@@ -389,13 +396,6 @@ void b2World::Solve(const b2TimeStep& step)
 	m_profile.solveVelocity = 0.0f;
 	m_profile.solvePosition = 0.0f;
 
-	// Size the island for the worst case.
-	b2Island island(m_bodyCount,
-					m_contactManager.m_contactCount,
-					m_jointCount,
-					&m_stackAllocator,
-					m_contactManager.m_contactListener);
-
 	// Clear all the island flags.
 	for (b2Body* b = m_bodyList; b; b = b->m_next)
 	{
@@ -410,6 +410,50 @@ void b2World::Solve(const b2TimeStep& step)
 		j->m_islandFlag = false;
 	}
 
+	if (m_solverExecutor != nullptr && m_solverExecutor->GetThreadCount() > 1)
+	{
+		SolveIslandsParallel(step);
+	}
+	else
+	{
+		SolveIslands(step);
+	}
+
+	{
+		b2Timer timer;
+		// Synchronize fixtures, check for out of range bodies.
+		for (b2Body* b = m_bodyList; b; b = b->GetNext())
+		{
+			// If a body was not in an island then it did not move.
+			if ((b->m_flags & b2Body::e_islandFlag) == 0)
+			{
+				continue;
+			}
+
+			if (b->GetType() == b2_staticBody)
+			{
+				continue;
+			}
+
+			// Update fixtures (for broad-phase).
+			b->SynchronizeFixtures();
+		}
+
+		// Look for new contacts.
+		m_contactManager.FindNewContacts();
+		m_profile.broadphase = timer.GetMilliseconds();
+	}
+}
+
+void b2World::SolveIslands(const b2TimeStep& step)
+{
+	// Size the island for the worst case.
+	b2Island island(m_bodyCount,
+					m_contactManager.m_contactCount,
+					m_jointCount,
+					&m_stackAllocator,
+					m_contactManager.m_contactListener);
+
 	// Build and simulate all awake islands.
 	int32 stackSize = m_bodyCount;
 	b2Body** stack = (b2Body**)m_stackAllocator.Allocate(stackSize * sizeof(b2Body*));
@@ -546,30 +590,335 @@ void b2World::Solve(const b2TimeStep& step)
 	}
 
 	m_stackAllocator.Free(stack);
+}
 
+void b2World::SolveIslandsParallel(const b2TimeStep& step)
+{
+	// Islands don't share dynamic bodies, contacts or joints, so they can be solved side by side.
+	// Static bodies however are part of every island touching them and get their island index
+	// assigned when the island is built. Islands sharing a static body are therefore merged
+	// into a group which is solved on a single thread.
+	m_islandBodies.clear();
+	m_islandContacts.clear();
+	m_islandJoints.clear();
+	m_islands.clear();
+	m_islandGroups.clear();
+	m_staticOwners.clear();
+
+	// Representative of an island's group, the smallest island index of the group.
+	auto findGroup = [this](int32 index)
 	{
-		b2Timer timer;
-		// Synchronize fixtures, check for out of range bodies.
-		for (b2Body* b = m_bodyList; b; b = b->GetNext())
+		while (m_islandGroups[index] != index)
 		{
-			// If a body was not in an island then it did not move.
-			if ((b->m_flags & b2Body::e_islandFlag) == 0)
+			m_islandGroups[index] = m_islandGroups[m_islandGroups[index]];
+			index = m_islandGroups[index];
+		}
+
+		return index;
+	};
+
+	// Collect all awake islands, the traversal is the same as in SolveIslands.
+	int32 stackSize = m_bodyCount;
+	b2Body** stack = (b2Body**)m_stackAllocator.Allocate(stackSize * sizeof(b2Body*));
+	for (b2Body* seed = m_bodyList; seed; seed = seed->m_next)
+	{
+		if (seed->m_flags & b2Body::e_islandFlag)
+		{
+			continue;
+		}
+
+		if (seed->IsAwake() == false || seed->IsActive() == false)
+		{
+			continue;
+		}
+
+		// The seed can be dynamic or kinematic.
+		if (seed->GetType() == b2_staticBody)
+		{
+			continue;
+		}
+
+		b2IslandRange range;
+		range.bodyStart = (int32)m_islandBodies.size();
+		range.contactStart = (int32)m_islandContacts.size();
+		range.jointStart = (int32)m_islandJoints.size();
+
+		int32 stackCount = 0;
+		stack[stackCount++] = seed;
+		seed->m_flags |= b2Body::e_islandFlag;
+
+		// Perform a depth first search (DFS) on the constraint graph.
+		while (stackCount > 0)
+		{
+			// Grab the next body off the stack and add it to the island.
+			b2Body* b = stack[--stackCount];
+			b2Assert(b->IsActive() == true);
+			m_islandBodies.push_back(b);
+
+			// Make sure the body is awake.
+			b->SetAwake(true);
+
+			// To keep islands as small as possible, we don't
+			// propagate islands across static bodies.
+			if (b->GetType() == b2_staticBody)
 			{
 				continue;
 			}
 
-			if (b->GetType() == b2_staticBody)
+			// Search all contacts connected to this body.
+			for (b2ContactEdge* ce = b->m_contactList; ce; ce = ce->next)
+			{
+				b2Contact* contact = ce->contact;
+
+				// Has this contact already been added to an island?
+				if (contact->m_flags & b2Contact::e_islandFlag)
+				{
+					continue;
+				}
+
+				// Is this contact solid and touching?
+				if (contact->IsEnabled() == false ||
+					contact->IsTouching() == false)
+				{
+					continue;
+				}
+
+				// Skip sensors.
+				bool sensorA = contact->m_fixtureA->m_isSensor;
+				bool sensorB = contact->m_fixtureB->m_isSensor;
+				if (sensorA || sensorB)
+				{
+					continue;
+				}
+
+				m_islandContacts.push_back(contact);
+				contact->m_flags |= b2Contact::e_islandFlag;
+
+				b2Body* other = ce->other;
+
+				// Was the other body already added to this island?
+				if (other->m_flags & b2Body::e_islandFlag)
+				{
+					continue;
+				}
+
+				b2Assert(stackCount < stackSize);
+				stack[stackCount++] = other;
+				other->m_flags |= b2Body::e_islandFlag;
+			}
+
+			// Search all joints connect to this body.
+			for (b2JointEdge* je = b->m_jointList; je; je = je->next)
+			{
+				if (je->joint->m_islandFlag == true)
+				{
+					continue;
+				}
+
+				b2Body* other = je->other;
+
+				// Don't simulate joints connected to inactive bodies.
+				if (other->IsActive() == false)
+				{
+					continue;
+				}
+
+				m_islandJoints.push_back(je->joint);
+				je->joint->m_islandFlag = true;
+
+				if (other->m_flags & b2Body::e_islandFlag)
+				{
+					continue;
+				}
+
+				b2Assert(stackCount < stackSize);
+				stack[stackCount++] = other;
+				other->m_flags |= b2Body::e_islandFlag;
+			}
+		}
+
+		range.bodyCount = (int32)m_islandBodies.size() - range.bodyStart;
+		range.contactCount = (int32)m_islandContacts.size() - range.contactStart;
+		range.jointCount = (int32)m_islandJoints.size() - range.jointStart;
+
+		const int32 islandIndex = (int32)m_islands.size();
+		range.group = islandIndex;
+		m_islands.push_back(range);
+		m_islandGroups.push_back(islandIndex);
+
+		for (int32 i = range.bodyStart; i < range.bodyStart + range.bodyCount; ++i)
+		{
+			b2Body* b = m_islandBodies[i];
+			if (b->GetType() != b2_staticBody)
 			{
 				continue;
 			}
 
-			// Update fixtures (for broad-phase).
-			b->SynchronizeFixtures();
+			// Allow static bodies to participate in other islands.
+			b->m_flags &= ~b2Body::e_islandFlag;
+
+			auto owner = m_staticOwners.find(b);
+			if (owner == m_staticOwners.end())
+			{
+				m_staticOwners.emplace(b, islandIndex);
+				continue;
+			}
+
+			int32 groupA = findGroup(owner->second);
+			int32 groupB = findGroup(islandIndex);
+			if (groupA != groupB)
+			{
+				m_islandGroups[b2Max(groupA, groupB)] = b2Min(groupA, groupB);
+			}
 		}
+	}
 
-		// Look for new contacts.
-		m_contactManager.FindNewContacts();
-		m_profile.broadphase = timer.GetMilliseconds();
+	m_stackAllocator.Free(stack);
+
+	const int32 islandCount = (int32)m_islands.size();
+
+	// Sort the islands by group, keeping their order inside a group.
+	// After this m_islandGroups maps the representative of a group to the group index.
+	int32 groupCount = 0;
+	for (int32 i = 0; i < islandCount; ++i)
+	{
+		m_islands[i].group = findGroup(i);
+	}
+
+	for (int32 i = 0; i < islandCount; ++i)
+	{
+		if (m_islands[i].group == i)
+		{
+			m_islandGroups[i] = groupCount++;
+		}
+	}
+
+	m_groupStarts.assign(groupCount + 1, 0);
+	for (int32 i = 0; i < islandCount; ++i)
+	{
+		m_islands[i].group = m_islandGroups[m_islands[i].group];
+		++m_groupStarts[m_islands[i].group + 1];
+	}
+
+	for (int32 i = 0; i < groupCount; ++i)
+	{
+		m_groupStarts[i + 1] += m_groupStarts[i];
+	}
+
+	m_groupOrder.resize(islandCount);
+	for (int32 i = 0; i < islandCount; ++i)
+	{
+		m_groupOrder[m_groupStarts[m_islands[i].group]++] = i;
+	}
+
+	for (int32 i = groupCount; i > 0; --i)
+	{
+		m_groupStarts[i] = m_groupStarts[i - 1];
+	}
+	m_groupStarts[0] = 0;
+
+	// Every thread but the calling one needs its own stack allocator.
+	const int32 threadCount = m_solverExecutor->GetThreadCount();
+	while ((int32)m_workerAllocators.size() < threadCount - 1)
+	{
+		m_workerAllocators.emplace_back(new b2StackAllocator());
+	}
+
+	if ((int32)m_postSolveRecords.size() < islandCount)
+	{
+		m_postSolveRecords.resize(islandCount);
+	}
+	m_islandProfiles.resize(islandCount);
+
+	// Worker threads must not call back into the game, their post solve callbacks are recorded.
+	class PostSolveRecorder : public b2ContactListener
+	{
+	public:
+		explicit PostSolveRecorder(std::vector<b2PostSolveRecord>* records) : m_records(records) {}
+
+		void PostSolve(b2Contact* contact, const b2ContactImpulse* impulse) override
+		{
+			b2PostSolveRecord record;
+			record.contact = contact;
+			record.impulse = *impulse;
+			m_records->push_back(record);
+		}
+
+		std::vector<b2PostSolveRecord>* m_records;
+	};
+
+	class GroupTask : public b2SolverTask
+	{
+	public:
+		GroupTask(b2World* world, const b2TimeStep& step) : m_world(world), m_step(step) {}
+
+		void Execute(int32 group, int32 threadIndex) override
+		{
+			b2StackAllocator* allocator = (threadIndex == 0)
+				? &m_world->m_stackAllocator
+				: m_world->m_workerAllocators[threadIndex - 1].get();
+
+			const bool hasListener = m_world->m_contactManager.m_contactListener != nullptr;
+
+			for (int32 k = m_world->m_groupStarts[group]; k < m_world->m_groupStarts[group + 1]; ++k)
+			{
+				const int32 islandIndex = m_world->m_groupOrder[k];
+				const b2IslandRange& range = m_world->m_islands[islandIndex];
+
+				std::vector<b2PostSolveRecord>& records = m_world->m_postSolveRecords[islandIndex];
+				records.clear();
+				PostSolveRecorder recorder(&records);
+
+				b2Island island(range.bodyCount,
+								range.contactCount,
+								range.jointCount,
+								allocator,
+								hasListener ? &recorder : nullptr);
+
+				for (int32 i = 0; i < range.bodyCount; ++i)
+				{
+					island.Add(m_world->m_islandBodies[range.bodyStart + i]);
+				}
+
+				for (int32 i = 0; i < range.contactCount; ++i)
+				{
+					island.Add(m_world->m_islandContacts[range.contactStart + i]);
+				}
+
+				for (int32 i = 0; i < range.jointCount; ++i)
+				{
+					island.Add(m_world->m_islandJoints[range.jointStart + i]);
+				}
+
+				island.Solve(&m_world->m_islandProfiles[islandIndex], m_step, m_world->m_gravity, m_world->m_allowSleep);
+			}
+		}
+
+	private:
+		b2World* m_world;
+		b2TimeStep m_step;
+	};
+
+	GroupTask task(this, step);
+	m_solverExecutor->ParallelFor(groupCount, &task);
+
+	// Report in island order, which is the order the serial solver uses.
+	b2ContactListener* listener = m_contactManager.m_contactListener;
+	for (int32 i = 0; i < islandCount; ++i)
+	{
+		m_profile.solveInit += m_islandProfiles[i].solveInit;
+		m_profile.solveVelocity += m_islandProfiles[i].solveVelocity;
+		m_profile.solvePosition += m_islandProfiles[i].solvePosition;
+
+		if (listener == nullptr)
+		{
+			continue;
+		}
+
+		for (const b2PostSolveRecord& record : m_postSolveRecords[i])
+		{
+			listener->PostSolve(record.contact, &record.impulse);
+		}
 	}
 }
 
@@ -860,6 +1209,7 @@ void b2World::SolveTOI(const b2TimeStep& step)
 		subStep.positionIterations = 20;
 		subStep.velocityIterations = step.velocityIterations;
 		subStep.warmStarting = false;
+		subStep.wideContactSolver = false;
 		island.SolveTOI(subStep, bA->m_islandIndex, bB->m_islandIndex);
 
 		// Reset island flags and synchronize broad-phase proxies.
@@ -923,6 +1273,7 @@ void b2World::Step(float32 dt, int32 velocityIterations, int32 positionIteration
 	step.dtRatio = m_inv_dt0 * dt;
 
 	step.warmStarting = m_warmStarting;
+	step.wideContactSolver = m_wideContactSolver;
 	
 	// Update contacts. This is where some contacts are destroyed.
 	{
@@ -26,6 +26,10 @@
 #include <Box2D/Dynamics/b2WorldCallbacks.h>
 #include <Box2D/Dynamics/b2TimeStep.h>
 
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
 struct b2AABB;
 struct b2BodyDef;
 struct b2Color;
@@ -61,6 +65,12 @@ public:
 	/// remain in scope.
 	void SetContactListener(b2ContactListener* listener);
 
+	/// Register an executor to solve independent islands in parallel. Islands sharing a
+	/// static body are solved on the same thread. Post solve callbacks are still reported
+	/// on the calling thread, in the order the serial solver would report them.
+	/// Pass nullptr to solve serially. The executor is owned by you and must remain in scope.
+	void SetSolverExecutor(b2SolverExecutor* executor);
+
 	/// Register a routine for debug drawing. The debug draw functions are called
 	/// inside with b2World::DrawDebugData method. The debug draw object is owned
 	/// by you and must remain in scope.
@@ -157,6 +167,11 @@ public:
 	void SetSubStepping(bool flag) { m_subStepping = flag; }
 	bool GetSubStepping() const { return m_subStepping; }
 
+	/// Enable/disable solving contacts in SIMD batches of four. The results differ
+	/// slightly from the sequential solver because the solve order changes.
+	void SetWideContactSolver(bool flag) { m_wideContactSolver = flag; }
+	bool GetWideContactSolver() const { return m_wideContactSolver; }
+
 	/// Get the number of broad-phase proxies.
 	int32 GetProxyCount() const;
 
@@ -225,6 +240,8 @@ private:
 	friend class b2Controller;
 
 	void Solve(const b2TimeStep& step);
+	void SolveIslands(const b2TimeStep& step);
+	void SolveIslandsParallel(const b2TimeStep& step);
 	void SolveTOI(const b2TimeStep& step);
 
 	void DrawJoint(b2Joint* joint);
@@ -257,10 +274,39 @@ private:
 	bool m_warmStarting;
 	bool m_continuousPhysics;
 	bool m_subStepping;
+	bool m_wideContactSolver;
 
 	bool m_stepComplete;
 
 	b2Profile m_profile;
+
+	// parallel island solver
+	struct b2IslandRange
+	{
+		int32 bodyStart, bodyCount;
+		int32 contactStart, contactCount;
+		int32 jointStart, jointCount;
+		int32 group;
+	};
+
+	struct b2PostSolveRecord
+	{
+		b2Contact* contact;
+		b2ContactImpulse impulse;
+	};
+
+	b2SolverExecutor* m_solverExecutor;
+	std::vector<std::unique_ptr<b2StackAllocator>> m_workerAllocators;
+	std::vector<b2Body*> m_islandBodies;
+	std::vector<b2Contact*> m_islandContacts;
+	std::vector<b2Joint*> m_islandJoints;
+	std::vector<b2IslandRange> m_islands;
+	std::vector<int32> m_islandGroups;
+	std::vector<int32> m_groupOrder;
+	std::vector<int32> m_groupStarts;
+	std::unordered_map<b2Body*, int32> m_staticOwners;
+	std::vector<std::vector<b2PostSolveRecord>> m_postSolveRecords;
+	std::vector<b2Profile> m_islandProfiles;
 };
 
 inline b2Body* b2World::GetBodyList()
@@ -118,6 +118,31 @@ public:
 	}
 };
 
+/// A unit of work handed out by a b2SolverExecutor.
+class b2SolverTask
+{
+public:
+	virtual ~b2SolverTask() {}
+
+	/// Called once for every index of the job.
+	/// @param threadIndex index of the executing thread, 0 is the calling thread
+	virtual void Execute(int32 index, int32 threadIndex) = 0;
+};
+
+/// Implement this class to let the world solve independent islands on several threads.
+/// See b2World::SetSolverExecutor
+class b2SolverExecutor
+{
+public:
+	virtual ~b2SolverExecutor() {}
+
+	/// The number of threads that may execute tasks, including the calling thread.
+	virtual int32 GetThreadCount() const = 0;
+
+	/// Call task->Execute for every index in [0, count) and return once all calls are done.
+	virtual void ParallelFor(int32 count, b2SolverTask* task) = 0;
+};
+
 /// Callback class for AABB queries.
 /// See b2World::Query
 class b2QueryCallback